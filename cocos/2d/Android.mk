@@ -18,6 +18,7 @@ CCActionGrid3D.cpp \
 CCActionInstant.cpp \
 CCActionInterval.cpp \
 CCActionManager.cpp \
+CCActionTemplate.cpp \
 CCActionPageTurn3D.cpp \
 CCActionProgressTimer.cpp \
 CCActionTiledGrid.cpp \
@@ -50,6 +51,7 @@ CCFont.cpp \
 CCFontCharMap.cpp \
 CCFontAtlas.cpp \
 CCFontAtlasCache.cpp \
+CCGlyphCache.cpp \
 CCFontFNT.cpp \
 CCFontFreeType.cpp \
 ccFPSImages.c \
@@ -79,6 +81,7 @@ CCProfiling.cpp \
 CCProgressTimer.cpp \
 CCRenderTexture.cpp \
 CCScene.cpp \
+CCSpatialGrid.cpp \
 CCScheduler.cpp \
 CCScriptSupport.cpp \
 CCShaderCache.cpp \
@@ -120,6 +123,7 @@ renderer/CCFrustum.cpp \
 renderer/CCGroupCommand.cpp \
 renderer/CCMaterialManager.cpp \
 renderer/CCQuadCommand.cpp \
+renderer/CCQuadTransform.cpp \
 renderer/CCBatchCommand.cpp \
 renderer/CCRenderCommand.cpp \
 renderer/CCRenderer.cpp \
@@ -128,6 +132,7 @@ renderer/CCRenderMaterial.cpp \
 ../base/CCAffineTransform.cpp \
 ../base/CCAutoreleasePool.cpp \
 ../base/CCConsole.cpp \
+../base/CCThreadPool.cpp \
 ../base/CCData.cpp \
 ../base/CCDataVisitor.cpp \
 ../base/CCGeometry.cpp \
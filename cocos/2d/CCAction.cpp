@@ -31,7 +31,139 @@ THE SOFTWARE.
 #include "CCDirector.h"
 #include "deprecated/CCString.h"
 
+#include <atomic>
+#include <mutex>
+#include <new>
+
 NS_CC_BEGIN
+
+static std::atomic<unsigned int> s_actionAllocations(0);
+static std::atomic<unsigned int> s_actionHeapAllocations(0);
+
+#if CC_ENABLE_ACTION_POOL
+
+namespace {
+
+/** Slots of 16 to 512 bytes, by steps of 16 bytes. The slots of a size are carved out of chunks that
+ are never freed, the free ones are chained through their first bytes.
+ */
+class ActionPool
+{
+public:
+    static const size_t GRANULARITY = 16;
+    static const size_t MAX_SIZE = 512;
+    static const size_t SLOTS_PER_CHUNK = 64;
+
+    ActionPool()
+    {
+        for (size_t i = 0; i < MAX_SIZE / GRANULARITY; ++i)
+        {
+            _freeSlots[i] = nullptr;
+        }
+    }
+
+    void* allocate(size_t size)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        FreeSlot*& head = _freeSlots[sizeClass(size)];
+        if (head == nullptr)
+        {
+            allocateChunk(head, (sizeClass(size) + 1) * GRANULARITY);
+        }
+        FreeSlot* slot = head;
+        head = slot->next;
+        return slot;
+    }
+
+    void deallocate(void* ptr, size_t size)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        FreeSlot*& head = _freeSlots[sizeClass(size)];
+        FreeSlot* slot = static_cast<FreeSlot*>(ptr);
+        slot->next = head;
+        head = slot;
+    }
+
+private:
+    struct FreeSlot
+    {
+        FreeSlot* next;
+    };
+
+    static size_t sizeClass(size_t size)
+    {
+        return (size + GRANULARITY - 1) / GRANULARITY - 1;
+    }
+
+    void allocateChunk(FreeSlot*& head, size_t slotSize)
+    {
+        // operator new aligns the chunk for any type and the slot sizes keep that alignment
+        char* chunk = static_cast<char*>(::operator new(slotSize * SLOTS_PER_CHUNK));
+        ++s_actionHeapAllocations;
+        for (size_t i = SLOTS_PER_CHUNK; i > 0; --i)
+        {
+            FreeSlot* slot = reinterpret_cast<FreeSlot*>(chunk + (i - 1) * slotSize);
+            slot->next = head;
+            head = slot;
+        }
+    }
+
+    std::mutex _mutex;
+    FreeSlot* _freeSlots[MAX_SIZE / GRANULARITY];
+};
+
+// never deleted: static actions can be released after the other statics are destroyed
+ActionPool* getActionPool()
+{
+    static ActionPool* pool = new ActionPool();
+    return pool;
+}
+
+} // namespace
+
+void* Action::operator new(size_t size)
+{
+    ++s_actionAllocations;
+    if (size > ActionPool::MAX_SIZE)
+    {
+        ++s_actionHeapAllocations;
+        return ::operator new(size);
+    }
+    return getActionPool()->allocate(size);
+}
+
+void Action::operator delete(void* ptr, size_t size)
+{
+    if (ptr == nullptr)
+    {
+        return;
+    }
+    if (size > ActionPool::MAX_SIZE)
+    {
+        ::operator delete(ptr);
+        return;
+    }
+    getActionPool()->deallocate(ptr, size);
+}
+
+#endif // CC_ENABLE_ACTION_POOL
+
+unsigned int Action::getAllocationCount()
+{
+    return s_actionAllocations;
+}
+
+unsigned int Action::getHeapAllocationCount()
+{
+    return s_actionHeapAllocations;
+}
+
+void Action::resetAllocationCounters()
+{
+    s_actionAllocations = 0;
+    s_actionHeapAllocations = 0;
+}
+
 //
 // Action Base Class
 //
@@ -41,6 +173,10 @@ Action::Action()
 ,_target(nullptr)
 ,_tag(Action::INVALID_TAG)
 {
+#if !CC_ENABLE_ACTION_POOL
+    ++s_actionAllocations;
+    ++s_actionHeapAllocations;
+#endif
 }
 
 Action::~Action()
@@ -99,6 +99,30 @@ public:
     inline int getTag() const { return _tag; }
     inline void setTag(int tag) { _tag = tag; }
 
+#if CC_ENABLE_ACTION_POOL
+    /** Allocates the actions from pools of fixed size slots, one pool per size.
+     Deleting an action, which ActionManager does when it releases a finished or removed action,
+     puts its slot back in the pool. Actions bigger than 512 bytes use the heap.
+     @since v3.0
+     */
+    static void* operator new(size_t size);
+    static void operator delete(void* ptr, size_t size);
+#endif
+
+    /** Number of actions allocated since the last resetAllocationCounters()
+     @since v3.0
+     */
+    static unsigned int getAllocationCount();
+    /** Number of the allocations counted by getAllocationCount() that needed memory from the heap,
+     because the pool of their size was empty or because the pools are disabled.
+     @since v3.0
+     */
+    static unsigned int getHeapAllocationCount();
+    /** Resets the allocation counters. The Director does it once per frame when the stats are displayed.
+     @since v3.0
+     */
+    static void resetAllocationCounters();
+
 protected:
     Action();
     virtual ~Action();
@@ -85,6 +85,9 @@ protected:
 
     float _elapsed;
     bool   _firstTick;
+
+    // the ActionManager steps the batched tweens itself
+    friend class ActionManager;
 };
 
 /** @brief Runs actions sequentially, one after another
@@ -358,6 +361,8 @@ protected:
     float _startAngleY;
     float _diffAngleY;
 
+    friend class ActionManager;
+
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(RotateTo);
 };
@@ -399,6 +404,8 @@ protected:
     Vertex3F _angle3D;
     Vertex3F _startAngle3D;
 
+    friend class ActionManager;
+
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(RotateBy);
 };
@@ -435,6 +442,8 @@ protected:
     Point _startPosition;
     Point _previousPosition;
 
+    friend class ActionManager;
+
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(MoveBy);
 };
@@ -720,6 +729,8 @@ protected:
     float _deltaY;
     float _deltaZ;
 
+    friend class ActionManager;
+
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(ScaleTo);
 };
@@ -815,6 +826,7 @@ protected:
     GLubyte _fromOpacity;
     friend class FadeOut;
     friend class FadeIn;
+    friend class ActionManager;
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(FadeTo);
 };
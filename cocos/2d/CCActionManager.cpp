@@ -29,9 +29,15 @@ THE SOFTWARE.
 #include "CCActionManager.h"
 #include "CCNode.h"
 #include "CCScheduler.h"
+#include "CCActionInterval.h"
+#include "CCActionEase.h"
+#include "CCTweenFunction.h"
 #include "ccMacros.h"
 #include "ccCArray.h"
 #include "uthash.h"
+#include "CCProfiling.h"
+
+#include <typeinfo>
 
 NS_CC_BEGIN
 //
@@ -45,15 +51,25 @@ typedef struct _hashElement
     Action                    *currentAction;
     bool                        currentActionSalvaged;
     bool                        paused;
+    int                         tweens;  // number of actions batched in the tween pools
     UT_hash_handle                hh;
 } tHashElement;
 
 ActionManager::ActionManager(void)
 : _targets(nullptr),
   _currentTarget(nullptr),
-  _currentTargetSalvaged(false)
+  _currentTargetSalvaged(false),
+  _tweensLocked(false)
 {
-
+    for (int property = 0; property < TWEEN_PROPERTY_COUNT; ++property)
+    {
+        _tweens[property].components = 0;
+        _tweens[property].removed = 0;
+    }
+    _tweens[TWEEN_POSITION].components = 2;
+    _tweens[TWEEN_SCALE].components = 3;
+    _tweens[TWEEN_ROTATION].components = 2;
+    _tweens[TWEEN_OPACITY].components = 1;
 }
 
 ActionManager::~ActionManager(void)
@@ -91,6 +107,11 @@ void ActionManager::removeActionAtIndex(ssize_t index, tHashElement *element)
 {
     Action *action = (Action*)element->actions->arr[index];
 
+    if (element->tweens > 0)
+    {
+        removeTween(action, element);
+    }
+
     if (action == element->currentAction && (! element->currentActionSalvaged))
     {
         element->currentAction->retain();
@@ -127,6 +148,7 @@ void ActionManager::pauseTarget(Node *target)
     if (element)
     {
         element->paused = true;
+        pauseTweens(element, true);
     }
 }
 
@@ -137,6 +159,7 @@ void ActionManager::resumeTarget(Node *target)
     if (element)
     {
         element->paused = false;
+        pauseTweens(element, false);
     }
 }
 
@@ -149,6 +172,7 @@ Vector<Node*> ActionManager::pauseAllRunningActions()
         if (! element->paused) 
         {
             element->paused = true;
+            pauseTweens(element, true);
             idsWithActions.pushBack(element->target);
         }
     }    
@@ -189,6 +213,20 @@ void ActionManager::addAction(Action *action, Node *target, bool paused)
      ccArrayAppendObject(element->actions, action);
  
      action->startWithTarget(target);
+
+     // the simple tweens are updated by the pools while the target runs no other actions
+     if (element->tweens == element->actions->num - 1 && ! addTween(action, element) && element->tweens > 0)
+     {
+         if (_tweensLocked)
+         {
+             // some tweens of the tick may already be skipped, they are moved after the tick
+             _targetsToUnbatch.pushBack(target);
+         }
+         else
+         {
+             unbatchTweens(element);
+         }
+     }
 }
 
 // remove
@@ -221,6 +259,11 @@ void ActionManager::removeAllActionsFromTarget(Node *target)
             element->currentActionSalvaged = true;
         }
 
+        for (int i = 0; i < element->actions->num && element->tweens > 0; ++i)
+        {
+            removeTween((Action*)element->actions->arr[i], element);
+        }
+
         ccArrayRemoveAllObjects(element->actions);
         if (_currentTarget == element)
         {
@@ -339,12 +382,17 @@ ssize_t ActionManager::getNumberOfRunningActionsInTarget(const Node *target) con
 // main loop
 void ActionManager::update(float dt)
 {
+    CC_PROFILER_TIMELINE_SCOPE("ActionManager::update");
+
+    _tweensLocked = true;
+
     for (tHashElement *elt = _targets; elt != nullptr; )
     {
         _currentTarget = elt;
         _currentTargetSalvaged = false;
 
-        if (! _currentTarget->paused)
+        // the tweens are updated after this loop
+        if (! _currentTarget->paused && _currentTarget->tweens < _currentTarget->actions->num)
         {
             // The 'actions' MutableArray may change while inside this loop.
             for (_currentTarget->actionIndex = 0; _currentTarget->actionIndex < _currentTarget->actions->num;
@@ -356,6 +404,12 @@ void ActionManager::update(float dt)
                     continue;
                 }
 
+                if (_currentTarget->tweens > 0 && _tweenLocations.find(_currentTarget->currentAction) != _tweenLocations.end())
+                {
+                    _currentTarget->currentAction = nullptr;
+                    continue;
+                }
+
                 _currentTarget->currentActionSalvaged = false;
 
                 _currentTarget->currentAction->step(dt);
@@ -394,6 +448,430 @@ void ActionManager::update(float dt)
 
     // issue #635
     _currentTarget = nullptr;
+
+    updateTweens(dt);
+
+    _tweensLocked = false;
+
+    if (! _targetsToUnbatch.empty())
+    {
+        for (const auto& target : _targetsToUnbatch)
+        {
+            tHashElement *element = nullptr;
+            Node *key = target;
+            HASH_FIND_PTR(_targets, &key, element);
+            if (element && element->tweens > 0 && element->tweens < element->actions->num)
+            {
+                unbatchTweens(element);
+            }
+        }
+        _targetsToUnbatch.clear();
+    }
+}
+
+// tweens
+
+bool ActionManager::addTween(Action *action, tHashElement *element)
+{
+    static const struct
+    {
+        const std::type_info *type;
+        TweenEasing easing;
+    } easeActions[] = {
+        { &typeid(EaseIn), TWEEN_EASE_IN },
+        { &typeid(EaseOut), TWEEN_EASE_OUT },
+        { &typeid(EaseInOut), TWEEN_EASE_IN_OUT },
+        { &typeid(EaseExponentialIn), TWEEN_EXPONENTIAL_IN },
+        { &typeid(EaseExponentialOut), TWEEN_EXPONENTIAL_OUT },
+        { &typeid(EaseExponentialInOut), TWEEN_EXPONENTIAL_IN_OUT },
+        { &typeid(EaseSineIn), TWEEN_SINE_IN },
+        { &typeid(EaseSineOut), TWEEN_SINE_OUT },
+        { &typeid(EaseSineInOut), TWEEN_SINE_IN_OUT },
+        { &typeid(EaseBackIn), TWEEN_BACK_IN },
+        { &typeid(EaseBackOut), TWEEN_BACK_OUT },
+        { &typeid(EaseBackInOut), TWEEN_BACK_IN_OUT },
+        { &typeid(EaseBounceIn), TWEEN_BOUNCE_IN },
+        { &typeid(EaseBounceOut), TWEEN_BOUNCE_OUT },
+        { &typeid(EaseBounceInOut), TWEEN_BOUNCE_IN_OUT },
+    };
+
+    // only the exact classes are batched, a subclass may override update()
+    const std::type_info& type = typeid(*action);
+    Action *tween = action;
+    TweenEasing easing = TWEEN_LINEAR;
+    float rate = 0.0f;
+    for (const auto& easeAction : easeActions)
+    {
+        if (type == *easeAction.type)
+        {
+            easing = easeAction.easing;
+            if (easing <= TWEEN_EASE_IN_OUT)
+            {
+                rate = static_cast<EaseRateAction*>(action)->getRate();
+            }
+            tween = static_cast<ActionEase*>(action)->getInnerAction();
+            break;
+        }
+    }
+
+    const std::type_info& tweenType = typeid(*tween);
+    int property = TWEEN_PROPERTY_COUNT;
+    float from[TWEEN_MAX_COMPONENTS];
+    float deltas[TWEEN_MAX_COMPONENTS];
+    float values[TWEEN_MAX_COMPONENTS];
+    if (tweenType == typeid(MoveBy) || tweenType == typeid(MoveTo))
+    {
+        auto moveBy = static_cast<MoveBy*>(tween);
+        property = TWEEN_POSITION;
+        from[0] = moveBy->_startPosition.x;
+        from[1] = moveBy->_startPosition.y;
+        deltas[0] = moveBy->_positionDelta.x;
+        deltas[1] = moveBy->_positionDelta.y;
+        values[0] = moveBy->_previousPosition.x;
+        values[1] = moveBy->_previousPosition.y;
+    }
+    else if (tweenType == typeid(ScaleTo) || tweenType == typeid(ScaleBy))
+    {
+        auto scaleTo = static_cast<ScaleTo*>(tween);
+        property = TWEEN_SCALE;
+        from[0] = scaleTo->_startScaleX;
+        from[1] = scaleTo->_startScaleY;
+        from[2] = scaleTo->_startScaleZ;
+        deltas[0] = scaleTo->_deltaX;
+        deltas[1] = scaleTo->_deltaY;
+        deltas[2] = scaleTo->_deltaZ;
+    }
+    else if (tweenType == typeid(RotateTo))
+    {
+        auto rotateTo = static_cast<RotateTo*>(tween);
+        property = TWEEN_ROTATION;
+        from[0] = rotateTo->_startAngleX;
+        from[1] = rotateTo->_startAngleY;
+        deltas[0] = rotateTo->_diffAngleX;
+        deltas[1] = rotateTo->_diffAngleY;
+    }
+    else if (tweenType == typeid(RotateBy) && ! static_cast<RotateBy*>(tween)->_is3D)
+    {
+        auto rotateBy = static_cast<RotateBy*>(tween);
+        property = TWEEN_ROTATION;
+        from[0] = rotateBy->_startAngleZ_X;
+        from[1] = rotateBy->_startAngleZ_Y;
+        deltas[0] = rotateBy->_angleZ_X;
+        deltas[1] = rotateBy->_angleZ_Y;
+    }
+    else if (tweenType == typeid(FadeTo) || tweenType == typeid(FadeIn) || tweenType == typeid(FadeOut))
+    {
+        auto fadeTo = static_cast<FadeTo*>(tween);
+        property = TWEEN_OPACITY;
+        from[0] = fadeTo->_fromOpacity;
+        deltas[0] = (float)(fadeTo->_toOpacity - fadeTo->_fromOpacity);
+    }
+
+    if (property == TWEEN_PROPERTY_COUNT)
+    {
+        return false;
+    }
+
+    auto interval = static_cast<ActionInterval*>(action);
+    auto& pool = _tweens[property];
+
+    TweenLocation location = { property, static_cast<int>(pool.actions.size()) };
+    _tweenLocations[action] = location;
+    ++element->tweens;
+
+    pool.actions.push_back(interval);
+    pool.targets.push_back(interval->getTarget());
+    pool.elapsed.push_back(interval->_elapsed);
+    pool.durations.push_back(interval->getDuration());
+    pool.times.push_back(0.0f);
+    pool.rates.push_back(rate);
+    pool.easings.push_back(easing);
+    pool.firstTicks.push_back(interval->_firstTick);
+    pool.paused.push_back(element->paused);
+    for (int c = 0; c < pool.components; ++c)
+    {
+        pool.from[c].push_back(from[c]);
+        pool.deltas[c].push_back(deltas[c]);
+        pool.values[c].push_back(property == TWEEN_POSITION ? values[c] : from[c]);
+    }
+
+    return true;
+}
+
+void ActionManager::removeTween(Action *action, tHashElement *element)
+{
+    auto iter = _tweenLocations.find(action);
+    if (iter == _tweenLocations.end())
+    {
+        return;
+    }
+
+    // the entry is removed from the pool at the end of the next tick
+    auto& pool = _tweens[iter->second.property];
+    pool.actions[iter->second.index] = nullptr;
+    ++pool.removed;
+
+    _tweenLocations.erase(iter);
+    --element->tweens;
+}
+
+void ActionManager::unbatchTweens(tHashElement *element)
+{
+    // the state of the pools is written back to the actions, which are stepped from now on
+    for (int i = 0; i < element->actions->num && element->tweens > 0; ++i)
+    {
+        Action *action = (Action*)element->actions->arr[i];
+        auto iter = _tweenLocations.find(action);
+        if (iter == _tweenLocations.end())
+        {
+            continue;
+        }
+
+        auto& pool = _tweens[iter->second.property];
+        int index = iter->second.index;
+
+        auto interval = static_cast<ActionInterval*>(action);
+        interval->_elapsed = pool.elapsed[index];
+        interval->_firstTick = pool.firstTicks[index] != 0;
+
+        if (iter->second.property == TWEEN_POSITION)
+        {
+            Action *tween = action;
+            if (pool.easings[index] != TWEEN_LINEAR)
+            {
+                tween = static_cast<ActionEase*>(action)->getInnerAction();
+            }
+            auto moveBy = static_cast<MoveBy*>(tween);
+            moveBy->_startPosition = Point(pool.from[0][index], pool.from[1][index]);
+            moveBy->_previousPosition = Point(pool.values[0][index], pool.values[1][index]);
+        }
+
+        removeTween(action, element);
+    }
+}
+
+void ActionManager::pauseTweens(tHashElement *element, bool paused)
+{
+    for (int i = 0; i < element->actions->num && element->tweens > 0; ++i)
+    {
+        auto iter = _tweenLocations.find((Action*)element->actions->arr[i]);
+        if (iter != _tweenLocations.end())
+        {
+            _tweens[iter->second.property].paused[iter->second.index] = paused;
+        }
+    }
+}
+
+void ActionManager::updateTweens(float dt)
+{
+    for (auto& pool : _tweens)
+    {
+        stepTweens(pool, dt);
+    }
+
+    // the setters of the nodes may add or remove tweens: the removed entries are only marked,
+    // and the added ones are updated from the next tick
+    for (int property = 0; property < TWEEN_PROPERTY_COUNT; ++property)
+    {
+        applyTweens(property, _tweens[property], _doneTweens);
+    }
+
+    for (const auto& action : _doneTweens)
+    {
+        // a callback may have removed the action, or run it again
+        if (_tweenLocations.find(action) != _tweenLocations.end() && action->isDone())
+        {
+            action->stop();
+            removeAction(action);
+        }
+        action->release();
+    }
+    _doneTweens.clear();
+
+    for (int property = 0; property < TWEEN_PROPERTY_COUNT; ++property)
+    {
+        if (_tweens[property].removed > 0)
+        {
+            compactTweens(_tweens[property]);
+        }
+    }
+}
+
+void ActionManager::stepTweens(TweenPool& pool, float dt)
+{
+    size_t count = pool.actions.size();
+    float *elapsed = pool.elapsed.data();
+    float *times = pool.times.data();
+    const float *durations = pool.durations.data();
+    unsigned char *firstTicks = pool.firstTicks.data();
+    const unsigned char *paused = pool.paused.data();
+
+    // same as ActionInterval::step()
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (! paused[i])
+        {
+            elapsed[i] = firstTicks[i] ? 0.0f : elapsed[i] + dt;
+            firstTicks[i] = 0;
+        }
+        times[i] = MAX(0, MIN(1, elapsed[i] / MAX(durations[i], FLT_EPSILON)));
+    }
+
+    const unsigned char *easings = pool.easings.data();
+    const float *rates = pool.rates.data();
+    for (size_t i = 0; i < count; ++i)
+    {
+        switch (easings[i])
+        {
+            case TWEEN_LINEAR:              break;
+            case TWEEN_EASE_IN:             times[i] = tweenfunc::easeIn(times[i], rates[i]); break;
+            case TWEEN_EASE_OUT:            times[i] = tweenfunc::easeOut(times[i], rates[i]); break;
+            case TWEEN_EASE_IN_OUT:         times[i] = tweenfunc::easeInOut(times[i], rates[i]); break;
+            case TWEEN_EXPONENTIAL_IN:      times[i] = tweenfunc::expoEaseIn(times[i]); break;
+            case TWEEN_EXPONENTIAL_OUT:     times[i] = tweenfunc::expoEaseOut(times[i]); break;
+            case TWEEN_EXPONENTIAL_IN_OUT:  times[i] = tweenfunc::expoEaseInOut(times[i]); break;
+            case TWEEN_SINE_IN:             times[i] = tweenfunc::sineEaseIn(times[i]); break;
+            case TWEEN_SINE_OUT:            times[i] = tweenfunc::sineEaseOut(times[i]); break;
+            case TWEEN_SINE_IN_OUT:         times[i] = tweenfunc::sineEaseInOut(times[i]); break;
+            case TWEEN_BACK_IN:             times[i] = tweenfunc::backEaseIn(times[i]); break;
+            case TWEEN_BACK_OUT:            times[i] = tweenfunc::backEaseOut(times[i]); break;
+            case TWEEN_BACK_IN_OUT:         times[i] = tweenfunc::backEaseInOut(times[i]); break;
+            case TWEEN_BOUNCE_IN:           times[i] = tweenfunc::bounceEaseIn(times[i]); break;
+            case TWEEN_BOUNCE_OUT:          times[i] = tweenfunc::bounceEaseOut(times[i]); break;
+            case TWEEN_BOUNCE_IN_OUT:       times[i] = tweenfunc::bounceEaseInOut(times[i]); break;
+            default:                        break;
+        }
+    }
+}
+
+void ActionManager::applyTweens(int property, TweenPool& pool, std::vector<ActionInterval*>& doneActions)
+{
+    size_t count = pool.actions.size();
+    if (count == 0)
+    {
+        return;
+    }
+
+    const float *times = pool.times.data();
+    for (int c = 0; c < pool.components; ++c)
+    {
+#if CC_ENABLE_STACKABLE_ACTIONS
+        // the positions depend on the moves done before them, they are computed when they are set
+        if (property == TWEEN_POSITION)
+        {
+            break;
+        }
+#endif // CC_ENABLE_STACKABLE_ACTIONS
+
+        const float *from = pool.from[c].data();
+        const float *deltas = pool.deltas[c].data();
+        float *values = pool.values[c].data();
+        for (size_t i = 0; i < count; ++i)
+        {
+            values[i] = from[i] + deltas[i] * times[i];
+        }
+    }
+
+    // the vectors may grow while the nodes are updated, the pointers are not kept
+    for (size_t i = 0; i < count; ++i)
+    {
+        ActionInterval *action = pool.actions[i];
+        if (action == nullptr || pool.paused[i])
+        {
+            continue;
+        }
+
+        action->_elapsed = pool.elapsed[i];
+        action->_firstTick = false;
+
+        Node *target = pool.targets[i];
+        switch (property)
+        {
+            case TWEEN_POSITION:
+            {
+#if CC_ENABLE_STACKABLE_ACTIONS
+                // same as MoveBy::update(): the moves of the other actions are added to the start position
+                const Point& position = target->getPosition();
+                pool.from[0][i] += position.x - pool.values[0][i];
+                pool.from[1][i] += position.y - pool.values[1][i];
+                pool.values[0][i] = pool.from[0][i] + pool.deltas[0][i] * pool.times[i];
+                pool.values[1][i] = pool.from[1][i] + pool.deltas[1][i] * pool.times[i];
+#endif // CC_ENABLE_STACKABLE_ACTIONS
+                target->setPosition(Point(pool.values[0][i], pool.values[1][i]));
+                break;
+            }
+            case TWEEN_SCALE:
+                target->setScaleX(pool.values[0][i]);
+                target->setScaleY(pool.values[1][i]);
+                target->setScaleZ(pool.values[2][i]);
+                break;
+            case TWEEN_ROTATION:
+                target->setRotationSkewX(pool.values[0][i]);
+                target->setRotationSkewY(pool.values[1][i]);
+                break;
+            case TWEEN_OPACITY:
+                target->setOpacity((GLubyte)pool.values[0][i]);
+                break;
+            default:
+                break;
+        }
+
+        // the setter may have removed the action
+        if (pool.actions[i] != nullptr && pool.elapsed[i] >= pool.durations[i])
+        {
+            action->retain();
+            doneActions.push_back(action);
+        }
+    }
+}
+
+void ActionManager::compactTweens(TweenPool& pool)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < pool.actions.size(); ++i)
+    {
+        if (pool.actions[i] == nullptr)
+        {
+            continue;
+        }
+
+        if (count != i)
+        {
+            pool.actions[count] = pool.actions[i];
+            pool.targets[count] = pool.targets[i];
+            pool.elapsed[count] = pool.elapsed[i];
+            pool.durations[count] = pool.durations[i];
+            pool.rates[count] = pool.rates[i];
+            pool.easings[count] = pool.easings[i];
+            pool.firstTicks[count] = pool.firstTicks[i];
+            pool.paused[count] = pool.paused[i];
+            for (int c = 0; c < pool.components; ++c)
+            {
+                pool.from[c][count] = pool.from[c][i];
+                pool.deltas[c][count] = pool.deltas[c][i];
+                pool.values[c][count] = pool.values[c][i];
+            }
+            _tweenLocations[pool.actions[count]].index = static_cast<int>(count);
+        }
+        ++count;
+    }
+
+    pool.actions.resize(count);
+    pool.targets.resize(count);
+    pool.elapsed.resize(count);
+    pool.durations.resize(count);
+    pool.times.resize(count);
+    pool.rates.resize(count);
+    pool.easings.resize(count);
+    pool.firstTicks.resize(count);
+    pool.paused.resize(count);
+    for (int c = 0; c < pool.components; ++c)
+    {
+        pool.from[c].resize(count);
+        pool.deltas[c].resize(count);
+        pool.values[c].resize(count);
+    }
+    pool.removed = 0;
 }
 
 NS_CC_END
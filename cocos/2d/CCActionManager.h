@@ -33,9 +33,13 @@ THE SOFTWARE.
 #include "CCVector.h"
 #include "CCRef.h"
 
+#include <unordered_map>
+#include <vector>
+
 NS_CC_BEGIN
 
 struct _hashElement;
+class ActionInterval;
 
 /**
  * @addtogroup actions
@@ -50,6 +54,11 @@ struct _hashElement;
  Examples:
     - When you want to run an action where the target is different from a Node. 
     - When you want to pause / resume the actions
+
+ The simple tweens (MoveBy, MoveTo, ScaleTo, ScaleBy, RotateTo, RotateBy, FadeTo, FadeIn and FadeOut, alone or
+ inside one of the common ease actions) are not stepped one by one: they are batched by property and updated
+ together, after the other actions of the tick. The tweens of a target are only batched while it runs no other
+ actions, so that the actions of a target are still applied in order.
  
  @since v0.8
  */
@@ -131,10 +140,84 @@ protected:
     void deleteHashElement(struct _hashElement *element);
     void actionAllocWithHashElement(struct _hashElement *element);
 
+    // tween specific
+
+    enum TweenProperty
+    {
+        TWEEN_POSITION,
+        TWEEN_SCALE,
+        TWEEN_ROTATION,
+        TWEEN_OPACITY,
+        TWEEN_PROPERTY_COUNT
+    };
+
+    enum TweenEasing
+    {
+        TWEEN_LINEAR,
+        TWEEN_EASE_IN,
+        TWEEN_EASE_OUT,
+        TWEEN_EASE_IN_OUT,
+        TWEEN_EXPONENTIAL_IN,
+        TWEEN_EXPONENTIAL_OUT,
+        TWEEN_EXPONENTIAL_IN_OUT,
+        TWEEN_SINE_IN,
+        TWEEN_SINE_OUT,
+        TWEEN_SINE_IN_OUT,
+        TWEEN_BACK_IN,
+        TWEEN_BACK_OUT,
+        TWEEN_BACK_IN_OUT,
+        TWEEN_BOUNCE_IN,
+        TWEEN_BOUNCE_OUT,
+        TWEEN_BOUNCE_IN_OUT
+    };
+
+    static const int TWEEN_MAX_COMPONENTS = 3;
+
+    // The tweens of a property, one entry per action. The arrays are parallel
+    struct TweenPool
+    {
+        std::vector<ActionInterval*> actions; // nullptr once removed, the entries are compacted at the end of the tick
+        std::vector<Node*> targets;
+        std::vector<float> elapsed;
+        std::vector<float> durations;
+        std::vector<float> times;
+        std::vector<float> rates;
+        std::vector<unsigned char> easings;
+        std::vector<unsigned char> firstTicks;
+        std::vector<unsigned char> paused;
+        std::vector<float> from[TWEEN_MAX_COMPONENTS];
+        std::vector<float> deltas[TWEEN_MAX_COMPONENTS];
+        std::vector<float> values[TWEEN_MAX_COMPONENTS]; // the values set by the last tick
+        int components;
+        int removed;
+    };
+
+    struct TweenLocation
+    {
+        int property;
+        int index;
+    };
+
+    bool addTween(Action *action, struct _hashElement *element);
+    void removeTween(Action *action, struct _hashElement *element);
+    void unbatchTweens(struct _hashElement *element);
+    void pauseTweens(struct _hashElement *element, bool paused);
+    void updateTweens(float dt);
+    void stepTweens(TweenPool& pool, float dt);
+    void applyTweens(int property, TweenPool& pool, std::vector<ActionInterval*>& doneActions);
+    void compactTweens(TweenPool& pool);
+
 protected:
     struct _hashElement    *_targets;
     struct _hashElement    *_currentTarget;
     bool            _currentTargetSalvaged;
+
+    TweenPool _tweens[TWEEN_PROPERTY_COUNT];
+    std::unordered_map<Action*, TweenLocation> _tweenLocations;
+    std::vector<ActionInterval*> _doneTweens;
+    Vector<Node*> _targetsToUnbatch;
+    // true while the actions are updated: the tweens are not unbatched in the middle of a tick
+    bool _tweensLocked;
 };
 
 // end of actions group
@@ -0,0 +1,314 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "CCActionTemplate.h"
+#include "CCActionInterval.h"
+#include "CCActionInstant.h"
+#include "CCActionEase.h"
+
+#include <algorithm>
+
+NS_CC_BEGIN
+
+ActionTemplate* ActionTemplate::create(Type type, float duration, float x, float y, float z)
+{
+    ActionTemplate* ret = new ActionTemplate(type, duration, x, y, z);
+    ret->autorelease();
+    return ret;
+}
+
+ActionTemplate::ActionTemplate(Type type, float duration, float x, float y, float z)
+: _type(type)
+, _duration(duration)
+, _times(0)
+, _easing(Easing::IN)
+{
+    _values[0] = x;
+    _values[1] = y;
+    _values[2] = z;
+}
+
+ActionTemplate::~ActionTemplate()
+{
+}
+
+ActionTemplate* ActionTemplate::moveTo(float duration, const Point& position)
+{
+    return create(Type::MOVE_TO, duration, position.x, position.y);
+}
+
+ActionTemplate* ActionTemplate::moveBy(float duration, const Point& deltaPosition)
+{
+    return create(Type::MOVE_BY, duration, deltaPosition.x, deltaPosition.y);
+}
+
+ActionTemplate* ActionTemplate::scaleTo(float duration, float scale)
+{
+    return create(Type::SCALE_TO, duration, scale, scale);
+}
+
+ActionTemplate* ActionTemplate::scaleTo(float duration, float scaleX, float scaleY)
+{
+    return create(Type::SCALE_TO, duration, scaleX, scaleY);
+}
+
+ActionTemplate* ActionTemplate::scaleBy(float duration, float scale)
+{
+    return create(Type::SCALE_BY, duration, scale, scale);
+}
+
+ActionTemplate* ActionTemplate::scaleBy(float duration, float scaleX, float scaleY)
+{
+    return create(Type::SCALE_BY, duration, scaleX, scaleY);
+}
+
+ActionTemplate* ActionTemplate::rotateTo(float duration, float angle)
+{
+    return create(Type::ROTATE_TO, duration, angle);
+}
+
+ActionTemplate* ActionTemplate::rotateBy(float duration, float deltaAngle)
+{
+    return create(Type::ROTATE_BY, duration, deltaAngle);
+}
+
+ActionTemplate* ActionTemplate::fadeTo(float duration, GLubyte opacity)
+{
+    return create(Type::FADE_TO, duration, opacity);
+}
+
+ActionTemplate* ActionTemplate::fadeIn(float duration)
+{
+    return create(Type::FADE_IN, duration);
+}
+
+ActionTemplate* ActionTemplate::fadeOut(float duration)
+{
+    return create(Type::FADE_OUT, duration);
+}
+
+ActionTemplate* ActionTemplate::tintTo(float duration, const Color3B& color)
+{
+    return create(Type::TINT_TO, duration, color.r, color.g, color.b);
+}
+
+ActionTemplate* ActionTemplate::delay(float duration)
+{
+    return create(Type::DELAY, duration);
+}
+
+ActionTemplate* ActionTemplate::show()
+{
+    return create(Type::SHOW, 0);
+}
+
+ActionTemplate* ActionTemplate::hide()
+{
+    return create(Type::HIDE, 0);
+}
+
+ActionTemplate* ActionTemplate::removeSelf(bool cleanup)
+{
+    return create(Type::REMOVE_SELF, 0, cleanup ? 1 : 0);
+}
+
+ActionTemplate* ActionTemplate::callFunc(const std::function<void()>& func)
+{
+    auto ret = create(Type::CALL_FUNC, 0);
+    ret->_func = func;
+    return ret;
+}
+
+ActionTemplate* ActionTemplate::sequence(const Vector<ActionTemplate*>& templates)
+{
+    CCASSERT(!templates.empty(), "a sequence needs at least one template");
+
+    float duration = 0;
+    for (const auto& child : templates)
+    {
+        CCASSERT(child->_type != Type::REPEAT_FOREVER, "a sequence can't contain a repeatForever");
+        duration += child->_duration;
+    }
+
+    auto ret = create(Type::SEQUENCE, duration);
+    ret->_children = templates;
+    return ret;
+}
+
+ActionTemplate* ActionTemplate::spawn(const Vector<ActionTemplate*>& templates)
+{
+    CCASSERT(!templates.empty(), "a spawn needs at least one template");
+
+    float duration = 0;
+    for (const auto& child : templates)
+    {
+        CCASSERT(child->_type != Type::REPEAT_FOREVER, "a spawn can't contain a repeatForever");
+        duration = std::max(duration, child->_duration);
+    }
+
+    auto ret = create(Type::SPAWN, duration);
+    ret->_children = templates;
+    return ret;
+}
+
+ActionTemplate* ActionTemplate::repeat(ActionTemplate* inner, unsigned int times)
+{
+    CCASSERT(inner != nullptr && inner->_type != Type::REPEAT_FOREVER, "can't repeat a repeatForever");
+
+    auto ret = create(Type::REPEAT, inner->_duration * times);
+    ret->_times = times;
+    ret->_children.pushBack(inner);
+    return ret;
+}
+
+ActionTemplate* ActionTemplate::repeatForever(ActionTemplate* inner)
+{
+    CCASSERT(inner != nullptr && inner->_duration > 0, "the template repeated forever must last some time");
+
+    auto ret = create(Type::REPEAT_FOREVER, -1);
+    ret->_children.pushBack(inner);
+    return ret;
+}
+
+ActionTemplate* ActionTemplate::ease(ActionTemplate* inner, Easing easing, float rate)
+{
+    CCASSERT(inner != nullptr && !inner->isInstant() && inner->_type != Type::REPEAT_FOREVER, "only intervals can be eased");
+
+    if (rate < 0)
+    {
+        bool elastic = (easing == Easing::ELASTIC_IN || easing == Easing::ELASTIC_OUT || easing == Easing::ELASTIC_IN_OUT);
+        rate = elastic ? 0.3f : 2.0f;
+    }
+
+    auto ret = create(Type::EASE, inner->_duration, rate);
+    ret->_easing = easing;
+    ret->_children.pushBack(inner);
+    return ret;
+}
+
+float ActionTemplate::getDuration() const
+{
+    return _duration;
+}
+
+bool ActionTemplate::isInstant() const
+{
+    return _type == Type::SHOW || _type == Type::HIDE || _type == Type::REMOVE_SELF || _type == Type::CALL_FUNC;
+}
+
+Action* ActionTemplate::instantiate() const
+{
+    if (_type == Type::REPEAT_FOREVER)
+    {
+        auto inner = static_cast<ActionInterval*>(_children.at(0)->instantiateFinite());
+        return RepeatForever::create(inner);
+    }
+    return instantiateFinite();
+}
+
+FiniteTimeAction* ActionTemplate::instantiateFinite() const
+{
+    switch (_type)
+    {
+        case Type::MOVE_TO:
+            return MoveTo::create(_duration, Point(_values[0], _values[1]));
+        case Type::MOVE_BY:
+            return MoveBy::create(_duration, Point(_values[0], _values[1]));
+        case Type::SCALE_TO:
+            return ScaleTo::create(_duration, _values[0], _values[1]);
+        case Type::SCALE_BY:
+            return ScaleBy::create(_duration, _values[0], _values[1]);
+        case Type::ROTATE_TO:
+            return RotateTo::create(_duration, _values[0]);
+        case Type::ROTATE_BY:
+            return RotateBy::create(_duration, _values[0]);
+        case Type::FADE_TO:
+            return FadeTo::create(_duration, (GLubyte)_values[0]);
+        case Type::FADE_IN:
+            return FadeIn::create(_duration);
+        case Type::FADE_OUT:
+            return FadeOut::create(_duration);
+        case Type::TINT_TO:
+            return TintTo::create(_duration, (GLubyte)_values[0], (GLubyte)_values[1], (GLubyte)_values[2]);
+        case Type::DELAY:
+            return DelayTime::create(_duration);
+        case Type::SHOW:
+            return Show::create();
+        case Type::HIDE:
+            return Hide::create();
+        case Type::REMOVE_SELF:
+            return RemoveSelf::create(_values[0] != 0);
+        case Type::CALL_FUNC:
+            return CallFunc::create(_func);
+        case Type::SEQUENCE:
+        case Type::SPAWN:
+        {
+            Vector<FiniteTimeAction*> actions(_children.size());
+            for (const auto& child : _children)
+            {
+                actions.pushBack(child->instantiateFinite());
+            }
+            if (_type == Type::SEQUENCE)
+            {
+                return Sequence::create(actions);
+            }
+            return Spawn::create(actions);
+        }
+        case Type::REPEAT:
+            return Repeat::create(_children.at(0)->instantiateFinite(), _times);
+        case Type::EASE:
+        {
+            auto inner = static_cast<ActionInterval*>(_children.at(0)->instantiateFinite());
+            float rate = _values[0];
+            switch (_easing)
+            {
+                case Easing::IN:                 return EaseIn::create(inner, rate);
+                case Easing::OUT:                return EaseOut::create(inner, rate);
+                case Easing::IN_OUT:             return EaseInOut::create(inner, rate);
+                case Easing::EXPONENTIAL_IN:     return EaseExponentialIn::create(inner);
+                case Easing::EXPONENTIAL_OUT:    return EaseExponentialOut::create(inner);
+                case Easing::EXPONENTIAL_IN_OUT: return EaseExponentialInOut::create(inner);
+                case Easing::SINE_IN:            return EaseSineIn::create(inner);
+                case Easing::SINE_OUT:           return EaseSineOut::create(inner);
+                case Easing::SINE_IN_OUT:        return EaseSineInOut::create(inner);
+                case Easing::ELASTIC_IN:         return EaseElasticIn::create(inner, rate);
+                case Easing::ELASTIC_OUT:        return EaseElasticOut::create(inner, rate);
+                case Easing::ELASTIC_IN_OUT:     return EaseElasticInOut::create(inner, rate);
+                case Easing::BOUNCE_IN:          return EaseBounceIn::create(inner);
+                case Easing::BOUNCE_OUT:         return EaseBounceOut::create(inner);
+                case Easing::BOUNCE_IN_OUT:      return EaseBounceInOut::create(inner);
+                case Easing::BACK_IN:            return EaseBackIn::create(inner);
+                case Easing::BACK_OUT:           return EaseBackOut::create(inner);
+                case Easing::BACK_IN_OUT:        return EaseBackInOut::create(inner);
+            }
+            break;
+        }
+        case Type::REPEAT_FOREVER:
+            CCASSERT(false, "a repeatForever can only be instantiated by instantiate()");
+            break;
+    }
+    return nullptr;
+}
+
+NS_CC_END
@@ -0,0 +1,179 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __CCACTIONTEMPLATE_H__
+#define __CCACTIONTEMPLATE_H__
+
+#include <functional>
+
+#include "CCRef.h"
+#include "CCVector.h"
+#include "CCGeometry.h"
+#include "ccTypes.h"
+
+NS_CC_BEGIN
+
+class Action;
+class FiniteTimeAction;
+
+/**
+ * @addtogroup actions
+ * @{
+ */
+
+/** @brief An immutable description of an action, from which actions are created without cloning a prototype.
+
+ The templates are built once with the factories below and never change afterwards, so one template can be
+ shared by all the nodes that run the same effect. instantiate() creates the action tree straight from the
+ parameters of the template: nothing is copied from another action, and the new actions come from the action
+ pools (see Action::operator new).
+
+ @code
+ Vector<ActionTemplate*> steps;
+ steps.pushBack(ActionTemplate::tintTo(0.05f, Color3B::RED));
+ steps.pushBack(ActionTemplate::tintTo(0.2f, Color3B::WHITE));
+ _hitFlash = ActionTemplate::sequence(steps);
+ _hitFlash->retain();
+ ...
+ enemy->runAction(_hitFlash->instantiate());
+ @endcode
+ @since v3.0
+ */
+class CC_DLL ActionTemplate : public Ref
+{
+public:
+    /** easing functions of ease() */
+    enum class Easing
+    {
+        IN,
+        OUT,
+        IN_OUT,
+        EXPONENTIAL_IN,
+        EXPONENTIAL_OUT,
+        EXPONENTIAL_IN_OUT,
+        SINE_IN,
+        SINE_OUT,
+        SINE_IN_OUT,
+        ELASTIC_IN,
+        ELASTIC_OUT,
+        ELASTIC_IN_OUT,
+        BOUNCE_IN,
+        BOUNCE_OUT,
+        BOUNCE_IN_OUT,
+        BACK_IN,
+        BACK_OUT,
+        BACK_IN_OUT,
+    };
+
+    static ActionTemplate* moveTo(float duration, const Point& position);
+    static ActionTemplate* moveBy(float duration, const Point& deltaPosition);
+    static ActionTemplate* scaleTo(float duration, float scale);
+    static ActionTemplate* scaleTo(float duration, float scaleX, float scaleY);
+    static ActionTemplate* scaleBy(float duration, float scale);
+    static ActionTemplate* scaleBy(float duration, float scaleX, float scaleY);
+    static ActionTemplate* rotateTo(float duration, float angle);
+    static ActionTemplate* rotateBy(float duration, float deltaAngle);
+    static ActionTemplate* fadeTo(float duration, GLubyte opacity);
+    static ActionTemplate* fadeIn(float duration);
+    static ActionTemplate* fadeOut(float duration);
+    static ActionTemplate* tintTo(float duration, const Color3B& color);
+    static ActionTemplate* delay(float duration);
+
+    static ActionTemplate* show();
+    static ActionTemplate* hide();
+    static ActionTemplate* removeSelf(bool cleanup = true);
+    static ActionTemplate* callFunc(const std::function<void()>& func);
+
+    /** runs the templates one after the other. None of them can be a repeatForever() */
+    static ActionTemplate* sequence(const Vector<ActionTemplate*>& templates);
+    /** runs the templates at the same time. None of them can be a repeatForever() */
+    static ActionTemplate* spawn(const Vector<ActionTemplate*>& templates);
+    static ActionTemplate* repeat(ActionTemplate* inner, unsigned int times);
+    /** the inner template must last some time */
+    static ActionTemplate* repeatForever(ActionTemplate* inner);
+    /** rate is the rate of IN, OUT and IN_OUT and the period of the ELASTIC easings, it is ignored by the other ones.
+     A negative rate uses the default one: 2 for IN, OUT and IN_OUT, 0.3 for ELASTIC.
+     The inner template must be an interval: it can't be show(), hide(), removeSelf(), callFunc() or repeatForever().
+     */
+    static ActionTemplate* ease(ActionTemplate* inner, Easing easing, float rate = -1);
+
+    /** creates a new action, autoreleased, that does what the template describes */
+    Action* instantiate() const;
+
+    /** duration of the actions created by the template, 0 for instant ones and -1 for repeatForever() */
+    float getDuration() const;
+
+protected:
+    enum class Type
+    {
+        MOVE_TO,
+        MOVE_BY,
+        SCALE_TO,
+        SCALE_BY,
+        ROTATE_TO,
+        ROTATE_BY,
+        FADE_TO,
+        FADE_IN,
+        FADE_OUT,
+        TINT_TO,
+        DELAY,
+        SHOW,
+        HIDE,
+        REMOVE_SELF,
+        CALL_FUNC,
+        SEQUENCE,
+        SPAWN,
+        REPEAT,
+        REPEAT_FOREVER,
+        EASE,
+    };
+
+    static ActionTemplate* create(Type type, float duration, float x = 0, float y = 0, float z = 0);
+
+    ActionTemplate(Type type, float duration, float x, float y, float z);
+    virtual ~ActionTemplate();
+
+    FiniteTimeAction* instantiateFinite() const;
+    bool isInstant() const;
+
+    Type _type;
+    float _duration;
+    /** position, scale, angle, opacity, color or rate */
+    float _values[3];
+    unsigned int _times;
+    Easing _easing;
+    std::function<void()> _func;
+    Vector<ActionTemplate*> _children;
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(ActionTemplate);
+};
+
+// end of actions group
+/// @}
+
+NS_CC_END
+
+#endif // __CCACTIONTEMPLATE_H__
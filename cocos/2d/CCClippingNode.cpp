@@ -29,6 +29,7 @@
 #include "kazmath/GL/matrix.h"
 #include "CCGLProgram.h"
 #include "CCShaderCache.h"
+#include "ccGLStateCache.h"
 #include "CCDirector.h"
 #include "CCDrawingPrimitives.h"
 
@@ -347,13 +348,13 @@ void ClippingNode::onBeforeVisit()
     glGetIntegerv(GL_STENCIL_PASS_DEPTH_PASS, (GLint *)&_currentStencilPassDepthPass);
 
     // enable stencil use
-    glEnable(GL_STENCIL_TEST);
+    GL::enable(GL_STENCIL_TEST);
     // check for OpenGL error while enabling stencil test
     CHECK_GL_ERROR_DEBUG();
 
     // all bits on the stencil buffer are readonly, except the current layer bit,
     // this means that operation like glClear or glStencilOp will be masked with this value
-    glStencilMask(mask_layer);
+    GL::stencilMask(mask_layer);
 
     // manually save the depth test state
 
@@ -365,7 +366,7 @@ void ClippingNode::onBeforeVisit()
     // as the stencil is not meant to be rendered in the real scene,
     // it should never prevent something else to be drawn,
     // only disabling depth buffer update should do
-    glDepthMask(GL_FALSE);
+    GL::depthMask(GL_FALSE);
 
     ///////////////////////////////////
     // CLEAR STENCIL BUFFER
@@ -376,8 +377,8 @@ void ClippingNode::onBeforeVisit()
     //     never draw it into the frame buffer
     //     if not in inverted mode: set the current layer value to 0 in the stencil buffer
     //     if in inverted mode: set the current layer value to 1 in the stencil buffer
-    glStencilFunc(GL_NEVER, mask_layer, mask_layer);
-    glStencilOp(!_inverted ? GL_ZERO : GL_REPLACE, GL_KEEP, GL_KEEP);
+    GL::stencilFunc(GL_NEVER, mask_layer, mask_layer);
+    GL::stencilOp(!_inverted ? GL_ZERO : GL_REPLACE, GL_KEEP, GL_KEEP);
 
     // draw a fullscreen solid rectangle to clear the stencil buffer
     //ccDrawSolidRect(Point::ZERO, ccpFromSize([[Director sharedDirector] winSize]), Color4F(1, 1, 1, 1));
@@ -391,8 +392,8 @@ void ClippingNode::onBeforeVisit()
     //     never draw it into the frame buffer
     //     if not in inverted mode: set the current layer value to 1 in the stencil buffer
     //     if in inverted mode: set the current layer value to 0 in the stencil buffer
-    glStencilFunc(GL_NEVER, mask_layer, mask_layer);
-    glStencilOp(!_inverted ? GL_REPLACE : GL_ZERO, GL_KEEP, GL_KEEP);
+    GL::stencilFunc(GL_NEVER, mask_layer, mask_layer);
+    GL::stencilOp(!_inverted ? GL_REPLACE : GL_ZERO, GL_KEEP, GL_KEEP);
 
     // enable alpha test only if the alpha threshold < 1,
     // indeed if alpha threshold == 1, every pixel will be drawn anyways
@@ -434,7 +435,7 @@ void ClippingNode::onAfterDrawStencil()
     }
 
     // restore the depth test state
-    glDepthMask(_currentDepthWriteMask);
+    GL::depthMask(_currentDepthWriteMask);
     //if (currentDepthTestEnabled) {
     //    glEnable(GL_DEPTH_TEST);
     //}
@@ -448,8 +449,8 @@ void ClippingNode::onAfterDrawStencil()
     //         draw the pixel and keep the current layer in the stencil buffer
     //     else
     //         do not draw the pixel but keep the current layer in the stencil buffer
-    glStencilFunc(GL_EQUAL, _mask_layer_le, _mask_layer_le);
-    glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+    GL::stencilFunc(GL_EQUAL, _mask_layer_le, _mask_layer_le);
+    GL::stencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
 
     // draw (according to the stencil test func) this node and its childs
 }
@@ -461,12 +462,12 @@ void ClippingNode::onAfterVisit()
     // CLEANUP
 
     // manually restore the stencil state
-    glStencilFunc(_currentStencilFunc, _currentStencilRef, _currentStencilValueMask);
-    glStencilOp(_currentStencilFail, _currentStencilPassDepthFail, _currentStencilPassDepthPass);
-    glStencilMask(_currentStencilWriteMask);
+    GL::stencilFunc(_currentStencilFunc, _currentStencilRef, _currentStencilValueMask);
+    GL::stencilOp(_currentStencilFail, _currentStencilPassDepthFail, _currentStencilPassDepthPass);
+    GL::stencilMask(_currentStencilWriteMask);
     if (!_currentStencilEnabled)
     {
-        glDisable(GL_STENCIL_TEST);
+        GL::disable(GL_STENCIL_TEST);
     }
 
     // we are done using this layer, decrement
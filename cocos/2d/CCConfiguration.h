@@ -110,6 +110,12 @@ public:
      */
 	bool supportsShareableVAO() const;
 
+    /** Whether or not glMapBufferRange is supported */
+    bool supportsMapBufferRange() const;
+
+    /** Whether or not fence sync objects (glFenceSync / glClientWaitSync) are supported */
+    bool supportsFenceSync() const;
+
     /** returns whether or not an OpenGL is supported */
     bool checkForGLExtension(const std::string &searchName) const;
 
@@ -146,6 +152,8 @@ protected:
     bool            _supportsBGRA8888;
     bool            _supportsDiscardFramebuffer;
     bool            _supportsShareableVAO;
+    bool            _supportsMapBufferRange;
+    bool            _supportsFenceSync;
     GLint           _maxSamplesAllowed;
     GLint           _maxTextureUnits;
     char *          _glExtensions;
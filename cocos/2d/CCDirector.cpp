@@ -45,6 +45,7 @@ THE SOFTWARE.
 #include "CCApplication.h"
 #include "CCFontFNT.h"
 #include "CCFontAtlasCache.h"
+#include "CCGlyphCache.h"
 #include "CCActionManager.h"
 #include "CCAnimationCache.h"
 #include "CCTouch.h"
@@ -61,6 +62,7 @@ THE SOFTWARE.
 #include "renderer/CCRenderer.h"
 #include "renderer/CCFrustum.h"
 #include "CCConsole.h"
+#include "CCThreadPool.h"
 
 #include "kazmath/kazmath.h"
 #include "kazmath/GL/matrix.h"
@@ -120,9 +122,10 @@ bool Director::init(void)
     // FPS
     _accumDt = 0.0f;
     _frameRate = 0.0f;
-    _FPSLabel = _drawnBatchesLabel = _drawnVerticesLabel = nullptr;
+    _FPSLabel = _drawnBatchesLabel = _drawnVerticesLabel = _textureUploadLabel = _glStateLabel = _actionAllocationLabel = nullptr;
     _totalFrames = _frames = 0;
     _lastUpdate = new struct timeval;
+    _fixedDeltaTime = 0.0f;
 
     // paused ?
     _paused = false;
@@ -171,6 +174,9 @@ Director::~Director(void)
     CC_SAFE_RELEASE(_FPSLabel);
     CC_SAFE_RELEASE(_drawnVerticesLabel);
     CC_SAFE_RELEASE(_drawnBatchesLabel);
+    CC_SAFE_RELEASE(_textureUploadLabel);
+    CC_SAFE_RELEASE(_glStateLabel);
+    CC_SAFE_RELEASE(_actionAllocationLabel);
 
     CC_SAFE_RELEASE(_runningScene);
     CC_SAFE_RELEASE(_notificationNode);
@@ -263,6 +269,8 @@ void Director::drawScene()
         return;
     }
 
+    CC_PROFILER_TIMELINE_SCOPE("Director::drawScene");
+
     if (_openGLView)
     {
         _openGLView->pollInputEvents();
@@ -277,6 +285,8 @@ void Director::drawScene()
 
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+    GLProgram::updateBuiltinUniforms();
+
     /* to avoid flickr, nextScene MUST be here: after tick and before draw.
      XXX: Which bug is this one. It seems that it can't be reproduced with v0.9 */
     if (_nextScene)
@@ -293,7 +303,9 @@ void Director::drawScene()
     // draw the scene
     if (_runningScene)
     {
+        CC_PROFILER_TIMELINE_BEGIN("Director::visit");
         _runningScene->visit(_renderer, identity, false);
+        CC_PROFILER_TIMELINE_END("Director::visit");
         _eventDispatcher->dispatchEvent(_eventAfterVisit);
     }
 
@@ -309,6 +321,8 @@ void Director::drawScene()
     }
 
     _renderer->render();
+    CC_PROFILER_TIMELINE_COUNTER("GL calls", (long long)_renderer->getDrawnBatches());
+    CC_PROFILER_TIMELINE_COUNTER("GL verts", (long long)_renderer->getDrawnVertices());
     _eventDispatcher->dispatchEvent(_eventAfterDraw);
 
     kmGLPopMatrix();
@@ -318,6 +332,7 @@ void Director::drawScene()
     // swap buffers
     if (_openGLView)
     {
+        CC_PROFILER_TIMELINE_SCOPE("GLView::swapBuffers");
         _openGLView->swapBuffers();
     }
 
@@ -344,6 +359,10 @@ void Director::calculateDeltaTime()
         _deltaTime = 0;
         _nextDeltaTimeZero = false;
     }
+    else if (_fixedDeltaTime > 0)
+    {
+        _deltaTime = _fixedDeltaTime;
+    }
     else
     {
         _deltaTime = (now.tv_sec - _lastUpdate->tv_sec) + (now.tv_usec - _lastUpdate->tv_usec) / 1000000.0f;
@@ -525,6 +544,7 @@ void Director::purgeCachedData(void)
         // Note: some tests such as ActionsTest are leaking refcounted textures
         // There should be no test textures left in the cache
         log("%s\n", _textureCache->getCachedTextureInfo().c_str());
+        log("%s\n", GlyphCache::getInstance()->getCachedGlyphInfo().c_str());
     }
     FileUtils::getInstance()->purgeCachedEntries();
 }
@@ -553,13 +573,13 @@ void Director::setDepthTest(bool on)
     if (on)
     {
         glClearDepth(1.0f);
-        glEnable(GL_DEPTH_TEST);
-        glDepthFunc(GL_LEQUAL);
+        GL::enable(GL_DEPTH_TEST);
+        GL::depthFunc(GL_LEQUAL);
 //        glHint(GL_PERSPECTIVE_CORRECTION_HINT, GL_NICEST);
     }
     else
     {
-        glDisable(GL_DEPTH_TEST);
+        GL::disable(GL_DEPTH_TEST);
     }
     CHECK_GL_ERROR_DEBUG();
 }
@@ -755,6 +775,13 @@ void Director::popToSceneStackLevel(int level)
 void Director::end()
 {
     _purgeDirectorInNextLoop = true;
+
+    // the process may exit before the next loop purges the director
+    auto userDefault = UserDefault::getInstanceIfExists();
+    if (userDefault)
+    {
+        userDefault->flush();
+    }
 }
 
 void Director::purgeDirector()
@@ -788,10 +815,16 @@ void Director::purgeDirector()
     CC_SAFE_RELEASE_NULL(_FPSLabel);
     CC_SAFE_RELEASE_NULL(_drawnBatchesLabel);
     CC_SAFE_RELEASE_NULL(_drawnVerticesLabel);
+    CC_SAFE_RELEASE_NULL(_textureUploadLabel);
+    CC_SAFE_RELEASE_NULL(_glStateLabel);
+    CC_SAFE_RELEASE_NULL(_actionAllocationLabel);
 
     // purge bitmap cache
     FontFNT::purgeCachedData();
 
+    // the worker threads may still be rasterizing glyphs
+    ThreadPool::destroyInstance();
+
     FontFreeType::shutdownFreeType();
 
     // purge all managed caches
@@ -799,6 +832,7 @@ void Director::purgeDirector()
     AnimationCache::destroyInstance();
     SpriteFrameCache::destroyInstance();
     ShaderCache::destroyInstance();
+    GlyphCache::destroyInstance();
     FileUtils::destroyInstance();
     Configuration::destroyInstance();
 
@@ -894,11 +928,27 @@ void Director::showStats()
 {
     static unsigned long prevCalls = 0;
     static unsigned long prevVerts = 0;
+    static unsigned long prevUploadKB = 0;
+    static int prevUploadTime = 0;
+    static unsigned int prevStateChanges = 0;
+    static unsigned int prevRedundantStateChanges = 0;
+    static unsigned int prevActionAllocations = 0;
+    static unsigned int prevActionHeapAllocations = 0;
 
     ++_frames;
     _accumDt += _deltaTime;
+
+    // state changes sent to GL and filtered out by the state cache since the last frame
+    auto currentStateChanges = GL::getStateChangeCount();
+    auto currentRedundantStateChanges = GL::getRedundantStateChangeCount();
+    GL::resetStateChangeCounters();
+
+    // actions created since the last frame, and how many of them were not served by the action pools
+    auto currentActionAllocations = Action::getAllocationCount();
+    auto currentActionHeapAllocations = Action::getHeapAllocationCount();
+    Action::resetAllocationCounters();
     
-    if (_displayStats && _FPSLabel && _drawnBatchesLabel && _drawnVerticesLabel)
+    if (_displayStats && _FPSLabel && _drawnBatchesLabel && _drawnVerticesLabel && _textureUploadLabel && _glStateLabel && _actionAllocationLabel)
     {
         char buffer[30];
 
@@ -926,10 +976,37 @@ void Director::showStats()
             prevVerts = currentVerts;
         }
 
+        // asynchronously loaded textures waiting for the GPU, and the time spent uploading them last frame
+        auto currentUploadKB = (unsigned long)(_textureCache->getAsyncPendingUploadBytes() / 1024);
+        auto currentUploadTime = (int)(_textureCache->getAsyncUploadTime() * 10000);
+        if( currentUploadKB != prevUploadKB || currentUploadTime != prevUploadTime ) {
+            snprintf(buffer, sizeof(buffer), "GL upload:%6luK %.1fms", currentUploadKB, currentUploadTime / 10.0f);
+            _textureUploadLabel->setString(buffer);
+            prevUploadKB = currentUploadKB;
+            prevUploadTime = currentUploadTime;
+        }
+
+        if( currentStateChanges != prevStateChanges || currentRedundantStateChanges != prevRedundantStateChanges ) {
+            snprintf(buffer, sizeof(buffer), "GL state:%6u skip:%6u", currentStateChanges, currentRedundantStateChanges);
+            _glStateLabel->setString(buffer);
+            prevStateChanges = currentStateChanges;
+            prevRedundantStateChanges = currentRedundantStateChanges;
+        }
+
+        if( currentActionAllocations != prevActionAllocations || currentActionHeapAllocations != prevActionHeapAllocations ) {
+            snprintf(buffer, sizeof(buffer), "Actions:%6u heap:%6u", currentActionAllocations, currentActionHeapAllocations);
+            _actionAllocationLabel->setString(buffer);
+            prevActionAllocations = currentActionAllocations;
+            prevActionHeapAllocations = currentActionHeapAllocations;
+        }
+
         // global identity matrix is needed... come on kazmath!
         kmMat4 identity;
         kmMat4Identity(&identity);
 
+        _actionAllocationLabel->visit(_renderer, identity, false);
+        _glStateLabel->visit(_renderer, identity, false);
+        _textureUploadLabel->visit(_renderer, identity, false);
         _drawnVerticesLabel->visit(_renderer, identity, false);
         _drawnBatchesLabel->visit(_renderer, identity, false);
         _FPSLabel->visit(_renderer, identity, false);
@@ -961,6 +1038,9 @@ void Director::createStatsLabel()
         CC_SAFE_RELEASE_NULL(_FPSLabel);
         CC_SAFE_RELEASE_NULL(_drawnBatchesLabel);
         CC_SAFE_RELEASE_NULL(_drawnVerticesLabel);
+        CC_SAFE_RELEASE_NULL(_textureUploadLabel);
+        CC_SAFE_RELEASE_NULL(_glStateLabel);
+        CC_SAFE_RELEASE_NULL(_actionAllocationLabel);
         _textureCache->removeTextureForKey("/cc_fps_images");
         FileUtils::getInstance()->purgeCachedEntries();
     }
@@ -1009,10 +1089,30 @@ void Director::createStatsLabel()
     _drawnVerticesLabel->initWithString("00000", texture, 12, 32, '.');
     _drawnVerticesLabel->setScale(scaleFactor);
 
+    _textureUploadLabel = LabelAtlas::create();
+    _textureUploadLabel->retain();
+    _textureUploadLabel->setIgnoreContentScaleFactor(true);
+    _textureUploadLabel->initWithString("00000", texture, 12, 32, '.');
+    _textureUploadLabel->setScale(scaleFactor);
+
+    _glStateLabel = LabelAtlas::create();
+    _glStateLabel->retain();
+    _glStateLabel->setIgnoreContentScaleFactor(true);
+    _glStateLabel->initWithString("00000", texture, 12, 32, '.');
+    _glStateLabel->setScale(scaleFactor);
+
+    _actionAllocationLabel = LabelAtlas::create();
+    _actionAllocationLabel->retain();
+    _actionAllocationLabel->setIgnoreContentScaleFactor(true);
+    _actionAllocationLabel->initWithString("00000", texture, 12, 32, '.');
+    _actionAllocationLabel->setScale(scaleFactor);
 
     Texture2D::setDefaultAlphaPixelFormat(currentFormat);
 
     const int height_spacing = 22 / CC_CONTENT_SCALE_FACTOR();
+    _actionAllocationLabel->setPosition(Point(0, height_spacing*5) + CC_DIRECTOR_STATS_POSITION);
+    _glStateLabel->setPosition(Point(0, height_spacing*4) + CC_DIRECTOR_STATS_POSITION);
+    _textureUploadLabel->setPosition(Point(0, height_spacing*3) + CC_DIRECTOR_STATS_POSITION);
     _drawnVerticesLabel->setPosition(Point(0, height_spacing*2) + CC_DIRECTOR_STATS_POSITION);
     _drawnBatchesLabel->setPosition(Point(0, height_spacing*1) + CC_DIRECTOR_STATS_POSITION);
     _FPSLabel->setPosition(Point(0, height_spacing*0)+CC_DIRECTOR_STATS_POSITION);
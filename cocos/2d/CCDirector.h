@@ -377,6 +377,12 @@ public:
 
     /* Gets delta time since last tick to main loop */
 	float getDeltaTime() const;
+
+    /** Sets the delta time used by every frame instead of the time measured since the last one, 0 to measure it again.
+     With a fixed delta time the scenes are updated the same way whatever the frame rate, e.g. for benchmarks.
+     */
+    void setFixedDeltaTime(float fixedDeltaTime) { _fixedDeltaTime = fixedDeltaTime; }
+    float getFixedDeltaTime() const { return _fixedDeltaTime; }
     
     /**
      *  get Frame Rate
@@ -439,6 +445,9 @@ protected:
     LabelAtlas *_FPSLabel;
     LabelAtlas *_drawnBatchesLabel;
     LabelAtlas *_drawnVerticesLabel;
+    LabelAtlas *_textureUploadLabel;
+    LabelAtlas *_glStateLabel;
+    LabelAtlas *_actionAllocationLabel;
     
     /** Whether or not the Director is paused */
     bool _paused;
@@ -466,6 +475,9 @@ protected:
 
     /* whether or not the next delta time will be zero */
     bool _nextDeltaTimeZero;
+
+    /* delta time of every frame when greater than 0 */
+    float _fixedDeltaTime;
     
     /* projection used */
     Projection _projection;
@@ -31,8 +31,25 @@ NS_CC_BEGIN
 EventCustom::EventCustom(const std::string& eventName)
 : Event(Type::CUSTOM)
 , _userData(nullptr)
+, _eventKey(EventListener::findListenerID(eventName))
 , _eventName(eventName)
 {
 }
 
+EventCustom::EventCustom(EventListener::ListenerKey eventKey)
+: Event(Type::CUSTOM)
+, _userData(nullptr)
+, _eventKey(eventKey)
+{
+}
+
+const std::string& EventCustom::getEventName() const
+{
+    if (_eventName.empty() && _eventKey != EventListener::INVALID_LISTENER_KEY)
+    {
+        return EventListener::getInternedListenerID(_eventKey);
+    }
+    return _eventName;
+}
+
 NS_CC_END
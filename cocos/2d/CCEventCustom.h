@@ -26,14 +26,18 @@
 #define __cocos2d_libs__CCCustomEvent__
 
 #include "CCEvent.h"
+#include "CCEventListener.h"
 
 NS_CC_BEGIN
 
 class EventCustom : public Event
 {
 public:
-    /** Constructor */
+    /** Constructor, the name isn't interned: an event nobody listens to isn't dispatched to anyone */
     EventCustom(const std::string& eventName);
+
+    /** Constructor with the event name interned by EventListener::internListenerID(), it doesn't hash the name */
+    explicit EventCustom(EventListener::ListenerKey eventKey);
     
     /** Sets user data */
     inline void setUserData(void* data) { _userData = data; };
@@ -42,10 +46,14 @@ public:
     inline void* getUserData() const { return _userData; };
     
     /** Gets event name */
-    inline const std::string& getEventName() const { return _eventName; };
+    const std::string& getEventName() const;
+
+    /** Gets the interned event name */
+    inline EventListener::ListenerKey getEventKey() const { return _eventKey; };
 protected:
     void* _userData;       ///< User data
-    std::string _eventName;
+    EventListener::ListenerKey _eventKey;
+    std::string _eventName;     ///< Empty when the event is built from a key
 };
 
 NS_CC_END
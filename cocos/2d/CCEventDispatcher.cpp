@@ -34,12 +34,17 @@
 #include "CCScene.h"
 #include "CCDirector.h"
 #include "CCEventType.h"
+#include "CCProfiling.h"
+#include "CCSpatialGrid.h"
 
 #include <algorithm>
 
 
 #define DUMP_LISTENER_ITEM_PRIORITY_INFO 0
 
+// size of the cells of the hit-test grid, in points
+#define HIT_TEST_CELL_SIZE 128.0f
+
 namespace
 {
 
@@ -65,25 +70,25 @@ private:
 
 NS_CC_BEGIN
 
-static EventListener::ListenerID __getListenerID(Event* event)
+static EventListener::ListenerKey __getListenerKey(Event* event)
 {
-    EventListener::ListenerID ret;
+    EventListener::ListenerKey ret = EventListener::INVALID_LISTENER_KEY;
     switch (event->getType())
     {
         case Event::Type::ACCELERATION:
-            ret = EventListenerAcceleration::LISTENER_ID;
+            ret = EventListenerAcceleration::LISTENER_KEY;
             break;
         case Event::Type::CUSTOM:
             {
                 auto customEvent = static_cast<EventCustom*>(event);
-                ret = customEvent->getEventName();
+                ret = customEvent->getEventKey();
             }
             break;
         case Event::Type::KEYBOARD:
-            ret = EventListenerKeyboard::LISTENER_ID;
+            ret = EventListenerKeyboard::LISTENER_KEY;
             break;
         case Event::Type::MOUSE:
-            ret = EventListenerMouse::LISTENER_ID;
+            ret = EventListenerMouse::LISTENER_KEY;
             break;
         case Event::Type::TOUCH:
             // Touch listener is very special, it contains two kinds of listeners, EventListenerTouchOneByOne and EventListenerTouchAllAtOnce.
@@ -193,13 +198,15 @@ EventDispatcher::EventDispatcher()
 : _inDispatch(0)
 , _isEnabled(false)
 , _nodePriorityIndex(0)
+, _hitTestGrid(nullptr)
+, _hitTestOrderDirty(true)
 {
     _toAddedListeners.reserve(50);
     
     // fixed #4129: Mark the following listener IDs for internal use.
     // Therefore, internal listeners would not be cleaned when removeAllEventListeners is invoked.
-    _internalCustomListenerIDs.insert(EVENT_COME_TO_FOREGROUND);
-    _internalCustomListenerIDs.insert(EVENT_COME_TO_BACKGROUND);
+    _internalCustomListenerIDs.insert(EventListener::internListenerID(EVENT_COME_TO_FOREGROUND));
+    _internalCustomListenerIDs.insert(EventListener::internListenerID(EVENT_COME_TO_BACKGROUND));
 }
 
 EventDispatcher::~EventDispatcher()
@@ -208,6 +215,7 @@ EventDispatcher::~EventDispatcher()
     // so removeAllEventListeners would clean internal custom listeners.
     _internalCustomListenerIDs.clear();
     removeAllEventListeners();
+    CC_SAFE_DELETE(_hitTestGrid);
 }
 
 void EventDispatcher::visitTarget(Node* node, bool isRootNode)
@@ -387,6 +395,11 @@ void EventDispatcher::associateNodeAndEventListener(Node* node, EventListener* l
     }
     
     listeners->push_back(listener);
+
+    if (listener->getType() == EventListener::Type::TOUCH_ONE_BY_ONE && static_cast<EventListenerTouchOneByOne*>(listener)->_hitTest)
+    {
+        addHitTestNode(node);
+    }
 }
 
 void EventDispatcher::dissociateNodeAndEventListener(Node* node, EventListener* listener)
@@ -400,6 +413,11 @@ void EventDispatcher::dissociateNodeAndEventListener(Node* node, EventListener*
         if (iter != listeners->end())
         {
             listeners->erase(iter);
+
+            if (listener->getType() == EventListener::Type::TOUCH_ONE_BY_ONE && static_cast<EventListenerTouchOneByOne*>(listener)->_hitTest)
+            {
+                removeHitTestNode(node);
+            }
         }
         
         if (listeners->empty())
@@ -427,13 +445,13 @@ void EventDispatcher::addEventListener(EventListener* listener)
 void EventDispatcher::forceAddEventListener(EventListener* listener)
 {
     EventListenerVector* listeners = nullptr;
-    EventListener::ListenerID listenerID = listener->getListenerID();
-    auto itr = _listenerMap.find(listenerID);
+    EventListener::ListenerKey listenerKey = listener->getListenerKey();
+    auto itr = _listenerMap.find(listenerKey);
     if (itr == _listenerMap.end())
     {
         
         listeners = new EventListenerVector();
-        _listenerMap.insert(std::make_pair(listenerID, listeners));
+        _listenerMap.insert(std::make_pair(listenerKey, listeners));
     }
     else
     {
@@ -444,7 +462,7 @@ void EventDispatcher::forceAddEventListener(EventListener* listener)
     
     if (listener->getFixedPriority() == 0)
     {
-        setDirty(listenerID, DirtyFlag::SCENE_GRAPH_PRIORITY);
+        setDirty(listenerKey, DirtyFlag::SCENE_GRAPH_PRIORITY);
         
         auto node = listener->getAssociatedNode();
         CCASSERT(node != nullptr, "Invalid scene graph priority!");
@@ -458,7 +476,7 @@ void EventDispatcher::forceAddEventListener(EventListener* listener)
     }
     else
     {
-        setDirty(listenerID, DirtyFlag::FIXED_PRIORITY);
+        setDirty(listenerKey, DirtyFlag::FIXED_PRIORITY);
     }
 }
 
@@ -610,14 +628,14 @@ void EventDispatcher::removeEventListener(EventListener* listener)
         if (isFound)
         {
             // fixed #4160: Dirty flag need to be updated after listeners were removed.
-            setDirty(listener->getListenerID(), DirtyFlag::SCENE_GRAPH_PRIORITY);
+            setDirty(listener->getListenerKey(), DirtyFlag::SCENE_GRAPH_PRIORITY);
         }
         else
         {
             removeListenerInVector(fixedPriorityListeners);
             if (isFound)
             {
-                setDirty(listener->getListenerID(), DirtyFlag::FIXED_PRIORITY);
+                setDirty(listener->getListenerKey(), DirtyFlag::FIXED_PRIORITY);
             }
         }
         
@@ -635,7 +653,7 @@ void EventDispatcher::removeEventListener(EventListener* listener)
 
         if (iter->second->empty())
         {
-            _priorityDirtyFlagMap.erase(listener->getListenerID());
+            _priorityDirtyFlagMap.erase(listener->getListenerKey());
             auto list = iter->second;
             iter = _listenerMap.erase(iter);
             CC_SAFE_DELETE(list);
@@ -686,7 +704,7 @@ void EventDispatcher::setPriority(EventListener* listener, int fixedPriority)
                 if (listener->getFixedPriority() != fixedPriority)
                 {
                     listener->setFixedPriority(fixedPriority);
-                    setDirty(listener->getListenerID(), DirtyFlag::FIXED_PRIORITY);
+                    setDirty(listener->getListenerKey(), DirtyFlag::FIXED_PRIORITY);
                 }
                 return;
             }
@@ -694,11 +712,12 @@ void EventDispatcher::setPriority(EventListener* listener, int fixedPriority)
     }
 }
 
-void EventDispatcher::dispatchEventToListeners(EventListenerVector* listeners, const std::function<bool(EventListener*)>& onEvent)
+void EventDispatcher::dispatchEventToListeners(EventListenerVector* listeners, const std::function<bool(EventListener*)>& onEvent,
+                                               const std::vector<EventListener*>* sceneGraphListeners/* = nullptr */)
 {
     bool shouldStopPropagation = false;
     auto fixedPriorityListeners = listeners->getFixedPriorityListeners();
-    auto sceneGraphPriorityListeners = listeners->getSceneGraphPriorityListeners();
+    auto sceneGraphPriorityListeners = sceneGraphListeners ? sceneGraphListeners : listeners->getSceneGraphPriorityListeners();
     
     ssize_t i = 0;
     // priority < 0
@@ -761,6 +780,8 @@ void EventDispatcher::dispatchEvent(Event* event)
     if (!_isEnabled)
         return;
     
+    CC_PROFILER_TIMELINE_SCOPE("EventDispatcher::dispatchEvent");
+
     updateDirtyFlagForSceneGraph();
     
     
@@ -772,11 +793,11 @@ void EventDispatcher::dispatchEvent(Event* event)
         return;
     }
     
-    auto listenerID = __getListenerID(event);
+    auto listenerKey = __getListenerKey(event);
     
-    sortEventListeners(listenerID);
+    sortEventListeners(listenerKey);
     
-    auto iter = _listenerMap.find(listenerID);
+    auto iter = _listenerMap.find(listenerKey);
     if (iter != _listenerMap.end())
     {
         auto listeners = iter->second;
@@ -800,14 +821,21 @@ void EventDispatcher::dispatchCustomEvent(const std::string &eventName, void *op
     dispatchEvent(&ev);
 }
 
+void EventDispatcher::dispatchCustomEvent(EventListener::ListenerKey eventKey, void *optionalUserData)
+{
+    EventCustom ev(eventKey);
+    ev.setUserData(optionalUserData);
+    dispatchEvent(&ev);
+}
+
 
 void EventDispatcher::dispatchTouchEvent(EventTouch* event)
 {
-    sortEventListeners(EventListenerTouchOneByOne::LISTENER_ID);
-    sortEventListeners(EventListenerTouchAllAtOnce::LISTENER_ID);
+    sortEventListeners(EventListenerTouchOneByOne::LISTENER_KEY);
+    sortEventListeners(EventListenerTouchAllAtOnce::LISTENER_KEY);
     
-    auto oneByOneListeners = getListeners(EventListenerTouchOneByOne::LISTENER_ID);
-    auto allAtOnceListeners = getListeners(EventListenerTouchAllAtOnce::LISTENER_ID);
+    auto oneByOneListeners = getListeners(EventListenerTouchOneByOne::LISTENER_KEY);
+    auto allAtOnceListeners = getListeners(EventListenerTouchAllAtOnce::LISTENER_KEY);
     
     // If there aren't any touch listeners, return directly.
     if (nullptr == oneByOneListeners && nullptr == allAtOnceListeners)
@@ -826,6 +854,14 @@ void EventDispatcher::dispatchTouchEvent(EventTouch* event)
     {
         auto mutableTouchesIter = mutableTouches.begin();
         auto touchesIter = originalTouches.begin();
+
+        // new touches only go to the hit tested listeners under them
+        bool hitTest = !_hitTestNodes.empty() && event->getEventCode() == EventTouch::EventCode::BEGAN;
+        if (hitTest && _hitTestOrderDirty)
+        {
+            updateHitTestOrder(oneByOneListeners);
+        }
+        std::vector<EventListener*> hitTestListeners;
         
         for (; touchesIter != originalTouches.end(); ++touchesIter)
         {
@@ -917,8 +953,13 @@ void EventDispatcher::dispatchTouchEvent(EventTouch* event)
                 return false;
             };
             
-            //
-            dispatchEventToListeners(oneByOneListeners, onTouchEvent);
+            if (hitTest)
+            {
+                hitTestListeners.clear();
+                getHitTestListeners((*touchesIter)->getLocation(), hitTestListeners);
+            }
+
+            dispatchEventToListeners(oneByOneListeners, onTouchEvent, hitTest ? &hitTestListeners : nullptr);
             if (event->isStopped())
             {
                 return;
@@ -998,9 +1039,9 @@ void EventDispatcher::updateListeners(Event* event)
 {
     CCASSERT(_inDispatch > 0, "If program goes here, there should be event in dispatch.");
     
-    auto onUpdateListeners = [this](const EventListener::ListenerID& listenerID)
+    auto onUpdateListeners = [this](EventListener::ListenerKey listenerKey)
     {
-        auto listenersIter = _listenerMap.find(listenerID);
+        auto listenersIter = _listenerMap.find(listenerKey);
         if (listenersIter == _listenerMap.end())
             return;
 
@@ -1018,6 +1059,7 @@ void EventDispatcher::updateListeners(Event* event)
                 {
                     iter = sceneGraphPriorityListeners->erase(iter);
                     l->release();
+                    _hitTestOrderDirty = true;
                 }
                 else
                 {
@@ -1057,12 +1099,12 @@ void EventDispatcher::updateListeners(Event* event)
     
     if (event->getType() == Event::Type::TOUCH)
     {
-        onUpdateListeners(EventListenerTouchOneByOne::LISTENER_ID);
-        onUpdateListeners(EventListenerTouchAllAtOnce::LISTENER_ID);
+        onUpdateListeners(EventListenerTouchOneByOne::LISTENER_KEY);
+        onUpdateListeners(EventListenerTouchAllAtOnce::LISTENER_KEY);
     }
     else
     {
-        onUpdateListeners(__getListenerID(event));
+        onUpdateListeners(__getListenerKey(event));
     }
     
     if (_inDispatch > 1)
@@ -1105,7 +1147,7 @@ void EventDispatcher::updateDirtyFlagForSceneGraph()
             {
                 for (auto& l : *iter->second)
                 {
-                    setDirty(l->getListenerID(), DirtyFlag::SCENE_GRAPH_PRIORITY);
+                    setDirty(l->getListenerKey(), DirtyFlag::SCENE_GRAPH_PRIORITY);
                 }
             }
         }
@@ -1114,11 +1156,11 @@ void EventDispatcher::updateDirtyFlagForSceneGraph()
     }
 }
 
-void EventDispatcher::sortEventListeners(const EventListener::ListenerID& listenerID)
+void EventDispatcher::sortEventListeners(EventListener::ListenerKey listenerKey)
 {
     DirtyFlag dirtyFlag = DirtyFlag::NONE;
     
-    auto dirtyIter = _priorityDirtyFlagMap.find(listenerID);
+    auto dirtyIter = _priorityDirtyFlagMap.find(listenerKey);
     if (dirtyIter != _priorityDirtyFlagMap.end())
     {
         dirtyFlag = dirtyIter->second;
@@ -1131,7 +1173,7 @@ void EventDispatcher::sortEventListeners(const EventListener::ListenerID& listen
 
         if ((int)dirtyFlag & (int)DirtyFlag::FIXED_PRIORITY)
         {
-            sortEventListenersOfFixedPriority(listenerID);
+            sortEventListenersOfFixedPriority(listenerKey);
         }
         
         if ((int)dirtyFlag & (int)DirtyFlag::SCENE_GRAPH_PRIORITY)
@@ -1139,7 +1181,7 @@ void EventDispatcher::sortEventListeners(const EventListener::ListenerID& listen
             auto rootNode = Director::getInstance()->getRunningScene();
             if (rootNode)
             {
-                sortEventListenersOfSceneGraphPriority(listenerID, rootNode);
+                sortEventListenersOfSceneGraphPriority(listenerKey, rootNode);
             }
             else
             {
@@ -1149,9 +1191,9 @@ void EventDispatcher::sortEventListeners(const EventListener::ListenerID& listen
     }
 }
 
-void EventDispatcher::sortEventListenersOfSceneGraphPriority(const EventListener::ListenerID& listenerID, Node* rootNode)
+void EventDispatcher::sortEventListenersOfSceneGraphPriority(EventListener::ListenerKey listenerKey, Node* rootNode)
 {
-    auto listeners = getListeners(listenerID);
+    auto listeners = getListeners(listenerKey);
     
     if (listeners == nullptr)
         return;
@@ -1180,9 +1222,9 @@ void EventDispatcher::sortEventListenersOfSceneGraphPriority(const EventListener
 #endif
 }
 
-void EventDispatcher::sortEventListenersOfFixedPriority(const EventListener::ListenerID& listenerID)
+void EventDispatcher::sortEventListenersOfFixedPriority(EventListener::ListenerKey listenerKey)
 {
-    auto listeners = getListeners(listenerID);
+    auto listeners = getListeners(listenerKey);
 
     if (listeners == nullptr)
         return;
@@ -1217,9 +1259,9 @@ void EventDispatcher::sortEventListenersOfFixedPriority(const EventListener::Lis
     
 }
 
-EventDispatcher::EventListenerVector* EventDispatcher::getListeners(const EventListener::ListenerID& listenerID)
+EventDispatcher::EventListenerVector* EventDispatcher::getListeners(EventListener::ListenerKey listenerKey)
 {
-    auto iter = _listenerMap.find(listenerID);
+    auto iter = _listenerMap.find(listenerKey);
     if (iter != _listenerMap.end())
     {
         return iter->second;
@@ -1228,9 +1270,9 @@ EventDispatcher::EventListenerVector* EventDispatcher::getListeners(const EventL
     return nullptr;
 }
 
-void EventDispatcher::removeEventListenersForListenerID(const EventListener::ListenerID& listenerID)
+void EventDispatcher::removeEventListenersForListenerID(EventListener::ListenerKey listenerKey)
 {
-    auto listenerItemIter = _listenerMap.find(listenerID);
+    auto listenerItemIter = _listenerMap.find(listenerKey);
     if (listenerItemIter != _listenerMap.end())
     {
         auto listeners = listenerItemIter->second;
@@ -1268,7 +1310,8 @@ void EventDispatcher::removeEventListenersForListenerID(const EventListener::Lis
         
         // Remove the dirty flag according the 'listenerID'.
         // No need to check whether the dispatcher is dispatching event.
-        _priorityDirtyFlagMap.erase(listenerID);
+        _priorityDirtyFlagMap.erase(listenerKey);
+        _hitTestOrderDirty = true;
         
         if (!_inDispatch)
         {
@@ -1280,7 +1323,7 @@ void EventDispatcher::removeEventListenersForListenerID(const EventListener::Lis
     
     for (auto iter = _toAddedListeners.begin(); iter != _toAddedListeners.end();)
     {
-        if ((*iter)->getListenerID() == listenerID)
+        if ((*iter)->getListenerKey() == listenerKey)
         {
             (*iter)->setRegistered(false);
             (*iter)->release();
@@ -1297,23 +1340,23 @@ void EventDispatcher::removeEventListenersForType(EventListener::Type listenerTy
 {
     if (listenerType == EventListener::Type::TOUCH_ONE_BY_ONE)
     {
-        removeEventListenersForListenerID(EventListenerTouchOneByOne::LISTENER_ID);
+        removeEventListenersForListenerID(EventListenerTouchOneByOne::LISTENER_KEY);
     }
     else if (listenerType == EventListener::Type::TOUCH_ALL_AT_ONCE)
     {
-        removeEventListenersForListenerID(EventListenerTouchAllAtOnce::LISTENER_ID);
+        removeEventListenersForListenerID(EventListenerTouchAllAtOnce::LISTENER_KEY);
     }
     else if (listenerType == EventListener::Type::MOUSE)
     {
-        removeEventListenersForListenerID(EventListenerMouse::LISTENER_ID);
+        removeEventListenersForListenerID(EventListenerMouse::LISTENER_KEY);
     }
     else if (listenerType == EventListener::Type::ACCELERATION)
     {
-        removeEventListenersForListenerID(EventListenerAcceleration::LISTENER_ID);
+        removeEventListenersForListenerID(EventListenerAcceleration::LISTENER_KEY);
     }
     else if (listenerType == EventListener::Type::KEYBOARD)
     {
-        removeEventListenersForListenerID(EventListenerKeyboard::LISTENER_ID);
+        removeEventListenersForListenerID(EventListenerKeyboard::LISTENER_KEY);
     }
     else
     {
@@ -1323,13 +1366,18 @@ void EventDispatcher::removeEventListenersForType(EventListener::Type listenerTy
 
 void EventDispatcher::removeCustomEventListeners(const std::string& customEventName)
 {
-    removeEventListenersForListenerID(customEventName);
+    auto key = EventListener::findListenerID(customEventName);
+    if (key != EventListener::INVALID_LISTENER_KEY)
+    {
+        removeEventListenersForListenerID(key);
+    }
 }
 
 void EventDispatcher::removeAllEventListeners()
 {
     bool cleanMap = true;
-    std::vector<EventListener::ListenerID> types(_listenerMap.size());
+    std::vector<EventListener::ListenerKey> types;
+    types.reserve(_listenerMap.size());
     
     for (const auto& e : _listenerMap)
     {
@@ -1380,12 +1428,17 @@ void EventDispatcher::setDirtyForNode(Node* node)
     }
 }
 
-void EventDispatcher::setDirty(const EventListener::ListenerID& listenerID, DirtyFlag flag)
+void EventDispatcher::setDirty(EventListener::ListenerKey listenerKey, DirtyFlag flag)
 {    
-    auto iter = _priorityDirtyFlagMap.find(listenerID);
+    if (listenerKey == EventListenerTouchOneByOne::LISTENER_KEY)
+    {
+        _hitTestOrderDirty = true;
+    }
+
+    auto iter = _priorityDirtyFlagMap.find(listenerKey);
     if (iter == _priorityDirtyFlagMap.end())
     {
-        _priorityDirtyFlagMap.insert(std::make_pair(listenerID, flag));
+        _priorityDirtyFlagMap.insert(std::make_pair(listenerKey, flag));
     }
     else
     {
@@ -1394,4 +1447,128 @@ void EventDispatcher::setDirty(const EventListener::ListenerID& listenerID, Dirt
     }
 }
 
+void EventDispatcher::setHitTestBoundsDirty(Node* node)
+{
+    std::lock_guard<std::mutex> lock(_hitTestMutex);
+
+    auto iter = _hitTestNodes.find(node);
+    if (iter != _hitTestNodes.end())
+    {
+        _hitTestGrid->markDirty(iter->second.entry);
+    }
+}
+
+void EventDispatcher::addHitTestNode(Node* node)
+{
+    std::lock_guard<std::mutex> lock(_hitTestMutex);
+
+    _hitTestOrderDirty = true;
+
+    auto iter = _hitTestNodes.find(node);
+    if (iter != _hitTestNodes.end())
+    {
+        ++iter->second.listenerCount;
+        return;
+    }
+
+    if (_hitTestGrid == nullptr)
+    {
+        _hitTestGrid = new SpatialGrid(HIT_TEST_CELL_SIZE, true);
+    }
+
+    HitTestNode hitTestNode;
+    hitTestNode.entry = _hitTestGrid->insert(node);
+    hitTestNode.listenerCount = 1;
+    hitTestNode.order = -1;
+    _hitTestNodes.insert(std::make_pair(node, hitTestNode));
+    node->_hitTestIndexed = true;
+    _hitTestOrderDirty = true;
+}
+
+void EventDispatcher::removeHitTestNode(Node* node)
+{
+    std::lock_guard<std::mutex> lock(_hitTestMutex);
+
+    auto iter = _hitTestNodes.find(node);
+    CCASSERT(iter != _hitTestNodes.end(), "The node isn't in the hit-test index");
+
+    // the listeners of the node are copied again before the next touch begins
+    _hitTestOrderDirty = true;
+    if (iter == _hitTestNodes.end() || --iter->second.listenerCount > 0)
+        return;
+
+    _hitTestGrid->remove(iter->second.entry);
+    _hitTestNodes.erase(iter);
+    node->_hitTestIndexed = false;
+}
+
+void EventDispatcher::updateHitTestOrder(EventListenerVector* listeners)
+{
+    _listenersWithoutHitTest.clear();
+    for (auto& iter : _hitTestNodes)
+    {
+        iter.second.order = -1;
+        iter.second.listeners.clear();
+    }
+
+    auto sceneGraphPriorityListeners = listeners->getSceneGraphPriorityListeners();
+    if (sceneGraphPriorityListeners)
+    {
+        int order = 0;
+        for (auto& l : *sceneGraphPriorityListeners)
+        {
+            auto listener = static_cast<EventListenerTouchOneByOne*>(l);
+            if (!listener->_hitTest)
+            {
+                _listenersWithoutHitTest.push_back(std::make_pair(order, l));
+            }
+            else if (listener->getAssociatedNode() != nullptr)
+            {
+                // the listeners of a node have the same priority, the first one gives the order of the node
+                auto iter = _hitTestNodes.find(listener->getAssociatedNode());
+                if (iter != _hitTestNodes.end())
+                {
+                    if (iter->second.order < 0)
+                    {
+                        iter->second.order = order;
+                        _hitTestGrid->setOrder(iter->second.entry, order);
+                    }
+                    iter->second.listeners.push_back(l);
+                }
+            }
+            ++order;
+        }
+    }
+
+    _hitTestOrderDirty = false;
+}
+
+void EventDispatcher::getHitTestListeners(const Point& location, std::vector<EventListener*>& result)
+{
+    _hitTestCandidates.clear();
+    _hitTestGrid->query(Rect(location.x, location.y, 0, 0), _hitTestCandidates);
+
+    // merges the listeners of the nodes under the touch with the ones without hit testing
+    auto withoutHitTest = _listenersWithoutHitTest.begin();
+    for (auto node : _hitTestCandidates)
+    {
+        const HitTestNode& hitTestNode = _hitTestNodes[node];
+        if (hitTestNode.order < 0)
+            continue;
+
+        while (withoutHitTest != _listenersWithoutHitTest.end() && withoutHitTest->first < hitTestNode.order)
+        {
+            result.push_back(withoutHitTest->second);
+            ++withoutHitTest;
+        }
+
+        result.insert(result.end(), hitTestNode.listeners.begin(), hitTestNode.listeners.end());
+    }
+
+    for (; withoutHitTest != _listenersWithoutHitTest.end(); ++withoutHitTest)
+    {
+        result.push_back(withoutHitTest->second);
+    }
+}
+
 NS_CC_END
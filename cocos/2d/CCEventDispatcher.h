@@ -29,11 +29,13 @@
 #include "CCEventListener.h"
 #include "CCEvent.h"
 #include "CCStdC.h"
+#include "CCGeometry.h"
 
 #include <functional>
 #include <string>
 #include <unordered_map>
 #include <list>
+#include <mutex>
 #include <vector>
 
 NS_CC_BEGIN
@@ -43,6 +45,7 @@ class EventTouch;
 class Node;
 class EventCustom;
 class EventListenerCustom;
+class SpatialGrid;
 
 /**
 This class manages event listener subscriptions
@@ -133,6 +136,12 @@ public:
     /** Dispatches a Custom Event with a event name an optional user data */
     void dispatchCustomEvent(const std::string &eventName, void *optionalUserData = nullptr);
 
+    /** Dispatches a Custom Event with an event name interned by EventListener::internListenerID() and an optional user data.
+     Unlike the other version, it doesn't hash the event name.
+     @since v3.0
+     */
+    void dispatchCustomEvent(EventListener::ListenerKey eventKey, void *optionalUserData = nullptr);
+
     /////////////////////////////////////////////
     
     /** Constructor of EventDispatcher */
@@ -155,6 +164,11 @@ protected:
     
     /** Sets the dirty flag for a node. */
     void setDirtyForNode(Node* node);
+
+    /** The world bounds of a node with hit tested touch listeners changed.
+     It can be called from the threads of a parallel visit.
+     */
+    void setHitTestBoundsDirty(Node* node);
     
     /**
      *  The vector to store event listeners with scene graph based priority and fixed priority.
@@ -195,22 +209,22 @@ protected:
     void forceAddEventListener(EventListener* listener);
     
     /** Gets event the listener list for the event listener type. */
-    EventListenerVector* getListeners(const EventListener::ListenerID& listenerID);
+    EventListenerVector* getListeners(EventListener::ListenerKey listenerKey);
     
     /** Update dirty flag */
     void updateDirtyFlagForSceneGraph();
     
     /** Removes all listeners with the same event listener ID */
-    void removeEventListenersForListenerID(const EventListener::ListenerID& listenerID);
+    void removeEventListenersForListenerID(EventListener::ListenerKey listenerKey);
     
     /** Sort event listener */
-    void sortEventListeners(const EventListener::ListenerID& listenerID);
+    void sortEventListeners(EventListener::ListenerKey listenerKey);
     
     /** Sorts the listeners of specified type by scene graph priority */
-    void sortEventListenersOfSceneGraphPriority(const EventListener::ListenerID& listenerID, Node* rootNode);
+    void sortEventListenersOfSceneGraphPriority(EventListener::ListenerKey listenerKey, Node* rootNode);
     
     /** Sorts the listeners of specified type by fixed priority */
-    void sortEventListenersOfFixedPriority(const EventListener::ListenerID& listenerID);
+    void sortEventListenersOfFixedPriority(EventListener::ListenerKey listenerKey);
     
     /** Updates all listeners
      *  1) Removes all listener items that have been marked as 'removed' when dispatching event.
@@ -227,8 +241,25 @@ protected:
     /** Dissociates node with event listener */
     void dissociateNodeAndEventListener(Node* node, EventListener* listener);
     
-    /** Dispatches event to listeners with a specified listener type */
-    void dispatchEventToListeners(EventListenerVector* listeners, const std::function<bool(EventListener*)>& onEvent);
+    /** Dispatches event to listeners with a specified listener type
+     *  @param sceneGraphListeners If not nullptr, replaces the scene graph priority listeners of `listeners`.
+     */
+    void dispatchEventToListeners(EventListenerVector* listeners, const std::function<bool(EventListener*)>& onEvent,
+                                  const std::vector<EventListener*>* sceneGraphListeners = nullptr);
+
+    /** Adds the node of a hit tested touch listener to the hit-test index */
+    void addHitTestNode(Node* node);
+
+    /** Removes the node of a hit tested touch listener from the hit-test index */
+    void removeHitTestNode(Node* node);
+
+    /** Copies the dispatch order of the scene graph priority touch listeners to the hit-test index */
+    void updateHitTestOrder(EventListenerVector* listeners);
+
+    /** Gets the scene graph priority touch listeners a touch beginning at `location` is dispatched to, in dispatch order:
+     *  the hit tested ones whose node contains the location and all the other ones.
+     */
+    void getHitTestListeners(const Point& location, std::vector<EventListener*>& result);
     
     /// Priority dirty flag
     enum class DirtyFlag
@@ -240,16 +271,16 @@ protected:
     };
     
     /** Sets the dirty flag for a specified listener ID */
-    void setDirty(const EventListener::ListenerID& listenerID, DirtyFlag flag);
+    void setDirty(EventListener::ListenerKey listenerKey, DirtyFlag flag);
     
     /** Walks though scene graph to get the draw order for each node, it's called before sorting event listener with scene graph priority */
     void visitTarget(Node* node, bool isRootNode);
     
     /** Listeners map */
-    std::unordered_map<EventListener::ListenerID, EventListenerVector*> _listenerMap;
+    std::unordered_map<EventListener::ListenerKey, EventListenerVector*> _listenerMap;
     
     /** The map of dirty flag */
-    std::unordered_map<EventListener::ListenerID, DirtyFlag> _priorityDirtyFlagMap;
+    std::unordered_map<EventListener::ListenerKey, DirtyFlag> _priorityDirtyFlagMap;
     
     /** The map of node and event listeners */
     std::unordered_map<Node*, std::vector<EventListener*>*> _nodeListenersMap;
@@ -274,7 +305,32 @@ protected:
     
     int _nodePriorityIndex;
     
-    std::set<std::string> _internalCustomListenerIDs;
+    std::set<EventListener::ListenerKey> _internalCustomListenerIDs;
+
+    struct HitTestNode
+    {
+        int entry;          // entry of the node in the hit-test grid
+        int listenerCount;  // hit tested touch listeners of the node
+        int order;          // dispatch order of its first listener
+        std::vector<EventListener*> listeners;  // its hit tested touch listeners, in dispatch order
+    };
+
+    /** World bounds of the nodes of the hit tested touch listeners, nullptr until there are some */
+    SpatialGrid* _hitTestGrid;
+
+    std::unordered_map<Node*, HitTestNode> _hitTestNodes;
+
+    /** The scene graph priority touch listeners without hit testing, with their dispatch order */
+    std::vector<std::pair<int, EventListener*>> _listenersWithoutHitTest;
+
+    /** The nodes under a touch, reused by getHitTestListeners() */
+    std::vector<Node*> _hitTestCandidates;
+
+    /** Whether the dispatch order must be copied to the hit-test index again */
+    bool _hitTestOrderDirty;
+
+    /** Guards the hit-test index while the nodes are visited in parallel */
+    std::mutex _hitTestMutex;
 };
 
 
@@ -24,9 +24,72 @@
 
 #include "CCEventListener.h"
 #include "platform/CCCommon.h"
+#include "ccMacros.h"
+
+#include <deque>
+#include <mutex>
+#include <unordered_map>
 
 NS_CC_BEGIN
 
+namespace {
+
+struct ListenerIDTable
+{
+    std::mutex mutex;
+    std::unordered_map<EventListener::ListenerID, EventListener::ListenerKey> keys;
+    // a deque doesn't move its elements when it grows, getInternedListenerID() returns references to them
+    std::deque<EventListener::ListenerID> listenerIDs;
+};
+
+// never deleted: listeners can be released after the other statics are destroyed
+ListenerIDTable& getListenerIDTable()
+{
+    static ListenerIDTable* table = new ListenerIDTable();
+    return *table;
+}
+
+} // namespace
+
+EventListener::ListenerKey EventListener::internListenerID(const ListenerID& listenerID)
+{
+    auto& table = getListenerIDTable();
+    std::lock_guard<std::mutex> lock(table.mutex);
+
+    auto iter = table.keys.find(listenerID);
+    if (iter != table.keys.end())
+    {
+        return iter->second;
+    }
+
+    ListenerKey key = (ListenerKey)table.listenerIDs.size();
+    table.listenerIDs.push_back(listenerID);
+    table.keys.insert(std::make_pair(listenerID, key));
+    return key;
+}
+
+EventListener::ListenerKey EventListener::findListenerID(const ListenerID& listenerID)
+{
+    auto& table = getListenerIDTable();
+    std::lock_guard<std::mutex> lock(table.mutex);
+
+    auto iter = table.keys.find(listenerID);
+    if (iter == table.keys.end())
+    {
+        return INVALID_LISTENER_KEY;
+    }
+    return iter->second;
+}
+
+const EventListener::ListenerID& EventListener::getInternedListenerID(ListenerKey key)
+{
+    auto& table = getListenerIDTable();
+    std::lock_guard<std::mutex> lock(table.mutex);
+
+    CCASSERT(key >= 0 && key < (ListenerKey)table.listenerIDs.size(), "Invalid listener key");
+    return table.listenerIDs[key];
+}
+
 EventListener::EventListener()
 {}
     
@@ -40,6 +103,7 @@ bool EventListener::init(Type t, const ListenerID& listenerID, const std::functi
     _onEvent = callback;
     _type = t;
     _listenerID = listenerID;
+    _listenerKey = internListenerID(listenerID);
     _isRegistered = false;
     _paused = true;
     _isEnabled = true;
@@ -58,6 +58,28 @@ public:
     };
 
     typedef std::string ListenerID;
+    /** The integer a ListenerID is interned as, see internListenerID() */
+    typedef int ListenerKey;
+    /** The key of a listener ID that was never interned: no listener has it */
+    static const ListenerKey INVALID_LISTENER_KEY = -1;
+
+    /** Interns a listener ID: returns the same key for the same ID during the whole life of the program.
+     The event dispatcher stores the listeners by key, so that the events are dispatched without hashing nor copying strings.
+     It is thread safe.
+     @since v3.0
+     */
+    static ListenerKey internListenerID(const ListenerID& listenerID);
+
+    /** Returns the key of an interned listener ID, or INVALID_LISTENER_KEY. Unlike internListenerID() it never grows the table.
+     It is thread safe.
+     @since v3.0
+     */
+    static ListenerKey findListenerID(const ListenerID& listenerID);
+
+    /** Returns the listener ID interned as the key. The reference stays valid until the program ends.
+     @since v3.0
+     */
+    static const ListenerID& getInternedListenerID(ListenerKey key);
 
 protected:
     /** Constructor */
@@ -117,6 +139,9 @@ protected:
      */
     inline const ListenerID& getListenerID() const { return _listenerID; };
 
+    /** Gets the interned listener ID of this listener */
+    inline ListenerKey getListenerKey() const { return _listenerKey; };
+
     /** Sets the fixed priority for this listener
      *  @note This method is only used for `fixed priority listeners`, it needs to access a non-zero value.
      *  0 is reserved for scene graph priority listeners
@@ -143,6 +168,7 @@ protected:
 
     Type _type;                             /// Event listener type
     ListenerID _listenerID;                 /// Event listener ID
+    ListenerKey _listenerKey;               /// Interned event listener ID
     bool _isRegistered;                     /// Whether the listener has been added to dispatcher.
 
     int   _fixedPriority;   // The higher the number, the higher the priority, 0 is for scene graph base priority.
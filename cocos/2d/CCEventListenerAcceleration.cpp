@@ -28,6 +28,7 @@
 NS_CC_BEGIN
 
 const std::string EventListenerAcceleration::LISTENER_ID = "__cc_acceleration";
+const EventListener::ListenerKey EventListenerAcceleration::LISTENER_KEY = EventListener::internListenerID(LISTENER_ID);
 
 EventListenerAcceleration::EventListenerAcceleration()
 {
@@ -34,6 +34,7 @@ class EventListenerAcceleration : public EventListener
 {
 public:
     static const std::string LISTENER_ID;
+    static const ListenerKey LISTENER_KEY;
     
     static EventListenerAcceleration* create(const std::function<void(Acceleration*, Event*)>& callback);
     virtual ~EventListenerAcceleration();
@@ -30,6 +30,7 @@
 NS_CC_BEGIN
 
 const std::string EventListenerKeyboard::LISTENER_ID = "__cc_keyboard";
+const EventListener::ListenerKey EventListenerKeyboard::LISTENER_KEY = EventListener::internListenerID(LISTENER_ID);
 
 bool EventListenerKeyboard::checkAvailable()
 {
@@ -37,6 +37,7 @@ class EventListenerKeyboard : public EventListener
 {
 public:
     static const std::string LISTENER_ID;
+    static const ListenerKey LISTENER_KEY;
     
     static EventListenerKeyboard* create();
     
@@ -28,6 +28,7 @@
 NS_CC_BEGIN
 
 const std::string EventListenerMouse::LISTENER_ID = "__cc_mouse";
+const EventListener::ListenerKey EventListenerMouse::LISTENER_KEY = EventListener::internListenerID(LISTENER_ID);
 
 bool EventListenerMouse::checkAvailable()
 {
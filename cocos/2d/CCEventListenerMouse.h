@@ -37,6 +37,7 @@ class EventListenerMouse : public EventListener
 {
 public:
     static const std::string LISTENER_ID;
+    static const ListenerKey LISTENER_KEY;
     
     static EventListenerMouse* create();
 
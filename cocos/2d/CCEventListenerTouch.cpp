@@ -31,6 +31,7 @@
 NS_CC_BEGIN
 
 const std::string EventListenerTouchOneByOne::LISTENER_ID = "__cc_touch_one_by_one";
+const EventListener::ListenerKey EventListenerTouchOneByOne::LISTENER_KEY = EventListener::internListenerID(LISTENER_ID);
 
 EventListenerTouchOneByOne::EventListenerTouchOneByOne()
 : onTouchBegan(nullptr)
@@ -38,6 +39,7 @@ EventListenerTouchOneByOne::EventListenerTouchOneByOne()
 , onTouchEnded(nullptr)
 , onTouchCancelled(nullptr)
 , _needSwallow(false)
+, _hitTest(false)
 {
 }
 
@@ -66,6 +68,17 @@ bool EventListenerTouchOneByOne::isSwallowTouches()
     return _needSwallow;
 }
 
+void EventListenerTouchOneByOne::setHitTestEnabled(bool enabled)
+{
+    CCASSERT(!_isRegistered, "Hit testing must be set before the listener is added");
+    _hitTest = enabled;
+}
+
+bool EventListenerTouchOneByOne::isHitTestEnabled() const
+{
+    return _hitTest;
+}
+
 EventListenerTouchOneByOne* EventListenerTouchOneByOne::create()
 {
     auto ret = new EventListenerTouchOneByOne();
@@ -107,6 +120,7 @@ EventListenerTouchOneByOne* EventListenerTouchOneByOne::clone()
         
         ret->_claimedTouches = _claimedTouches;
         ret->_needSwallow = _needSwallow;
+        ret->_hitTest = _hitTest;
     }
     else
     {
@@ -118,6 +132,7 @@ EventListenerTouchOneByOne* EventListenerTouchOneByOne::clone()
 /////////
 
 const std::string EventListenerTouchAllAtOnce::LISTENER_ID = "__cc_touch_all_at_once";
+const EventListener::ListenerKey EventListenerTouchAllAtOnce::LISTENER_KEY = EventListener::internListenerID(LISTENER_ID);
 
 EventListenerTouchAllAtOnce::EventListenerTouchAllAtOnce()
 : onTouchesBegan(nullptr)
@@ -37,6 +37,7 @@ class EventListenerTouchOneByOne : public EventListener
 {
 public:
     static const std::string LISTENER_ID;
+    static const ListenerKey LISTENER_KEY;
     
     static EventListenerTouchOneByOne* create();
     
@@ -44,6 +45,15 @@ public:
     
     void setSwallowTouches(bool needSwallow);
     bool isSwallowTouches();
+
+    /** Only the touches that begin inside the bounding box of the node of the listener, in world space, are sent to onTouchBegan.
+     The event dispatcher then looks up the listeners under a new touch in a spatial index instead of calling all of them.
+     The bounds are refreshed when the node or one of its parents is moved and drawn.
+     Only used by listeners with scene graph priority, it must be set before the listener is added to the dispatcher.
+     @since v3.0
+     */
+    void setHitTestEnabled(bool enabled);
+    bool isHitTestEnabled() const;
     
     /// Overrides
     virtual EventListenerTouchOneByOne* clone() override;
@@ -62,6 +72,7 @@ private:
     
     std::vector<Touch*> _claimedTouches;
     bool _needSwallow;
+    bool _hitTest;
     
     friend class EventDispatcher;
 };
@@ -71,6 +82,7 @@ class EventListenerTouchAllAtOnce : public EventListener
 {
 public:
     static const std::string LISTENER_ID;
+    static const ListenerKey LISTENER_KEY;
     
     static EventListenerTouchAllAtOnce* create();
     virtual ~EventListenerTouchAllAtOnce();
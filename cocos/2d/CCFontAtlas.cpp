@@ -25,21 +25,72 @@
 
 #include "CCFontAtlas.h"
 #include "CCFontFreeType.h"
+#include "CCGlyphCache.h"
 #include "ccUTF8.h"
 #include "CCDirector.h"
 #include "CCEventListenerCustom.h"
 #include "CCEventDispatcher.h"
 #include "CCEventType.h"
+#include "CCScheduler.h"
+#include "CCThreadPool.h"
+
+#include <condition_variable>
+#include <deque>
+#include <limits>
+#include <mutex>
 
 NS_CC_BEGIN
 
 const int FontAtlas::CacheTextureWidth = 1024;
 const int FontAtlas::CacheTextureHeight = 1024;
 const char* FontAtlas::EVENT_PURGE_TEXTURES = "__cc_FontAtlasPurgeTextures";
+const char* FontAtlas::EVENT_GLYPHS_READY = "__cc_FontAtlasGlyphsReady";
+
+// pixels of the background glyphs copied into the pages per frame
+static const ssize_t ASYNC_GLYPH_BYTES_PER_FRAME = 64 * 1024;
+
+static bool s_asyncGlyphLoadingEnabled = false;
+
+struct FontAtlas::RenderedGlyph
+{
+    unsigned short letter;
+    bool hasBitmap;
+    Rect rect;
+    int xAdvance;
+    // size of the bitmap, with the distance field spread
+    int width;
+    int height;
+    std::vector<unsigned char> pixels;
+};
+
+// shared with the tasks of ThreadPool, which may outlive the atlas
+struct FontAtlas::AsyncGlyphs
+{
+    AsyncGlyphs()
+    : font(nullptr)
+    , cancelled(false)
+    , scheduled(false)
+    {}
+
+    // copy of the font with its own FreeType face, only used by the tasks
+    FontFreeType* font;
+    std::mutex fontMutex;
+    bool cancelled;
+
+    std::mutex resultsMutex;
+    std::condition_variable resultsCondition;
+    std::deque<RenderedGlyph> results;
+
+    bool scheduled;
+};
+
+static Texture2D::PixelFormat getGlyphPixelFormat(FontFreeType* font)
+{
+    return font->getOutlineSize() > 0 ? Texture2D::PixelFormat::AI88 : Texture2D::PixelFormat::A8;
+}
 
 FontAtlas::FontAtlas(Font &theFont) 
 : _font(&theFont)
-, _currentPageData(nullptr)
 , _fontAscender(0)
 , _toForegroundListener(nullptr)
 , _toBackgroundListener(nullptr)
@@ -52,31 +103,14 @@ FontAtlas::FontAtlas(Font &theFont)
     {
         _commonLineHeight = _font->getFontMaxHeight();
         _fontAscender = fontTTf->getFontAscender();
-        auto texture = new Texture2D;
-        _currentPage = 0;
-        _currentPageOrigX = 0;
-        _currentPageOrigY = 0;
         _letterPadding = 0;
 
         if(fontTTf->isDistanceFieldEnabled())
         {
             _letterPadding += 2 * FontFreeType::DistanceMapSpread;    
         }
-        _currentPageDataSize = CacheTextureWidth * CacheTextureHeight;
-        if(fontTTf->getOutlineSize() > 0)
-        {
-            _currentPageDataSize *= 2;
-        }    
 
-        _currentPageData = new unsigned char[_currentPageDataSize];
-        memset(_currentPageData, 0, _currentPageDataSize);
-
-        auto  pixelFormat = fontTTf->getOutlineSize() > 0 ? Texture2D::PixelFormat::AI88 : Texture2D::PixelFormat::A8; 
-        texture->initWithData(_currentPageData, _currentPageDataSize, 
-            pixelFormat, CacheTextureWidth, CacheTextureHeight, Size(CacheTextureWidth,CacheTextureHeight) );
-
-        addTexture(texture,0);
-        texture->release();
+        resetTextures();
 #if CC_ENABLE_CACHE_TEXTURE_DATA
         auto eventDispatcher = Director::getInstance()->getEventDispatcher();
         _toBackgroundListener = EventListenerCustom::create(EVENT_COME_TO_BACKGROUND, CC_CALLBACK_1(FontAtlas::listenToBackground, this));
@@ -89,10 +123,10 @@ FontAtlas::FontAtlas(Font &theFont)
 
 FontAtlas::~FontAtlas()
 {
-#if CC_ENABLE_CACHE_TEXTURE_DATA
     FontFreeType* fontTTf = dynamic_cast<FontFreeType*>(_font);
     if (fontTTf)
     {
+#if CC_ENABLE_CACHE_TEXTURE_DATA
         auto eventDispatcher = Director::getInstance()->getEventDispatcher();
         if (_toForegroundListener)
         {
@@ -104,13 +138,35 @@ FontAtlas::~FontAtlas()
             eventDispatcher->removeEventListener(_toBackgroundListener);
             _toBackgroundListener = nullptr;
         }
-    }
 #endif
+        // the atlas may be released after the Director has destroyed the cache
+        auto glyphCache = GlyphCache::getInstanceIfExists();
+        if (glyphCache)
+        {
+            glyphCache->removeGlyphs(this, false);
+        }
+    }
+
+    if (_asyncGlyphs)
+    {
+        if (_asyncGlyphs->scheduled)
+        {
+            Director::getInstance()->getScheduler()->unschedule(schedule_selector(FontAtlas::updateAsyncGlyphs), this);
+        }
+        if (_asyncGlyphs->font)
+        {
+            // waits for the running task, the other ones return without touching the font
+            {
+                std::lock_guard<std::mutex> fontLock(_asyncGlyphs->fontMutex);
+                _asyncGlyphs->cancelled = true;
+            }
+            _asyncGlyphs->font->release();
+            _asyncGlyphs->font = nullptr;
+        }
+    }
 
     _font->release();
     relaseTextures();
-
-    delete []_currentPageData;
 }
 
 void FontAtlas::relaseTextures()
@@ -122,78 +178,67 @@ void FontAtlas::relaseTextures()
     _atlasTextures.clear();
 }
 
-void FontAtlas::purgeTexturesAtlas()
+void FontAtlas::resetTextures()
 {
     FontFreeType* fontTTf = dynamic_cast<FontFreeType*>(_font);
-    if (fontTTf && _atlasTextures.size() > 1)
-    {
-        for( auto &item: _atlasTextures)
-        {
-            if (item.first != 0)
-            {
-                item.second->release();
-            }
-        }
-        auto temp = _atlasTextures[0];
-        _atlasTextures.clear();
-        _atlasTextures[0] = temp;
 
-        _fontLetterDefinitions.clear();
-        memset(_currentPageData,0,_currentPageDataSize);
-        _currentPage = 0;
-        _currentPageOrigX = 0;
-        _currentPageOrigY = 0;
-
-        auto eventDispatcher = Director::getInstance()->getEventDispatcher();
-        eventDispatcher->dispatchCustomEvent(EVENT_PURGE_TEXTURES,this);
-    }
+    relaseTextures();
+    addTexture(GlyphCache::getInstance()->getFirstPage(getGlyphPixelFormat(fontTTf), _antialiasEnabled), 0);
 }
 
-void FontAtlas::listenToBackground(EventCustom *event)
+int FontAtlas::getTextureSlot(Texture2D *texture)
 {
-#if CC_ENABLE_CACHE_TEXTURE_DATA
-    FontFreeType* fontTTf = dynamic_cast<FontFreeType*>(_font);
-    if (fontTTf && _atlasTextures.size() > 1)
+    for (const auto &item: _atlasTextures)
     {
-        for( auto &item: _atlasTextures)
+        if (item.second == texture)
         {
-            if (item.first != 0)
-            {
-                item.second->release();
-            }
+            return static_cast<int>(item.first);
         }
-        auto temp = _atlasTextures[0];
-        _atlasTextures.clear();
-        _atlasTextures[0] = temp;
-
-        _fontLetterDefinitions.clear();
-        memset(_currentPageData,0,_currentPageDataSize);
-        _currentPage = 0;
-        _currentPageOrigX = 0;
-        _currentPageOrigY = 0;
     }
-#endif
+
+    // the slots stay contiguous, Label has one batch node per slot
+    int slot = static_cast<int>(_atlasTextures.size());
+    addTexture(texture, slot);
+    return slot;
 }
 
-void FontAtlas::listenToForeground(EventCustom *event)
+void FontAtlas::purgeTexturesAtlas()
 {
-#if CC_ENABLE_CACHE_TEXTURE_DATA
     FontFreeType* fontTTf = dynamic_cast<FontFreeType*>(_font);
     if (fontTTf)
     {
-        if (_currentPageOrigX == 0 && _currentPageOrigY == 0)
+        if (_letterReferences.empty() && _atlasTextures.size() > 1)
         {
+            // no label shows this font, the pages can be released
+            GlyphCache::getInstance()->removeGlyphs(this, false);
+            _fontLetterDefinitions.clear();
+            resetTextures();
+
             auto eventDispatcher = Director::getInstance()->getEventDispatcher();
             eventDispatcher->dispatchCustomEvent(EVENT_PURGE_TEXTURES,this);
         }
         else
         {
-            auto  pixelFormat = fontTTf->getOutlineSize() > 0 ? Texture2D::PixelFormat::AI88 : Texture2D::PixelFormat::A8;
-
-            _atlasTextures[_currentPage]->initWithData(_currentPageData, _currentPageDataSize, 
-                pixelFormat, CacheTextureWidth, CacheTextureHeight, Size(CacheTextureWidth,CacheTextureHeight) );
+            GlyphCache::getInstance()->removeGlyphs(this, true);
         }
     }
+}
+
+void FontAtlas::listenToBackground(EventCustom *event)
+{
+    // the glyph pages keep a copy of their pixels, GlyphCache uploads them again when coming to foreground
+}
+
+void FontAtlas::listenToForeground(EventCustom *event)
+{
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    FontFreeType* fontTTf = dynamic_cast<FontFreeType*>(_font);
+    if (fontTTf)
+    {
+        // the labels removed their letters when coming to background
+        auto eventDispatcher = Director::getInstance()->getEventDispatcher();
+        eventDispatcher->dispatchCustomEvent(EVENT_PURGE_TEXTURES,this);
+    }
 #endif
 }
 
@@ -202,6 +247,11 @@ void FontAtlas::addLetterDefinition(const FontLetterDefinition &letterDefinition
     _fontLetterDefinitions[letterDefinition.letteCharUTF16] = letterDefinition;
 }
 
+void FontAtlas::removeLetterDefinition(unsigned short letteCharUTF16)
+{
+    _fontLetterDefinitions.erase(letteCharUTF16);
+}
+
 bool FontAtlas::getLetterDefinitionForChar(unsigned short  letteCharUTF16, FontLetterDefinition &outDefinition)
 {
     auto outIterator = _fontLetterDefinitions.find(letteCharUTF16);
@@ -218,6 +268,38 @@ bool FontAtlas::getLetterDefinitionForChar(unsigned short  letteCharUTF16, FontL
     }
 }
 
+void FontAtlas::retainLetters(const unsigned short *utf16String)
+{
+    if (utf16String == nullptr || dynamic_cast<FontFreeType*>(_font) == nullptr)
+        return;
+
+    for (; *utf16String; ++utf16String)
+    {
+        ++_letterReferences[*utf16String];
+    }
+}
+
+void FontAtlas::releaseLetters(const unsigned short *utf16String)
+{
+    if (utf16String == nullptr || dynamic_cast<FontFreeType*>(_font) == nullptr)
+        return;
+
+    for (; *utf16String; ++utf16String)
+    {
+        auto it = _letterReferences.find(*utf16String);
+        CCASSERT(it != _letterReferences.end(), "The letter is not retained");
+        if (it != _letterReferences.end() && --it->second == 0)
+        {
+            _letterReferences.erase(it);
+        }
+    }
+}
+
+bool FontAtlas::isLetterRetained(unsigned short letteCharUTF16) const
+{
+    return _letterReferences.find(letteCharUTF16) != _letterReferences.end();
+}
+
 bool FontAtlas::prepareLetterDefinitions(unsigned short *utf16String)
 {
     FontFreeType* fontTTf = dynamic_cast<FontFreeType*>(_font);
@@ -225,111 +307,256 @@ bool FontAtlas::prepareLetterDefinitions(unsigned short *utf16String)
         return false;
 
     int length = cc_wcslen(utf16String);
+    auto glyphCache = GlyphCache::getInstance();
 
-    float offsetAdjust = _letterPadding / 2;  
-    long bitmapWidth;
-    long bitmapHeight;
-    Rect tempRect;
-    FontLetterDefinition tempDef;
+    glyphCache->beginUpdate();
 
-    auto scaleFactor = CC_CONTENT_SCALE_FACTOR();
-    auto  pixelFormat = fontTTf->getOutlineSize() > 0 ? Texture2D::PixelFormat::AI88 : Texture2D::PixelFormat::A8; 
+    // the cached glyphs of the string must not be evicted to make room for its new glyphs
+    for (int i = 0; i < length; ++i)
+    {
+        glyphCache->touchGlyph(this, utf16String[i]);
+    }
+
+    std::vector<unsigned short> missingLetters;
+    RenderedGlyph glyph;
+    for (int i = 0; i < length; ++i)
+    {
+        if (_fontLetterDefinitions.find(utf16String[i]) != _fontLetterDefinitions.end()
+            || _pendingLetters.find(utf16String[i]) != _pendingLetters.end())
+            continue;
 
-    bool existNewLetter = false;
+        if (s_asyncGlyphLoadingEnabled)
+        {
+            _pendingLetters.insert(utf16String[i]);
+            missingLetters.push_back(utf16String[i]);
+        }
+        else
+        {
+            renderGlyph(fontTTf, utf16String[i], glyph);
+            addRenderedGlyph(glyph);
+        }
+    }
+
+    glyphCache->endUpdate();
+
+    if (! missingLetters.empty())
+    {
+        enqueueGlyphs(missingLetters);
+    }
+    return true;
+}
+
+void FontAtlas::renderGlyph(FontFreeType *font, unsigned short letter, RenderedGlyph &outGlyph)
+{
+    long bitmapWidth = 0;
+    long bitmapHeight = 0;
+
+    outGlyph.letter = letter;
+    outGlyph.xAdvance = 0;
+    outGlyph.width = 0;
+    outGlyph.height = 0;
+    outGlyph.pixels.clear();
+
+    auto bitmap = font->getGlyphBitmap(letter, bitmapWidth, bitmapHeight, outGlyph.rect, outGlyph.xAdvance);
+    outGlyph.hasBitmap = (bitmap != nullptr);
+    if (bitmap)
+    {
+        int spread = font->isDistanceFieldEnabled() ? 2 * FontFreeType::DistanceMapSpread : 0;
+        int bytesPerPixel = font->getOutlineSize() > 0 ? 2 : 1;
+
+        outGlyph.width = static_cast<int>(bitmapWidth) + spread;
+        outGlyph.height = static_cast<int>(bitmapHeight) + spread;
+        outGlyph.pixels.assign(outGlyph.width * outGlyph.height * bytesPerPixel, 0);
+        // generates the distance field, and deletes the outline bitmaps
+        font->renderCharAt(outGlyph.pixels.data(), 0, 0, bitmap, bitmapWidth, bitmapHeight, outGlyph.width);
+    }
+}
+
+void FontAtlas::addRenderedGlyph(const RenderedGlyph &glyph)
+{
+    FontFreeType* fontTTf = static_cast<FontFreeType*>(_font);
+    auto pixelFormat = getGlyphPixelFormat(fontTTf);
+    auto scaleFactor = CC_CONTENT_SCALE_FACTOR();
+    float offsetAdjust = _letterPadding / 2;
     int bottomHeight = _commonLineHeight - _fontAscender;
 
-    float startY = _currentPageOrigY;
+    FontLetterDefinition tempDef;
+    tempDef.letteCharUTF16 = glyph.letter;
+    tempDef.xAdvance = glyph.xAdvance;
 
-    for (int i = 0; i < length; ++i)
+    int width = glyph.rect.size.width + _letterPadding;
+    int height = glyph.rect.size.height + _letterPadding;
+    GlyphCache::GlyphSlot slot;
+    if (glyph.hasBitmap && GlyphCache::getInstance()->addGlyph(this, glyph.letter, pixelFormat, _antialiasEnabled, width, height, slot))
     {
-        auto outIterator = _fontLetterDefinitions.find(utf16String[i]);
+        int bytesPerPixel = pixelFormat == Texture2D::PixelFormat::AI88 ? 2 : 1;
+        int copyWidth = std::min(width, glyph.width) * bytesPerPixel;
+        int copyHeight = std::min(height, glyph.height);
+        for (int row = 0; row < copyHeight; ++row)
+        {
+            memcpy(slot.pageData + ((slot.y + row) * CacheTextureWidth + slot.x) * bytesPerPixel,
+                   glyph.pixels.data() + row * glyph.width * bytesPerPixel, copyWidth);
+        }
+
+        tempDef.validDefinition = true;
+        tempDef.width            = width;
+        tempDef.height           = height;
+        tempDef.offsetX          = glyph.rect.origin.x + offsetAdjust;
+        tempDef.offsetY          = _fontAscender + glyph.rect.origin.y - offsetAdjust;
+        tempDef.clipBottom     = bottomHeight - (tempDef.height + glyph.rect.origin.y + offsetAdjust);
+        tempDef.U                = slot.x;
+        tempDef.V                = slot.y;
+        tempDef.textureID        = getTextureSlot(slot.texture);
+        // take from pixels to points
+        tempDef.width  =    tempDef.width  / scaleFactor;
+        tempDef.height =    tempDef.height / scaleFactor;      
+        tempDef.U      =    tempDef.U      / scaleFactor;
+        tempDef.V      =    tempDef.V      / scaleFactor;
+    }
+    else{
+        if(! glyph.hasBitmap && tempDef.xAdvance)
+            tempDef.validDefinition = true;
+        else
+            tempDef.validDefinition = false;
+
+        tempDef.width            = 0;
+        tempDef.height           = 0;
+        tempDef.U                = 0;
+        tempDef.V                = 0;
+        tempDef.offsetX          = 0;
+        tempDef.offsetY          = 0;
+        tempDef.textureID        = 0;
+        tempDef.clipBottom = 0;
+    }
+
+    _fontLetterDefinitions[tempDef.letteCharUTF16] = tempDef;
+}
+
+void FontAtlas::setAsyncGlyphLoadingEnabled(bool enabled)
+{
+    s_asyncGlyphLoadingEnabled = enabled;
+}
+
+bool FontAtlas::isAsyncGlyphLoadingEnabled()
+{
+    return s_asyncGlyphLoadingEnabled;
+}
+
+void FontAtlas::enqueueGlyphs(const std::vector<unsigned short> &letters)
+{
+    if (_asyncGlyphs == nullptr)
+    {
+        _asyncGlyphs = std::make_shared<AsyncGlyphs>();
+        _asyncGlyphs->font = static_cast<FontFreeType*>(_font)->clone();
+    }
+
+    if (_asyncGlyphs->font == nullptr)
+    {
+        CCLOG("cocos2d: FontAtlas: the font could not be opened again, the glyphs are rasterized on the main thread");
+        RenderedGlyph glyph;
+        GlyphCache::getInstance()->beginUpdate();
+        for (auto letter : letters)
+        {
+            _pendingLetters.erase(letter);
+            renderGlyph(static_cast<FontFreeType*>(_font), letter, glyph);
+            addRenderedGlyph(glyph);
+        }
+        GlyphCache::getInstance()->endUpdate();
+        return;
+    }
 
-        if (outIterator == _fontLetterDefinitions.end())
-        {  
-            existNewLetter = true;
+    // the tasks share the FreeType face of the worker font: they run one at a time, in order
+    auto asyncGlyphs = _asyncGlyphs;
+    ThreadPool::getInstance()->enqueue([asyncGlyphs, letters]() {
+        std::lock_guard<std::mutex> fontLock(asyncGlyphs->fontMutex);
+        RenderedGlyph glyph;
+        for (auto letter : letters)
+        {
+            if (asyncGlyphs->cancelled)
+                return;
 
-            auto bitmap = fontTTf->getGlyphBitmap(utf16String[i],bitmapWidth,bitmapHeight,tempRect,tempDef.xAdvance);
-            if (bitmap)
+            renderGlyph(asyncGlyphs->font, letter, glyph);
             {
-                tempDef.validDefinition = true;
-                tempDef.letteCharUTF16   = utf16String[i];
-                tempDef.width            = tempRect.size.width + _letterPadding;
-                tempDef.height           = tempRect.size.height + _letterPadding;
-                tempDef.offsetX          = tempRect.origin.x + offsetAdjust;
-                tempDef.offsetY          = _fontAscender + tempRect.origin.y - offsetAdjust;
-                tempDef.clipBottom     = bottomHeight - (tempDef.height + tempRect.origin.y + offsetAdjust);
-
-                if (_currentPageOrigX + tempDef.width > CacheTextureWidth)
-                {
-                    _currentPageOrigY += _commonLineHeight;
-                    _currentPageOrigX = 0;
-                    if(_currentPageOrigY + _commonLineHeight >= CacheTextureHeight)
-                    {     
-                        auto data = _currentPageData + CacheTextureWidth * (int)startY;
-                        _atlasTextures[_currentPage]->updateWithData(data, 0, startY, 
-                            CacheTextureWidth, CacheTextureHeight - startY);
-
-                        startY = 0.0f;
-
-                        _currentPageOrigY = 0;
-                        memset(_currentPageData, 0, _currentPageDataSize);
-                        _currentPage++;
-                        auto tex = new Texture2D;
-                        if (_antialiasEnabled)
-                        {
-                            tex->setAntiAliasTexParameters();
-                        } 
-                        else
-                        {
-                            tex->setAliasTexParameters();
-                        }
-                        tex->initWithData(_currentPageData, _currentPageDataSize, 
-                            pixelFormat, CacheTextureWidth, CacheTextureHeight, Size(CacheTextureWidth,CacheTextureHeight) );
-                        addTexture(tex,_currentPage);
-                        tex->release();
-                    }  
-                }
-                fontTTf->renderCharAt(_currentPageData,_currentPageOrigX,_currentPageOrigY,bitmap,bitmapWidth,bitmapHeight);
-
-                tempDef.U                = _currentPageOrigX;
-                tempDef.V                = _currentPageOrigY;
-                tempDef.textureID        = _currentPage;
-                _currentPageOrigX        += tempDef.width + 1;
-                // take from pixels to points
-                tempDef.width  =    tempDef.width  / scaleFactor;
-                tempDef.height =    tempDef.height / scaleFactor;      
-                tempDef.U      =    tempDef.U      / scaleFactor;
-                tempDef.V      =    tempDef.V      / scaleFactor;
-            }
-            else{
-                if(tempDef.xAdvance)
-                    tempDef.validDefinition = true;
-                else
-                    tempDef.validDefinition = false;
-
-                tempDef.letteCharUTF16   = utf16String[i];
-                tempDef.width            = 0;
-                tempDef.height           = 0;
-                tempDef.U                = 0;
-                tempDef.V                = 0;
-                tempDef.offsetX          = 0;
-                tempDef.offsetY          = 0;
-                tempDef.textureID        = 0;
-                tempDef.clipBottom = 0;
-                _currentPageOrigX += 1;
+                std::lock_guard<std::mutex> resultsLock(asyncGlyphs->resultsMutex);
+                asyncGlyphs->results.push_back(std::move(glyph));
             }
+            asyncGlyphs->resultsCondition.notify_all();
+        }
+    });
 
-            _fontLetterDefinitions[tempDef.letteCharUTF16] = tempDef;
-        }       
+    if (! _asyncGlyphs->scheduled)
+    {
+        Director::getInstance()->getScheduler()->schedule(schedule_selector(FontAtlas::updateAsyncGlyphs), this, 0, false);
+        _asyncGlyphs->scheduled = true;
     }
+}
 
-    if(existNewLetter)
+int FontAtlas::addRenderedGlyphs(ssize_t maxBytes)
+{
+    auto glyphCache = GlyphCache::getInstance();
+    int added = 0;
+    ssize_t bytes = 0;
+
+    glyphCache->beginUpdate();
+    while (bytes < maxBytes)
     {
-        auto data = _currentPageData + CacheTextureWidth * (int)startY;
-        _atlasTextures[_currentPage]->updateWithData(data, 0, startY, 
-            CacheTextureWidth, _currentPageOrigY - startY + _commonLineHeight);
+        RenderedGlyph glyph;
+        {
+            std::lock_guard<std::mutex> resultsLock(_asyncGlyphs->resultsMutex);
+            if (_asyncGlyphs->results.empty())
+                break;
+            glyph = std::move(_asyncGlyphs->results.front());
+            _asyncGlyphs->results.pop_front();
+        }
+
+        if (_pendingLetters.erase(glyph.letter) && _fontLetterDefinitions.find(glyph.letter) == _fontLetterDefinitions.end())
+        {
+            addRenderedGlyph(glyph);
+            ++added;
+        }
+        bytes += glyph.pixels.size();
+    }
+    glyphCache->endUpdate();
+
+    return added;
+}
+
+void FontAtlas::updateAsyncGlyphs(float dt)
+{
+    if (addRenderedGlyphs(ASYNC_GLYPH_BYTES_PER_FRAME) > 0)
+    {
+        Director::getInstance()->getEventDispatcher()->dispatchCustomEvent(EVENT_GLYPHS_READY, this);
+    }
+
+    if (_pendingLetters.empty())
+    {
+        Director::getInstance()->getScheduler()->unschedule(schedule_selector(FontAtlas::updateAsyncGlyphs), this);
+        _asyncGlyphs->scheduled = false;
+    }
+}
+
+void FontAtlas::waitForPendingGlyphs()
+{
+    if (_pendingLetters.empty())
+        return;
+
+    int added = 0;
+    while (! _pendingLetters.empty())
+    {
+        {
+            std::unique_lock<std::mutex> resultsLock(_asyncGlyphs->resultsMutex);
+            _asyncGlyphs->resultsCondition.wait(resultsLock, [this]() { return ! _asyncGlyphs->results.empty(); });
+        }
+        added += addRenderedGlyphs(std::numeric_limits<ssize_t>::max());
+    }
+
+    Director::getInstance()->getScheduler()->unschedule(schedule_selector(FontAtlas::updateAsyncGlyphs), this);
+    _asyncGlyphs->scheduled = false;
+
+    if (added > 0)
+    {
+        Director::getInstance()->getEventDispatcher()->dispatchCustomEvent(EVENT_GLYPHS_READY, this);
     }
-    return true;
 }
 
 void FontAtlas::addTexture(Texture2D *texture, int slot)
@@ -363,10 +590,7 @@ void FontAtlas::setAliasTexParameters()
     if (_antialiasEnabled)
     {
         _antialiasEnabled = false;
-        for (const auto & tex : _atlasTextures)
-        {
-            tex.second->setAliasTexParameters();
-        }
+        updateTexParameters();
     }
 }
 
@@ -375,9 +599,31 @@ void FontAtlas::setAntiAliasTexParameters()
     if (! _antialiasEnabled)
     {
         _antialiasEnabled = true;
+        updateTexParameters();
+    }
+}
+
+void FontAtlas::updateTexParameters()
+{
+    FontFreeType* fontTTf = dynamic_cast<FontFreeType*>(_font);
+    if (fontTTf)
+    {
+        // the pages are shared with other fonts: the glyphs move to the pages using the same texture parameters
+        GlyphCache::getInstance()->removeGlyphs(this, false);
+        _fontLetterDefinitions.clear();
+        resetTextures();
+
+        auto eventDispatcher = Director::getInstance()->getEventDispatcher();
+        eventDispatcher->dispatchCustomEvent(EVENT_PURGE_TEXTURES,this);
+    }
+    else
+    {
         for (const auto & tex : _atlasTextures)
         {
-            tex.second->setAntiAliasTexParameters();
+            if (_antialiasEnabled)
+                tex.second->setAntiAliasTexParameters();
+            else
+                tex.second->setAliasTexParameters();
         }
     }
 }
@@ -25,7 +25,10 @@
 #ifndef _CCFontAtlas_h_
 #define _CCFontAtlas_h_
 
+#include <memory>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include "CCPlatformMacros.h"
 #include "CCRef.h"
 #include "CCStdC.h"
@@ -34,6 +37,7 @@ NS_CC_BEGIN
 
 //fwd
 class Font;
+class FontFreeType;
 class Texture2D;
 class EventCustom;
 class EventListenerCustom;
@@ -60,6 +64,16 @@ public:
     static const int CacheTextureWidth;
     static const int CacheTextureHeight;
     static const char* EVENT_PURGE_TEXTURES;
+    /** Dispatched with the FontAtlas as user data when glyphs rasterized in the background were added */
+    static const char* EVENT_GLYPHS_READY;
+
+    /** When enabled, prepareLetterDefinitions() rasterizes the missing TTF glyphs, and generates their distance field,
+     on the threads of ThreadPool. The labels show the glyphs already available and are laid out again when the other
+     ones are ready. Default is false: the glyphs are rasterized before prepareLetterDefinitions() returns.
+     */
+    static void setAsyncGlyphLoadingEnabled(bool enabled);
+    static bool isAsyncGlyphLoadingEnabled();
+
     /**
      * @js ctor
      */
@@ -71,10 +85,24 @@ public:
     virtual ~FontAtlas();
     
     void addLetterDefinition(const FontLetterDefinition &letterDefinition);
+    void removeLetterDefinition(unsigned short letteCharUTF16);
     bool getLetterDefinitionForChar(unsigned short  letteCharUTF16, FontLetterDefinition &outDefinition);
     
     bool prepareLetterDefinitions(unsigned short  *utf16String);
 
+    /** Prevents the glyphs of the letters from being evicted from the pages shared with the other fonts,
+     until releaseLetters() is called with the same string. It only has effect on TTF fonts.
+     */
+    void retainLetters(const unsigned short *utf16String);
+    void releaseLetters(const unsigned short *utf16String);
+    bool isLetterRetained(unsigned short letteCharUTF16) const;
+
+    /** Whether glyphs are being rasterized in the background */
+    bool hasPendingGlyphs() const { return !_pendingLetters.empty(); }
+
+    /** Blocks until the glyphs rasterized in the background are ready, and adds them */
+    void waitForPendingGlyphs();
+
     inline const std::unordered_map<ssize_t, Texture2D*>& getTextures() const{ return _atlasTextures;}
     void  addTexture(Texture2D *texture, int slot);
     float getCommonLineHeight() const;
@@ -94,7 +122,7 @@ public:
     void listenToForeground(EventCustom *event);
     
     /** Removes textures atlas.
-     It will purge the textures atlas and if multiple texture exist in the FontAtlas.
+     It will remove the glyphs that are not retained by a label from the shared glyph pages.
      */
     void purgeTexturesAtlas();
 
@@ -111,19 +139,28 @@ public:
      void setAliasTexParameters();
 
 private:
+    struct RenderedGlyph;
+    struct AsyncGlyphs;
+
+    static void renderGlyph(FontFreeType *font, unsigned short letter, RenderedGlyph &outGlyph);
+    void addRenderedGlyph(const RenderedGlyph &glyph);
+    int  addRenderedGlyphs(ssize_t maxBytes);
+    void enqueueGlyphs(const std::vector<unsigned short> &letters);
+    void updateAsyncGlyphs(float dt);
 
     void relaseTextures();
+    int  getTextureSlot(Texture2D *texture);
+    void resetTextures();
+    void updateTexParameters();
     std::unordered_map<ssize_t, Texture2D*> _atlasTextures;
     std::unordered_map<unsigned short, FontLetterDefinition> _fontLetterDefinitions;
     float _commonLineHeight;
     Font * _font;
 
-    // Dynamic GlyphCollection related stuff
-    int _currentPage;
-    unsigned char *_currentPageData;
-    int _currentPageDataSize;
-    float _currentPageOrigX;
-    float _currentPageOrigY;
+    // Dynamic GlyphCollection related stuff, the glyphs are stored in the pages of GlyphCache
+    std::unordered_map<unsigned short, int> _letterReferences;
+    std::unordered_set<unsigned short> _pendingLetters;
+    std::shared_ptr<AsyncGlyphs> _asyncGlyphs;
     float _letterPadding;
     bool  _makeDistanceMap;
 
@@ -30,6 +30,7 @@
 #include "CCFontFNT.h"
 #include "CCFontFreeType.h"
 #include "CCFontCharMap.h"
+#include "CCGlyphCache.h"
 #include "CCDirector.h"
 
 NS_CC_BEGIN
@@ -42,6 +43,7 @@ void FontAtlasCache::purgeCachedData()
     {
         atlas.second->purgeTexturesAtlas();
     }
+    GlyphCache::getInstance()->removeUnusedPages();
 }
 
 FontAtlas * FontAtlasCache::getFontAtlasTTF(const TTFConfig & config)
@@ -93,15 +93,23 @@ FT_Library FontFreeType::getFTLibrary()
     return _FTlibrary;
 }
 
-FontFreeType::FontFreeType(bool distanceFieldEnabled /* = false */,int outline /* = 0 */)
-: _fontRef(nullptr)
+FontFreeType::FontFreeType(bool distanceFieldEnabled /* = false */,int outline /* = 0 */,FT_Library library /* = nullptr */)
+: _library(library)
+,_ownsLibrary(library != nullptr)
+,_fontRef(nullptr)
+,_fontSize(0)
 ,_distanceFieldEnabled(distanceFieldEnabled)
 ,_outlineSize(outline)
 ,_stroker(nullptr)
 {
+    if (_library == nullptr)
+    {
+        _library = getFTLibrary();
+    }
+
     if (_outlineSize > 0)
     {
-        FT_Stroker_New(FontFreeType::getFTLibrary(), &_stroker);
+        FT_Stroker_New(_library, &_stroker);
         FT_Stroker_Set(_stroker,
             (int)(_outlineSize * 64),
             FT_STROKER_LINECAP_ROUND,
@@ -115,6 +123,7 @@ bool FontFreeType::createFontObject(const std::string &fontName, int fontSize)
     FT_Face face;
     // save font name locally
     _fontName = fontName;
+    _fontSize = fontSize;
 
     auto it = s_cacheFontData.find(fontName);
     if (it != s_cacheFontData.end())
@@ -132,7 +141,7 @@ bool FontFreeType::createFontObject(const std::string &fontName, int fontSize)
         }
     }
 
-    if (FT_New_Memory_Face(getFTLibrary(), s_cacheFontData[fontName].data.getBytes(), s_cacheFontData[fontName].data.getSize(), 0, &face ))
+    if (FT_New_Memory_Face(_library, s_cacheFontData[fontName].data.getBytes(), s_cacheFontData[fontName].data.getSize(), 0, &face ))
         return false;
     
     //we want to use unicode
@@ -162,6 +171,10 @@ FontFreeType::~FontFreeType()
     {
         FT_Done_Face(_fontRef);
     }
+    if (_ownsLibrary)
+    {
+        FT_Done_FreeType(_library);
+    }
 
     s_cacheFontData[_fontName].referenceCount -= 1;
     if (s_cacheFontData[_fontName].referenceCount == 0)
@@ -170,6 +183,25 @@ FontFreeType::~FontFreeType()
     }
 }
 
+FontFreeType* FontFreeType::clone() const
+{
+    // FreeType objects of the same FT_Library can't be used on several threads at once,
+    // so the clone opens its face in a library of its own
+    FT_Library library;
+    if (FT_Init_FreeType(&library))
+        return nullptr;
+
+    FontFreeType *tempFont = new FontFreeType(_distanceFieldEnabled, _outlineSize, library);
+    tempFont->setCurrentGlyphCollection(GlyphCollection::DYNAMIC, nullptr);
+
+    if (!tempFont->createFontObject(_fontName, _fontSize))
+    {
+        delete tempFont;
+        return nullptr;
+    }
+    return tempFont;
+}
+
 FontAtlas * FontFreeType::createFontAtlas()
 {
     FontAtlas *atlas = new FontAtlas(*this);
@@ -388,7 +420,7 @@ unsigned char * FontFreeType::getGlyphBitmapWithOutline(unsigned short theChar,
                     params.target = &bmp;
                     params.flags = FT_RASTER_FLAG_AA;
                     FT_Outline_Translate(outline,-bbox.xMin,-bbox.yMin);
-                    FT_Outline_Render(_FTlibrary, outline, &params);
+                    FT_Outline_Render(_library, outline, &params);
 
                     ret = bmp.buffer;
                 }
@@ -482,6 +514,11 @@ unsigned char * makeDistanceMap( unsigned char *img, long width, long height)
 }
 
 void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned char* bitmap,long bitmapWidth,long bitmapHeight)
+{
+    renderCharAt(dest, posX, posY, bitmap, bitmapWidth, bitmapHeight, FontAtlas::CacheTextureWidth);
+}
+
+void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned char* bitmap,long bitmapWidth,long bitmapHeight,int destWidth)
 {
     int iX = posX;
     int iY = posY;
@@ -507,7 +544,7 @@ void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned
                 dest[index + 2] = out[index2 + 2];*/
 
                 //Single channel 8-bit output 
-                dest[iX + ( iY * FontAtlas::CacheTextureWidth )] = distanceMap[bitmap_y + x];
+                dest[iX + ( iY * destWidth )] = distanceMap[bitmap_y + x];
 
                 iX += 1;
             }
@@ -527,9 +564,9 @@ void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned
             for (int x = 0; x < bitmapWidth; ++x)
             {
                 tempChar = bitmap[(bitmap_y + x) * 2];
-                dest[(iX + ( iY * FontAtlas::CacheTextureWidth ) ) * 2] = tempChar;
+                dest[(iX + ( iY * destWidth ) ) * 2] = tempChar;
                 tempChar = bitmap[(bitmap_y + x) * 2 + 1];
-                dest[(iX + ( iY * FontAtlas::CacheTextureWidth ) ) * 2 + 1] = tempChar;
+                dest[(iX + ( iY * destWidth ) ) * 2 + 1] = tempChar;
 
                 iX += 1;
             }
@@ -550,7 +587,7 @@ void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned
                 unsigned char cTemp = bitmap[bitmap_y + x];
 
                 // the final pixel
-                dest[(iX + ( iY * FontAtlas::CacheTextureWidth ) )] = cTemp;
+                dest[(iX + ( iY * destWidth ) )] = cTemp;
 
                 iX += 1;
             }
@@ -60,6 +60,13 @@ public:
     bool     isDistanceFieldEnabled() const { return _distanceFieldEnabled;}
     int      getOutlineSize() const { return _outlineSize; }
     void     renderCharAt(unsigned char *dest,int posX, int posY, unsigned char* bitmap,long bitmapWidth,long bitmapHeight); 
+    /** Same as above, the rows of dest are destWidth pixels wide */
+    void     renderCharAt(unsigned char *dest,int posX, int posY, unsigned char* bitmap,long bitmapWidth,long bitmapHeight,int destWidth);
+
+    /** Creates a font object with the same file, size and effects, with its own FreeType library and face.
+     It can rasterize glyphs on another thread than the one using this font.
+     */
+    FontFreeType* clone() const;
 
     virtual FontAtlas   * createFontAtlas() override;
     virtual int         * getHorizontalKerningForTextUTF16(unsigned short *text, int &outNumLetters) const override;
@@ -71,7 +78,8 @@ public:
 
 protected:
     
-    FontFreeType(bool distanceFieldEnabled = false,int outline = 0);
+    /** library is owned by the font, the shared library is used when it is null */
+    FontFreeType(bool distanceFieldEnabled = false,int outline = 0,FT_Library library = nullptr);
     virtual ~FontFreeType();
     bool   createFontObject(const std::string &fontName, int fontSize);
     
@@ -85,9 +93,12 @@ private:
     
     static FT_Library _FTlibrary;
     static bool       _FTInitialized;
+    FT_Library        _library;
+    bool              _ownsLibrary;
     FT_Face           _fontRef;
     FT_Stroker        _stroker;
     std::string       _fontName;
+    int               _fontSize;
     bool              _distanceFieldEnabled;
     int               _outlineSize;
 };
@@ -24,6 +24,9 @@ THE SOFTWARE.
 ****************************************************************************/
 
 #include "CCGLBufferedNode.h"
+#include "ccGLStateCache.h"
+
+USING_NS_CC;
 
 GLBufferedNode::GLBufferedNode()
 {
@@ -42,11 +45,11 @@ GLBufferedNode::~GLBufferedNode()
     {
         if(_bufferSize[i])
         {
-            glDeleteBuffers(1, &(_bufferObject[i]));
+            GL::deleteBuffers(1, &(_bufferObject[i]));
         }
         if(_indexBufferSize[i])
         {
-            glDeleteBuffers(1, &(_indexBufferObject[i]));
+            GL::deleteBuffers(1, &(_indexBufferObject[i]));
         }
     }
 }
@@ -58,17 +61,17 @@ void GLBufferedNode::setGLBufferData(void *buf, GLuint bufSize, int slot)
     {
         if(_bufferObject[slot])
         {
-            glDeleteBuffers(1, &(_bufferObject[slot]));
+            GL::deleteBuffers(1, &(_bufferObject[slot]));
         }
         glGenBuffers(1, &(_bufferObject[slot]));
         _bufferSize[slot] = bufSize;
 
-        glBindBuffer(GL_ARRAY_BUFFER, _bufferObject[slot]);
+        GL::bindBuffer(GL_ARRAY_BUFFER, _bufferObject[slot]);
         glBufferData(GL_ARRAY_BUFFER, bufSize, buf, GL_DYNAMIC_DRAW);
     }
     else
     {
-        glBindBuffer(GL_ARRAY_BUFFER, _bufferObject[slot]);
+        GL::bindBuffer(GL_ARRAY_BUFFER, _bufferObject[slot]);
         glBufferSubData(GL_ARRAY_BUFFER, 0, bufSize, buf);
     }
 }
@@ -80,17 +83,17 @@ void GLBufferedNode::setGLIndexData(void *buf, GLuint bufSize, int slot)
     {
         if(_indexBufferObject[slot])
         {
-            glDeleteBuffers(1, &(_indexBufferObject[slot]));
+            GL::deleteBuffers(1, &(_indexBufferObject[slot]));
         }
         glGenBuffers(1, &(_indexBufferObject[slot]));
         _indexBufferSize[slot] = bufSize;
 
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBufferObject[slot]);
+        GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBufferObject[slot]);
         glBufferData(GL_ELEMENT_ARRAY_BUFFER, bufSize, buf, GL_DYNAMIC_DRAW);
     }
     else
     {
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBufferObject[slot]);
+        GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBufferObject[slot]);
         glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, bufSize, buf);
     }
 }
@@ -50,6 +50,18 @@ typedef struct _hashUniformEntry
     UT_hash_handle  hh;          // hash entry
 } tHashUniformEntry;
 
+// Builtin uniforms shared by all the programs. Each program keeps the serials of the values it uploaded last.
+static struct
+{
+    unsigned int    frameSerial;
+    unsigned int    projectionSerial;
+    kmMat4          projection;
+    GLfloat         time[4];
+    GLfloat         sinTime[4];
+    GLfloat         cosTime[4];
+    GLfloat         random[4];
+} s_builtinUniforms = { 1, 1 };
+
 const char* GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR = "ShaderPositionTextureColor";
 const char* GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP = "ShaderPositionTextureColor_noMVP";
 const char* GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST = "ShaderPositionTextureColorAlphaTest";
@@ -67,6 +79,11 @@ const char* GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_GLOW = "ShaderLabelDFGlow
 const char* GLProgram::SHADER_NAME_LABEL_NORMAL = "ShaderLabelNormal";
 const char* GLProgram::SHADER_NAME_LABEL_OUTLINE = "ShaderLabelOutline";
 
+const char* GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL_NO_MVP = "ShaderLabelDFNormal_noMVP";
+const char* GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_GLOW_NO_MVP = "ShaderLabelDFGlow_noMVP";
+const char* GLProgram::SHADER_NAME_LABEL_NORMAL_NO_MVP = "ShaderLabelNormal_noMVP";
+const char* GLProgram::SHADER_NAME_LABEL_OUTLINE_NO_MVP = "ShaderLabelOutline_noMVP";
+
 
 // uniform names
 const char* GLProgram::UNIFORM_NAME_P_MATRIX = "CC_PMatrix";
@@ -90,9 +107,12 @@ GLProgram::GLProgram()
 , _vertShader(0)
 , _fragShader(0)
 , _hashForUniforms(nullptr)
+, _builtinFrameSerial(0)
+, _builtinProjectionSerial(0)
 , _flags()
 {
     memset(_uniforms, 0, sizeof(_uniforms));
+    memset(&_builtinMV, 0, sizeof(_builtinMV));
 }
 
 GLProgram::~GLProgram()
@@ -309,6 +329,10 @@ void GLProgram::updateUniforms()
                        );
 	_flags.usesRandom = _uniforms[UNIFORM_RANDOM01] != -1;
 
+    // the builtin uniforms have to be uploaded again
+    _builtinFrameSerial = 0;
+    _builtinProjectionSerial = 0;
+
     this->use();
     
     // Since sample most probably won't change, set it to 0 now.
@@ -441,6 +465,7 @@ bool GLProgram::updateUniformLocation(GLint location, const GLvoid* data, unsign
         }
     }
 
+    GL::countStateChange(!updated);
     return updated;
 }
 
@@ -637,36 +662,74 @@ void GLProgram::setUniformsForBuiltins()
 
 void GLProgram::setUniformsForBuiltins(const kmMat4 &matrixMV)
 {
+    // The projection changes a few times per frame at most (render textures), the programs only
+    // upload it when it differs from the one they used last
     kmMat4 matrixP;
+    kmGLGetMatrix(KM_GL_PROJECTION, &matrixP);
+    if (memcmp(&matrixP, &s_builtinUniforms.projection, sizeof(matrixP)) != 0)
+    {
+        kmMat4Assign(&s_builtinUniforms.projection, &matrixP);
+        ++s_builtinUniforms.projectionSerial;
+    }
+
+    bool projectionChanged = _builtinProjectionSerial != s_builtinUniforms.projectionSerial;
+    if (projectionChanged)
+    {
+        _builtinProjectionSerial = s_builtinUniforms.projectionSerial;
 
-	kmGLGetMatrix(KM_GL_PROJECTION, &matrixP);
+        if(_flags.usesP)
+            setUniformLocationWithMatrix4fv(_uniforms[UNIFORM_P_MATRIX], s_builtinUniforms.projection.mat, 1);
+    }
 
-    if(_flags.usesP)
-        setUniformLocationWithMatrix4fv(_uniforms[UNIFORM_P_MATRIX], matrixP.mat, 1);
+    // Neither the multiplication nor the lookups of the uniform cache are needed when the modelview is the same
+    if ((_flags.usesMV || _flags.usesMVP) && (projectionChanged || memcmp(&matrixMV, &_builtinMV, sizeof(matrixMV)) != 0))
+    {
+        kmMat4Assign(&_builtinMV, &matrixMV);
 
-    if(_flags.usesMV)
-        setUniformLocationWithMatrix4fv(_uniforms[UNIFORM_MV_MATRIX], matrixMV.mat, 1);
+        if(_flags.usesMV)
+            setUniformLocationWithMatrix4fv(_uniforms[UNIFORM_MV_MATRIX], matrixMV.mat, 1);
 
-    if(_flags.usesMVP) {
-        kmMat4 matrixMVP;
-        kmMat4Multiply(&matrixMVP, &matrixP, &matrixMV);
-        setUniformLocationWithMatrix4fv(_uniforms[UNIFORM_MVP_MATRIX], matrixMVP.mat, 1);
+        if(_flags.usesMVP) {
+            kmMat4 matrixMVP;
+            kmMat4Multiply(&matrixMVP, &s_builtinUniforms.projection, &matrixMV);
+            setUniformLocationWithMatrix4fv(_uniforms[UNIFORM_MVP_MATRIX], matrixMVP.mat, 1);
+        }
     }
 
-	if(_flags.usesTime) {
-		Director *director = Director::getInstance();
-		// This doesn't give the most accurate global time value.
-		// Cocos2D doesn't store a high precision time value, so this will have to do.
-		// Getting Mach time per frame per shader using time could be extremely expensive.
-        float time = director->getTotalFrames() * director->getAnimationInterval();
-		
-        setUniformLocationWith4f(_uniforms[GLProgram::UNIFORM_TIME], time/10.0, time, time*2, time*4);
-        setUniformLocationWith4f(_uniforms[GLProgram::UNIFORM_SIN_TIME], time/8.0, time/4.0, time/2.0, sinf(time));
-        setUniformLocationWith4f(_uniforms[GLProgram::UNIFORM_COS_TIME], time/8.0, time/4.0, time/2.0, cosf(time));
-	}
-	
-	if(_flags.usesRandom)
-        setUniformLocationWith4f(_uniforms[GLProgram::UNIFORM_RANDOM01], CCRANDOM_0_1(), CCRANDOM_0_1(), CCRANDOM_0_1(), CCRANDOM_0_1());
+    if ((_flags.usesTime || _flags.usesRandom) && _builtinFrameSerial != s_builtinUniforms.frameSerial)
+    {
+        _builtinFrameSerial = s_builtinUniforms.frameSerial;
+
+        if(_flags.usesTime) {
+            setUniformLocationWith4fv(_uniforms[GLProgram::UNIFORM_TIME], s_builtinUniforms.time, 1);
+            setUniformLocationWith4fv(_uniforms[GLProgram::UNIFORM_SIN_TIME], s_builtinUniforms.sinTime, 1);
+            setUniformLocationWith4fv(_uniforms[GLProgram::UNIFORM_COS_TIME], s_builtinUniforms.cosTime, 1);
+        }
+
+        if(_flags.usesRandom)
+            setUniformLocationWith4fv(_uniforms[GLProgram::UNIFORM_RANDOM01], s_builtinUniforms.random, 1);
+    }
+}
+
+void GLProgram::updateBuiltinUniforms()
+{
+    Director *director = Director::getInstance();
+    // This doesn't give the most accurate global time value.
+    // Cocos2D doesn't store a high precision time value, so this will have to do.
+    // Getting Mach time per frame per shader using time could be extremely expensive.
+    float time = director->getTotalFrames() * director->getAnimationInterval();
+
+    GLfloat timeValues[4] = { time/10.0f, time, time*2, time*4 };
+    GLfloat sinTimeValues[4] = { time/8.0f, time/4.0f, time/2.0f, sinf(time) };
+    GLfloat cosTimeValues[4] = { time/8.0f, time/4.0f, time/2.0f, cosf(time) };
+    memcpy(s_builtinUniforms.time, timeValues, sizeof(timeValues));
+    memcpy(s_builtinUniforms.sinTime, sinTimeValues, sizeof(sinTimeValues));
+    memcpy(s_builtinUniforms.cosTime, cosTimeValues, sizeof(cosTimeValues));
+
+    for (int i = 0; i < 4; ++i)
+        s_builtinUniforms.random[i] = CCRANDOM_0_1();
+
+    ++s_builtinUniforms.frameSerial;
 }
 
 void GLProgram::reset()
@@ -678,6 +741,8 @@ void GLProgram::reset()
     // it is already deallocated by android
     //GL::deleteProgram(_program);
     _program = 0;
+    _builtinFrameSerial = 0;
+    _builtinProjectionSerial = 0;
 
     
     tHashUniformEntry *current_element, *tmp;
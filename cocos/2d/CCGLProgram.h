@@ -97,6 +97,12 @@ public:
 
     static const char* SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL;
     static const char* SHADER_NAME_LABEL_DISTANCEFIELD_GLOW;
+
+    static const char* SHADER_NAME_LABEL_NORMAL_NO_MVP;
+    static const char* SHADER_NAME_LABEL_OUTLINE_NO_MVP;
+
+    static const char* SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL_NO_MVP;
+    static const char* SHADER_NAME_LABEL_DISTANCEFIELD_GLOW_NO_MVP;
     
     
     // uniform names
@@ -239,10 +245,18 @@ public:
     /** calls glUniformMatrix4fv only if the values are different than the previous call for this same shader program. */
     void setUniformLocationWithMatrix4fv(GLint location, const GLfloat* matrixArray, unsigned int numberOfMatrices);
     
-    /** will update the builtin uniforms if they are different than the previous call for this same shader program. */
+    /** will update the builtin uniforms if they are different than the previous call for this same shader program.
+     The projection, time and random values come from the per frame block of updateBuiltinUniforms(), they are only
+     uploaded when the program hasn't seen them yet. MVP is only computed again when the modelview or the projection changed.
+     */
     void setUniformsForBuiltins();
     void setUniformsForBuiltins(const kmMat4 &modelView);
 
+    /** Computes the builtin uniforms shared by all the programs for the current frame: time, sin/cos time and random values.
+     Called by the Director at the beginning of every frame.
+     */
+    static void updateBuiltinUniforms();
+
     /** returns the vertexShader error log */
     std::string getVertexShaderLog() const;
 
@@ -278,6 +292,10 @@ private:
     GLuint            _fragShader;
     GLint             _uniforms[UNIFORM_MAX];
     struct _hashUniformEntry* _hashForUniforms;
+    // builtin uniforms uploaded last, see setUniformsForBuiltins()
+    unsigned int      _builtinFrameSerial;
+    unsigned int      _builtinProjectionSerial;
+    kmMat4            _builtinMV;
 	bool              _hasShaderCompiler;
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT) || (CC_TARGET_PLATFORM == CC_PLATFORM_WP8)
     std::string       _shaderId;
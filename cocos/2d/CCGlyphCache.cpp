@@ -0,0 +1,591 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "CCGlyphCache.h"
+
+#include <algorithm>
+
+#include "CCFontAtlas.h"
+#include "CCDirector.h"
+#include "CCEventDispatcher.h"
+#include "CCEventListenerCustom.h"
+#include "CCEventType.h"
+
+NS_CC_BEGIN
+
+// empty pixels kept on the right and bottom of each glyph, so that linear filtering doesn't sample its neighbours
+static const int GLYPH_GUTTER = 1;
+// the height of the shelves is rounded up, so that the fonts of close sizes can share them
+static const int SHELF_HEIGHT_STEP = 4;
+
+static GlyphCache* s_sharedGlyphCache = nullptr;
+
+static inline uint64_t glyphKey(FontAtlas* font, unsigned short letter)
+{
+    return (static_cast<uint64_t>(reinterpret_cast<uintptr_t>(font)) << 16) | letter;
+}
+
+/** A page of glyphs, packed on horizontal shelves. The free spans of a shelf are reused by the glyphs that fit in them. */
+class GlyphPage
+{
+public:
+    GlyphPage(Texture2D::PixelFormat format, bool antialias)
+    : _format(format)
+    , _antialias(antialias)
+    , _glyphCount(0)
+    , _shelvesHeight(0)
+    , _dirtyTop(FontAtlas::CacheTextureHeight)
+    , _dirtyBottom(0)
+    {
+        _bytesPerPixel = (format == Texture2D::PixelFormat::AI88) ? 2 : 1;
+        _dataSize = FontAtlas::CacheTextureWidth * FontAtlas::CacheTextureHeight * _bytesPerPixel;
+        _data = new unsigned char[_dataSize];
+        memset(_data, 0, _dataSize);
+
+        _texture = new Texture2D;
+        if (_antialias)
+        {
+            _texture->setAntiAliasTexParameters();
+        }
+        else
+        {
+            _texture->setAliasTexParameters();
+        }
+        reload();
+    }
+
+    ~GlyphPage()
+    {
+        _texture->release();
+        delete [] _data;
+    }
+
+    bool insert(int width, int height, int& outX, int& outY)
+    {
+        // the lowest shelf that is high enough and has a free span wide enough
+        Shelf* bestShelf = nullptr;
+        size_t bestSpan = 0;
+        for (auto& shelf : _shelves)
+        {
+            if (shelf.height < height || (bestShelf && shelf.height >= bestShelf->height))
+                continue;
+
+            for (size_t i = 0; i < shelf.freeSpans.size(); ++i)
+            {
+                if (shelf.freeSpans[i].width >= width)
+                {
+                    bestShelf = &shelf;
+                    bestSpan = i;
+                    break;
+                }
+            }
+        }
+
+        int shelfHeight = std::min((height + SHELF_HEIGHT_STEP - 1) / SHELF_HEIGHT_STEP * SHELF_HEIGHT_STEP, FontAtlas::CacheTextureHeight);
+        bool canAddShelf = _shelvesHeight + shelfHeight <= FontAtlas::CacheTextureHeight && width <= FontAtlas::CacheTextureWidth;
+
+        // don't waste a shelf much higher than the glyph if a new one can be added
+        if (canAddShelf && (bestShelf == nullptr || bestShelf->height > 2 * shelfHeight))
+        {
+            Shelf shelf;
+            shelf.y = _shelvesHeight;
+            shelf.height = shelfHeight;
+            shelf.freeSpans.push_back({0, FontAtlas::CacheTextureWidth});
+            _shelves.push_back(shelf);
+            _shelvesHeight += shelfHeight;
+
+            bestShelf = &_shelves.back();
+            bestSpan = 0;
+        }
+
+        if (bestShelf == nullptr)
+        {
+            return false;
+        }
+
+        auto& span = bestShelf->freeSpans[bestSpan];
+        outX = span.x;
+        outY = bestShelf->y;
+        span.x += width;
+        span.width -= width;
+        if (span.width == 0)
+        {
+            bestShelf->freeSpans.erase(bestShelf->freeSpans.begin() + bestSpan);
+        }
+
+        clear(outX, outY, width, height);
+        ++_glyphCount;
+        return true;
+    }
+
+    void remove(int x, int y, int width)
+    {
+        auto shelfIt = std::find_if(_shelves.begin(), _shelves.end(), [y](const Shelf& shelf){ return shelf.y == y; });
+        CCASSERT(shelfIt != _shelves.end(), "The glyph is not on a shelf of this page");
+
+        // insert the span, sorted by x, and merge it with its neighbours
+        auto& spans = shelfIt->freeSpans;
+        auto it = std::lower_bound(spans.begin(), spans.end(), x, [](const Span& span, int value){ return span.x < value; });
+        it = spans.insert(it, {x, width});
+        if (it + 1 != spans.end() && it->x + it->width == (it + 1)->x)
+        {
+            it->width += (it + 1)->width;
+            spans.erase(it + 1);
+        }
+        if (it != spans.begin() && (it - 1)->x + (it - 1)->width == it->x)
+        {
+            (it - 1)->width += it->width;
+            spans.erase(it);
+        }
+        --_glyphCount;
+
+        // the empty shelves at the top of the page can get another height
+        while (!_shelves.empty())
+        {
+            auto& last = _shelves.back();
+            if (last.freeSpans.size() != 1 || last.freeSpans[0].width != FontAtlas::CacheTextureWidth)
+                break;
+            _shelvesHeight = last.y;
+            _shelves.pop_back();
+        }
+    }
+
+    void upload()
+    {
+        if (_dirtyTop < _dirtyBottom)
+        {
+            int rowSize = FontAtlas::CacheTextureWidth * _bytesPerPixel;
+            _texture->updateWithData(_data + rowSize * _dirtyTop, 0, _dirtyTop, FontAtlas::CacheTextureWidth, _dirtyBottom - _dirtyTop);
+            _dirtyTop = FontAtlas::CacheTextureHeight;
+            _dirtyBottom = 0;
+        }
+    }
+
+    void reload()
+    {
+        _texture->initWithData(_data, _dataSize, _format, FontAtlas::CacheTextureWidth, FontAtlas::CacheTextureHeight,
+            Size(FontAtlas::CacheTextureWidth, FontAtlas::CacheTextureHeight));
+        _dirtyTop = FontAtlas::CacheTextureHeight;
+        _dirtyBottom = 0;
+    }
+
+    Texture2D* getTexture() const { return _texture; }
+    unsigned char* getData() const { return _data; }
+    Texture2D::PixelFormat getFormat() const { return _format; }
+    bool isAntialias() const { return _antialias; }
+    int getGlyphCount() const { return _glyphCount; }
+    int getDataSize() const { return _dataSize; }
+
+private:
+    struct Span
+    {
+        int x;
+        int width;
+    };
+
+    struct Shelf
+    {
+        int y;
+        int height;
+        std::vector<Span> freeSpans;
+    };
+
+    void clear(int x, int y, int width, int height)
+    {
+        int rowSize = FontAtlas::CacheTextureWidth * _bytesPerPixel;
+        for (int row = y; row < y + height; ++row)
+        {
+            memset(_data + row * rowSize + x * _bytesPerPixel, 0, width * _bytesPerPixel);
+        }
+        _dirtyTop = std::min(_dirtyTop, y);
+        _dirtyBottom = std::max(_dirtyBottom, y + height);
+    }
+
+    Texture2D* _texture;
+    Texture2D::PixelFormat _format;
+    bool _antialias;
+    unsigned char* _data;
+    int _dataSize;
+    int _bytesPerPixel;
+    int _glyphCount;
+
+    std::vector<Shelf> _shelves;
+    int _shelvesHeight;
+    int _dirtyTop;
+    int _dirtyBottom;
+};
+
+GlyphCache* GlyphCache::getInstance()
+{
+    if (s_sharedGlyphCache == nullptr)
+    {
+        s_sharedGlyphCache = new GlyphCache();
+    }
+    return s_sharedGlyphCache;
+}
+
+GlyphCache* GlyphCache::getInstanceIfExists()
+{
+    return s_sharedGlyphCache;
+}
+
+void GlyphCache::destroyInstance()
+{
+    CC_SAFE_DELETE(s_sharedGlyphCache);
+}
+
+GlyphCache::GlyphCache()
+: _leastRecentlyUsed(-1)
+, _mostRecentlyUsed(-1)
+, _updateSerial(0)
+, _maxPages(8)
+, _evictionCount(0)
+, _toForegroundListener(nullptr)
+{
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    _toForegroundListener = EventListenerCustom::create(EVENT_COME_TO_FOREGROUND, [this](EventCustom* event){
+        reloadPages();
+    });
+    Director::getInstance()->getEventDispatcher()->addEventListenerWithFixedPriority(_toForegroundListener, 1);
+#endif
+}
+
+GlyphCache::~GlyphCache()
+{
+    if (_toForegroundListener)
+    {
+        Director::getInstance()->getEventDispatcher()->removeEventListener(_toForegroundListener);
+    }
+
+    for (auto& glyph : _glyphs)
+    {
+        if (glyph.font)
+        {
+            glyph.font->removeLetterDefinition(glyph.letter);
+        }
+    }
+    for (auto page : _pages)
+    {
+        delete page;
+    }
+}
+
+GlyphPage* GlyphCache::createPage(Texture2D::PixelFormat format, bool antialias)
+{
+    auto page = new GlyphPage(format, antialias);
+    _pages.push_back(page);
+    return page;
+}
+
+Texture2D* GlyphCache::getFirstPage(Texture2D::PixelFormat format, bool antialias)
+{
+    for (auto page : _pages)
+    {
+        if (page->getFormat() == format && page->isAntialias() == antialias)
+        {
+            return page->getTexture();
+        }
+    }
+    return createPage(format, antialias)->getTexture();
+}
+
+void GlyphCache::beginUpdate()
+{
+    ++_updateSerial;
+}
+
+void GlyphCache::endUpdate()
+{
+    for (auto page : _pages)
+    {
+        page->upload();
+    }
+}
+
+bool GlyphCache::touchGlyph(FontAtlas* font, unsigned short letter)
+{
+    auto it = _glyphIndices.find(glyphKey(font, letter));
+    if (it == _glyphIndices.end())
+    {
+        return false;
+    }
+
+    touch(it->second);
+    return true;
+}
+
+bool GlyphCache::addGlyph(FontAtlas* font, unsigned short letter, Texture2D::PixelFormat format, bool antialias, int width, int height, GlyphSlot& outSlot)
+{
+    CCASSERT(_glyphIndices.find(glyphKey(font, letter)) == _glyphIndices.end(), "The glyph is already cached");
+
+    width += GLYPH_GUTTER;
+    height += GLYPH_GUTTER;
+    if (width > FontAtlas::CacheTextureWidth || height > FontAtlas::CacheTextureHeight)
+    {
+        CCLOG("cocos2d: GlyphCache: the glyph %d of %d x %d pixels is bigger than a page", letter, width, height);
+        return false;
+    }
+
+    int pageIndex = -1;
+    int x = 0;
+    int y = 0;
+
+    // 1. the pages of the same format
+    for (int i = 0; i < (int)_pages.size() && pageIndex < 0; ++i)
+    {
+        if (_pages[i]->getFormat() == format && _pages[i]->isAntialias() == antialias && _pages[i]->insert(width, height, x, y))
+        {
+            pageIndex = i;
+        }
+    }
+
+    // 2. a new page, if the budget allows it
+    if (pageIndex < 0 && (int)_pages.size() < _maxPages)
+    {
+        if (createPage(format, antialias)->insert(width, height, x, y))
+        {
+            pageIndex = (int)_pages.size() - 1;
+        }
+    }
+
+    // 3. evict the least recently used glyphs of the same format, until the glyph fits where they were
+    int candidate = _leastRecentlyUsed;
+    while (pageIndex < 0 && candidate >= 0)
+    {
+        const Glyph& glyph = _glyphs[candidate];
+        int next = glyph.next;
+        auto page = _pages[glyph.page];
+
+        if (glyph.lastUpdate != _updateSerial && page->getFormat() == format && page->isAntialias() == antialias
+            && !glyph.font->isLetterRetained(glyph.letter))
+        {
+            int evictedPage = glyph.page;
+            removeGlyph(candidate);
+            ++_evictionCount;
+
+            if (_pages[evictedPage]->insert(width, height, x, y))
+            {
+                pageIndex = evictedPage;
+            }
+        }
+        candidate = next;
+    }
+
+    // 4. the glyphs in use don't fit in the budget
+    if (pageIndex < 0)
+    {
+        CCLOG("cocos2d: GlyphCache: the glyphs in use need more than %d pages", _maxPages);
+        if (createPage(format, antialias)->insert(width, height, x, y))
+        {
+            pageIndex = (int)_pages.size() - 1;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    int index;
+    if (_freeGlyphs.empty())
+    {
+        index = (int)_glyphs.size();
+        _glyphs.push_back(Glyph());
+    }
+    else
+    {
+        index = _freeGlyphs.back();
+        _freeGlyphs.pop_back();
+    }
+
+    Glyph& glyph = _glyphs[index];
+    glyph.font = font;
+    glyph.letter = letter;
+    glyph.page = pageIndex;
+    glyph.x = x;
+    glyph.y = y;
+    glyph.width = width;
+    glyph.height = height;
+    glyph.previous = glyph.next = -1;
+    _glyphIndices[glyphKey(font, letter)] = index;
+    touch(index);
+
+    outSlot.texture = _pages[pageIndex]->getTexture();
+    outSlot.pageData = _pages[pageIndex]->getData();
+    outSlot.x = x;
+    outSlot.y = y;
+    return true;
+}
+
+void GlyphCache::touch(int index)
+{
+    Glyph& glyph = _glyphs[index];
+    glyph.lastUpdate = _updateSerial;
+
+    if (_mostRecentlyUsed == index)
+    {
+        return;
+    }
+    if (glyph.previous >= 0 || glyph.next >= 0 || _leastRecentlyUsed == index)
+    {
+        unlink(index);
+    }
+
+    glyph.previous = _mostRecentlyUsed;
+    glyph.next = -1;
+    if (_mostRecentlyUsed >= 0)
+    {
+        _glyphs[_mostRecentlyUsed].next = index;
+    }
+    _mostRecentlyUsed = index;
+    if (_leastRecentlyUsed < 0)
+    {
+        _leastRecentlyUsed = index;
+    }
+}
+
+void GlyphCache::unlink(int index)
+{
+    Glyph& glyph = _glyphs[index];
+    if (glyph.previous >= 0)
+    {
+        _glyphs[glyph.previous].next = glyph.next;
+    }
+    else
+    {
+        _leastRecentlyUsed = glyph.next;
+    }
+
+    if (glyph.next >= 0)
+    {
+        _glyphs[glyph.next].previous = glyph.previous;
+    }
+    else
+    {
+        _mostRecentlyUsed = glyph.previous;
+    }
+    glyph.previous = glyph.next = -1;
+}
+
+void GlyphCache::removeGlyph(int index)
+{
+    Glyph& glyph = _glyphs[index];
+
+    unlink(index);
+    _pages[glyph.page]->remove(glyph.x, glyph.y, glyph.width);
+    _glyphIndices.erase(glyphKey(glyph.font, glyph.letter));
+    glyph.font->removeLetterDefinition(glyph.letter);
+
+    glyph.font = nullptr;
+    _freeGlyphs.push_back(index);
+}
+
+void GlyphCache::removeGlyphs(FontAtlas* font, bool unusedOnly)
+{
+    for (int i = 0; i < (int)_glyphs.size(); ++i)
+    {
+        if (_glyphs[i].font == font && !(unusedOnly && font->isLetterRetained(_glyphs[i].letter)))
+        {
+            removeGlyph(i);
+        }
+    }
+}
+
+void GlyphCache::removeUnusedPages()
+{
+    std::vector<int> remap(_pages.size(), -1);
+    std::vector<GlyphPage*> pages;
+
+    for (size_t i = 0; i < _pages.size(); ++i)
+    {
+        auto page = _pages[i];
+        bool firstOfFormat = std::none_of(pages.begin(), pages.end(), [page](GlyphPage* kept){
+            return kept->getFormat() == page->getFormat() && kept->isAntialias() == page->isAntialias();
+        });
+
+        // the texture can still be retained by a font atlas or a label
+        if (page->getGlyphCount() > 0 || firstOfFormat || page->getTexture()->getReferenceCount() > 1)
+        {
+            remap[i] = (int)pages.size();
+            pages.push_back(page);
+        }
+        else
+        {
+            delete page;
+        }
+    }
+
+    for (auto& glyph : _glyphs)
+    {
+        if (glyph.font)
+        {
+            glyph.page = remap[glyph.page];
+        }
+    }
+    _pages.swap(pages);
+}
+
+ssize_t GlyphCache::getTextureMemory() const
+{
+    ssize_t bytes = 0;
+    for (auto page : _pages)
+    {
+        bytes += page->getDataSize();
+    }
+    return bytes;
+}
+
+std::string GlyphCache::getCachedGlyphInfo() const
+{
+    std::string buffer;
+    char buftmp[256];
+
+    for (size_t i = 0; i < _pages.size(); ++i)
+    {
+        auto page = _pages[i];
+        snprintf(buftmp, sizeof(buftmp)-1, "page %lu id=%lu %s%s: %d glyphs => %lu KB\n",
+                 (long)i,
+                 (long)page->getTexture()->getName(),
+                 page->getFormat() == Texture2D::PixelFormat::AI88 ? "AI88" : "A8",
+                 page->isAntialias() ? "" : " alias",
+                 page->getGlyphCount(),
+                 (long)page->getDataSize() / 1024);
+        buffer += buftmp;
+    }
+
+    snprintf(buftmp, sizeof(buftmp)-1, "GlyphCache: %d glyphs in %d pages, %u evicted, for a total of %.2f MB\n",
+             getGlyphCount(), getPageCount(), _evictionCount, getTextureMemory() / (1024.0f * 1024.0f));
+    buffer += buftmp;
+
+    return buffer;
+}
+
+void GlyphCache::reloadPages()
+{
+    for (auto page : _pages)
+    {
+        page->reload();
+    }
+}
+
+NS_CC_END
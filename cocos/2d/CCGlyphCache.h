@@ -0,0 +1,156 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef _CCGlyphCache_h_
+#define _CCGlyphCache_h_
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "CCPlatformMacros.h"
+#include "CCTexture2D.h"
+
+NS_CC_BEGIN
+
+class FontAtlas;
+class EventListenerCustom;
+class GlyphPage;
+
+/** Glyph pages shared by all the dynamic TTF fonts.
+ The glyphs are packed on shelves of pages of FontAtlas::CacheTextureWidth x FontAtlas::CacheTextureHeight.
+ The fonts using the same pixel format and texture filtering share their pages, whatever their name and size.
+ When the pages are full, the least recently used glyphs that are not retained by a label are evicted.
+ @since v3.0
+ */
+class CC_DLL GlyphCache
+{
+public:
+    /** Where a glyph was placed */
+    struct GlyphSlot
+    {
+        Texture2D* texture;
+        /** pixels of the whole page, a row is FontAtlas::CacheTextureWidth pixels */
+        unsigned char* pageData;
+        int x;
+        int y;
+    };
+
+    /** returns the shared instance */
+    static GlyphCache* getInstance();
+
+    /** returns the shared instance, or nullptr if it doesn't exist. It is never created. */
+    static GlyphCache* getInstanceIfExists();
+
+    /** purges the cache. It releases the pages */
+    static void destroyInstance();
+
+    /** Returns the first page of the fonts using the given format and texture filtering. It is created if needed. */
+    Texture2D* getFirstPage(Texture2D::PixelFormat format, bool antialias);
+
+    /** Starts an update of the glyphs of a string. The glyphs touched or added until endUpdate()
+     are not evicted to make room for the other glyphs of the update. */
+    void beginUpdate();
+
+    /** Uploads the rows of the pages modified since beginUpdate() */
+    void endUpdate();
+
+    /** Marks the glyph of a letter as recently used. Returns false if it is not cached. */
+    bool touchGlyph(FontAtlas* font, unsigned short letter);
+
+    /** Reserves a rect of width x height pixels for the glyph of a letter. The rect is cleared, the caller renders the glyph in it.
+     Returns false if the glyph is bigger than a page.
+     */
+    bool addGlyph(FontAtlas* font, unsigned short letter, Texture2D::PixelFormat format, bool antialias, int width, int height, GlyphSlot& outSlot);
+
+    /** Removes the glyphs of a font. If unusedOnly is true, the glyphs retained by a label are kept. */
+    void removeGlyphs(FontAtlas* font, bool unusedOnly);
+
+    /** Releases the pages without glyphs whose texture is not used anymore. The first page of each format is kept. */
+    void removeUnusedPages();
+
+    /** Sets the number of pages that can be allocated before evicting glyphs. Default is 8.
+     More pages are allocated if the glyphs retained by the labels don't fit.
+     */
+    void setMaxPages(int maxPages) { _maxPages = maxPages; }
+    int getMaxPages() const { return _maxPages; }
+
+    int getPageCount() const { return static_cast<int>(_pages.size()); }
+    int getGlyphCount() const { return static_cast<int>(_glyphIndices.size()); }
+
+    /** Number of glyphs evicted to make room for other ones */
+    unsigned int getEvictionCount() const { return _evictionCount; }
+
+    /** Memory used by the textures of the pages, in bytes. The pages keep a copy of their pixels of the same size. */
+    ssize_t getTextureMemory() const;
+
+    /** Output to CCLOG the current contents of this GlyphCache
+     * This will attempt to calculate the size of each page
+     */
+    std::string getCachedGlyphInfo() const;
+
+    /** Uploads again the pixels of the pages. It is used when the GL context is recreated. */
+    void reloadPages();
+
+protected:
+    GlyphCache();
+    ~GlyphCache();
+
+    struct Glyph
+    {
+        FontAtlas* font;
+        unsigned short letter;
+        int page;
+        int x;
+        int y;
+        int width;
+        int height;
+        unsigned int lastUpdate;
+        // least recently used list
+        int previous;
+        int next;
+    };
+
+    GlyphPage* createPage(Texture2D::PixelFormat format, bool antialias);
+    void removeGlyph(int index);
+    void touch(int index);
+    void unlink(int index);
+
+    std::vector<GlyphPage*> _pages;
+    std::vector<Glyph> _glyphs;
+    std::vector<int> _freeGlyphs;
+    std::unordered_map<uint64_t, int> _glyphIndices;
+    int _leastRecentlyUsed;
+    int _mostRecentlyUsed;
+
+    unsigned int _updateSerial;
+    int _maxPages;
+    unsigned int _evictionCount;
+
+    EventListenerCustom* _toForegroundListener;
+};
+
+NS_CC_END
+
+#endif /* _CCGlyphCache_h_ */
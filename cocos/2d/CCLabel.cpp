@@ -237,7 +237,8 @@ bool Label::setCharMap(const std::string& charMapFile, int itemWidth, int itemHe
 
 Label::Label(FontAtlas *atlas /* = nullptr */, TextHAlignment hAlignment /* = TextHAlignment::LEFT */, 
              TextVAlignment vAlignment /* = TextVAlignment::TOP */,bool useDistanceField /* = false */,bool useA8Shader /* = false */)
-: _reusedLetter(nullptr)
+: _glyphsReadyListener(nullptr)
+, _reusedLetter(nullptr)
 , _commonLineHeight(0.0f)
 , _lineBreakWithoutSpaces(false)
 , _maxLineWidth(0)
@@ -258,6 +259,8 @@ Label::Label(FontAtlas *atlas /* = nullptr */, TextHAlignment hAlignment /* = Te
 , _currNumLines(-1)
 , _textSprite(nullptr)
 , _contentDirty(false)
+, _layoutDirty(true)
+, _lineWrapped(false)
 , _shadowDirty(false)
 , _compatibleMode(false)
 {
@@ -290,8 +293,14 @@ Label::~Label()
     delete [] _originalUTF16String;
     delete [] _horizontalKernings;
 
+    if (_glyphsReadyListener)
+    {
+        _eventDispatcher->removeEventListener(_glyphsReadyListener);
+    }
+
     if (_fontAtlas)
     {
+        releaseRetainedLetters();
         FontAtlasCache::releaseFontAtlas(_fontAtlas);
     }
 
@@ -312,6 +321,7 @@ void Label::reset()
 
     if (_fontAtlas)
     {
+        releaseRetainedLetters();
         FontAtlasCache::releaseFontAtlas(_fontAtlas);
         _fontAtlas = nullptr;
     }
@@ -319,6 +329,7 @@ void Label::reset()
     _currentLabelType = LabelType::STRING_TEXTURE;
     _currLabelEffect = LabelEffect::NORMAL;
     _shadowBlurRadius = 0;
+    updateGlyphsReadyListener();
 
     Node::removeAllChildrenWithCleanup(true);
     _textSprite = nullptr;
@@ -337,25 +348,27 @@ void Label::reset()
 
 void Label::updateShaderProgram()
 {
+    // The glyph quads are drawn by QuadCommand, which moves them to world space on the CPU,
+    // so the label must use the shaders without the MV matrix.
     switch (_currLabelEffect)
     {
     case cocos2d::LabelEffect::NORMAL:
         if (_useDistanceField)
-            setShaderProgram(ShaderCache::getInstance()->getProgram(GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL));
+            setShaderProgram(ShaderCache::getInstance()->getProgram(GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL_NO_MVP));
         else if (_useA8Shader)
-            setShaderProgram(ShaderCache::getInstance()->getProgram(GLProgram::SHADER_NAME_LABEL_NORMAL));
+            setShaderProgram(ShaderCache::getInstance()->getProgram(GLProgram::SHADER_NAME_LABEL_NORMAL_NO_MVP));
         else
-            setShaderProgram(ShaderCache::getInstance()->getProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR));
+            setShaderProgram(ShaderCache::getInstance()->getProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP));
 
         break;
     case cocos2d::LabelEffect::OUTLINE: 
-        setShaderProgram(ShaderCache::getInstance()->getProgram(GLProgram::SHADER_NAME_LABEL_OUTLINE));
+        setShaderProgram(ShaderCache::getInstance()->getProgram(GLProgram::SHADER_NAME_LABEL_OUTLINE_NO_MVP));
         _uniformEffectColor = glGetUniformLocation(_shaderProgram->getProgram(), "v_effectColor");
         break;
     case cocos2d::LabelEffect::GLOW:
         if (_useDistanceField)
         {
-            setShaderProgram(ShaderCache::getInstance()->getProgram(GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_GLOW));
+            setShaderProgram(ShaderCache::getInstance()->getProgram(GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_GLOW_NO_MVP));
             _uniformEffectColor = glGetUniformLocation(_shaderProgram->getProgram(), "v_effectColor");
         }
         break;
@@ -371,11 +384,13 @@ void Label::setFontAtlas(FontAtlas* atlas,bool distanceFieldEnabled /* = false *
     if (atlas == _fontAtlas)
     {
         FontAtlasCache::releaseFontAtlas(atlas);
+        updateGlyphsReadyListener();
         return;
     }
 
     if (_fontAtlas)
     {
+        releaseRetainedLetters();
         FontAtlasCache::releaseFontAtlas(_fontAtlas);
         _fontAtlas = nullptr;
     }
@@ -408,6 +423,7 @@ void Label::setFontAtlas(FontAtlas* atlas,bool distanceFieldEnabled /* = false *
     {
         _commonLineHeight = _fontAtlas->getCommonLineHeight();
         _contentDirty = true;
+        _layoutDirty = true;
     }
     _useDistanceField = distanceFieldEnabled;
     _useA8Shader = useA8Shader;
@@ -417,6 +433,30 @@ void Label::setFontAtlas(FontAtlas* atlas,bool distanceFieldEnabled /* = false *
         _currLabelEffect = LabelEffect::NORMAL;
         updateShaderProgram();
     }
+    updateGlyphsReadyListener();
+}
+
+void Label::updateGlyphsReadyListener()
+{
+    // only the TTF atlases load their glyphs in the background
+    if (_fontAtlas && _currentLabelType == LabelType::TTF && FontAtlas::isAsyncGlyphLoadingEnabled())
+    {
+        if (_glyphsReadyListener == nullptr)
+        {
+            _glyphsReadyListener = EventListenerCustom::create(FontAtlas::EVENT_GLYPHS_READY, [this](EventCustom* event){
+                if (event->getUserData() == _fontAtlas)
+                {
+                    alignText();
+                }
+            });
+            _eventDispatcher->addEventListenerWithFixedPriority(_glyphsReadyListener, 1);
+        }
+    }
+    else if (_glyphsReadyListener)
+    {
+        _eventDispatcher->removeEventListener(_glyphsReadyListener);
+        _glyphsReadyListener = nullptr;
+    }
 }
 
 bool Label::setTTFConfig(const TTFConfig& ttfConfig)
@@ -472,6 +512,11 @@ bool Label::setBMFontFilePath(const std::string& bmfontFilePath, const Point& im
 
 void Label::setString(const std::string& text)
 {
+    if (text == _originalUTF8String)
+    {
+        return;
+    }
+
     _originalUTF8String = text;
     _contentDirty = true;
 }
@@ -484,6 +529,7 @@ void Label::setAlignment(TextHAlignment hAlignment,TextVAlignment vAlignment)
         _vAlignment = vAlignment;
 
         _contentDirty = true;
+        _layoutDirty = true;
     }
 }
 
@@ -493,6 +539,7 @@ void Label::setMaxLineWidth(unsigned int maxLineWidth)
     {
         _maxLineWidth = maxLineWidth;
         _contentDirty = true;
+        _layoutDirty = true;
     }
 }
 
@@ -507,6 +554,7 @@ void Label::setDimensions(unsigned int width,unsigned int height)
 
         _maxLineWidth = width;
         _contentDirty = true;
+        _layoutDirty = true;
     }  
 }
 
@@ -515,7 +563,8 @@ void Label::setLineBreakWithoutSpace(bool breakWithoutSpace)
     if (breakWithoutSpace != _lineBreakWithoutSpaces)
     {
         _lineBreakWithoutSpaces = breakWithoutSpace;
-        _contentDirty = true;     
+        _contentDirty = true;
+        _layoutDirty = true;
     }
 }
 
@@ -582,25 +631,22 @@ void Label::alignText()
         batchNode->getTextureAtlas()->removeAllQuads();
     }
     _fontAtlas->prepareLetterDefinitions(_currentUTF16String);
-    auto textures = _fontAtlas->getTextures();
-    if (textures.size() > _batchNodes.size())
-    {
-        for (auto index = _batchNodes.size(); index < textures.size(); ++index)
-        {
-            auto batchNode = SpriteBatchNode::createWithTexture(textures[index]);
-            batchNode->setAnchorPoint(Point::ANCHOR_TOP_LEFT);
-            batchNode->setPosition(Point::ZERO);
-            Node::addChild(batchNode,0,Node::INVALID_TAG);
-            _batchNodes.push_back(batchNode);
-        }
-    }
+    updateRetainedLetters();
+
+    updateBatchNodes();
+
     LabelTextFormatter::createStringSprites(this);    
-    if(_maxLineWidth > 0 && _contentSize.width > _maxLineWidth && LabelTextFormatter::multilineText(this) )      
+    _lineWrapped = false;
+    if(_maxLineWidth > 0 && _contentSize.width > _maxLineWidth && LabelTextFormatter::multilineText(this) )
+    {
         LabelTextFormatter::createStringSprites(this);
+        _lineWrapped = true;
+    }
 
     if(_labelWidth > 0 || (_currNumLines > 1 && _hAlignment != TextHAlignment::LEFT))
         LabelTextFormatter::alignText(this);
 
+    auto textures = _fontAtlas->getTextures();
     int strLen = cc_wcslen(_currentUTF16String);
     Rect uvRect;
     Sprite* letterSprite;
@@ -629,6 +675,149 @@ void Label::alignText()
     updateQuads();
 
     updateColor();
+
+    _layoutDirty = false;
+}
+
+void Label::updateBatchNodes()
+{
+    auto textures = _fontAtlas->getTextures();
+    // the texture of a slot changes when the font atlas is purged
+    for (size_t index = 0; index < _batchNodes.size() && index < textures.size(); ++index)
+    {
+        if (_batchNodes[index]->getTexture() != textures[index])
+        {
+            _batchNodes[index]->setTexture(textures[index]);
+        }
+    }
+    if (textures.size() > _batchNodes.size())
+    {
+        for (auto index = _batchNodes.size(); index < textures.size(); ++index)
+        {
+            auto batchNode = SpriteBatchNode::createWithTexture(textures[index]);
+            batchNode->setAnchorPoint(Point::ANCHOR_TOP_LEFT);
+            batchNode->setPosition(Point::ZERO);
+            Node::addChild(batchNode,0,Node::INVALID_TAG);
+            _batchNodes.push_back(batchNode);
+        }
+    }
+}
+
+bool Label::updateChangedLetters(unsigned short *utf16String)
+{
+    // only the string changed since the last layout, and the letters of its unchanged prefix can't move:
+    // no line is wrapped, aligned or clipped, and the number of lines is the same
+    if (_layoutDirty || _fontAtlas == nullptr || _textSprite || _lineWrapped || _clipEnabled || _labelWidth > 0
+        || _currentUTF16String == nullptr || _horizontalKernings == nullptr
+        || (_currNumLines > 1 && _hAlignment != TextHAlignment::LEFT))
+    {
+        return false;
+    }
+    for (const auto &child : _children)
+    {
+        // the sprites returned by getLetter() are updated by alignText()
+        if (child->getTag() >= 0)
+        {
+            return false;
+        }
+    }
+
+    int newLength = cc_wcslen(utf16String);
+    int prefixLength = 0;
+    int newNumLines = 1;
+    for (int i = 0; i < newLength; ++i)
+    {
+        if (prefixLength == i && utf16String[i] == _currentUTF16String[i])
+        {
+            ++prefixLength;
+        }
+        if (utf16String[i] == '\n' && i < newLength - 1)
+        {
+            ++newNumLines;
+        }
+    }
+
+    // the kerning of a letter may depend on the next one, the last letter of the prefix is laid out again
+    int startIndex = prefixLength - 1;
+    if (startIndex < 1 || startIndex >= _limitShowCount || newNumLines != _currNumLines)
+    {
+        return false;
+    }
+
+    // kernings of the changed letters, the ones of the prefix are kept
+    int kerningStart = startIndex - 1;
+    int letterCount = 0;
+    int *changedKernings = _fontAtlas->getFont()->getHorizontalKerningForTextUTF16(utf16String + kerningStart, letterCount);
+    if (changedKernings == nullptr)
+    {
+        return false;
+    }
+
+    int *kernings = new int[newLength];
+    memcpy(kernings, _horizontalKernings, (kerningStart + 1) * sizeof(int));
+    memcpy(kernings + startIndex, changedKernings + 1, (letterCount - 1) * sizeof(int));
+    delete [] changedKernings;
+    delete [] _horizontalKernings;
+    _horizontalKernings = kernings;
+
+    delete [] _currentUTF16String;
+    _currentUTF16String = utf16String;
+    setOriginalString(utf16String);
+
+    _fontAtlas->prepareLetterDefinitions(_currentUTF16String);
+    updateRetainedLetters();
+    updateBatchNodes();
+
+    // keeps the quads of the prefix, they are the first ones of their batch node
+    std::vector<ssize_t> keptQuads(_batchNodes.size(), 0);
+    for (int i = 0; i < startIndex; ++i)
+    {
+        if (_lettersInfo[i].def.validDefinition)
+        {
+            ++keptQuads[_lettersInfo[i].def.textureID];
+        }
+    }
+    for (size_t index = 0; index < _batchNodes.size(); ++index)
+    {
+        auto textureAtlas = _batchNodes[index]->getTextureAtlas();
+        auto removedQuads = textureAtlas->getTotalQuads() - keptQuads[index];
+        if (removedQuads > 0)
+        {
+            textureAtlas->removeQuadsAtIndex(keptQuads[index], removedQuads);
+        }
+    }
+
+    LabelTextFormatter::createStringSprites(this, startIndex);
+    if (_maxLineWidth > 0 && _contentSize.width > _maxLineWidth)
+    {
+        // the new letters need the lines to be wrapped
+        alignText();
+        return true;
+    }
+
+    updateQuads(startIndex);
+    updateColor();
+
+    return true;
+}
+
+void Label::updateRetainedLetters()
+{
+    std::vector<unsigned short> letters(_currentUTF16String, _currentUTF16String + cc_wcslen(_currentUTF16String) + 1);
+
+    // retain before releasing, so that the letters of both strings are not evicted in between
+    _fontAtlas->retainLetters(letters.data());
+    releaseRetainedLetters();
+    _retainedLetters.swap(letters);
+}
+
+void Label::releaseRetainedLetters()
+{
+    if (_fontAtlas && !_retainedLetters.empty())
+    {
+        _fontAtlas->releaseLetters(_retainedLetters.data());
+    }
+    _retainedLetters.clear();
 }
 
 bool Label::computeHorizontalKernings(unsigned short int *stringToRender)
@@ -683,10 +872,10 @@ bool Label::setCurrentString(unsigned short *stringToSet)
     return true;
 }
 
-void Label::updateQuads()
+void Label::updateQuads(int startIndex /* = 0 */)
 {
     int index;
-    for (int ctr = 0; ctr < _limitShowCount; ++ctr)
+    for (int ctr = startIndex; ctr < _limitShowCount; ++ctr)
     {
         auto &letterDef = _lettersInfo[ctr].def;
 
@@ -784,6 +973,7 @@ void Label::enableOutline(const Color4B& outlineColor,int outlineSize /* = -1 */
 
         _currLabelEffect = LabelEffect::OUTLINE;
         _contentDirty = true;
+        _layoutDirty = true;
     }
 }
 
@@ -821,6 +1011,7 @@ void Label::disableEffect()
     _currLabelEffect = LabelEffect::NORMAL;
     updateShaderProgram();
     _contentDirty = true;
+    _layoutDirty = true;
     _shadowEnabled = false;
     if (_shadowNode)
     {
@@ -835,37 +1026,59 @@ void Label::setFontScale(float fontScale)
     Node::setScale(_fontScale);
 }
 
-void Label::onDraw(const kmMat4& transform, bool transformUpdated)
+void Label::updateShadowQuads()
 {
-    CC_PROFILER_START("Label - draw");
-
-    // Optimization: Fast Dispatch
-    if( _batchNodes.size() == 1 && _textureAtlas->getTotalQuads() == 0 )
+    Color3B parentColor = Color3B::WHITE;
+    if (_parent && _parent->isCascadeColorEnabled())
     {
-        return;
+        parentColor = _parent->getDisplayedColor();
     }
 
-    _shaderProgram->use();
-    GL::blendFunc( _blendFunc.src, _blendFunc.dst );
+    GLubyte opacity = _shadowOpacity * _displayedOpacity;
+    Color4B color4( _shadowColor.r * parentColor.r/255.0f, _shadowColor.g * parentColor.g/255.0f, _shadowColor.b * parentColor.b/255.0f, opacity );
 
-    if (_currentLabelType == LabelType::TTF)
+    // special opacity for premultiplied textures
+    if (_isOpacityModifyRGB)
     {
-        _shaderProgram->setUniformLocationWith4f(_uniformTextColor, 
-            _textColorF.r,_textColorF.g,_textColorF.b,_textColorF.a);
+        color4.r *= opacity/255.0f;
+        color4.g *= opacity/255.0f;
+        color4.b *= opacity/255.0f;
     }
 
-    if (_currLabelEffect == LabelEffect::OUTLINE || _currLabelEffect == LabelEffect::GLOW)
+    ssize_t totalQuads = 0;
+    for (const auto& batchNode:_batchNodes)
     {
-         _shaderProgram->setUniformLocationWith4f(_uniformEffectColor, 
-             _effectColorF.r,_effectColorF.g,_effectColorF.b,_effectColorF.a);
+        totalQuads += batchNode->getTextureAtlas()->getTotalQuads();
     }
+    _shadowQuads.resize(totalQuads);
 
-    if(_shadowEnabled && _shadowBlurRadius <= 0)
+    auto shadowQuad = _shadowQuads.data();
+    for (const auto& batchNode:_batchNodes)
     {
-        drawShadowWithoutBlur();
+        auto textureAtlas = batchNode->getTextureAtlas();
+        auto quads = textureAtlas->getQuads();
+        auto count = textureAtlas->getTotalQuads();
+
+        for (ssize_t index = 0; index < count; ++index, ++shadowQuad)
+        {
+            *shadowQuad = quads[index];
+            shadowQuad->bl.colors = color4;
+            shadowQuad->br.colors = color4;
+            shadowQuad->tl.colors = color4;
+            shadowQuad->tr.colors = color4;
+        }
     }
+}
 
-    _shaderProgram->setUniformsForBuiltins(transform);
+void Label::draw(Renderer *renderer, const kmMat4 &transform, bool transformUpdated)
+{
+    // Optimization: Fast Dispatch
+    if( _batchNodes.size() == 1 && _textureAtlas->getTotalQuads() == 0 )
+    {
+        return;
+    }
+
+    CC_PROFILER_START("Label - draw");
 
     for(const auto &child: _children)
     {
@@ -873,45 +1086,75 @@ void Label::onDraw(const kmMat4& transform, bool transformUpdated)
             child->updateTransform();
     }
 
-    for (const auto& batchNode:_batchNodes)
+    // The text and effect colors are uniforms of the label shaders. They are part of the material,
+    // so labels using the same font, shader and colors are batched together and with the sprites around them.
+    GLint uniformLocations[QuadCommand::MAX_MATERIAL_UNIFORMS];
+    Color4F uniformValues[QuadCommand::MAX_MATERIAL_UNIFORMS];
+    int uniformCount = 0;
+
+    if (_currentLabelType == LabelType::TTF && (GLint)_uniformTextColor >= 0)
     {
-        batchNode->getTextureAtlas()->drawQuads();
+        uniformLocations[uniformCount] = _uniformTextColor;
+        uniformValues[uniformCount++] = _textColorF;
     }
 
-    CC_PROFILER_STOP("Label - draw");
-}
+    if ((_currLabelEffect == LabelEffect::OUTLINE || _currLabelEffect == LabelEffect::GLOW) && (GLint)_uniformEffectColor >= 0)
+    {
+        uniformLocations[uniformCount] = _uniformEffectColor;
+        uniformValues[uniformCount++] = _effectColorF;
+    }
 
-void Label::drawShadowWithoutBlur()
-{
-    Color3B oldColor = _realColor;
-    GLubyte oldOPacity = _displayedOpacity;
-    _displayedOpacity = _shadowOpacity * _displayedOpacity;
-    setColor(_shadowColor);
+    bool drawShadow = _shadowEnabled && _shadowBlurRadius <= 0;
+    if (drawShadow)
+    {
+        updateShadowQuads();
+    }
 
-    _shaderProgram->setUniformsForBuiltins(_shadowTransform);
-    for(const auto &child: _children)
+    size_t commandCount = _batchNodes.size() * (drawShadow ? 2 : 1);
+    if (_quadCommands.size() < commandCount)
     {
-        child->updateTransform();
+        _quadCommands.resize(commandCount);
     }
+
+    size_t commandIndex = 0;
+    if (drawShadow)
+    {
+        auto shadowQuads = _shadowQuads.data();
+        for (const auto& batchNode:_batchNodes)
+        {
+            auto textureAtlas = batchNode->getTextureAtlas();
+            auto count = textureAtlas->getTotalQuads();
+            if (count > 0)
+            {
+                auto& command = _quadCommands[commandIndex++];
+                command.init(_globalZOrder, textureAtlas->getTexture()->getName(), _shaderProgram, _blendFunc, shadowQuads, count, _shadowTransform,
+                             uniformLocations, uniformValues, uniformCount);
+                renderer->addCommand(&command);
+            }
+            shadowQuads += count;
+        }
+    }
+
     for (const auto& batchNode:_batchNodes)
     {
-        batchNode->getTextureAtlas()->drawQuads();
+        auto textureAtlas = batchNode->getTextureAtlas();
+        auto count = textureAtlas->getTotalQuads();
+        if (count > 0)
+        {
+            auto& command = _quadCommands[commandIndex++];
+            command.init(_globalZOrder, textureAtlas->getTexture()->getName(), _shaderProgram, _blendFunc, textureAtlas->getQuads(), count, transform,
+                         uniformLocations, uniformValues, uniformCount);
+            renderer->addCommand(&command);
+        }
     }
-    
-    _displayedOpacity = oldOPacity;
-    setColor(oldColor);
-}
 
-void Label::draw(Renderer *renderer, const kmMat4 &transform, bool transformUpdated)
-{
-    _customCommand.init(_globalZOrder);
-    _customCommand.func = CC_CALLBACK_0(Label::onDraw, this, transform, transformUpdated);
-    renderer->addCommand(&_customCommand);
+    CC_PROFILER_STOP("Label - draw");
 }
 
 void Label::createSpriteWithFontDefinition()
 {
     _currentLabelType = LabelType::STRING_TEXTURE;
+    updateGlyphsReadyListener();
 
     auto texture = new Texture2D;
     texture->initWithString(_originalUTF8String.c_str(),_fontDefinition);
@@ -951,6 +1194,12 @@ void Label::setFontDefinition(const FontDefinition& textDefinition)
 void Label::updateContent()
 {
     auto utf16String = cc_utf8_to_utf16(_originalUTF8String.c_str());
+    if (updateChangedLetters(utf16String))
+    {
+        _contentDirty = false;
+        return;
+    }
+
     setCurrentString(utf16String);
     setOriginalString(utf16String);
 
@@ -1022,11 +1271,13 @@ void Label::updateFont()
         _batchNodes.clear();
         _batchNodes.push_back(this);
 
+        releaseRetainedLetters();
         FontAtlasCache::releaseFontAtlas(_fontAtlas);
         _fontAtlas = nullptr;
     }
 
     _contentDirty = true;
+    _layoutDirty = true;
     _fontDirty = false;
 }
 
@@ -29,7 +29,7 @@
 
 #include "CCSpriteBatchNode.h"
 #include "ccTypes.h"
-#include "renderer/CCCustomCommand.h"
+#include "renderer/CCQuadCommand.h"
 #include "CCFontAtlas.h"
 
 NS_CC_BEGIN
@@ -204,7 +204,7 @@ public:
 
     /** clip upper and lower margin for reduce height of label.
      */
-    void setClipMarginEnabled(bool clipEnabled) { _clipEnabled = clipEnabled; }
+    void setClipMarginEnabled(bool clipEnabled) { _clipEnabled = clipEnabled; _layoutDirty = true; }
     bool isClipMarginEnabled() const { return _clipEnabled; }
     // font related stuff
     int getCommonLineHeight() const;
@@ -248,8 +248,6 @@ public:
     CC_DEPRECATED_ATTRIBUTE const FontDefinition& getFontDefinition() const { return _fontDefinition; }
 
 protected:
-    void onDraw(const kmMat4& transform, bool transformUpdated);
-
     struct LetterInfo
     {
         FontLetterDefinition def;
@@ -258,6 +256,14 @@ protected:
         Size  contentSize;
         int   atlasIndex;
     };
+    // pen of LabelTextFormatter::createStringSprites() before it lays out a letter
+    struct LayoutPen
+    {
+        int x;
+        int y;
+        int lineIndex;
+        int longestLine;
+    };
     enum class LabelType {
 
         TTF,
@@ -291,13 +297,25 @@ protected:
     bool setOriginalString(unsigned short *stringToSet);
     void computeStringNumLines();
 
-    void updateQuads();
+    void updateQuads(int startIndex = 0);
+    void updateBatchNodes();
+
+    /** lays out again the letters after the prefix shared with the previous string, takes the ownership of the string.
+     Returns false when the whole string must be laid out again */
+    bool updateChangedLetters(unsigned short *utf16String);
+
+    /** keeps the glyphs of the current string in the glyph pages shared by the fonts */
+    void updateRetainedLetters();
+    void releaseRetainedLetters();
 
     virtual void updateColor() override;
 
     virtual void updateShaderProgram();
 
-    void drawShadowWithoutBlur();
+    void updateShadowQuads();
+
+    /** listens to the glyphs loaded in the background only while an async TTF atlas is set */
+    void updateGlyphsReadyListener();
 
     void drawTextSprite(Renderer *renderer, bool parentTransformUpdated);
 
@@ -310,6 +328,9 @@ protected:
 
     bool _isOpacityModifyRGB;
     bool _contentDirty;
+    // something else than the string changed since the last layout
+    bool _layoutDirty;
+    bool _lineWrapped;
 
     bool _fontDirty;
     std::string _systemFont;
@@ -319,6 +340,10 @@ protected:
     std::vector<SpriteBatchNode*> _batchNodes;
     FontAtlas *                   _fontAtlas;
     std::vector<LetterInfo>       _lettersInfo;
+    std::vector<LayoutPen>        _layoutPens;
+    std::vector<unsigned short>   _retainedLetters;
+    // fixed priority, so that the labels out of the running scene are laid out again too
+    EventListenerCustom*          _glyphsReadyListener;
 
     TTFConfig _fontConfig;
 
@@ -359,7 +384,7 @@ protected:
 
     GLuint _uniformEffectColor;
     GLuint _uniformTextColor;
-    CustomCommand _customCommand;   
+    std::vector<QuadCommand> _quadCommands;
 
     bool    _shadowDirty;
     bool    _shadowEnabled;
@@ -369,6 +394,7 @@ protected:
     Color3B _shadowColor;
     float   _shadowOpacity;
     Sprite*   _shadowNode;
+    std::vector<V3F_C4B_T2F_Quad> _shadowQuads;
 
     int     _outlineSize;
 
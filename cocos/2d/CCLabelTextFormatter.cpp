@@ -271,11 +271,11 @@ bool LabelTextFormatter::alignText(Label *theLabel)
     return true;
 }
 
-bool LabelTextFormatter::createStringSprites(Label *theLabel)
+bool LabelTextFormatter::createStringSprites(Label *theLabel, int startIndex /* = 0 */)
 {
     // check for string
     unsigned int stringLen = theLabel->getStringLength();
-    theLabel->_limitShowCount = 0;
+    theLabel->_limitShowCount = startIndex;
 
     // no string
     if (stringLen == 0)
@@ -331,9 +331,25 @@ bool LabelTextFormatter::createStringSprites(Label *theLabel)
     {
         clip = true;
     }
+
+    auto& pens = theLabel->_layoutPens;
+    pens.resize(stringLen);
+    if (startIndex > 0)
+    {
+        CCASSERT(!clip && startIndex < (int)stringLen, "Only the letters of a string which is not clipped can be laid out again");
+        nextFontPositionX = pens[startIndex].x;
+        nextFontPositionY = pens[startIndex].y;
+        lineIndex = pens[startIndex].lineIndex;
+        longestLine = pens[startIndex].longestLine;
+    }
     
-    for (unsigned int i = 0; i < stringLen; i++)
+    for (unsigned int i = startIndex; i < stringLen; i++)
     {
+        pens[i].x = nextFontPositionX;
+        pens[i].y = nextFontPositionY;
+        pens[i].lineIndex = lineIndex;
+        pens[i].longestLine = longestLine;
+
         unsigned short c    = strWhole[i];
         if (fontAtlas->getLetterDefinitionForChar(c, tempDefinition))
         {
@@ -36,7 +36,8 @@ public:
     
     static bool multilineText(Label *theLabel);
     static bool alignText(Label *theLabel);
-    static bool createStringSprites(Label *theLabel);
+    /** lays out the letters from startIndex, the ones before it keep their position */
+    static bool createStringSprites(Label *theLabel, int startIndex = 0);
 
 };
 
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "CCNode.h"
 
 #include <algorithm>
+#include <cfloat>
 
 #include "deprecated/CCString.h"
 #include "ccCArray.h"
@@ -44,6 +45,8 @@ THE SOFTWARE.
 #include "CCEvent.h"
 #include "CCEventTouch.h"
 #include "CCLayer.h"
+#include "renderer/CCRenderer.h"
+#include "CCSpatialGrid.h"
 
 #if CC_USE_PHYSICS
 #include "CCPhysicsBody.h"
@@ -109,6 +112,11 @@ Node::Node(void)
 , _visible(true)
 , _ignoreAnchorPointForPosition(false)
 , _reorderChildDirty(false)
+, _parallelVisitEnabled(false)
+, _spatialGrid(nullptr)
+, _spatialGridEntry(-1)
+, _spatialOrderDirty(false)
+, _hitTestIndexed(false)
 , _isTransitionFinished(false)
 #if CC_ENABLE_SCRIPT_BINDING
 , _updateScriptHandler(0)
@@ -164,7 +172,9 @@ Node::~Node()
     for (auto& child : _children)
     {
         child->_parent = nullptr;
+        child->_spatialGridEntry = -1;
     }
+    CC_SAFE_DELETE(_spatialGrid);
 
     removeAllComponents();
     
@@ -205,6 +215,7 @@ void Node::setSkewX(float skewX)
     
     _skewX = skewX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markSpatialBoundsDirty();
 }
 
 float Node::getSkewY() const
@@ -219,6 +230,7 @@ void Node::setSkewY(float skewY)
     
     _skewY = skewY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markSpatialBoundsDirty();
 }
 
 
@@ -267,6 +279,7 @@ void Node::setRotation(float rotation)
     
     _rotationZ_X = _rotationZ_Y = rotation;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markSpatialBoundsDirty();
 
 #if CC_USE_PHYSICS
     if (_physicsBody && !_physicsBody->_rotationResetTag)
@@ -290,6 +303,7 @@ void Node::setRotation3D(const Vertex3F& rotation)
         return;
     
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markSpatialBoundsDirty();
 
     _rotationX = rotation.x;
     _rotationY = rotation.y;
@@ -321,6 +335,7 @@ void Node::setRotationSkewX(float rotationX)
     
     _rotationZ_X = rotationX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markSpatialBoundsDirty();
 }
 
 float Node::getRotationSkewY() const
@@ -335,6 +350,7 @@ void Node::setRotationSkewY(float rotationY)
     
     _rotationZ_Y = rotationY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markSpatialBoundsDirty();
 }
 
 /// scale getter
@@ -352,6 +368,7 @@ void Node::setScale(float scale)
 
     _scaleX = _scaleY = _scaleZ = scale;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markSpatialBoundsDirty();
 }
 
 /// scaleX getter
@@ -369,6 +386,7 @@ void Node::setScale(float scaleX,float scaleY)
     _scaleX = scaleX;
     _scaleY = scaleY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markSpatialBoundsDirty();
 }
 
 /// scaleX setter
@@ -379,6 +397,7 @@ void Node::setScaleX(float scaleX)
     
     _scaleX = scaleX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markSpatialBoundsDirty();
 }
 
 /// scaleY getter
@@ -395,6 +414,7 @@ void Node::setScaleZ(float scaleZ)
     
     _scaleZ = scaleZ;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markSpatialBoundsDirty();
 }
 
 /// scaleY getter
@@ -411,6 +431,7 @@ void Node::setScaleY(float scaleY)
     
     _scaleY = scaleY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markSpatialBoundsDirty();
 }
 
 
@@ -428,6 +449,7 @@ void Node::setPosition(const Point& position)
     
     _position = position;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markSpatialBoundsDirty();
 
 #if CC_USE_PHYSICS
     if (_physicsBody != nullptr && !_physicsBody->_positionResetTag)
@@ -495,6 +517,7 @@ void Node::setPositionZ(float positionZ)
         return;
     
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markSpatialBoundsDirty();
 
     _positionZ = positionZ;
 
@@ -550,6 +573,7 @@ void Node::setAnchorPoint(const Point& point)
         _anchorPoint = point;
         _anchorPointInPoints = Point(_contentSize.width * _anchorPoint.x, _contentSize.height * _anchorPoint.y );
         _transformUpdated = _transformDirty = _inverseDirty = true;
+        markSpatialBoundsDirty();
     }
 }
 
@@ -567,6 +591,7 @@ void Node::setContentSize(const Size & size)
 
         _anchorPointInPoints = Point(_contentSize.width * _anchorPoint.x, _contentSize.height * _anchorPoint.y );
         _transformUpdated = _transformDirty = _inverseDirty = true;
+        markSpatialBoundsDirty();
     }
 }
 
@@ -594,6 +619,7 @@ void Node::ignoreAnchorPointForPosition(bool newValue)
     {
 		_ignoreAnchorPointForPosition = newValue;
         _transformUpdated = _transformDirty = _inverseDirty = true;
+        markSpatialBoundsDirty();
 	}
 }
 
@@ -733,6 +759,11 @@ void Node::addChild(Node *child, int zOrder, int tag)
 
     child->setParent(this);
     child->setOrderOfArrival(s_globalOrderOfArrival++);
+
+    if (_spatialGrid)
+    {
+        child->_spatialGridEntry = _spatialGrid->insert(child);
+    }
     
 #if CC_USE_PHYSICS
     // Recursive add children with which have physics body.
@@ -857,9 +888,15 @@ void Node::removeAllChildrenWithCleanup(bool cleanup)
         }
         // set parent nil at the end
         child->setParent(nullptr);
+        child->_spatialGridEntry = -1;
     }
     
     _children.clear();
+
+    if (_spatialGrid)
+    {
+        _spatialGrid->clear();
+    }
 }
 
 void Node::detachChild(Node *child, ssize_t childIndex, bool doCleanup)
@@ -888,6 +925,12 @@ void Node::detachChild(Node *child, ssize_t childIndex, bool doCleanup)
         child->cleanup();
     }
 
+    if (child->_spatialGridEntry >= 0)
+    {
+        _spatialGrid->remove(child->_spatialGridEntry);
+        child->_spatialGridEntry = -1;
+    }
+
     // set parent nil at the end
     child->setParent(nullptr);
 
@@ -899,6 +942,7 @@ void Node::detachChild(Node *child, ssize_t childIndex, bool doCleanup)
 void Node::insertChild(Node* child, int z)
 {
     _reorderChildDirty = true;
+    _spatialOrderDirty = true;
     _children.pushBack(child);
     child->_setLocalZOrder(z);
 }
@@ -907,6 +951,7 @@ void Node::reorderChild(Node *child, int zOrder)
 {
     CCASSERT( child != nullptr, "Child must be non-nil");
     _reorderChildDirty = true;
+    _spatialOrderDirty = true;
     child->setOrderOfArrival(s_globalOrderOfArrival++);
     child->_setLocalZOrder(zOrder);
 }
@@ -947,36 +992,76 @@ void Node::visit(Renderer* renderer, const kmMat4 &parentTransform, bool parentT
 
     bool dirty = _transformUpdated || parentTransformUpdated;
     if(dirty)
-        _modelViewTransform = this->transform(parentTransform);
+    {
+        kmMat4 modelViewTransform = this->transform(parentTransform);
+        // Only the parent was flagged and our matrix didn't actually change:
+        // the subtree doesn't need to be re-multiplied.
+        if (!_transformUpdated && memcmp(&modelViewTransform, &_modelViewTransform, sizeof(kmMat4)) == 0)
+            dirty = false;
+        else
+            _modelViewTransform = modelViewTransform;
+    }
     _transformUpdated = false;
 
+    // the world bounds change with the transform of a parent too
+    if (dirty && _hitTestIndexed)
+    {
+        _eventDispatcher->setHitTestBoundsDirty(this);
+    }
+
 
     // IMPORTANT:
     // To ease the migration to v3.0, we still support the kmGL stack,
-    // but it is deprecated and your code should not rely on it
-    kmGLPushMatrix();
-    kmGLLoadMatrix(&_modelViewTransform);
+    // but it is deprecated and your code should not rely on it.
+    // It is not thread safe either: nodes visited in parallel don't update it.
+    bool useGLStack = !renderer->isCommandRecorder();
+    if (useGLStack)
+    {
+        kmGLPushMatrix();
+        kmGLLoadMatrix(&_modelViewTransform);
+    }
 
     int i = 0;
 
     if(!_children.empty())
     {
         sortAllChildren();
-        // draw children zOrder < 0
-        for( ; i < _children.size(); i++ )
-        {
-            auto node = _children.at(i);
 
-            if ( node && node->_localZOrder < 0 )
-                node->visit(renderer, _modelViewTransform, dirty);
-            else
-                break;
+        if (_spatialGrid && visitCulledChildren(renderer, dirty))
+        {
+            // only the children that intersect the screen were visited
         }
-        // self draw
-        this->draw(renderer, _modelViewTransform, dirty);
+        else if (_parallelVisitEnabled)
+        {
+            ssize_t count = _children.size();
+            while (i < count && _children.at(i)->_localZOrder < 0)
+                ++i;
+
+            Node* const* children = &(*_children.cbegin());
+            // draw children zOrder < 0
+            renderer->visitInParallel(children, i, _modelViewTransform, dirty);
+            // self draw
+            this->draw(renderer, _modelViewTransform, dirty);
+            renderer->visitInParallel(children + i, count - i, _modelViewTransform, dirty);
+        }
+        else
+        {
+            // draw children zOrder < 0
+            for( ; i < _children.size(); i++ )
+            {
+                auto node = _children.at(i);
 
-        for(auto it=_children.cbegin()+i; it != _children.cend(); ++it)
-            (*it)->visit(renderer, _modelViewTransform, dirty);
+                if ( node && node->_localZOrder < 0 )
+                    node->visit(renderer, _modelViewTransform, dirty);
+                else
+                    break;
+            }
+            // self draw
+            this->draw(renderer, _modelViewTransform, dirty);
+
+            for(auto it=_children.cbegin()+i; it != _children.cend(); ++it)
+                (*it)->visit(renderer, _modelViewTransform, dirty);
+        }
     }
     else
     {
@@ -986,13 +1071,118 @@ void Node::visit(Renderer* renderer, const kmMat4 &parentTransform, bool parentT
     // reset for next frame
     _orderOfArrival = 0;
  
-    kmGLPopMatrix();
+    if (useGLStack)
+    {
+        kmGLPopMatrix();
+    }
+}
+
+void Node::setSpatialCullingEnabled(bool enabled, float cellSize)
+{
+    for (const auto& child : _children)
+    {
+        child->_spatialGridEntry = -1;
+    }
+    CC_SAFE_DELETE(_spatialGrid);
+
+    if (enabled)
+    {
+        _spatialGrid = new SpatialGrid(cellSize);
+        for (const auto& child : _children)
+        {
+            child->_spatialGridEntry = _spatialGrid->insert(child);
+        }
+        _spatialOrderDirty = true;
+    }
+}
+
+void Node::getChildrenInRect(const Rect& rect, std::vector<Node*>& result)
+{
+    CCASSERT(_spatialGrid, "Spatial culling must be enabled");
+
+    sortAllChildren();
+    updateSpatialGridOrder();
+    _spatialGrid->query(rect, result);
+}
+
+void Node::markSpatialBoundsDirty()
+{
+    if (_spatialGridEntry >= 0)
+    {
+        _parent->_spatialGrid->markDirty(_spatialGridEntry);
+    }
+    if (_hitTestIndexed)
+    {
+        _eventDispatcher->setHitTestBoundsDirty(this);
+    }
+}
+
+void Node::updateSpatialGridOrder()
+{
+    if (_spatialOrderDirty)
+    {
+        for (ssize_t i = 0, count = _children.size(); i < count; ++i)
+        {
+            _spatialGrid->setOrder(_children.at(i)->_spatialGridEntry, (int)i);
+        }
+        _spatialOrderDirty = false;
+    }
+}
+
+bool Node::visitCulledChildren(Renderer* renderer, bool dirty)
+{
+    // The screen rect is brought into this node's space with the inverse of the 2D model view.
+    // 3D transforms would need a frustum, just visit everything in that case.
+    const float* m = _modelViewTransform.mat;
+    float det = m[0] * m[5] - m[1] * m[4];
+    if (!GLIsAffine2D(m) || det == 0)
+    {
+        return false;
+    }
+
+    updateSpatialGridOrder();
+
+    Size winSize = Director::getInstance()->getWinSize();
+    Point corners[4] = { Point(0, 0), Point(winSize.width, 0), Point(0, winSize.height), Point(winSize.width, winSize.height) };
+    Point lower(FLT_MAX, FLT_MAX);
+    Point upper(-FLT_MAX, -FLT_MAX);
+    for (const auto& corner : corners)
+    {
+        float x = corner.x - m[12];
+        float y = corner.y - m[13];
+        Point local((m[5] * x - m[4] * y) / det, (m[0] * y - m[1] * x) / det);
+        lower.x = std::min(lower.x, local.x);
+        lower.y = std::min(lower.y, local.y);
+        upper.x = std::max(upper.x, local.x);
+        upper.y = std::max(upper.y, local.y);
+    }
+
+    const auto& visibleChildren = _spatialGrid->cull(Rect(lower.x, lower.y, upper.x - lower.x, upper.y - lower.y));
+
+    // Children that were culled last frame missed the transform updates: refresh them.
+    size_t i = 0;
+    // draw children zOrder < 0
+    for ( ; i < visibleChildren.size() && visibleChildren[i].node->_localZOrder < 0; ++i)
+        visibleChildren[i].node->visit(renderer, _modelViewTransform, dirty || visibleChildren[i].entered);
+    // self draw
+    this->draw(renderer, _modelViewTransform, dirty);
+
+    for ( ; i < visibleChildren.size(); ++i)
+        visibleChildren[i].node->visit(renderer, _modelViewTransform, dirty || visibleChildren[i].entered);
+
+    return true;
 }
 
 kmMat4 Node::transform(const kmMat4& parentTransform)
 {
-    kmMat4 ret = this->getNodeToParentTransform();
-    kmMat4Multiply(&ret, &parentTransform, &ret);
+    const kmMat4& nodeToParent = this->getNodeToParentTransform();
+    kmMat4 ret;
+
+    // Most 2D nodes have neither 3D rotation nor an additional transform: use 3x2 affine math
+    if (GLIsAffine2D(parentTransform.mat) && GLIsAffine2D(nodeToParent.mat))
+        GLAffine2DMultiply(ret.mat, parentTransform.mat, nodeToParent.mat);
+    else
+        kmMat4Multiply(&ret, &parentTransform, &nodeToParent);
 
     return ret;
 }
@@ -1391,12 +1581,17 @@ const kmMat4& Node::getNodeToParentTransform() const
         // If skew is needed, apply skew and then anchor point
         if (needsSkewMatrix)
         {
-            kmMat4 skewMatrix = { 1, (float)tanf(CC_DEGREES_TO_RADIANS(_skewY)), 0, 0,
-                                  (float)tanf(CC_DEGREES_TO_RADIANS(_skewX)), 1, 0, 0,
-                                  0,  0,  1, 0,
-                                  0,  0,  0, 1};
-
-            kmMat4Multiply(&_transform, &_transform, &skewMatrix);
+            // Inlined multiplication by the skew matrix, which only mixes the first two columns:
+            // { 1, tan(skewY), 0, 0,  tan(skewX), 1, 0, 0,  0, 0, 1, 0,  0, 0, 0, 1 }
+            float skewX = tanf(CC_DEGREES_TO_RADIANS(_skewX));
+            float skewY = tanf(CC_DEGREES_TO_RADIANS(_skewY));
+            for (int row = 0; row < 4; ++row)
+            {
+                float col0 = _transform.mat[row];
+                float col1 = _transform.mat[row + 4];
+                _transform.mat[row] = col0 + col1 * skewY;
+                _transform.mat[row + 4] = col0 * skewX + col1;
+            }
 
             // adjust anchor point
             if (!_anchorPointInPoints.equals(Point::ZERO))
@@ -1410,7 +1605,10 @@ const kmMat4& Node::getNodeToParentTransform() const
 
         if (_useAdditionalTransform)
         {
-            kmMat4Multiply(&_transform, &_transform, &_additionalTransform);
+            if (GLIsAffine2D(_transform.mat) && GLIsAffine2D(_additionalTransform.mat))
+                GLAffine2DMultiply(_transform.mat, _transform.mat, _additionalTransform.mat);
+            else
+                kmMat4Multiply(&_transform, &_transform, &_additionalTransform);
         }
 
         _transformDirty = false;
@@ -1424,6 +1622,7 @@ void Node::setNodeToParentTransform(const kmMat4& transform)
     _transform = transform;
     _transformDirty = false;
     _transformUpdated = true;
+    markSpatialBoundsDirty();
 }
 
 void Node::setAdditionalTransform(const AffineTransform& additionalTransform)
@@ -1442,6 +1641,7 @@ void Node::setAdditionalTransform(kmMat4* additionalTransform)
         _useAdditionalTransform = true;
     }
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markSpatialBoundsDirty();
 }
 
 
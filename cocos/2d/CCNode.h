@@ -54,6 +54,7 @@ class ComponentContainer;
 class EventDispatcher;
 class Scene;
 class Renderer;
+class SpatialGrid;
 #if CC_USE_PHYSICS
 class PhysicsBody;
 #endif
@@ -928,6 +929,40 @@ public:
     virtual void visit(Renderer *renderer, const kmMat4& parentTransform, bool parentTransformUpdated);
     virtual void visit() final;
 
+    /**
+     * Sets whether or not the children of this node are visited on worker threads.
+     * Only enable it when the children subtrees are independent: they can't use `GroupCommand`s
+     * (eg: `ClippingNode`, `RenderTexture`, `NodeGrid`), the kmGL matrix stack, nor create, retain
+     * or release objects from `draw()` or `visit()`.
+     * The commands are merged in the same order as a sequential visit, so the output is the same.
+     *
+     * @see `Renderer::visitInParallel()`
+     */
+    inline void setParallelVisitEnabled(bool enabled) { _parallelVisitEnabled = enabled; }
+    /** Whether or not the children of this node are visited on worker threads */
+    inline bool isParallelVisitEnabled() const { return _parallelVisitEnabled; }
+
+    /**
+     * Sets whether or not the children of this node are culled with a spatial grid.
+     * The grid indexes the bounding box of every child in this node's space, so visit() only
+     * walks the children that intersect the screen: off-screen subtrees are skipped entirely.
+     * The descendants of a child must fit in its bounding box, otherwise they may be culled
+     * while visible. It is ignored while this node has a 3D transform.
+     * Use it on containers of many children that are mostly off-screen, like a big scrolling world.
+     *
+     * @param enabled   true to cull the children
+     * @param cellSize  size of the grid cells, in points. A few times the size of a typical child works well
+     */
+    void setSpatialCullingEnabled(bool enabled, float cellSize = 256);
+    /** Whether or not the children of this node are culled with a spatial grid */
+    inline bool isSpatialCullingEnabled() const { return _spatialGrid != nullptr; }
+
+    /**
+     * Appends the children whose bounding box intersects `rect`, in drawing order.
+     * `rect` is in this node's space. Requires spatial culling to be enabled.
+     */
+    void getChildrenInRect(const Rect& rect, std::vector<Node*>& result);
+
 
     /** Returns the Scene that contains the Node.
      It returns `nullptr` if the node doesn't belong to any Scene.
@@ -1359,6 +1394,15 @@ protected:
 
     kmMat4 transform(const kmMat4 &parentTransform);
 
+    /// Tells the spatial grid of the parent and the hit-test index of the event dispatcher, if any, that the bounds of this node changed
+    void markSpatialBoundsDirty();
+
+    /// Copies the order of the children to the spatial grid, if it changed
+    void updateSpatialGridOrder();
+
+    /// Visits the children that intersect the screen. Returns false if they can't be culled
+    bool visitCulledChildren(Renderer* renderer, bool dirty);
+
     virtual void updateCascadeOpacity();
     virtual void disableCascadeOpacity();
     virtual void updateCascadeColor();
@@ -1434,6 +1478,13 @@ protected:
                                           ///< Used by Layer and Scene.
 
     bool _reorderChildDirty;          ///< children order dirty flag
+
+    bool _parallelVisitEnabled;       ///< children are visited on worker threads
+
+    SpatialGrid* _spatialGrid;        ///< culls the children, nullptr unless spatial culling is enabled
+    int _spatialGridEntry;            ///< entry of this node in the spatial grid of its parent, or -1
+    bool _spatialOrderDirty;          ///< the order of the children must be copied to the spatial grid
+    bool _hitTestIndexed;             ///< the event dispatcher hit tests touches against the world bounds of this node
     bool _isTransitionFinished;       ///< flag to indicate whether the transition was finished
 
 #if CC_ENABLE_SCRIPT_BINDING
@@ -1464,6 +1515,7 @@ private:
 #if CC_USE_PHYSICS
     friend class Layer;
 #endif //CC_USTPS
+    friend class EventDispatcher;
 };
 
 // NodeRGBA
@@ -141,13 +141,21 @@ void ParticleBatchNode::visit(Renderer *renderer, const kmMat4 &parentTransform,
 
     // IMPORTANT:
     // To ease the migration to v3.0, we still support the kmGL stack,
-    // but it is deprecated and your code should not rely on it
-    kmGLPushMatrix();
-    kmGLLoadMatrix(&_modelViewTransform);
+    // but it is deprecated and your code should not rely on it.
+    // It is not thread safe either: nodes visited in parallel don't update it.
+    bool useGLStack = !renderer->isCommandRecorder();
+    if (useGLStack)
+    {
+        kmGLPushMatrix();
+        kmGLLoadMatrix(&_modelViewTransform);
+    }
 
     draw(renderer, _modelViewTransform, dirty);
 
-    kmGLPopMatrix();
+    if (useGLStack)
+    {
+        kmGLPopMatrix();
+    }
 }
 
 // override addChild:
@@ -56,6 +56,7 @@ THE SOFTWARE.
 #include "ZipUtils.h"
 #include "CCDirector.h"
 #include "CCProfiling.h"
+#include "CCThreadPool.h"
 // opengl
 #include "CCGL.h"
 
@@ -81,18 +82,104 @@ NS_CC_BEGIN
 //  cocos2d uses a another approach, but the results are almost identical. 
 //
 
+// number of arrays of ParticleData
+static const int PARTICLE_DATA_ARRAY_COUNT = 26;
+
+// below this many particles, a worker thread costs more than it saves
+static const int PARALLEL_UPDATE_MIN_PARTICLES = 4096;
+
+ParticleData::ParticleData()
+: maxCount(0)
+, _memory(nullptr)
+, _stride(0)
+{
+    memset(&modeA, 0, sizeof(modeA));
+    memset(&modeB, 0, sizeof(modeB));
+    posx = posy = startPosX = startPosY = nullptr;
+    colorR = colorG = colorB = colorA = nullptr;
+    deltaColorR = deltaColorG = deltaColorB = deltaColorA = nullptr;
+    size = deltaSize = rotation = deltaRotation = timeToLive = nullptr;
+    atlasIndex = nullptr;
+}
+
+ParticleData::~ParticleData()
+{
+    release();
+}
+
+bool ParticleData::init(int count)
+{
+    release();
+
+    // a multiple of 4 floats keeps every array aligned to 16 bytes
+    _stride = (count + 3) & ~3;
+    _memory = calloc(_stride * PARTICLE_DATA_ARRAY_COUNT * sizeof(float) + 15, 1);
+    if (_memory == nullptr)
+    {
+        _stride = 0;
+        return false;
+    }
+
+    float* array = (float*)(((uintptr_t)_memory + 15) & ~(uintptr_t)15);
+    posx = array; array += _stride;
+    posy = array; array += _stride;
+    startPosX = array; array += _stride;
+    startPosY = array; array += _stride;
+    colorR = array; array += _stride;
+    colorG = array; array += _stride;
+    colorB = array; array += _stride;
+    colorA = array; array += _stride;
+    deltaColorR = array; array += _stride;
+    deltaColorG = array; array += _stride;
+    deltaColorB = array; array += _stride;
+    deltaColorA = array; array += _stride;
+    size = array; array += _stride;
+    deltaSize = array; array += _stride;
+    rotation = array; array += _stride;
+    deltaRotation = array; array += _stride;
+    timeToLive = array; array += _stride;
+    atlasIndex = (unsigned int*)array; array += _stride;
+    modeA.dirX = array; array += _stride;
+    modeA.dirY = array; array += _stride;
+    modeA.radialAccel = array; array += _stride;
+    modeA.tangentialAccel = array; array += _stride;
+    modeB.angle = array; array += _stride;
+    modeB.degreesPerSecond = array; array += _stride;
+    modeB.radius = array; array += _stride;
+    modeB.deltaRadius = array;
+
+    maxCount = count;
+    return true;
+}
+
+void ParticleData::release()
+{
+    CC_SAFE_FREE(_memory);
+    maxCount = 0;
+}
+
+void ParticleData::copyParticle(int p1, int p2)
+{
+    // copies the bits, atlasIndex isn't a float
+    unsigned int* array = (unsigned int*)posx;
+    for (int i = 0; i < PARTICLE_DATA_ARRAY_COUNT; ++i, array += _stride)
+    {
+        array[p1] = array[p2];
+    }
+}
+
 ParticleSystem::ParticleSystem()
 : _isBlendAdditive(false)
 , _isAutoRemoveOnFinish(false)
 , _plistFile("")
 , _elapsed(0)
-, _particles(nullptr)
 , _configName("")
 , _emitCounter(0)
 , _particleIdx(0)
 , _batchNode(nullptr)
 , _atlasIndex(0)
 , _transformSystemDirty(false)
+, _parallelUpdateEnabled(false)
 , _allocatedParticles(0)
 , _isActive(true)
 , _particleCount(0)
@@ -435,11 +522,7 @@ bool ParticleSystem::initWithTotalParticles(int numberOfParticles)
 {
     _totalParticles = numberOfParticles;
 
-    CC_SAFE_FREE(_particles);
-    
-    _particles = (tParticle*)calloc(_totalParticles, sizeof(tParticle));
-
-    if( ! _particles )
+    if( ! _particleData.init(_totalParticles) )
     {
         CCLOG("Particle system: not enough memory");
         this->release();
@@ -451,7 +534,7 @@ bool ParticleSystem::initWithTotalParticles(int numberOfParticles)
     {
         for (int i = 0; i < _totalParticles; i++)
         {
-            _particles[i].atlasIndex=i;
+            _particleData.atlasIndex[i]=i;
         }
     }
     // default, active
@@ -472,9 +555,6 @@ bool ParticleSystem::initWithTotalParticles(int numberOfParticles)
 
     _isAutoRemoveOnFinish = false;
 
-    // Optimization: compile updateParticle method
-    //updateParticleSel = @selector(updateQuadWithParticle:newPosition:);
-    //updateParticleImp = (CC_UPDATE_PARTICLE_IMP) [self methodForSelector:updateParticleSel];
     //for batchNode
     _transformSystemDirty = false;
 
@@ -486,7 +566,7 @@ ParticleSystem::~ParticleSystem()
     // Since the scheduler retains the "target (in this case the ParticleSystem)
 	// it is not needed to call "unscheduleUpdate" here. In fact, it will be called in "cleanup"
     //unscheduleUpdate();
-    CC_SAFE_FREE(_particles);
+    _particleData.release();
     CC_SAFE_RELEASE(_texture);
 }
 
@@ -497,13 +577,166 @@ bool ParticleSystem::addParticle()
         return false;
     }
 
-    tParticle * particle = &_particles[ _particleCount ];
-    this->initParticle(particle);
-    ++_particleCount;
+    addParticles(1);
 
     return true;
 }
 
+void ParticleSystem::addParticles(int count)
+{
+    count = MIN(count, _totalParticles - _particleCount);
+    if (count <= 0)
+    {
+        return;
+    }
+
+    // the particles are initialized one value at a time
+    ParticleData& d = _particleData;
+    int start = _particleCount;
+    int end = _particleCount + count;
+
+    // timeToLive
+    // no negative life. prevent division by 0
+    for (int i = start; i < end; ++i)
+    {
+        d.timeToLive[i] = MAX(0, _life + _lifeVar * CCRANDOM_MINUS1_1());
+    }
+
+    // position
+    for (int i = start; i < end; ++i)
+    {
+        d.posx[i] = _sourcePosition.x + _posVar.x * CCRANDOM_MINUS1_1();
+        d.posy[i] = _sourcePosition.y + _posVar.y * CCRANDOM_MINUS1_1();
+    }
+
+    // Color
+    for (int i = start; i < end; ++i)
+    {
+        Color4F start;
+        start.r = clampf(_startColor.r + _startColorVar.r * CCRANDOM_MINUS1_1(), 0, 1);
+        start.g = clampf(_startColor.g + _startColorVar.g * CCRANDOM_MINUS1_1(), 0, 1);
+        start.b = clampf(_startColor.b + _startColorVar.b * CCRANDOM_MINUS1_1(), 0, 1);
+        start.a = clampf(_startColor.a + _startColorVar.a * CCRANDOM_MINUS1_1(), 0, 1);
+
+        Color4F end;
+        end.r = clampf(_endColor.r + _endColorVar.r * CCRANDOM_MINUS1_1(), 0, 1);
+        end.g = clampf(_endColor.g + _endColorVar.g * CCRANDOM_MINUS1_1(), 0, 1);
+        end.b = clampf(_endColor.b + _endColorVar.b * CCRANDOM_MINUS1_1(), 0, 1);
+        end.a = clampf(_endColor.a + _endColorVar.a * CCRANDOM_MINUS1_1(), 0, 1);
+
+        d.colorR[i] = start.r;
+        d.colorG[i] = start.g;
+        d.colorB[i] = start.b;
+        d.colorA[i] = start.a;
+        d.deltaColorR[i] = (end.r - start.r) / d.timeToLive[i];
+        d.deltaColorG[i] = (end.g - start.g) / d.timeToLive[i];
+        d.deltaColorB[i] = (end.b - start.b) / d.timeToLive[i];
+        d.deltaColorA[i] = (end.a - start.a) / d.timeToLive[i];
+    }
+
+    // size
+    for (int i = start; i < end; ++i)
+    {
+        float startS = _startSize + _startSizeVar * CCRANDOM_MINUS1_1();
+        startS = MAX(0, startS); // No negative value
+
+        d.size[i] = startS;
+
+        if (_endSize == START_SIZE_EQUAL_TO_END_SIZE)
+        {
+            d.deltaSize[i] = 0;
+        }
+        else
+        {
+            float endS = _endSize + _endSizeVar * CCRANDOM_MINUS1_1();
+            endS = MAX(0, endS); // No negative values
+            d.deltaSize[i] = (endS - startS) / d.timeToLive[i];
+        }
+    }
+
+    // rotation
+    for (int i = start; i < end; ++i)
+    {
+        float startA = _startSpin + _startSpinVar * CCRANDOM_MINUS1_1();
+        float endA = _endSpin + _endSpinVar * CCRANDOM_MINUS1_1();
+        d.rotation[i] = startA;
+        d.deltaRotation[i] = (endA - startA) / d.timeToLive[i];
+    }
+
+    // position
+    Point startPos = Point::ZERO;
+    if (_positionType == PositionType::FREE)
+    {
+        startPos = this->convertToWorldSpace(Point::ZERO);
+    }
+    else if (_positionType == PositionType::RELATIVE)
+    {
+        startPos = _position;
+    }
+    for (int i = start; i < end; ++i)
+    {
+        d.startPosX[i] = startPos.x;
+        d.startPosY[i] = startPos.y;
+    }
+
+    // Mode Gravity: A
+    if (_emitterMode == Mode::GRAVITY)
+    {
+        for (int i = start; i < end; ++i)
+        {
+            // direction
+            float a = CC_DEGREES_TO_RADIANS( _angle + _angleVar * CCRANDOM_MINUS1_1() );
+            float s = modeA.speed + modeA.speedVar * CCRANDOM_MINUS1_1();
+            d.modeA.dirX[i] = cosf( a ) * s;
+            d.modeA.dirY[i] = sinf( a ) * s;
+
+            // radial accel
+            d.modeA.radialAccel[i] = modeA.radialAccel + modeA.radialAccelVar * CCRANDOM_MINUS1_1();
+
+            // tangential accel
+            d.modeA.tangentialAccel[i] = modeA.tangentialAccel + modeA.tangentialAccelVar * CCRANDOM_MINUS1_1();
+        }
+
+        // rotation is dir
+        if(modeA.rotationIsDir)
+        {
+            for (int i = start; i < end; ++i)
+            {
+                d.rotation[i] = -CC_RADIANS_TO_DEGREES(atan2f(d.modeA.dirY[i], d.modeA.dirX[i]));
+            }
+        }
+    }
+
+    // Mode Radius: B
+    else 
+    {
+        for (int i = start; i < end; ++i)
+        {
+            float a = CC_DEGREES_TO_RADIANS( _angle + _angleVar * CCRANDOM_MINUS1_1() );
+
+            // Set the default diameter of the particle from the source position
+            float startRadius = modeB.startRadius + modeB.startRadiusVar * CCRANDOM_MINUS1_1();
+            float endRadius = modeB.endRadius + modeB.endRadiusVar * CCRANDOM_MINUS1_1();
+
+            d.modeB.radius[i] = startRadius;
+
+            if (modeB.endRadius == START_RADIUS_EQUAL_TO_END_RADIUS)
+            {
+                d.modeB.deltaRadius[i] = 0;
+            }
+            else
+            {
+                d.modeB.deltaRadius[i] = (endRadius - startRadius) / d.timeToLive[i];
+            }
+
+            d.modeB.angle[i] = a;
+            d.modeB.degreesPerSecond[i] = CC_DEGREES_TO_RADIANS(modeB.rotatePerSecond + modeB.rotatePerSecondVar * CCRANDOM_MINUS1_1());
+        }
+    }
+
+    _particleCount = end;
+}
+
 void ParticleSystem::initParticle(tParticle* particle)
 {
     // timeToLive
@@ -643,8 +876,7 @@ void ParticleSystem::resetSystem()
     _elapsed = 0;
     for (_particleIdx = 0; _particleIdx < _particleCount; ++_particleIdx)
     {
-        tParticle *p = &_particles[_particleIdx];
-        p->timeToLive = 0;
+        _particleData.timeToLive[_particleIdx] = 0;
     }
 }
 bool ParticleSystem::isFull()
@@ -666,10 +898,12 @@ void ParticleSystem::update(float dt)
             _emitCounter += dt;
         }
         
-        while (_particleCount < _totalParticles && _emitCounter > rate) 
+        // emit the particles of the frame at once
+        if (_particleCount < _totalParticles && _emitCounter > rate)
         {
-            this->addParticle();
-            _emitCounter -= rate;
+            int count = MIN(_totalParticles - _particleCount, (int)(_emitCounter / rate));
+            this->addParticles(count);
+            _emitCounter -= rate * count;
         }
 
         _elapsed += dt;
@@ -679,166 +913,192 @@ void ParticleSystem::update(float dt)
         }
     }
 
-    _particleIdx = 0;
-
-    Point currentPosition = Point::ZERO;
-    if (_positionType == PositionType::FREE)
+    // life
+    float* timeToLive = _particleData.timeToLive;
+    for (int i = 0; i < _particleCount; ++i)
     {
-        currentPosition = this->convertToWorldSpace(Point::ZERO);
-    }
-    else if (_positionType == PositionType::RELATIVE)
-    {
-        currentPosition = _position;
+        timeToLive[i] -= dt;
     }
 
+    // the last living particle takes the place of a dead one
+    for (int i = 0; i < _particleCount; )
     {
-        while (_particleIdx < _particleCount)
+        if (timeToLive[i] > 0)
         {
-            tParticle *p = &_particles[_particleIdx];
-
-            // life
-            p->timeToLive -= dt;
-
-            if (p->timeToLive > 0) 
-            {
-                // Mode A: gravity, direction, tangential accel & radial accel
-                if (_emitterMode == Mode::GRAVITY)
-                {
-                    Point tmp, radial, tangential;
-
-                    radial = Point::ZERO;
-                    // radial acceleration
-                    if (p->pos.x || p->pos.y)
-                    {
-                        radial = p->pos.normalize();
-                    }
-                    tangential = radial;
-                    radial = radial * p->modeA.radialAccel;
-
-                    // tangential acceleration
-                    float newy = tangential.x;
-                    tangential.x = -tangential.y;
-                    tangential.y = newy;
-                    tangential = tangential * p->modeA.tangentialAccel;
-
-                    // (gravity + radial + tangential) * dt
-                    tmp = radial + tangential + modeA.gravity;
-                    tmp = tmp * dt;
-                    p->modeA.dir = p->modeA.dir + tmp;
-					if (_configName.length()>0)
-					{
-						if (_yCoordFlipped == -1)
-						{
-							 tmp = p->modeA.dir * dt;
-						}
-						else
-						{
-							 tmp = p->modeA.dir * -dt;
-						}
-					}
-					else
-					{
-						 tmp = p->modeA.dir * dt;
-					}
-                    p->pos = p->pos + tmp;
-                }
-
-                // Mode B: radius movement
-                else 
-                {                
-                    // Update the angle and radius of the particle.
-                    p->modeB.angle += p->modeB.degreesPerSecond * dt;
-                    p->modeB.radius += p->modeB.deltaRadius * dt;
-
-                    p->pos.x = - cosf(p->modeB.angle) * p->modeB.radius;
-                    p->pos.y = - sinf(p->modeB.angle) * p->modeB.radius;
-                    if (_yCoordFlipped == 1)
-                    {
-                      p->pos.y = -p->pos.y;
-                    }
-				}
+            ++i;
+            continue;
+        }
 
-                // color
-                p->color.r += (p->deltaColor.r * dt);
-                p->color.g += (p->deltaColor.g * dt);
-                p->color.b += (p->deltaColor.b * dt);
-                p->color.a += (p->deltaColor.a * dt);
+        // life < 0
+        int currentIndex = _particleData.atlasIndex[i];
+        if( i != _particleCount-1 )
+        {
+            _particleData.copyParticle(i, _particleCount-1);
+        }
+        if (_batchNode)
+        {
+            //disable the switched particle
+            _batchNode->disableParticle(_atlasIndex+currentIndex);
 
-                // size
-                p->size += (p->deltaSize * dt);
-                p->size = MAX( 0, p->size );
+            //switch indexes
+            _particleData.atlasIndex[_particleCount-1] = currentIndex;
+        }
 
-                // angle
-                p->rotation += (p->deltaRotation * dt);
+        --_particleCount;
 
-                //
-                // update values in quad
-                //
+        if( _particleCount == 0 && _isAutoRemoveOnFinish )
+        {
+            this->unscheduleUpdate();
+            _parent->removeChild(this, true);
+            return;
+        }
+    }
 
-                Point    newPos;
+    // the quads are centered on pos + startPos + offset
+    Point offset = Point::ZERO;
+    if (_positionType == PositionType::FREE)
+    {
+        offset = -this->convertToWorldSpace(Point::ZERO);
+    }
+    else if (_positionType == PositionType::RELATIVE)
+    {
+        offset = -_position;
+    }
 
-                if (_positionType == PositionType::FREE || _positionType == PositionType::RELATIVE)
-                {
-                    Point diff = currentPosition - p->startPos;
-                    newPos = p->pos - diff;
-                } 
-                else
-                {
-                    newPos = p->pos;
-                }
+    // translate newPos to correct position, since matrix transform isn't performed in batchnode
+    // don't update the particle with the new position information, it will interfere with the radius and tangential calculations
+    if (_batchNode)
+    {
+        offset = offset + _position;
+    }
 
-                // translate newPos to correct position, since matrix transform isn't performed in batchnode
-                // don't update the particle with the new position information, it will interfere with the radius and tangential calculations
-                if (_batchNode)
-                {
-                    newPos.x+=_position.x;
-                    newPos.y+=_position.y;
-                }
+    auto pool = ThreadPool::getInstance();
+    if (_parallelUpdateEnabled && _particleCount >= PARALLEL_UPDATE_MIN_PARTICLES && pool->getThreadCount() > 0)
+    {
+        // the particles don't depend on each other: each thread moves a range of them and updates their quads
+        int chunks = pool->getThreadCount() + 1;
+        int count = _particleCount;
+        pool->parallelFor(chunks, [&](int chunk) {
+            // ranges of multiples of 4 particles, so that the threads don't write the same cache lines as often
+            int start = (count * chunk / chunks) & ~3;
+            int end = chunk == chunks - 1 ? count : (count * (chunk + 1) / chunks) & ~3;
+            updateParticles(start, end, dt);
+            updateParticleQuads(start, end, offset);
+        });
+    }
+    else
+    {
+        updateParticles(0, _particleCount, dt);
+        updateParticleQuads(0, _particleCount, offset);
+    }
 
-                updateQuadWithParticle(p, newPos);
-                //updateParticleImp(self, updateParticleSel, p, newPos);
+    _particleIdx = _particleCount;
+    _transformSystemDirty = false;
+    
+    // only update gl buffer when visible
+    if (_visible && ! _batchNode)
+    {
+        postStep();
+    }
 
-                // update particle counter
-                ++_particleIdx;
-            } 
-            else 
-            {
-                // life < 0
-                int currentIndex = p->atlasIndex;
-                if( _particleIdx != _particleCount-1 )
-                {
-                    _particles[_particleIdx] = _particles[_particleCount-1];
-                }
-                if (_batchNode)
-                {
-                    //disable the switched particle
-                    _batchNode->disableParticle(_atlasIndex+currentIndex);
+    CC_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
+}
 
-                    //switch indexes
-                    _particles[_particleCount-1].atlasIndex = currentIndex;
-                }
+void ParticleSystem::updateParticles(int start, int end, float dt)
+{
+    // one loop per value, without branches, so that the compiler vectorizes them
+    ParticleData& d = _particleData;
 
+    // Mode A: gravity, direction, tangential accel & radial accel
+    if (_emitterMode == Mode::GRAVITY)
+    {
+        // the y axis of the Particle Designer files is flipped, unless _yCoordFlipped is -1
+        float moveDt = (_configName.length() > 0 && _yCoordFlipped != -1) ? -dt : dt;
+        float gravityX = modeA.gravity.x * dt;
+        float gravityY = modeA.gravity.y * dt;
+
+        float* posx = d.posx;
+        float* posy = d.posy;
+        float* dirX = d.modeA.dirX;
+        float* dirY = d.modeA.dirY;
+        const float* radialAccel = d.modeA.radialAccel;
+        const float* tangentialAccel = d.modeA.tangentialAccel;
+        for (int i = start; i < end; ++i)
+        {
+            // radial acceleration along the normalized position, none at the origin
+            float x = posx[i];
+            float y = posy[i];
+            float lengthSq = x * x + y * y;
+            float invLength = lengthSq > 0 ? 1.0f / sqrtf(lengthSq) : 0.0f;
+            float radialX = x * invLength;
+            float radialY = y * invLength;
+
+            // (gravity + radial + tangential) * dt, the tangent is the radial direction rotated by 90 degrees
+            float radial = radialAccel[i] * dt;
+            float tangential = tangentialAccel[i] * dt;
+            float dx = dirX[i] + radialX * radial - radialY * tangential + gravityX;
+            float dy = dirY[i] + radialY * radial + radialX * tangential + gravityY;
+            dirX[i] = dx;
+            dirY[i] = dy;
+
+            posx[i] = x + dx * moveDt;
+            posy[i] = y + dy * moveDt;
+        }
+    }
 
-                --_particleCount;
+    // Mode B: radius movement
+    else 
+    {
+        float signY = (_yCoordFlipped == 1) ? 1.0f : -1.0f;
+
+        float* posx = d.posx;
+        float* posy = d.posy;
+        float* angle = d.modeB.angle;
+        float* radius = d.modeB.radius;
+        const float* degreesPerSecond = d.modeB.degreesPerSecond;
+        const float* deltaRadius = d.modeB.deltaRadius;
+        for (int i = start; i < end; ++i)
+        {
+            // Update the angle and radius of the particle.
+            angle[i] += degreesPerSecond[i] * dt;
+            radius[i] += deltaRadius[i] * dt;
+        }
+        for (int i = start; i < end; ++i)
+        {
+            posx[i] = - cosf(angle[i]) * radius[i];
+            posy[i] = signY * sinf(angle[i]) * radius[i];
+        }
+    }
 
-                if( _particleCount == 0 && _isAutoRemoveOnFinish )
-                {
-                    this->unscheduleUpdate();
-                    _parent->removeChild(this, true);
-                    return;
-                }
-            }
-        } //while
-        _transformSystemDirty = false;
+    // color
+    for (int i = start; i < end; ++i)
+    {
+        d.colorR[i] += d.deltaColorR[i] * dt;
     }
-    
-    // only update gl buffer when visible
-    if (_visible && ! _batchNode)
+    for (int i = start; i < end; ++i)
     {
-        postStep();
+        d.colorG[i] += d.deltaColorG[i] * dt;
+    }
+    for (int i = start; i < end; ++i)
+    {
+        d.colorB[i] += d.deltaColorB[i] * dt;
+    }
+    for (int i = start; i < end; ++i)
+    {
+        d.colorA[i] += d.deltaColorA[i] * dt;
     }
 
-    CC_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
+    // size
+    for (int i = start; i < end; ++i)
+    {
+        d.size[i] = MAX(0, d.size[i] + d.deltaSize[i] * dt);
+    }
+
+    // angle
+    for (int i = start; i < end; ++i)
+    {
+        d.rotation[i] += d.deltaRotation[i] * dt;
+    }
 }
 
 void ParticleSystem::updateWithNoTime(void)
@@ -846,6 +1106,36 @@ void ParticleSystem::updateWithNoTime(void)
     this->update(0.0f);
 }
 
+void ParticleSystem::updateParticleQuads(int start, int end, const Point& offset)
+{
+    // calls the deprecated per particle function, for the subclasses that still override it
+    const ParticleData& d = _particleData;
+    tParticle particle;
+    for (int i = start; i < end; ++i)
+    {
+        particle.pos = Point(d.posx[i], d.posy[i]);
+        particle.startPos = Point(d.startPosX[i], d.startPosY[i]);
+        particle.color = Color4F(d.colorR[i], d.colorG[i], d.colorB[i], d.colorA[i]);
+        particle.deltaColor = Color4F(d.deltaColorR[i], d.deltaColorG[i], d.deltaColorB[i], d.deltaColorA[i]);
+        particle.size = d.size[i];
+        particle.deltaSize = d.deltaSize[i];
+        particle.rotation = d.rotation[i];
+        particle.deltaRotation = d.deltaRotation[i];
+        particle.timeToLive = d.timeToLive[i];
+        particle.atlasIndex = d.atlasIndex[i];
+        particle.modeA.dir = Point(d.modeA.dirX[i], d.modeA.dirY[i]);
+        particle.modeA.radialAccel = d.modeA.radialAccel[i];
+        particle.modeA.tangentialAccel = d.modeA.tangentialAccel[i];
+        particle.modeB.angle = d.modeB.angle[i];
+        particle.modeB.degreesPerSecond = d.modeB.degreesPerSecond[i];
+        particle.modeB.radius = d.modeB.radius[i];
+        particle.modeB.deltaRadius = d.modeB.deltaRadius[i];
+
+        _particleIdx = i;
+        updateQuadWithParticle(&particle, particle.pos + particle.startPos + offset);
+    }
+}
+
 void ParticleSystem::updateQuadWithParticle(tParticle* particle, const Point& newPosition)
 {
     CC_UNUSED_PARAM(particle);
@@ -1147,7 +1437,7 @@ void ParticleSystem::setBatchNode(ParticleBatchNode* batchNode)
             //each particle needs a unique index
             for (int i = 0; i < _totalParticles; i++)
             {
-                _particles[i].atlasIndex=i;
+                _particleData.atlasIndex[i]=i;
             }
         }
     }
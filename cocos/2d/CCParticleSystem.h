@@ -41,8 +41,72 @@ NS_CC_BEGIN
 
 class ParticleBatchNode;
 
+/**
+Values of the particles, one array per value so that the update loops go through contiguous floats.
+All the arrays are allocated in one block, each one aligned to 16 bytes.
+*/
+struct CC_DLL ParticleData
+{
+    float* posx;
+    float* posy;
+    float* startPosX;
+    float* startPosY;
+
+    float* colorR;
+    float* colorG;
+    float* colorB;
+    float* colorA;
+
+    float* deltaColorR;
+    float* deltaColorG;
+    float* deltaColorB;
+    float* deltaColorA;
+
+    float* size;
+    float* deltaSize;
+    float* rotation;
+    float* deltaRotation;
+    float* timeToLive;
+    unsigned int* atlasIndex;
+
+    //! Mode A: gravity, direction, radial accel, tangential accel
+    struct {
+        float* dirX;
+        float* dirY;
+        float* radialAccel;
+        float* tangentialAccel;
+    } modeA;
+
+    //! Mode B: radius mode
+    struct {
+        float* angle;
+        float* degreesPerSecond;
+        float* radius;
+        float* deltaRadius;
+    } modeB;
+
+    unsigned int maxCount;
+
+    ParticleData();
+    ~ParticleData();
+
+    /** allocates zeroed arrays for count particles, releasing the previous ones */
+    bool init(int count);
+    void release();
+
+    /** copies the values of the particle p2 to the particle p1 */
+    void copyParticle(int p1, int p2);
+
+private:
+    void* _memory;
+    unsigned int _stride;       // distance between two arrays, in floats
+
+    CC_DISALLOW_COPY_AND_ASSIGN(ParticleData);
+};
+
 /**
 Structure that contains the values of each particle
+@deprecated The particles are stored in ParticleData. It is only used by initParticle() and updateQuadWithParticle().
 */
 typedef struct sParticle {
     Point     pos;
@@ -78,8 +142,6 @@ typedef struct sParticle {
 
 }tParticle;
 
-//typedef void (*CC_UPDATE_PARTICLE_IMP)(id, SEL, tParticle*, Point);
-
 class Texture2D;
 
 /** @brief Particle System base class.
@@ -182,8 +244,12 @@ public:
 
     //! Add a particle to the emitter
     bool addParticle();
-    //! Initializes a particle
-    void initParticle(tParticle* particle);
+    //! Add particles to the emitter, as many as the system can hold
+    void addParticles(int count);
+    /** Initializes a particle
+     @deprecated Use addParticles() instead. The particle is not added to the system.
+     */
+    CC_DEPRECATED_ATTRIBUTE void initParticle(tParticle* particle);
     //! stop emitting particles. Running particles will continue to run until they die
     void stopSystem();
     //! Kill all living particles.
@@ -191,11 +257,27 @@ public:
     //! whether or not the system is full
     bool isFull();
 
-    //! should be overridden by subclasses
+    /** Updates the quads of the particles in [start, end). The quad of a particle is centered on
+     its position + its start position (zero if the system is grouped) + offset.
+     It can be called from worker threads, see setParallelUpdateEnabled().
+     Should be overridden by subclasses. By default it calls updateQuadWithParticle() for each particle.
+     */
+    virtual void updateParticleQuads(int start, int end, const Point& offset);
+    /** should be overridden by subclasses
+     @deprecated Override updateParticleQuads() instead. It is only called by the default updateParticleQuads(),
+     so it is not called for the subclasses of ParticleSystemQuad. It isn't thread safe: don't enable the parallel
+     update of the systems relying on it.
+     */
     virtual void updateQuadWithParticle(tParticle* particle, const Point& newPosition);
     //! should be overridden by subclasses
     virtual void postStep();
 
+    /** Sets whether or not the particles of big systems are updated on worker threads.
+     Below a few thousand particles the system is always updated on the main thread.
+     */
+    inline void setParallelUpdateEnabled(bool enabled) { _parallelUpdateEnabled = enabled; }
+    inline bool isParallelUpdateEnabled() const { return _parallelUpdateEnabled; }
+
     virtual void updateWithNoTime(void);
 
     virtual bool isAutoRemoveOnFinish() const;
@@ -409,6 +491,9 @@ CC_CONSTRUCTOR_ACCESS:
 protected:
     virtual void updateBlendFunc();
 
+    //! moves the living particles [start, end) during dt seconds
+    void updateParticles(int start, int end, float dt);
+
     /** whether or not the particles are using blend additive.
      If enabled, the following blending function will be used.
      @code
@@ -465,8 +550,8 @@ protected:
         float rotatePerSecondVar;
     } modeB;
 
-    //! Array of particles
-    tParticle *_particles;
+    //! Values of the particles
+    ParticleData _particleData;
 
     //Emitter name
     std::string _configName;
@@ -492,6 +577,8 @@ protected:
 
     //true if scaled or rotated
     bool _transformSystemDirty;
+    // update big systems on worker threads
+    bool _parallelUpdateEnabled;
     // Number of allocated particles
     int _allocatedParticles;
 
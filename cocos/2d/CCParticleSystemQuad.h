@@ -79,12 +79,6 @@ public:
      */
     void setTextureWithRect(Texture2D *texture, const Rect& rect);
 
-    /** listen the event that coming to foreground on Android
-     * @js NA
-     * @lua NA
-     */
-    void listenBackToForeground(EventCustom* event);
-
     /**
      * @js NA
      * @lua NA
@@ -94,12 +88,13 @@ public:
      * @js NA
      * @lua NA
      */
-    virtual void updateQuadWithParticle(tParticle* particle, const Point& newPosition) override;
+    virtual void updateParticleQuads(int start, int end, const Point& offset) override;
     /**
+     * @deprecated Use updateParticleQuads() instead.
      * @js NA
      * @lua NA
      */
-    virtual void postStep() override;
+    virtual void updateQuadWithParticle(tParticle* particle, const Point& newPosition) override;
     /**
      * @js NA
      * @lua NA
@@ -138,23 +133,15 @@ CC_CONSTRUCTOR_ACCESS:
     virtual bool initWithTotalParticles(int numberOfParticles) override;
 
 protected:
-    /** initializes the indices for the vertices*/
-    void initIndices();
-    
     /** initializes the texture with a rectangle measured Points */
     void initTexCoordsWithRect(const Rect& rect);
     
     /** Updates texture coords */
     void updateTexCoords();
 
-    void setupVBOandVAO();
-    void setupVBO();
     bool allocMemory();
 
-    V3F_C4B_T2F_Quad    *_quads;        // quads to be rendered
-    GLushort            *_indices;      // indices
-    GLuint              _VAOname;
-    GLuint              _buffersVBO[2]; //0: vertex  1: indices
+    V3F_C4B_T2F_Quad    *_quads;        // quads to be rendered, the renderer copies the living ones
 
     QuadCommand _quadCommand;           // quad command
 
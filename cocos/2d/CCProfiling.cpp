@@ -26,6 +26,7 @@ THE SOFTWARE.
 #include "CCProfiling.h"
 
 #include <chrono>
+#include <stdio.h>
 
 using namespace std;
 
@@ -182,5 +183,180 @@ void ProfilingResetTimingBlock(const char *timerName)
     timer->reset();
 }
 
+// implementation of ProfilerTimeline
+
+#if defined(_MSC_VER)
+#define CC_PROFILER_THREAD_LOCAL __declspec(thread)
+#else
+#define CC_PROFILER_THREAD_LOCAL __thread
+#endif
+
+// the ProfilerTimeline::ThreadBuffer of the calling thread
+static CC_PROFILER_THREAD_LOCAL void* s_timelineThreadBuffer = nullptr;
+
+std::atomic<bool> ProfilerTimeline::s_recording(false);
+
+static ProfilerTimeline* s_sharedProfilerTimeline = nullptr;
+
+ProfilerTimeline* ProfilerTimeline::getInstance()
+{
+    static std::once_flag once;
+    std::call_once(once, []() { s_sharedProfilerTimeline = new ProfilerTimeline(); });
+    return s_sharedProfilerTimeline;
+}
+
+ProfilerTimeline::ProfilerTimeline()
+: _capture(0)
+, _eventsPerThread(64 * 1024)
+, _mainThreadIndex(-1)
+{
+}
+
+void ProfilerTimeline::setEventsPerThread(size_t count)
+{
+    CCASSERT(count > 0, "Invalid event count");
+    CCASSERT(!isRecording(), "Cannot resize the buffers while recording");
+    _eventsPerThread = count;
+}
+
+void ProfilerTimeline::start()
+{
+    stop();
+
+    _startTime = chrono::steady_clock::now();
+    // the threads reset their buffer when they see a new capture
+    _capture.fetch_add(1, memory_order_release);
+    _mainThreadIndex = getThreadBuffer()->threadIndex;
+    s_recording.store(true, memory_order_release);
+}
+
+void ProfilerTimeline::stop()
+{
+    s_recording.store(false, memory_order_release);
+}
+
+ProfilerTimeline::ThreadBuffer* ProfilerTimeline::getThreadBuffer()
+{
+    ThreadBuffer* buffer = static_cast<ThreadBuffer*>(s_timelineThreadBuffer);
+    if (buffer == nullptr)
+    {
+        buffer = new ThreadBuffer();
+        buffer->capture = 0;
+        buffer->count = 0;
+
+        std::lock_guard<std::mutex> lock(_buffersMutex);
+        buffer->threadIndex = (int)_buffers.size();
+        _buffers.push_back(buffer);
+        s_timelineThreadBuffer = buffer;
+    }
+    return buffer;
+}
+
+void ProfilerTimeline::record(EventType type, const char* name, long long value)
+{
+    ThreadBuffer* buffer = getThreadBuffer();
+
+    unsigned int capture = _capture.load(memory_order_acquire);
+    if (buffer->capture.load(memory_order_relaxed) != capture)
+    {
+        // the scopes still open when writeToFile() ended the capture don't
+        // write in the buffers it reads
+        if (!isRecording())
+        {
+            return;
+        }
+
+        // first event of the thread in this capture
+        if (buffer->events.size() != _eventsPerThread)
+        {
+            buffer->events.resize(_eventsPerThread);
+        }
+        buffer->count.store(0, memory_order_relaxed);
+        buffer->capture.store(capture, memory_order_release);
+    }
+
+    size_t count = buffer->count.load(memory_order_relaxed);
+    Event& event = buffer->events[count % buffer->events.size()];
+    event.time = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - _startTime).count();
+    event.value = value;
+    event.name = name;
+    event.type = type;
+
+    // publishes the event to writeToFile()
+    buffer->count.store(count + 1, memory_order_release);
+}
+
+static void writeTimelineString(FILE* file, const char* str)
+{
+    fputc('"', file);
+    for (; *str; ++str)
+    {
+        if (*str == '"' || *str == '\\')
+        {
+            fputc('\\', file);
+        }
+        fputc(*str, file);
+    }
+    fputc('"', file);
+}
+
+bool ProfilerTimeline::writeToFile(const std::string& fullPath)
+{
+    CCASSERT(!isRecording(), "Stop the capture before writing it");
+
+    FILE* file = fopen(fullPath.c_str(), "wb");
+    if (file == nullptr)
+    {
+        CCLOG("cocos2d: ProfilerTimeline: can't open %s", fullPath.c_str());
+        return false;
+    }
+
+    // ends the capture: from now on the threads only record in the buffers after a start()
+    unsigned int capture = _capture.fetch_add(1, memory_order_acq_rel);
+    bool first = true;
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+    std::lock_guard<std::mutex> lock(_buffersMutex);
+    for (auto& buffer : _buffers)
+    {
+        if (buffer->capture.load(memory_order_acquire) != capture)
+        {
+            continue;
+        }
+
+        fprintf(file, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s %d\"}}",
+                first ? "" : ",", buffer->threadIndex, buffer->threadIndex == _mainThreadIndex ? "main" : "thread", buffer->threadIndex);
+        first = false;
+
+        // the ring buffer keeps the last events. A thread that read the capture before it ended
+        // may still write one event, over the oldest one: it is skipped
+        size_t count = buffer->count.load(memory_order_acquire);
+        size_t size = buffer->events.size();
+        for (size_t i = count >= size ? count - size + 1 : 0; i < count; ++i)
+        {
+            const Event& event = buffer->events[i % size];
+
+            fprintf(file, ",\n{\"name\":");
+            writeTimelineString(file, event.name);
+            fprintf(file, ",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%d", (char)event.type, event.time / 1000.0, buffer->threadIndex);
+            if (event.type == EventType::COUNTER)
+            {
+                fprintf(file, ",\"args\":{\"value\":%lld}", event.value);
+            }
+            else if (event.type == EventType::MARKER)
+            {
+                fprintf(file, ",\"s\":\"t\"");
+            }
+            fputc('}', file);
+        }
+    }
+
+    fprintf(file, "\n]}\n");
+    bool ok = ferror(file) == 0;
+    fclose(file);
+    return ok;
+}
+
 NS_CC_END
 
@@ -28,6 +28,9 @@ THE SOFTWARE.
 
 #include <string>
 #include <chrono>
+#include <atomic>
+#include <mutex>
+#include <vector>
 #include "ccConfig.h"
 #include "CCRef.h"
 #include "CCMap.h"
@@ -156,6 +159,107 @@ extern bool kProfilerCategorySprite;
 extern bool kProfilerCategoryBatchSprite;
 extern bool kProfilerCategoryParticles;
 
+/** ProfilerTimeline
+ Records a timeline of begin / end events, counters and markers, to find the frames that take longer than the others.
+
+ Every thread records in its own ring buffer, without locks. When no capture is running recording costs a single test,
+ so it is built in unless CC_ENABLE_PROFILER_TIMELINE is set to 0 in ccConfig.h.
+ A capture is exported in the Chrome trace event format: load the file in chrome://tracing.
+ It can be started and stopped with the "profile" command of the Console.
+ */
+class CC_DLL ProfilerTimeline
+{
+public:
+    enum class EventType : char
+    {
+        BEGIN = 'B',
+        END = 'E',
+        COUNTER = 'C',
+        MARKER = 'i',
+    };
+
+    /** returns the singleton
+     * @js NA
+     * @lua NA
+     */
+    static ProfilerTimeline* getInstance();
+
+    /** Discards the previous capture and starts recording */
+    void start();
+    /** Stops recording. The capture is kept until it is written or the next start() */
+    void stop();
+    static bool isRecording() { return s_recording.load(std::memory_order_relaxed); }
+
+    /** Writes the last capture in the Chrome trace event format and ends it. Call it after stop() */
+    bool writeToFile(const std::string& fullPath);
+
+    /** Size of the ring buffer of each thread, the oldest events are overwritten. Changes apply to the next capture */
+    void setEventsPerThread(size_t count);
+    size_t getEventsPerThread() const { return _eventsPerThread; }
+
+    /** Records an event of the calling thread.
+     * The name isn't copied: it must outlive the capture, use string literals.
+     */
+    void record(EventType type, const char* name, long long value = 0);
+
+protected:
+    ProfilerTimeline();
+
+    struct Event
+    {
+        long long time;         // nanoseconds since the start of the capture
+        long long value;
+        const char* name;
+        EventType type;
+    };
+
+    struct ThreadBuffer
+    {
+        int threadIndex;
+        std::atomic<unsigned int> capture;  // the capture the events belong to
+        std::vector<Event> events;
+        std::atomic<size_t> count;      // events recorded in the capture, the buffer keeps the last ones
+    };
+
+    ThreadBuffer* getThreadBuffer();
+
+    static std::atomic<bool> s_recording;
+
+    std::chrono::steady_clock::time_point _startTime;
+    std::atomic<unsigned int> _capture;
+    size_t _eventsPerThread;
+    int _mainThreadIndex;
+
+    // buffers of every thread that recorded, they live as long as the profiler
+    std::mutex _buffersMutex;
+    std::vector<ThreadBuffer*> _buffers;
+};
+
+/** Records a begin event in its constructor and the matching end event in its destructor */
+class ProfilerTimelineScope
+{
+public:
+    ProfilerTimelineScope(const char* name)
+    : _name(nullptr)
+    {
+        if (ProfilerTimeline::isRecording())
+        {
+            _name = name;
+            ProfilerTimeline::getInstance()->record(ProfilerTimeline::EventType::BEGIN, name);
+        }
+    }
+    ~ProfilerTimelineScope()
+    {
+        if (_name)
+        {
+            ProfilerTimeline::getInstance()->record(ProfilerTimeline::EventType::END, _name);
+        }
+    }
+
+private:
+    const char* _name;
+};
+
 // end of global group
 /// @}
 
@@ -28,42 +28,21 @@ THE SOFTWARE.
 #include "CCScheduler.h"
 #include "ccMacros.h"
 #include "CCDirector.h"
-#include "utlist.h"
 #include "ccCArray.h"
 #include "CCScriptSupport.h"
+#include "CCProfiling.h"
+
+#include <algorithm>
 
 NS_CC_BEGIN
 
 // data structures
 
-// A list double-linked list used for "updates with priority"
-typedef struct _listEntry
-{
-    struct _listEntry   *prev, *next;
-    ccSchedulerFunc     callback;
-    void                *target;
-    int                 priority;
-    bool                paused;
-    bool                markedForDeletion; // selector will no longer be called and entry will be removed at end of the next tick
-} tListEntry;
-
-typedef struct _hashUpdateEntry
-{
-    tListEntry          **list;        // Which list does it belong to ?
-    tListEntry          *entry;        // entry in the list
-    void                *target;
-    ccSchedulerFunc     callback;
-    UT_hash_handle      hh;
-} tHashUpdateEntry;
-
 // Hash Element used for "selectors with interval"
 typedef struct _hashSelectorEntry
 {
     ccArray             *timers;
     void                *target;
-    int                 timerIndex;
-    Timer               *currentTimer;
-    bool                currentTimerSalvaged;
     bool                paused;
     UT_hash_handle      hh;
 } tHashTimerEntry;
@@ -79,6 +58,12 @@ Timer::Timer()
 , _repeat(0)
 , _delay(0.0f)
 , _interval(0.0f)
+, _deadline(0.0)
+, _lastTime(0.0)
+, _heapIndex(-1)
+, _order(0)
+, _scheduled(false)
+, _paused(false)
 {
 }
 
@@ -145,6 +130,41 @@ void Timer::update(float dt)
     }
 }
 
+void Timer::expire(double time)
+{
+    if (_elapsed == -1)
+    {
+        // like update(), the time counts from the first tick
+        _elapsed = 0;
+        _timesExecuted = 0;
+        _lastTime = time;
+        _deadline = time + (_useDelay ? _delay : _interval);
+        return;
+    }
+
+    _elapsed = static_cast<float>(time - _lastTime);
+
+    // the next deadline is computed before the callback, which may pause or reschedule the timer
+    if (_runForever && !_useDelay)
+    {//standard timer usage
+        _lastTime = time;
+    }
+    else
+    {//advanced usage
+        // the time elapsed after the delay counts for the first interval
+        _lastTime = _useDelay ? _deadline : time;
+        _useDelay = false;
+        _timesExecuted += 1;
+    }
+    _deadline = _lastTime + _interval;
+
+    trigger();
+
+    if (!_runForever && _timesExecuted > _repeat)
+    {    //unschedule timer
+        cancel();
+    }
+}
 
 // TimerTargetSelector
 
@@ -247,13 +267,10 @@ const int Scheduler::PRIORITY_NON_SYSTEM_MIN = PRIORITY_SYSTEM + 1;
 
 Scheduler::Scheduler(void)
 : _timeScale(1.0f)
-, _updatesNegList(nullptr)
-, _updates0List(nullptr)
-, _updatesPosList(nullptr)
-, _hashForUpdates(nullptr)
+, _updatesMarkedForDeletion(0)
 , _hashForTimers(nullptr)
-, _currentTarget(nullptr)
-, _currentTargetSalvaged(false)
+, _timerClock(0.0)
+, _timerOrder(0)
 , _updateHashLocked(false)
 #if CC_ENABLE_SCRIPT_BINDING
 , _scriptHandlerEntries(20)
@@ -266,6 +283,7 @@ Scheduler::Scheduler(void)
 Scheduler::~Scheduler(void)
 {
     unscheduleAll();
+    removeMarkedUpdates();
 }
 
 void Scheduler::removeHashElement(_hashSelectorEntry *element)
@@ -275,6 +293,173 @@ void Scheduler::removeHashElement(_hashSelectorEntry *element)
     free(element);
 }
 
+void Scheduler::addTimer(_hashSelectorEntry *element, Timer *timer)
+{
+    ccArrayAppendObject(element->timers, timer);
+
+    timer->_scheduled = true;
+    timer->_order = _timerOrder++;
+
+    // the timer is started by the next tick
+    if (element->paused)
+    {
+        timer->_paused = true;
+        timer->_deadline = 0.0;
+    }
+    else
+    {
+        timer->_paused = false;
+        timer->_deadline = _timerClock;
+        pushTimer(timer);
+    }
+}
+
+void Scheduler::removeTimer(Timer *timer)
+{
+    if (timer->_heapIndex >= 0)
+    {
+        eraseTimer(timer);
+    }
+    timer->_scheduled = false;
+}
+
+void Scheduler::pauseTimers(_hashSelectorEntry *element)
+{
+    for (int i = 0; i < element->timers->num; ++i)
+    {
+        Timer *timer = static_cast<Timer*>(element->timers->arr[i]);
+        if (! timer->_paused)
+        {
+            // a paused timer keeps the time left until its deadline
+            if (timer->_heapIndex >= 0)
+            {
+                eraseTimer(timer);
+            }
+            timer->_paused = true;
+            timer->_deadline -= _timerClock;
+            timer->_lastTime -= _timerClock;
+        }
+    }
+}
+
+void Scheduler::resumeTimers(_hashSelectorEntry *element)
+{
+    for (int i = 0; i < element->timers->num; ++i)
+    {
+        Timer *timer = static_cast<Timer*>(element->timers->arr[i]);
+        if (timer->_paused)
+        {
+            timer->_paused = false;
+            timer->_deadline += _timerClock;
+            timer->_lastTime += _timerClock;
+            pushTimer(timer);
+        }
+    }
+}
+
+void Scheduler::updateTimerDeadline(Timer *timer)
+{
+    // the deadline of a timer that is not started yet or waiting for its delay doesn't depend on the interval
+    if (timer->_elapsed == -1 || timer->_useDelay)
+    {
+        return;
+    }
+
+    timer->_deadline = timer->_lastTime + timer->_interval;
+    if (timer->_heapIndex >= 0)
+    {
+        siftTimerUp(timer->_heapIndex);
+        siftTimerDown(timer->_heapIndex);
+    }
+}
+
+void Scheduler::pushTimer(Timer *timer)
+{
+    CCASSERT(timer->_heapIndex < 0, "The timer is already in the heap");
+
+    timer->_heapIndex = static_cast<int>(_timerHeap.size());
+    _timerHeap.push_back(timer);
+    siftTimerUp(timer->_heapIndex);
+}
+
+void Scheduler::eraseTimer(Timer *timer)
+{
+    int index = timer->_heapIndex;
+    CCASSERT(index >= 0 && _timerHeap[index] == timer, "The timer is not in the heap");
+
+    Timer *last = _timerHeap.back();
+    _timerHeap.pop_back();
+    timer->_heapIndex = -1;
+
+    if (last != timer)
+    {
+        _timerHeap[index] = last;
+        last->_heapIndex = index;
+        siftTimerUp(index);
+        siftTimerDown(last->_heapIndex);
+    }
+}
+
+void Scheduler::siftTimerUp(int index)
+{
+    Timer *timer = _timerHeap[index];
+    while (index > 0)
+    {
+        int parentIndex = (index - 1) / 2;
+        Timer *parent = _timerHeap[parentIndex];
+        if (parent->_deadline < timer->_deadline
+            || (parent->_deadline == timer->_deadline && parent->_order < timer->_order))
+        {
+            break;
+        }
+
+        _timerHeap[index] = parent;
+        parent->_heapIndex = index;
+        index = parentIndex;
+    }
+    _timerHeap[index] = timer;
+    timer->_heapIndex = index;
+}
+
+void Scheduler::siftTimerDown(int index)
+{
+    int count = static_cast<int>(_timerHeap.size());
+    Timer *timer = _timerHeap[index];
+    while (true)
+    {
+        int childIndex = index * 2 + 1;
+        if (childIndex >= count)
+        {
+            break;
+        }
+
+        // the earliest of the children
+        Timer *child = _timerHeap[childIndex];
+        if (childIndex + 1 < count)
+        {
+            Timer *right = _timerHeap[childIndex + 1];
+            if (right->_deadline < child->_deadline
+                || (right->_deadline == child->_deadline && right->_order < child->_order))
+            {
+                ++childIndex;
+                child = right;
+            }
+        }
+
+        if (timer->_deadline < child->_deadline
+            || (timer->_deadline == child->_deadline && timer->_order < child->_order))
+        {
+            break;
+        }
+
+        _timerHeap[index] = child;
+        child->_heapIndex = index;
+        index = childIndex;
+    }
+    _timerHeap[index] = timer;
+    timer->_heapIndex = index;
+}
+
 void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float interval, bool paused, const std::string& key)
 {
     this->schedule(callback, target, interval, kRepeatForever, 0.0f, paused, key);
@@ -317,6 +502,7 @@ void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float in
             {
                 CCLOG("CCScheduler#scheduleSelector. Selector already scheduled. Updating interval from: %.4f to %.4f", timer->getInterval(), interval);
                 timer->setInterval(interval);
+                updateTimerDeadline(timer);
                 return;
             }        
         }
@@ -325,7 +511,7 @@ void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float in
 
     TimerTargetCallback *timer = new TimerTargetCallback();
     timer->initWithCallback(this, callback, target, key, interval, repeat, delay);
-    ccArrayAppendObject(element->timers, timer);
+    addTimer(element, timer);
     timer->release();
 }
 
@@ -351,30 +537,13 @@ void Scheduler::unschedule(const std::string &key, void *target)
 
             if (key == timer->getKey())
             {
-                if (timer == element->currentTimer && (! element->currentTimerSalvaged))
-                {
-                    element->currentTimer->retain();
-                    element->currentTimerSalvaged = true;
-                }
-
+                // the timers triggered by the current tick are retained until the end of it
+                removeTimer(timer);
                 ccArrayRemoveObjectAtIndex(element->timers, i, true);
 
-                // update timerIndex in case we are in tick:, looping over the actions
-                if (element->timerIndex >= i)
-                {
-                    element->timerIndex--;
-                }
-
                 if (element->timers->num == 0)
                 {
-                    if (_currentTarget == element)
-                    {
-                        _currentTargetSalvaged = true;
-                    }
-                    else
-                    {
-                        removeHashElement(element);
-                    }
+                    removeHashElement(element);
                 }
 
                 return;
@@ -383,112 +552,164 @@ void Scheduler::unschedule(const std::string &key, void *target)
     }
 }
 
-void Scheduler::priorityIn(tListEntry **list, const ccSchedulerFunc& callback, void *target, int priority, bool paused)
+// the callbacks of schedulePerFrame(ccSchedulerFunc) are stored in the entries as objects of this function
+static void invokeCallback(void *object, float dt)
+{
+    (*static_cast<ccSchedulerFunc*>(object))(dt);
+}
+
+Scheduler::UpdateHandle Scheduler::schedulePerFrame(const ccSchedulerFunc& callback, void *target, int priority, bool paused)
+{
+    auto iter = _updateHandles.find(target);
+    if (iter != _updateHandles.end())
+    {
+        CCASSERT(false, "The update selector of the target is already scheduled");
+        return iter->second;
+    }
+
+    return schedulePerFrame(invokeCallback, new ccSchedulerFunc(callback), target, priority, paused);
+}
+
+Scheduler::UpdateHandle Scheduler::schedulePerFrame(UpdateFunction function, void *object, void *target, int priority, bool paused)
 {
-    tListEntry *listElement = new tListEntry();
+    CCASSERT(function, "Argument function must be non-nullptr");
+    CCASSERT(target, "Argument target must be non-nullptr");
 
-    listElement->callback = callback;
-    listElement->target = target;
-    listElement->priority = priority;
-    listElement->paused = paused;
-    listElement->next = listElement->prev = nullptr;
-    listElement->markedForDeletion = false;
+    auto iter = _updateHandles.find(target);
+    if (iter != _updateHandles.end())
+    {
+        // TODO: check if priority has changed!
+        CCASSERT(false, "The update selector of the target is already scheduled");
+        return iter->second;
+    }
 
-    // empty list ?
-    if (! *list)
+    UpdateHandle handle;
+    if (_freeUpdateSlots.empty())
     {
-        DL_APPEND(*list, listElement);
+        UpdateSlot slot = { -1, -1, 0 };
+        handle.index = static_cast<unsigned int>(_updateSlots.size());
+        _updateSlots.push_back(slot);
     }
     else
     {
-        bool added = false;
+        handle.index = _freeUpdateSlots.back();
+        _freeUpdateSlots.pop_back();
+    }
+    handle.generation = _updateSlots[handle.index].generation;
+
+    UpdateEntry entry;
+    entry.function = function;
+    entry.object = object;
+    entry.target = target;
+    entry.priority = priority;
+    entry.handleIndex = handle.index;
+    entry.paused = paused;
+    entry.markedForDeletion = false;
+    insertUpdateEntry(entry);
+
+    _updateHandles[target] = handle;
+    return handle;
+}
 
-        for (tListEntry *element = *list; element; element = element->next)
-        {
-            if (priority < element->priority)
-            {
-                if (element == *list)
-                {
-                    DL_PREPEND(*list, listElement);
-                }
-                else
-                {
-                    listElement->next = element;
-                    listElement->prev = element->prev;
+void Scheduler::insertUpdateEntry(const UpdateEntry& entry)
+{
+    int bucket = UPDATE_BUCKET_ZERO;
+    if (_updateHashLocked)
+    {
+        // the buckets must not move while they are iterated
+        bucket = UPDATE_BUCKET_PENDING;
+    }
+    else if (entry.priority < 0)
+    {
+        bucket = UPDATE_BUCKET_NEGATIVE;
+    }
+    else if (entry.priority > 0)
+    {
+        bucket = UPDATE_BUCKET_POSITIVE;
+    }
 
-                    element->prev->next = listElement;
-                    element->prev = listElement;
-                }
+    auto& entries = _updateBuckets[bucket];
 
-                added = true;
-                break;
-            }
-        }
+    // most of the updates are going to be 0, they are appended
+    size_t index = entries.size();
+    if (bucket == UPDATE_BUCKET_NEGATIVE || bucket == UPDATE_BUCKET_POSITIVE)
+    {
+        auto position = std::upper_bound(entries.begin(), entries.end(), entry.priority, [](int priority, const UpdateEntry& other) {
+            return priority < other.priority;
+        });
+        index = position - entries.begin();
+    }
+    entries.insert(entries.begin() + index, entry);
 
-        // Not added? priority has the higher value. Append it.
-        if (! added)
+    for (size_t i = index; i < entries.size(); ++i)
+    {
+        // the slot of a removed entry may already be used by another one
+        if (! entries[i].markedForDeletion)
         {
-            DL_APPEND(*list, listElement);
+            auto& slot = _updateSlots[entries[i].handleIndex];
+            slot.bucket = bucket;
+            slot.index = static_cast<int>(i);
         }
     }
-
-    // update hash entry for quick access
-    tHashUpdateEntry *hashElement = (tHashUpdateEntry *)calloc(sizeof(*hashElement), 1);
-    hashElement->target = target;
-    hashElement->list = list;
-    hashElement->entry = listElement;
-    HASH_ADD_PTR(_hashForUpdates, target, hashElement);
 }
 
-void Scheduler::appendIn(_listEntry **list, const ccSchedulerFunc& callback, void *target, bool paused)
+Scheduler::UpdateEntry* Scheduler::getUpdateEntry(const UpdateHandle& handle)
 {
-    tListEntry *listElement = new tListEntry();
+    if (! isScheduled(handle))
+    {
+        return nullptr;
+    }
 
-    listElement->callback = callback;
-    listElement->target = target;
-    listElement->paused = paused;
-    listElement->markedForDeletion = false;
+    const auto& slot = _updateSlots[handle.index];
+    return &_updateBuckets[slot.bucket][slot.index];
+}
 
-    DL_APPEND(*list, listElement);
+Scheduler::UpdateEntry* Scheduler::getUpdateEntry(void *target)
+{
+    auto iter = _updateHandles.find(target);
+    if (iter == _updateHandles.end())
+    {
+        return nullptr;
+    }
 
-    // update hash entry for quicker access
-    tHashUpdateEntry *hashElement = (tHashUpdateEntry *)calloc(sizeof(*hashElement), 1);
-    hashElement->target = target;
-    hashElement->list = list;
-    hashElement->entry = listElement;
-    HASH_ADD_PTR(_hashForUpdates, target, hashElement);
+    return getUpdateEntry(iter->second);
 }
 
-void Scheduler::schedulePerFrame(const ccSchedulerFunc& callback, void *target, int priority, bool paused)
+void Scheduler::removeMarkedUpdates()
 {
-    tHashUpdateEntry *hashElement = nullptr;
-    HASH_FIND_PTR(_hashForUpdates, &target, hashElement);
-    if (hashElement)
+    for (int bucket = 0; bucket < UPDATE_BUCKET_COUNT && _updatesMarkedForDeletion > 0; ++bucket)
     {
-#if COCOS2D_DEBUG >= 1
-        CCASSERT(hashElement->entry->markedForDeletion,"");
-#endif
-        // TODO: check if priority has changed!
+        auto& entries = _updateBuckets[bucket];
+        size_t count = 0;
+        for (size_t i = 0; i < entries.size(); ++i)
+        {
+            const auto& entry = entries[i];
+            if (entry.markedForDeletion)
+            {
+                if (entry.function == invokeCallback)
+                {
+                    delete static_cast<ccSchedulerFunc*>(entry.object);
+                }
+                --_updatesMarkedForDeletion;
+                continue;
+            }
 
-        hashElement->entry->markedForDeletion = false;
-        return;
+            if (count != i)
+            {
+                entries[count] = entry;
+                _updateSlots[entry.handleIndex].index = static_cast<int>(count);
+            }
+            ++count;
+        }
+        entries.resize(count);
     }
+}
 
-    // most of the updates are going to be 0, that's way there
-    // is an special list for updates with priority 0
-    if (priority == 0)
-    {
-        appendIn(&_updates0List, callback, target, paused);
-    }
-    else if (priority < 0)
-    {
-        priorityIn(&_updatesNegList, callback, target, priority, paused);
-    }
-    else
-    {
-        // priority > 0
-        priorityIn(&_updatesPosList, callback, target, priority, paused);
-    }
+bool Scheduler::isScheduled(const UpdateHandle& handle) const
+{
+    return handle.index < _updateSlots.size()
+        && _updateSlots[handle.index].generation == handle.generation
+        && _updateSlots[handle.index].bucket >= 0;
 }
 
 bool Scheduler::isScheduled(const std::string& key, void *target)
@@ -526,23 +747,6 @@ bool Scheduler::isScheduled(const std::string& key, void *target)
     return false;  // should never get here
 }
 
-void Scheduler::removeUpdateFromHash(struct _listEntry *entry)
-{
-    tHashUpdateEntry *element = nullptr;
-
-    HASH_FIND_PTR(_hashForUpdates, &entry->target, element);
-    if (element)
-    {
-        // list entry
-        DL_DELETE(*element->list, element->entry);
-        CC_SAFE_DELETE(element->entry);
-
-        // hash entry
-        HASH_DEL(_hashForUpdates, element);
-        free(element);
-    }
-}
-
 void Scheduler::unscheduleUpdate(void *target)
 {
     if (target == nullptr)
@@ -550,18 +754,30 @@ void Scheduler::unscheduleUpdate(void *target)
         return;
     }
 
-    tHashUpdateEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForUpdates, &target, element);
-    if (element)
+    auto iter = _updateHandles.find(target);
+    if (iter != _updateHandles.end())
     {
-        if (_updateHashLocked)
-        {
-            element->entry->markedForDeletion = true;
-        }
-        else
-        {
-            this->removeUpdateFromHash(element->entry);
-        }
+        auto& slot = _updateSlots[iter->second.index];
+
+        // the callback may be running: the entry is removed at the end of the next tick
+        _updateBuckets[slot.bucket][slot.index].markedForDeletion = true;
+        ++_updatesMarkedForDeletion;
+
+        // the handles of the entry are no longer valid, and its slot can be reused
+        slot.bucket = -1;
+        slot.index = -1;
+        ++slot.generation;
+        _freeUpdateSlots.push_back(iter->second.index);
+        _updateHandles.erase(iter);
+    }
+}
+
+void Scheduler::unscheduleUpdate(const UpdateHandle& handle)
+{
+    auto entry = getUpdateEntry(handle);
+    if (entry)
+    {
+        unscheduleUpdate(entry->target);
     }
 }
 
@@ -585,33 +801,17 @@ void Scheduler::unscheduleAllWithMinPriority(int minPriority)
     }
 
     // Updates selectors
-    tListEntry *entry, *tmp;
-    if(minPriority < 0)
+    for (auto& entries : _updateBuckets)
     {
-        DL_FOREACH_SAFE(_updatesNegList, entry, tmp)
+        // unscheduleUpdate() only marks the entries
+        for (const auto& entry : entries)
         {
-            if(entry->priority >= minPriority)
+            if (! entry.markedForDeletion && entry.priority >= minPriority)
             {
-                unscheduleUpdate(entry->target);
+                unscheduleUpdate(entry.target);
             }
         }
     }
-
-    if(minPriority <= 0)
-    {
-        DL_FOREACH_SAFE(_updates0List, entry, tmp)
-        {
-            unscheduleUpdate(entry->target);
-        }
-    }
-
-    DL_FOREACH_SAFE(_updatesPosList, entry, tmp)
-    {
-        if(entry->priority >= minPriority)
-        {
-            unscheduleUpdate(entry->target);
-        }
-    }
 #if CC_ENABLE_SCRIPT_BINDING
     _scriptHandlerEntries.clear();
 #endif
@@ -631,22 +831,11 @@ void Scheduler::unscheduleAllForTarget(void *target)
 
     if (element)
     {
-        if (ccArrayContainsObject(element->timers, element->currentTimer)
-            && (! element->currentTimerSalvaged))
-        {
-            element->currentTimer->retain();
-            element->currentTimerSalvaged = true;
-        }
-        ccArrayRemoveAllObjects(element->timers);
-
-        if (_currentTarget == element)
-        {
-            _currentTargetSalvaged = true;
-        }
-        else
+        for (int i = 0; i < element->timers->num; ++i)
         {
-            removeHashElement(element);
+            removeTimer(static_cast<Timer*>(element->timers->arr[i]));
         }
+        removeHashElement(element);
     }
 
     // update selector
@@ -683,18 +872,17 @@ void Scheduler::resumeTarget(void *target)
     // custom selectors
     tHashTimerEntry *element = nullptr;
     HASH_FIND_PTR(_hashForTimers, &target, element);
-    if (element)
+    if (element && element->paused)
     {
         element->paused = false;
+        resumeTimers(element);
     }
 
     // update selector
-    tHashUpdateEntry *elementUpdate = nullptr;
-    HASH_FIND_PTR(_hashForUpdates, &target, elementUpdate);
-    if (elementUpdate)
+    auto entry = getUpdateEntry(target);
+    if (entry)
     {
-        CCASSERT(elementUpdate->entry != nullptr, "");
-        elementUpdate->entry->paused = false;
+        entry->paused = false;
     }
 }
 
@@ -705,18 +893,17 @@ void Scheduler::pauseTarget(void *target)
     // custom selectors
     tHashTimerEntry *element = nullptr;
     HASH_FIND_PTR(_hashForTimers, &target, element);
-    if (element)
+    if (element && ! element->paused)
     {
         element->paused = true;
+        pauseTimers(element);
     }
 
     // update selector
-    tHashUpdateEntry *elementUpdate = nullptr;
-    HASH_FIND_PTR(_hashForUpdates, &target, elementUpdate);
-    if (elementUpdate)
+    auto entry = getUpdateEntry(target);
+    if (entry)
     {
-        CCASSERT(elementUpdate->entry != nullptr, "");
-        elementUpdate->entry->paused = true;
+        entry->paused = true;
     }
 }
 
@@ -733,11 +920,10 @@ bool Scheduler::isTargetPaused(void *target)
     }
     
     // We should check update selectors if target does not have custom selectors
-	tHashUpdateEntry *elementUpdate = nullptr;
-	HASH_FIND_PTR(_hashForUpdates, &target, elementUpdate);
-	if ( elementUpdate )
+    auto entry = getUpdateEntry(target);
+    if (entry)
     {
-		return elementUpdate->entry->paused;
+        return entry->paused;
     }
     
     return false;  // should never get here
@@ -756,42 +942,27 @@ std::set<void*> Scheduler::pauseAllTargetsWithMinPriority(int minPriority)
     for(tHashTimerEntry *element = _hashForTimers; element != nullptr;
         element = (tHashTimerEntry*)element->hh.next)
     {
-        element->paused = true;
+        if (! element->paused)
+        {
+            element->paused = true;
+            pauseTimers(element);
+        }
         idsWithSelectors.insert(element->target);
     }
 
     // Updates selectors
-    tListEntry *entry, *tmp;
-    if(minPriority < 0)
+    for (auto& entries : _updateBuckets)
     {
-        DL_FOREACH_SAFE( _updatesNegList, entry, tmp ) 
+        for (auto& entry : entries)
         {
-            if(entry->priority >= minPriority)
+            if (! entry.markedForDeletion && entry.priority >= minPriority)
             {
-                entry->paused = true;
-                idsWithSelectors.insert(entry->target);
+                entry.paused = true;
+                idsWithSelectors.insert(entry.target);
             }
         }
     }
 
-    if(minPriority <= 0)
-    {
-        DL_FOREACH_SAFE( _updates0List, entry, tmp )
-        {
-            entry->paused = true;
-            idsWithSelectors.insert(entry->target);
-        }
-    }
-
-    DL_FOREACH_SAFE( _updatesPosList, entry, tmp ) 
-    {
-        if(entry->priority >= minPriority) 
-        {
-            entry->paused = true;
-            idsWithSelectors.insert(entry->target);
-        }
-    }
-
     return idsWithSelectors;
 }
 
@@ -814,6 +985,8 @@ void Scheduler::performFunctionInCocosThread(const std::function<void ()> &funct
 // main loop
 void Scheduler::update(float dt)
 {
+    CC_PROFILER_TIMELINE_SCOPE("Scheduler::update");
+
     _updateHashLocked = true;
 
     if (_timeScale != 1.0f)
@@ -825,106 +998,64 @@ void Scheduler::update(float dt)
     // Selector callbacks
     //
 
-    // Iterate over all the Updates' selectors
-    tListEntry *entry, *tmp;
-
-    // updates with priority < 0
-    DL_FOREACH_SAFE(_updatesNegList, entry, tmp)
+    // Iterate over all the Updates' selectors, by priority
+    for (int bucket = UPDATE_BUCKET_NEGATIVE; bucket <= UPDATE_BUCKET_POSITIVE; ++bucket)
     {
-        if ((! entry->paused) && (! entry->markedForDeletion))
+        // the entries don't move until the end of the tick: the new ones are pending,
+        // and the removed ones are only marked
+        for (const auto& entry : _updateBuckets[bucket])
         {
-            entry->callback(dt);
+            if ((! entry.paused) && (! entry.markedForDeletion))
+            {
+                entry.function(entry.object, dt);
+            }
         }
     }
 
-    // updates with priority == 0
-    DL_FOREACH_SAFE(_updates0List, entry, tmp)
-    {
-        if ((! entry->paused) && (! entry->markedForDeletion))
-        {
-            entry->callback(dt);
-        }
-    }
+    // Trigger the custom selectors that are due, the other ones are not visited
+    _timerClock += dt;
 
-    // updates with priority > 0
-    DL_FOREACH_SAFE(_updatesPosList, entry, tmp)
+    // the callbacks may schedule, unschedule, pause or resume timers: the heap is not iterated
+    while (! _timerHeap.empty() && _timerHeap.front()->_deadline <= _timerClock)
     {
-        if ((! entry->paused) && (! entry->markedForDeletion))
-        {
-            entry->callback(dt);
-        }
+        Timer *timer = _timerHeap.front();
+        eraseTimer(timer);
+        timer->retain();
+        _dueTimers.push_back(timer);
     }
 
-    // Iterate over all the custom selectors
-    for (tHashTimerEntry *elt = _hashForTimers; elt != nullptr; )
+    for (const auto& timer : _dueTimers)
     {
-        _currentTarget = elt;
-        _currentTargetSalvaged = false;
-
-        if (! _currentTarget->paused)
+        // a previous callback may have unscheduled or paused the timer
+        if (timer->_scheduled && ! timer->_paused && timer->_heapIndex < 0)
         {
-            // The 'timers' array may change while inside this loop
-            for (elt->timerIndex = 0; elt->timerIndex < elt->timers->num; ++(elt->timerIndex))
-            {
-                elt->currentTimer = (Timer*)(elt->timers->arr[elt->timerIndex]);
-                elt->currentTimerSalvaged = false;
-
-                elt->currentTimer->update(dt);
-
-                if (elt->currentTimerSalvaged)
-                {
-                    // The currentTimer told the remove itself. To prevent the timer from
-                    // accidentally deallocating itself before finishing its step, we retained
-                    // it. Now that step is done, it's safe to release it.
-                    elt->currentTimer->release();
-                }
+            timer->expire(_timerClock);
 
-                elt->currentTimer = nullptr;
+            if (timer->_scheduled && ! timer->_paused && timer->_heapIndex < 0)
+            {
+                pushTimer(timer);
             }
         }
-
-        // elt, at this moment, is still valid
-        // so it is safe to ask this here (issue #490)
-        elt = (tHashTimerEntry *)elt->hh.next;
-
-        // only delete currentTarget if no actions were scheduled during the cycle (issue #481)
-        if (_currentTargetSalvaged && _currentTarget->timers->num == 0)
-        {
-            removeHashElement(_currentTarget);
-        }
+        timer->release();
     }
+    _dueTimers.clear();
 
     // delete all updates that are marked for deletion
-    // updates with priority < 0
-    DL_FOREACH_SAFE(_updatesNegList, entry, tmp)
-    {
-        if (entry->markedForDeletion)
-        {
-            this->removeUpdateFromHash(entry);
-        }
-    }
+    removeMarkedUpdates();
 
-    // updates with priority == 0
-    DL_FOREACH_SAFE(_updates0List, entry, tmp)
-    {
-        if (entry->markedForDeletion)
-        {
-            this->removeUpdateFromHash(entry);
-        }
-    }
+    _updateHashLocked = false;
 
-    // updates with priority > 0
-    DL_FOREACH_SAFE(_updatesPosList, entry, tmp)
+    // add the updates scheduled during the tick
+    if (! _updateBuckets[UPDATE_BUCKET_PENDING].empty())
     {
-        if (entry->markedForDeletion)
+        std::vector<UpdateEntry> pendingEntries;
+        pendingEntries.swap(_updateBuckets[UPDATE_BUCKET_PENDING]);
+        for (const auto& entry : pendingEntries)
         {
-            this->removeUpdateFromHash(entry);
+            insertUpdateEntry(entry);
         }
     }
 
-    _updateHashLocked = false;
-    _currentTarget = nullptr;
-
 #if CC_ENABLE_SCRIPT_BINDING
     //
     // Script callbacks
@@ -1002,6 +1133,7 @@ void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, uns
             {
                 CCLOG("CCScheduler#scheduleSelector. Selector already scheduled. Updating interval from: %.4f to %.4f", timer->getInterval(), interval);
                 timer->setInterval(interval);
+                updateTimerDeadline(timer);
                 return;
             }
         }
@@ -1010,7 +1142,7 @@ void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, uns
     
     TimerTargetSelector *timer = new TimerTargetSelector();
     timer->initWithSelector(this, selector, target, interval, repeat, delay);
-    ccArrayAppendObject(element->timers, timer);
+    addTimer(element, timer);
     timer->release();
 }
 
@@ -1076,32 +1208,15 @@ void Scheduler::unschedule(SEL_SCHEDULE selector, Ref *target)
             
             if (selector == timer->getSelector())
             {
-                if (timer == element->currentTimer && (! element->currentTimerSalvaged))
-                {
-                    element->currentTimer->retain();
-                    element->currentTimerSalvaged = true;
-                }
-                
+                // the timers triggered by the current tick are retained until the end of it
+                removeTimer(timer);
                 ccArrayRemoveObjectAtIndex(element->timers, i, true);
-                
-                // update timerIndex in case we are in tick:, looping over the actions
-                if (element->timerIndex >= i)
-                {
-                    element->timerIndex--;
-                }
-                
+
                 if (element->timers->num == 0)
                 {
-                    if (_currentTarget == element)
-                    {
-                        _currentTargetSalvaged = true;
-                    }
-                    else
-                    {
-                        removeHashElement(element);
-                    }
+                    removeHashElement(element);
                 }
-                
+
                 return;
             }
         }
@@ -31,6 +31,8 @@ THE SOFTWARE.
 #include <functional>
 #include <mutex>
 #include <set>
+#include <unordered_map>
+#include <vector>
 
 #include "CCRef.h"
 #include "CCVector.h"
@@ -70,6 +72,12 @@ public:
     void update(float dt);
     
 protected:
+    friend class Scheduler;
+
+    /** Triggers the timer when the clock of the scheduler reaches its deadline, and computes the next deadline.
+     It does the same as update(), but the timer is only visited when it is due.
+     */
+    void expire(double time);
     
     Scheduler* _scheduler; // weak ref
     float _elapsed;
@@ -79,6 +87,15 @@ protected:
     unsigned int _repeat; //0 = once, 1 is 2 x executed
     float _delay;
     float _interval;
+
+    // state of the timer in the heap of the scheduler.
+    // The times are relative to the clock of the scheduler while the timer is paused
+    double _deadline;
+    double _lastTime;     // time of the start or of the last trigger
+    int _heapIndex;       // -1 when the timer is not in the heap
+    unsigned int _order;  // the timers with the same deadline are triggered in schedule order
+    bool _scheduled;
+    bool _paused;
 };
 
 
@@ -145,9 +162,7 @@ private:
 //
 // Scheduler
 //
-struct _listEntry;
 struct _hashSelectorEntry;
-struct _hashUpdateEntry;
 
 #if CC_ENABLE_SCRIPT_BINDING
 class SchedulerScriptHandlerEntry;
@@ -167,6 +182,22 @@ The 'custom selectors' should be avoided when possible. It is faster, and consum
 class CC_DLL Scheduler : public Ref
 {
 public:
+    /** Identifies a scheduled 'update' selector.
+     It becomes invalid when the selector is unscheduled, even if another selector gets its slot.
+     @since v3.0
+     */
+    struct UpdateHandle
+    {
+        unsigned int index;
+        unsigned int generation;
+    };
+
+    /** Function called every frame with the object given to schedulePerFrame().
+     Unlike ccSchedulerFunc, it doesn't allocate memory and it is called without indirection.
+     @since v3.0
+     */
+    typedef void (*UpdateFunction)(void *object, float dt);
+
     // Priority level reserved for system services.
     static const int PRIORITY_SYSTEM;
     
@@ -241,13 +272,18 @@ public:
      @lua NA
      */
     template <class T>
-    void scheduleUpdate(T *target, int priority, bool paused)
+    UpdateHandle scheduleUpdate(T *target, int priority, bool paused)
     {
-        this->schedulePerFrame([target](float dt){
-            target->update(dt);
-        }, target, priority, paused);
+        return this->schedulePerFrame(&Scheduler::invokeUpdate<T>, target, target, priority, paused);
     }
 
+    /** Schedules 'function' for a given target with a given priority. It will be called every frame with 'object'.
+     The lower the priority, the earlier it is called. The target identifies the selector, like in scheduleUpdate().
+     The callbacks scheduled while the scheduler is updating are called from the next frame.
+     @since v3.0
+     */
+    UpdateHandle schedulePerFrame(UpdateFunction function, void *object, void *target, int priority, bool paused);
+
 #if CC_ENABLE_SCRIPT_BINDING
     // schedule for script bindings
     /** The scheduled script callback will be called every 'interval' seconds.
@@ -277,6 +313,11 @@ public:
      @since v0.99.3
      */
     void unscheduleUpdate(void *target);
+
+    /** Unschedules the update selector of a handle. Nothing happens if the handle is no longer valid.
+     @since v3.0
+     */
+    void unscheduleUpdate(const UpdateHandle& handle);
     
     /** Unschedules all selectors for a given target.
      This also includes the "update" selector.
@@ -316,6 +357,11 @@ public:
      @since v3.0
      */
     bool isScheduled(SEL_SCHEDULE selector, Ref *target);
+
+    /** Checks whether the update selector of a handle is still scheduled.
+     @since v3.0
+     */
+    bool isScheduled(const UpdateHandle& handle) const;
     
     /////////////////////////////////////
     
@@ -426,31 +472,78 @@ protected:
      @note This method is only for internal use.
      @since v3.0
      */
-    void schedulePerFrame(const ccSchedulerFunc& callback, void *target, int priority, bool paused);
+    UpdateHandle schedulePerFrame(const ccSchedulerFunc& callback, void *target, int priority, bool paused);
     
     void removeHashElement(struct _hashSelectorEntry *element);
-    void removeUpdateFromHash(struct _listEntry *entry);
+
+    // timer specific
+    void addTimer(struct _hashSelectorEntry *element, Timer *timer);
+    void removeTimer(Timer *timer);
+    void pauseTimers(struct _hashSelectorEntry *element);
+    void resumeTimers(struct _hashSelectorEntry *element);
+    void updateTimerDeadline(Timer *timer);
+    void pushTimer(Timer *timer);
+    void eraseTimer(Timer *timer);
+    void siftTimerUp(int index);
+    void siftTimerDown(int index);
 
     // update specific
 
-    void priorityIn(struct _listEntry **list, const ccSchedulerFunc& callback, void *target, int priority, bool paused);
-    void appendIn(struct _listEntry **list, const ccSchedulerFunc& callback, void *target, bool paused);
+    template <class T>
+    static void invokeUpdate(void *target, float dt)
+    {
+        static_cast<T*>(target)->update(dt);
+    }
+
+    struct UpdateEntry
+    {
+        UpdateFunction function;
+        void *object;
+        void *target;
+        int priority;
+        unsigned int handleIndex;
+        bool paused;
+        bool markedForDeletion; // selector will no longer be called and entry will be removed at end of the next tick
+    };
+
+    struct UpdateSlot
+    {
+        int bucket;
+        int index;
+        unsigned int generation;
+    };
+
+    enum
+    {
+        UPDATE_BUCKET_NEGATIVE,  // priority < 0
+        UPDATE_BUCKET_ZERO,      // priority == 0
+        UPDATE_BUCKET_POSITIVE,  // priority > 0
+        UPDATE_BUCKET_PENDING,   // scheduled during update(), moved to their bucket at the end of it
+        UPDATE_BUCKET_COUNT
+    };
 
+    UpdateEntry* getUpdateEntry(const UpdateHandle& handle);
+    UpdateEntry* getUpdateEntry(void *target);
+    void insertUpdateEntry(const UpdateEntry& entry);
+    void removeMarkedUpdates();
 
     float _timeScale;
 
     //
     // "updates with priority" stuff
     //
-    struct _listEntry *_updatesNegList;        // list of priority < 0
-    struct _listEntry *_updates0List;            // list priority == 0
-    struct _listEntry *_updatesPosList;        // list priority > 0
-    struct _hashUpdateEntry *_hashForUpdates; // hash used to fetch quickly the list entries for pause,delete,etc
+    std::vector<UpdateEntry> _updateBuckets[UPDATE_BUCKET_COUNT]; // sorted by priority, then by schedule order
+    std::vector<UpdateSlot> _updateSlots;      // where the entry of a handle is
+    std::vector<unsigned int> _freeUpdateSlots;
+    std::unordered_map<void*, UpdateHandle> _updateHandles; // used to fetch quickly the entries for pause,delete,etc
+    int _updatesMarkedForDeletion;
 
     // Used for "selectors with interval"
     struct _hashSelectorEntry *_hashForTimers;
-    struct _hashSelectorEntry *_currentTarget;
-    bool _currentTargetSalvaged;
+    std::vector<Timer*> _timerHeap;   // min-heap of the running timers, sorted by deadline
+    std::vector<Timer*> _dueTimers;   // timers triggered by the current tick, retained
+    double _timerClock;               // scaled time since the creation of the scheduler
+    unsigned int _timerOrder;
     // If true unschedule will not remove anything from a hash. Elements will only be marked for deletion.
     bool _updateHashLocked;
     
@@ -48,6 +48,10 @@ enum {
     kShaderType_LabelDistanceFieldGlow,
     kShaderType_LabelNormal,
     kShaderType_LabelOutline,
+    kShaderType_LabelDistanceFieldNormal_noMVP,
+    kShaderType_LabelDistanceFieldGlow_noMVP,
+    kShaderType_LabelNormal_noMVP,
+    kShaderType_LabelOutline_noMVP,
     kShaderType_MAX,
 };
 
@@ -188,6 +192,25 @@ void ShaderCache::loadDefaultShaders()
     p = new GLProgram();
     loadDefaultShader(p, kShaderType_LabelOutline);
     _programs.insert( std::make_pair(GLProgram::SHADER_NAME_LABEL_OUTLINE, p) );
+
+    //
+    // Label shaders without MVP, for the quads already in world space (QuadCommand)
+    //
+    p = new GLProgram();
+    loadDefaultShader(p, kShaderType_LabelDistanceFieldNormal_noMVP);
+    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL_NO_MVP, p) );
+
+    p = new GLProgram();
+    loadDefaultShader(p, kShaderType_LabelDistanceFieldGlow_noMVP);
+    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_GLOW_NO_MVP, p) );
+
+    p = new GLProgram();
+    loadDefaultShader(p, kShaderType_LabelNormal_noMVP);
+    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_LABEL_NORMAL_NO_MVP, p) );
+
+    p = new GLProgram();
+    loadDefaultShader(p, kShaderType_LabelOutline_noMVP);
+    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_LABEL_OUTLINE_NO_MVP, p) );
 }
 
 void ShaderCache::reloadDefaultShaders()
@@ -276,6 +299,25 @@ void ShaderCache::reloadDefaultShaders()
     p = getProgram(GLProgram::SHADER_NAME_LABEL_OUTLINE);
     p->reset();
     loadDefaultShader(p, kShaderType_LabelOutline);
+
+    //
+    // Label shaders without MVP
+    //
+    p = getProgram(GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL_NO_MVP);
+    p->reset();
+    loadDefaultShader(p, kShaderType_LabelDistanceFieldNormal_noMVP);
+
+    p = getProgram(GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_GLOW_NO_MVP);
+    p->reset();
+    loadDefaultShader(p, kShaderType_LabelDistanceFieldGlow_noMVP);
+
+    p = getProgram(GLProgram::SHADER_NAME_LABEL_NORMAL_NO_MVP);
+    p->reset();
+    loadDefaultShader(p, kShaderType_LabelNormal_noMVP);
+
+    p = getProgram(GLProgram::SHADER_NAME_LABEL_OUTLINE_NO_MVP);
+    p->reset();
+    loadDefaultShader(p, kShaderType_LabelOutline_noMVP);
 }
 
 void ShaderCache::loadDefaultShader(GLProgram *p, int type)
@@ -395,6 +437,38 @@ void ShaderCache::loadDefaultShader(GLProgram *p, int type)
             p->bindAttribLocation(GLProgram::ATTRIBUTE_NAME_COLOR, GLProgram::VERTEX_ATTRIB_COLOR);
             p->bindAttribLocation(GLProgram::ATTRIBUTE_NAME_TEX_COORD, GLProgram::VERTEX_ATTRIB_TEX_COORDS);
 
+            break;
+        case kShaderType_LabelDistanceFieldNormal_noMVP:
+            p->initWithByteArrays(ccLabel_noMVP_vert, ccLabelDistanceFieldNormal_frag);
+
+            p->bindAttribLocation(GLProgram::ATTRIBUTE_NAME_POSITION, GLProgram::VERTEX_ATTRIB_POSITION);
+            p->bindAttribLocation(GLProgram::ATTRIBUTE_NAME_COLOR, GLProgram::VERTEX_ATTRIB_COLOR);
+            p->bindAttribLocation(GLProgram::ATTRIBUTE_NAME_TEX_COORD, GLProgram::VERTEX_ATTRIB_TEX_COORDS);
+
+            break;
+        case kShaderType_LabelDistanceFieldGlow_noMVP:
+            p->initWithByteArrays(ccLabel_noMVP_vert, ccLabelDistanceFieldGlow_frag);
+
+            p->bindAttribLocation(GLProgram::ATTRIBUTE_NAME_POSITION, GLProgram::VERTEX_ATTRIB_POSITION);
+            p->bindAttribLocation(GLProgram::ATTRIBUTE_NAME_COLOR, GLProgram::VERTEX_ATTRIB_COLOR);
+            p->bindAttribLocation(GLProgram::ATTRIBUTE_NAME_TEX_COORD, GLProgram::VERTEX_ATTRIB_TEX_COORDS);
+
+            break;
+        case kShaderType_LabelNormal_noMVP:
+            p->initWithByteArrays(ccLabel_noMVP_vert, ccLabelNormal_frag);
+
+            p->bindAttribLocation(GLProgram::ATTRIBUTE_NAME_POSITION, GLProgram::VERTEX_ATTRIB_POSITION);
+            p->bindAttribLocation(GLProgram::ATTRIBUTE_NAME_COLOR, GLProgram::VERTEX_ATTRIB_COLOR);
+            p->bindAttribLocation(GLProgram::ATTRIBUTE_NAME_TEX_COORD, GLProgram::VERTEX_ATTRIB_TEX_COORDS);
+
+            break;
+        case kShaderType_LabelOutline_noMVP:
+            p->initWithByteArrays(ccLabel_noMVP_vert, ccLabelOutline_frag);
+
+            p->bindAttribLocation(GLProgram::ATTRIBUTE_NAME_POSITION, GLProgram::VERTEX_ATTRIB_POSITION);
+            p->bindAttribLocation(GLProgram::ATTRIBUTE_NAME_COLOR, GLProgram::VERTEX_ATTRIB_COLOR);
+            p->bindAttribLocation(GLProgram::ATTRIBUTE_NAME_TEX_COORD, GLProgram::VERTEX_ATTRIB_TEX_COORDS);
+
             break;
         default:
             CCLOG("cocos2d: %s:%d, error shader type", __FUNCTION__, __LINE__);
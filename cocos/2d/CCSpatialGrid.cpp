@@ -0,0 +1,285 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "CCSpatialGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "CCNode.h"
+
+NS_CC_BEGIN
+
+SpatialGrid::SpatialGrid(float cellSize, bool worldSpace)
+: _cellSize(cellSize)
+, _worldSpace(worldSpace)
+, _entryCount(0)
+, _cullStamp(1)
+{
+    CCASSERT(cellSize > 0, "cell size must be positive");
+}
+
+SpatialGrid::~SpatialGrid()
+{
+}
+
+long long SpatialGrid::cellKey(int x, int y) const
+{
+    return ((long long)x << 32) | (unsigned int)y;
+}
+
+int SpatialGrid::insert(Node* node)
+{
+    CCASSERT(node != nullptr, "Argument must be non-nil");
+
+    int id;
+    if (!_freeEntries.empty())
+    {
+        id = _freeEntries.back();
+        _freeEntries.pop_back();
+    }
+    else
+    {
+        id = (int)_entries.size();
+        _entries.push_back(Entry());
+    }
+
+    Entry& entry = _entries[id];
+    entry.node = node;
+    entry.bounds = Rect::ZERO;
+    entry.bin = Bin::NONE;
+    entry.cell = 0;
+    entry.slot = -1;
+    entry.order = id;
+    entry.culledStamp = 0;
+    entry.dirty = true;
+    _dirtyEntries.push_back(id);
+
+    ++_entryCount;
+    return id;
+}
+
+void SpatialGrid::remove(int id)
+{
+    CCASSERT(id >= 0 && id < (int)_entries.size() && _entries[id].node, "Invalid entry");
+
+    unbin(id);
+
+    Entry& entry = _entries[id];
+    entry.node = nullptr;
+    entry.dirty = false;
+    _freeEntries.push_back(id);
+    --_entryCount;
+}
+
+void SpatialGrid::clear()
+{
+    _entries.clear();
+    _freeEntries.clear();
+    _dirtyEntries.clear();
+    _cells.clear();
+    _oversized.clear();
+    _entryCount = 0;
+}
+
+void SpatialGrid::markDirty(int id)
+{
+    Entry& entry = _entries[id];
+    if (!entry.dirty)
+    {
+        entry.dirty = true;
+        _dirtyEntries.push_back(id);
+    }
+}
+
+void SpatialGrid::setOrder(int id, int order)
+{
+    _entries[id].order = order;
+}
+
+void SpatialGrid::bin(int id)
+{
+    Entry& entry = _entries[id];
+    std::vector<int>* list;
+
+    if (entry.bounds.size.width > _cellSize || entry.bounds.size.height > _cellSize)
+    {
+        entry.bin = Bin::OVERSIZED;
+        list = &_oversized;
+    }
+    else
+    {
+        int x = (int)floorf(entry.bounds.getMidX() / _cellSize);
+        int y = (int)floorf(entry.bounds.getMidY() / _cellSize);
+        entry.bin = Bin::CELL;
+        entry.cell = cellKey(x, y);
+        list = &_cells[entry.cell];
+    }
+
+    entry.slot = (int)list->size();
+    list->push_back(id);
+}
+
+void SpatialGrid::unbin(int id)
+{
+    Entry& entry = _entries[id];
+    if (entry.bin == Bin::NONE)
+        return;
+
+    auto cellIter = _cells.end();
+    std::vector<int>* list;
+    if (entry.bin == Bin::OVERSIZED)
+    {
+        list = &_oversized;
+    }
+    else
+    {
+        cellIter = _cells.find(entry.cell);
+        CCASSERT(cellIter != _cells.end(), "entry not found in its cell");
+        list = &cellIter->second;
+    }
+
+    // swap with the last one
+    int last = list->back();
+    (*list)[entry.slot] = last;
+    _entries[last].slot = entry.slot;
+    list->pop_back();
+
+    // don't let empty cells accumulate, queries may walk the whole map
+    if (cellIter != _cells.end() && list->empty())
+        _cells.erase(cellIter);
+
+    entry.bin = Bin::NONE;
+    entry.slot = -1;
+}
+
+void SpatialGrid::flush()
+{
+    for (int id : _dirtyEntries)
+    {
+        Entry& entry = _entries[id];
+        if (entry.node == nullptr || !entry.dirty)
+            continue;
+
+        unbin(id);
+        if (_worldSpace)
+        {
+            Rect rect(0, 0, entry.node->getContentSize().width, entry.node->getContentSize().height);
+            entry.bounds = RectApplyAffineTransform(rect, entry.node->getNodeToWorldAffineTransform());
+        }
+        else
+        {
+            entry.bounds = entry.node->getBoundingBox();
+        }
+        bin(id);
+        entry.dirty = false;
+    }
+    _dirtyEntries.clear();
+}
+
+template <typename Visitor>
+void SpatialGrid::visitCandidates(const Rect& rect, Visitor visitor)
+{
+    // An entry is binned by its center and is at most one cell wide, so it can
+    // stick out of its cell by half a cell at most.
+    float loose = _cellSize / 2;
+    int minX = (int)floorf((rect.getMinX() - loose) / _cellSize);
+    int maxX = (int)floorf((rect.getMaxX() + loose) / _cellSize);
+    int minY = (int)floorf((rect.getMinY() - loose) / _cellSize);
+    int maxY = (int)floorf((rect.getMaxY() + loose) / _cellSize);
+
+    auto visitCell = [&](const std::vector<int>& cell) {
+        for (int id : cell)
+        {
+            if (_entries[id].bounds.intersectsRect(rect))
+                visitor(id);
+        }
+    };
+
+    double rangeCount = ((double)maxX - minX + 1) * ((double)maxY - minY + 1);
+    if (rangeCount > _cells.size())
+    {
+        // the rect covers more cells than there are non-empty ones
+        for (const auto& cell : _cells)
+        {
+            int x = (int)(cell.first >> 32);
+            int y = (int)(unsigned int)cell.first;
+            if (x >= minX && x <= maxX && y >= minY && y <= maxY)
+                visitCell(cell.second);
+        }
+    }
+    else
+    {
+        for (int y = minY; y <= maxY; ++y)
+        {
+            for (int x = minX; x <= maxX; ++x)
+            {
+                auto iter = _cells.find(cellKey(x, y));
+                if (iter != _cells.end())
+                    visitCell(iter->second);
+            }
+        }
+    }
+
+    visitCell(_oversized);
+}
+
+void SpatialGrid::gatherCandidates(const Rect& rect)
+{
+    flush();
+
+    _candidates.clear();
+    visitCandidates(rect, [this](int id) { _candidates.push_back(id); });
+    std::sort(_candidates.begin(), _candidates.end(), [this](int a, int b) {
+        return _entries[a].order < _entries[b].order;
+    });
+}
+
+void SpatialGrid::query(const Rect& rect, std::vector<Node*>& result)
+{
+    gatherCandidates(rect);
+
+    for (int id : _candidates)
+        result.push_back(_entries[id].node);
+}
+
+const std::vector<SpatialGrid::Result>& SpatialGrid::cull(const Rect& rect)
+{
+    gatherCandidates(rect);
+
+    unsigned int previousStamp = _cullStamp++;
+    _results.clear();
+    for (int id : _candidates)
+    {
+        Entry& entry = _entries[id];
+        Result result = { entry.node, entry.culledStamp != previousStamp };
+        entry.culledStamp = _cullStamp;
+        _results.push_back(result);
+    }
+
+    return _results;
+}
+
+NS_CC_END
@@ -0,0 +1,128 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __CCSPATIALGRID_H__
+#define __CCSPATIALGRID_H__
+
+#include <vector>
+#include <unordered_map>
+
+#include "CCPlatformMacros.h"
+#include "CCGeometry.h"
+
+NS_CC_BEGIN
+
+class Node;
+
+/** A loose grid over the bounding boxes of the children of a Node, used to cull them.
+ Each child is stored in the cell that contains the center of its bounding box, so
+ moving a child only touches two cells. Children larger than a cell are kept aside
+ and always tested. Bounds are refreshed lazily: markDirty() queues a child and the
+ next query re-reads its bounding box.
+ */
+class CC_DLL SpatialGrid
+{
+public:
+    struct Result
+    {
+        Node* node;
+        /** true if the node wasn't returned by the previous cull() */
+        bool entered;
+    };
+
+    /** With worldSpace set, the nodes are binned by their bounding box in world space
+     instead of the space of their parent.
+     */
+    explicit SpatialGrid(float cellSize, bool worldSpace = false);
+    ~SpatialGrid();
+
+    /** adds a node and returns its entry id */
+    int insert(Node* node);
+    void remove(int entry);
+    void clear();
+
+    /** the bounding box of the node changed. It will be re-read by the next query */
+    void markDirty(int entry);
+
+    /** sets the rank used to sort the results, usually the index of the node in its parent's children */
+    void setOrder(int entry, int order);
+
+    /** appends the nodes whose bounding box intersects `rect`, sorted by order */
+    void query(const Rect& rect, std::vector<Node*>& result);
+
+    /** Like query(), but also records which nodes were returned, so the next call can
+     tell the nodes that just became visible.
+     */
+    const std::vector<Result>& cull(const Rect& rect);
+
+    inline float getCellSize() const { return _cellSize; }
+    inline ssize_t getNodeCount() const { return _entryCount; }
+
+protected:
+    enum class Bin
+    {
+        NONE,
+        CELL,
+        OVERSIZED,
+    };
+
+    struct Entry
+    {
+        Node* node;
+        Rect bounds;
+        Bin bin;
+        long long cell;     // key of the cell when bin is CELL
+        int slot;           // index in the cell or in the oversized list
+        int order;
+        unsigned int culledStamp;
+        bool dirty;
+    };
+
+    void flush();
+    void bin(int entry);
+    void unbin(int entry);
+    long long cellKey(int x, int y) const;
+    template <typename Visitor> void visitCandidates(const Rect& rect, Visitor visitor);
+    void gatherCandidates(const Rect& rect);
+
+    float _cellSize;
+    bool _worldSpace;
+    std::vector<Entry> _entries;
+    std::vector<int> _freeEntries;
+    ssize_t _entryCount;
+    std::vector<int> _dirtyEntries;
+    std::unordered_map<long long, std::vector<int>> _cells;
+    std::vector<int> _oversized;
+    std::vector<Result> _results;
+    std::vector<int> _candidates;
+    unsigned int _cullStamp;
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(SpatialGrid);
+};
+
+NS_CC_END
+
+#endif // __CCSPATIALGRID_H__
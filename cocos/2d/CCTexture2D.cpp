@@ -423,6 +423,27 @@ void Texture2D::convertRGBA8888ToRGB5A1(const unsigned char* data, ssize_t dataL
 // conventer function end
 //////////////////////////////////////////////////////////////////////////
 
+// the largest alignment that tightly packed rows of bytesPerRow bytes satisfy
+static void setUnpackAlignmentForRow(ssize_t bytesPerRow)
+{
+    if(bytesPerRow % 8 == 0)
+    {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 8);
+    }
+    else if(bytesPerRow % 4 == 0)
+    {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    }
+    else if(bytesPerRow % 2 == 0)
+    {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+    }
+    else
+    {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    }
+}
+
 Texture2D::Texture2D()
 : _pixelFormat(Texture2D::PixelFormat::DEFAULT)
 , _pixelsWide(0)
@@ -434,6 +455,7 @@ Texture2D::Texture2D()
 , _hasMipmaps(false)
 , _shaderProgram(nullptr)
 , _antialiasEnabled(true)
+, _pendingUpload(nullptr)
 {
 }
 
@@ -445,6 +467,7 @@ Texture2D::~Texture2D()
 
     CCLOGINFO("deallocing Texture2D: %p - id=%u", this, _name);
     CC_SAFE_RELEASE(_shaderProgram);
+    releasePendingUpload();
 
     if(_name)
     {
@@ -593,24 +616,7 @@ bool Texture2D::initWithMipmaps(MipmapInfo* mipmaps, int mipmapsNum, PixelFormat
     //Set the row align only when mipmapsNum == 1 and the data is uncompressed
     if (mipmapsNum == 1 && !info.compressed)
     {
-        unsigned int bytesPerRow = pixelsWide * info.bpp / 8;
-
-        if(bytesPerRow % 8 == 0)
-        {
-            glPixelStorei(GL_UNPACK_ALIGNMENT, 8);
-        }
-        else if(bytesPerRow % 4 == 0)
-        {
-            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
-        }
-        else if(bytesPerRow % 2 == 0)
-        {
-            glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
-        }
-        else
-        {
-            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-        }
+        setUnpackAlignmentForRow(pixelsWide * info.bpp / 8);
     }else
     {
         glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
@@ -710,6 +716,52 @@ bool Texture2D::updateWithData(const void *data,int offsetX,int offsetY,int widt
     return false;
 }
 
+ssize_t Texture2D::uploadPendingRows(ssize_t maxBytes)
+{
+    if (_pendingUpload == nullptr)
+    {
+        return 0;
+    }
+
+    ssize_t bytesPerRow = _pendingUpload->bytesPerRow;
+    int rows = (int)std::max((ssize_t)1, maxBytes / bytesPerRow);
+    rows = std::min(rows, _pixelsHigh - _pendingUpload->uploadedRows);
+
+    // the GL state may have changed since the last rows were uploaded
+    setUnpackAlignmentForRow(bytesPerRow);
+    updateWithData(_pendingUpload->data + _pendingUpload->uploadedRows * bytesPerRow, 0, _pendingUpload->uploadedRows, _pixelsWide, rows);
+
+    _pendingUpload->uploadedRows += rows;
+    if (_pendingUpload->uploadedRows >= _pixelsHigh)
+    {
+        releasePendingUpload();
+    }
+
+    return rows * bytesPerRow;
+}
+
+ssize_t Texture2D::getPendingUploadBytes() const
+{
+    if (_pendingUpload == nullptr)
+    {
+        return 0;
+    }
+    return (_pixelsHigh - _pendingUpload->uploadedRows) * _pendingUpload->bytesPerRow;
+}
+
+void Texture2D::releasePendingUpload()
+{
+    if (_pendingUpload)
+    {
+        if (_pendingUpload->ownsData)
+        {
+            free(_pendingUpload->data);
+        }
+        _pendingUpload->image->release();
+        CC_SAFE_DELETE(_pendingUpload);
+    }
+}
+
 std::string Texture2D::getDescription() const
 {
     return StringUtils::format("<Texture2D | Name = %u | Dimensions = %ld x %ld | Coordinates = (%.2f, %.2f)>", _name, (long)_pixelsWide, (long)_pixelsHigh, _maxS, _maxT);
@@ -723,6 +775,18 @@ bool Texture2D::initWithImage(Image *image)
 
 bool Texture2D::initWithImage(Image *image, PixelFormat format)
 {
+    return initWithImage(image, format, false);
+}
+
+bool Texture2D::initWithImageIncremental(Image *image)
+{
+    return initWithImage(image, PixelFormat::NONE, true);
+}
+
+bool Texture2D::initWithImage(Image *image, PixelFormat format, bool deferUpload)
+{
+    releasePendingUpload();
+
     if (image == nullptr)
     {
         CCLOG("cocos2d: Texture2D. Can't create Texture. UIImage is nil");
@@ -785,13 +849,33 @@ bool Texture2D::initWithImage(Image *image, PixelFormat format)
 
         pixelFormat = convertDataToFormat(tempData, tempDataLen, renderFormat, pixelFormat, &outTempData, &outTempDataLen);
 
-        initWithData(outTempData, outTempDataLen, pixelFormat, imageWidth, imageHeight, imageSize);
-
-
-        if (outTempData != nullptr && outTempData != tempData)
+        if (deferUpload)
+        {
+            // only allocate the texture storage, the pixels are uploaded by uploadPendingRows()
+            if (initWithData(nullptr, outTempDataLen, pixelFormat, imageWidth, imageHeight, imageSize))
+            {
+                _pendingUpload = new PendingUpload();
+                _pendingUpload->image = image;
+                _pendingUpload->data = outTempData;
+                _pendingUpload->ownsData = outTempData != tempData;
+                _pendingUpload->bytesPerRow = outTempDataLen / imageHeight;
+                _pendingUpload->uploadedRows = 0;
+                image->retain();
+            }
+            else if (outTempData != nullptr && outTempData != tempData)
+            {
+                free(outTempData);
+            }
+        }
+        else
         {
+            initWithData(outTempData, outTempDataLen, pixelFormat, imageWidth, imageHeight, imageSize);
+
+            if (outTempData != nullptr && outTempData != tempData)
+            {
 
-            free(outTempData);
+                free(outTempData);
+            }
         }
 
         // set the premultiplied tag
@@ -1177,13 +1261,13 @@ void Texture2D::drawAtPoint(const Point& point)
 
 #ifdef EMSCRIPTEN
     setGLBufferData(vertices, 8 * sizeof(GLfloat), 0);
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, 0, 0);
+    GL::vertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, 0, 0);
 
     setGLBufferData(coordinates, 8 * sizeof(GLfloat), 1);
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORDS, 2, GL_FLOAT, GL_FALSE, 0, 0);
+    GL::vertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORDS, 2, GL_FLOAT, GL_FALSE, 0, 0);
 #else
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, 0, vertices);
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORDS, 2, GL_FLOAT, GL_FALSE, 0, coordinates);
+    GL::vertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, 0, vertices);
+    GL::vertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORDS, 2, GL_FLOAT, GL_FALSE, 0, coordinates);
 #endif // EMSCRIPTEN
 
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
@@ -1210,13 +1294,13 @@ void Texture2D::drawInRect(const Rect& rect)
 
 #ifdef EMSCRIPTEN
     setGLBufferData(vertices, 8 * sizeof(GLfloat), 0);
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, 0, 0);
+    GL::vertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, 0, 0);
 
     setGLBufferData(coordinates, 8 * sizeof(GLfloat), 1);
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORDS, 2, GL_FLOAT, GL_FALSE, 0, 0);
+    GL::vertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORDS, 2, GL_FLOAT, GL_FALSE, 0, 0);
 #else
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, 0, vertices);
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORDS, 2, GL_FLOAT, GL_FALSE, 0, coordinates);
+    GL::vertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, 0, vertices);
+    GL::vertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORDS, 2, GL_FLOAT, GL_FALSE, 0, coordinates);
 #endif // EMSCRIPTEN
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 }
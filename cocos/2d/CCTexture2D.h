@@ -251,6 +251,22 @@ public:
     **/
     bool initWithImage(Image * image, PixelFormat format);
 
+    /**
+    Initializes a texture from an Image without uploading its pixels: they are uploaded a few rows at a time by uploadPendingRows(),
+    so that a big image can be uploaded over several frames. The texture must not be used before isUploadPending() returns false.
+    Images with mipmaps or compressed data are uploaded at once.
+    **/
+    bool initWithImageIncremental(Image * image);
+
+    /** Uploads the next rows of the pending image, about `maxBytes` but at least one row. Returns the number of bytes uploaded */
+    ssize_t uploadPendingRows(ssize_t maxBytes);
+
+    /** Whether or not initWithImageIncremental() left pixels to upload */
+    bool isUploadPending() const { return _pendingUpload != nullptr; }
+
+    /** Number of bytes left to upload by uploadPendingRows() */
+    ssize_t getPendingUploadBytes() const;
+
     /** Initializes a texture from a string with dimensions, alignment, font name and font size */
     bool initWithString(const char *text,  const char *fontName, float fontSize, const Size& dimensions = Size(0, 0), TextHAlignment hAlignment = TextHAlignment::CENTER, TextVAlignment vAlignment = TextVAlignment::TOP);
     /** Initializes a texture from a string using a text definition*/
@@ -357,6 +373,8 @@ public:
     static const PixelFormatInfoMap& getPixelFormatInfoMap();
     
 private:
+    bool initWithImage(Image * image, PixelFormat format, bool deferUpload);
+    void releasePendingUpload();
 
     /**convert functions*/
 
@@ -438,6 +456,17 @@ protected:
     static const PixelFormatInfoMap _pixelFormatInfoTables;
 
     bool _antialiasEnabled;
+
+    /** pixels left to upload after initWithImageIncremental() */
+    struct PendingUpload
+    {
+        Image *image;               // retained while data points to its pixels
+        unsigned char *data;
+        bool ownsData;              // data was converted and must be freed
+        ssize_t bytesPerRow;
+        int uploadedRows;
+    };
+    PendingUpload *_pendingUpload;
 };
 
 
@@ -29,6 +29,8 @@ THE SOFTWARE.
 #include <stack>
 #include <cctype>
 #include <list>
+#include <algorithm>
+#include <chrono>
 
 #include "CCTextureCache.h"
 #include "CCTexture2D.h"
@@ -57,22 +59,42 @@ TextureCache * TextureCache::getInstance()
 }
 
 TextureCache::TextureCache()
-: _loadingThread(nullptr)
-, _asyncStructQueue(nullptr)
-, _imageInfoQueue(nullptr)
+: _loadingThreadCount(0)
 , _needQuit(false)
 , _asyncRefCount(0)
+, _asyncSequence(0)
+, _asyncUploadBudget(1.0f / 240)
+, _asyncUploadChunkSize(256 * 1024)
+, _asyncUploadTime(0)
 {
+    // leave a core to the main thread
+    int cores = (int)std::thread::hardware_concurrency();
+    _loadingThreadCount = std::max(1, std::min(4, cores - 1));
 }
 
 TextureCache::~TextureCache()
 {
     CCLOGINFO("deallocing TextureCache: %p", this);
 
+    waitForQuit();
+
     for( auto it=_textures.begin(); it!=_textures.end(); ++it)
         (it->second)->release();
 
-    CC_SAFE_DELETE(_loadingThread);
+    // the requests still in flight
+    for (auto& request : _asyncRequestQueue)
+        delete request;
+    for (auto& request : _asyncLoadedQueue)
+    {
+        CC_SAFE_RELEASE(request->image);
+        delete request;
+    }
+    for (auto& request : _asyncUploadQueue)
+    {
+        CC_SAFE_RELEASE(request->texture);
+        CC_SAFE_RELEASE(request->image);
+        delete request;
+    }
 }
 
 void TextureCache::destroyInstance()
@@ -93,7 +115,66 @@ std::string TextureCache::getDescription() const
     return StringUtils::format("<TextureCache | Number of textures = %d>", static_cast<int>(_textures.size()));
 }
 
+bool TextureCache::compareAsyncPriority(const AsyncStruct* a, const AsyncStruct* b)
+{
+    // std heaps keep the greatest element on top: the highest priority, then the oldest request
+    return a->priority < b->priority || (a->priority == b->priority && a->sequence > b->sequence);
+}
+
+void TextureCache::setAsyncLoadingThreadCount(int count)
+{
+    CCASSERT(count > 0, "Invalid thread count");
+    if (!_loadingThreads.empty())
+    {
+        CCLOG("cocos2d: TextureCache: the loading threads are already running, the thread count can't change");
+        return;
+    }
+    _loadingThreadCount = count;
+}
+
+void TextureCache::setAsyncUploadChunkSize(ssize_t bytes)
+{
+    CCASSERT(bytes > 0, "Invalid chunk size");
+    _asyncUploadChunkSize = bytes;
+}
+
+ssize_t TextureCache::getAsyncPendingUploadBytes()
+{
+    ssize_t bytes = 0;
+    for (auto& request : _asyncUploadQueue)
+    {
+        if (request->texture)
+        {
+            bytes += request->texture->getPendingUploadBytes();
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(_asyncMutex);
+    for (auto& request : _asyncLoadedQueue)
+    {
+        if (request->image && !request->callbacks.empty())
+        {
+            bytes += request->image->getDataLen();
+        }
+    }
+    return bytes;
+}
+
+void TextureCache::startLoadingThreads()
+{
+    _needQuit = false;
+    for (int i = 0; i < _loadingThreadCount; ++i)
+    {
+        _loadingThreads.push_back(std::thread(&TextureCache::loadImage, this));
+    }
+}
+
 void TextureCache::addImageAsync(const std::string &path, const std::function<void(Texture2D*)>& callback)
+{
+    addImageAsync(path, callback, 0);
+}
+
+void TextureCache::addImageAsync(const std::string &path, const std::function<void(Texture2D*)>& callback, int priority)
 {
     Texture2D *texture = nullptr;
 
@@ -110,15 +191,25 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
     }
 
     // lazy init
-    if (_asyncStructQueue == nullptr)
-    {             
-        _asyncStructQueue = new queue<AsyncStruct*>();
-        _imageInfoQueue   = new deque<ImageInfo*>();        
+    if (_loadingThreads.empty())
+    {
+        startLoadingThreads();
+    }
 
-        // create a new thread to load images
-        _loadingThread = new std::thread(&TextureCache::loadImage, this);
+    std::unique_lock<std::mutex> lock(_asyncMutex);
 
-        _needQuit = false;
+    // the file is already being loaded: wait for the same image
+    auto requestIter = _asyncRequests.find(fullpath);
+    if (requestIter != _asyncRequests.end())
+    {
+        AsyncStruct* request = requestIter->second;
+        request->callbacks.push_back(callback);
+        if (request->queued && priority > request->priority)
+        {
+            request->priority = priority;
+            std::make_heap(_asyncRequestQueue.begin(), _asyncRequestQueue.end(), compareAsyncPriority);
+        }
+        return;
     }
 
     if (0 == _asyncRefCount)
@@ -129,157 +220,200 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
     ++_asyncRefCount;
 
     // generate async struct
-    AsyncStruct *data = new AsyncStruct(fullpath, callback);
+    AsyncStruct *data = new AsyncStruct(fullpath, priority, _asyncSequence++);
+    data->callbacks.push_back(callback);
+    _asyncRequests[fullpath] = data;
 
     // add async struct into queue
-    _asyncStructQueueMutex.lock();
-    _asyncStructQueue->push(data);
-    _asyncStructQueueMutex.unlock();
+    _asyncRequestQueue.push_back(data);
+    std::push_heap(_asyncRequestQueue.begin(), _asyncRequestQueue.end(), compareAsyncPriority);
+    lock.unlock();
 
     _sleepCondition.notify_one();
 }
 
-void TextureCache::loadImage()
+void TextureCache::unbindImageAsync(const std::string &path)
+{
+    std::string fullpath = FileUtils::getInstance()->fullPathForFilename(path);
+
+    std::lock_guard<std::mutex> lock(_asyncMutex);
+
+    auto requestIter = _asyncRequests.find(fullpath);
+    if (requestIter == _asyncRequests.end())
+        return;
+
+    AsyncStruct* request = requestIter->second;
+    request->callbacks.clear();
+    if (request->queued)
+    {
+        // not decoded yet: skip it. It goes through the loaded queue to be released on the main thread
+        auto queueIter = std::find(_asyncRequestQueue.begin(), _asyncRequestQueue.end(), request);
+        _asyncRequestQueue.erase(queueIter);
+        std::make_heap(_asyncRequestQueue.begin(), _asyncRequestQueue.end(), compareAsyncPriority);
+
+        request->queued = false;
+        _asyncLoadedQueue.push_back(request);
+        _asyncRequests.erase(requestIter);
+    }
+    // else it is being decoded or waiting for the main thread: with no callback it won't be uploaded,
+    // and it can still be reused if the file is requested again in the meantime
+}
+
+void TextureCache::unbindAllImageAsync()
 {
-    AsyncStruct *asyncStruct = nullptr;
+    std::lock_guard<std::mutex> lock(_asyncMutex);
 
+    for (auto& request : _asyncRequestQueue)
+    {
+        request->callbacks.clear();
+        request->queued = false;
+        _asyncLoadedQueue.push_back(request);
+        _asyncRequests.erase(request->filename);
+    }
+    _asyncRequestQueue.clear();
+
+    for (auto& request : _asyncRequests)
+    {
+        request.second->callbacks.clear();
+    }
+}
+
+void TextureCache::loadImage()
+{
     while (true)
     {
-        std::queue<AsyncStruct*> *pQueue = _asyncStructQueue;
-        _asyncStructQueueMutex.lock();
-        if (pQueue->empty())
+        AsyncStruct *asyncStruct = nullptr;
         {
-            _asyncStructQueueMutex.unlock();
-            if (_needQuit) {
+            std::unique_lock<std::mutex> lock(_asyncMutex);
+            _sleepCondition.wait(lock, [this]() { return _needQuit || !_asyncRequestQueue.empty(); });
+            if (_needQuit)
+            {
                 break;
             }
-            else {
-                std::unique_lock<std::mutex> lk(_sleepMutex);
-                _sleepCondition.wait(lk);
-                continue;
-            }
-        }
-        else
-        {
-            asyncStruct = pQueue->front();
-            pQueue->pop();
-            _asyncStructQueueMutex.unlock();
-        }        
 
-        Image *image = nullptr;
-        bool generateImage = false;
+            std::pop_heap(_asyncRequestQueue.begin(), _asyncRequestQueue.end(), compareAsyncPriority);
+            asyncStruct = _asyncRequestQueue.back();
+            _asyncRequestQueue.pop_back();
+            asyncStruct->queued = false;
+        }
 
-        auto it = _textures.find(asyncStruct->filename);
-        if( it == _textures.end() )
+        // generate image
+        const std::string& filename = asyncStruct->filename;
+        Image *image = new Image();
+        if (!image->initWithImageFileThreadSafe(filename))
         {
-           _imageInfoMutex.lock();
-           ImageInfo *imageInfo;
-           size_t pos = 0;
-           size_t infoSize = _imageInfoQueue->size();
-           for (; pos < infoSize; pos++)
-           {
-               imageInfo = (*_imageInfoQueue)[pos];
-               if(imageInfo->asyncStruct->filename.compare(asyncStruct->filename))
-                   break;
-           }
-           _imageInfoMutex.unlock();
-           if(infoSize == 0 || pos < infoSize)
-               generateImage = true;
+            CC_SAFE_RELEASE_NULL(image);
+            CCLOG("can not load %s", filename.c_str());
         }
 
-        if (generateImage)
+        // put the image into the loaded queue, even if it failed: the callbacks are called with nullptr
+        std::lock_guard<std::mutex> lock(_asyncMutex);
+        asyncStruct->image = image;
+        _asyncLoadedQueue.push_back(asyncStruct);
+    }
+}
+
+void TextureCache::addImageAsyncCallBack(float dt)
+{
+    auto start = std::chrono::steady_clock::now();
+    auto budget = std::chrono::duration<float>(_asyncUploadBudget);
+
+    // upload as many strips as the budget allows, but at least one so that loading always progresses
+    do
+    {
+        if (_asyncUploadQueue.empty())
         {
-            const std::string& filename = asyncStruct->filename;
-            // generate image      
-            image = new Image();
-            if (image && !image->initWithImageFileThreadSafe(filename))
+            AsyncStruct *asyncStruct = nullptr;
             {
-                CC_SAFE_RELEASE(image);
-                CCLOG("can not load %s", filename.c_str());
-                continue;
+                std::lock_guard<std::mutex> lock(_asyncMutex);
+                if (_asyncLoadedQueue.empty())
+                {
+                    break;
+                }
+                asyncStruct = _asyncLoadedQueue.front();
+                _asyncLoadedQueue.pop_front();
+            }
+
+            // the pixels are uploaded by the next iterations, or the next frames
+            if (asyncStruct->image && !asyncStruct->callbacks.empty() && _textures.find(asyncStruct->filename) == _textures.end())
+            {
+                asyncStruct->texture = new Texture2D();
+                if (!asyncStruct->texture->initWithImageIncremental(asyncStruct->image))
+                {
+                    CC_SAFE_RELEASE_NULL(asyncStruct->texture);
+                }
             }
-        }    
+            _asyncUploadQueue.push_back(asyncStruct);
+        }
 
-        // generate image info
-        ImageInfo *imageInfo = new ImageInfo();
-        imageInfo->asyncStruct = asyncStruct;
-        imageInfo->image = image;
+        AsyncStruct *asyncStruct = _asyncUploadQueue.front();
+        if (asyncStruct->texture && asyncStruct->texture->isUploadPending() && !asyncStruct->callbacks.empty())
+        {
+            asyncStruct->texture->uploadPendingRows(_asyncUploadChunkSize);
+        }
+        else
+        {
+            finishAsyncUpload();
+        }
+    } while (std::chrono::steady_clock::now() - start < budget);
 
-        // put the image info into the queue
-        _imageInfoMutex.lock();
-        _imageInfoQueue->push_back(imageInfo);
-        _imageInfoMutex.unlock();
-    }
-    
-	if(_asyncStructQueue != nullptr)
+    _asyncUploadTime = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+
+    if (0 == _asyncRefCount)
     {
-        delete _asyncStructQueue;
-	    _asyncStructQueue = nullptr;
-        delete _imageInfoQueue;
-	    _imageInfoQueue = nullptr;
+        _asyncUploadTime = 0;
+        Director::getInstance()->getScheduler()->unschedule(schedule_selector(TextureCache::addImageAsyncCallBack), this);
     }
 }
 
-void TextureCache::addImageAsyncCallBack(float dt)
+void TextureCache::finishAsyncUpload()
 {
-    // the image is generated in loading thread
-    std::deque<ImageInfo*> *imagesQueue = _imageInfoQueue;
+    AsyncStruct *asyncStruct = _asyncUploadQueue.front();
+    _asyncUploadQueue.pop_front();
 
-    _imageInfoMutex.lock();
-    if (imagesQueue->empty())
     {
-        _imageInfoMutex.unlock();
-    }
-    else
-    {
-        ImageInfo *imageInfo = imagesQueue->front();
-        imagesQueue->pop_front();
-        _imageInfoMutex.unlock();
-
-        AsyncStruct *asyncStruct = imageInfo->asyncStruct;
-        Image *image = imageInfo->image;
-
-        const std::string& filename = asyncStruct->filename;
-
-        Texture2D *texture = nullptr;
-        if (image)
+        // from now on, requests for this file use the texture cache or start a new load
+        std::lock_guard<std::mutex> lock(_asyncMutex);
+        auto requestIter = _asyncRequests.find(asyncStruct->filename);
+        if (requestIter != _asyncRequests.end() && requestIter->second == asyncStruct)
         {
-            // generate texture in render thread
-            texture = new Texture2D();
+            _asyncRequests.erase(requestIter);
+        }
+    }
 
-            texture->initWithImage(image);
+    const std::string& filename = asyncStruct->filename;
+    Texture2D *texture = asyncStruct->texture;
 
+    auto it = _textures.find(filename);
+    if (it != _textures.end())
+    {
+        // loaded synchronously in the meantime
+        CC_SAFE_RELEASE(texture);
+        texture = it->second;
+    }
+    else if (texture && !asyncStruct->callbacks.empty())
+    {
 #if CC_ENABLE_CACHE_TEXTURE_DATA
-            // cache the texture file name
-            VolatileTextureMgr::addImageTexture(texture, filename);
+        // cache the texture file name
+        VolatileTextureMgr::addImageTexture(texture, filename);
 #endif
-            // cache the texture. retain it, since it is added in the map
-            _textures.insert( std::make_pair(filename, texture) );
-            texture->retain();
-
-            texture->autorelease();
-        }
-        else
-        {
-            auto it = _textures.find(asyncStruct->filename);
-            if(it != _textures.end())
-                texture = it->second;
-        }
-        
-        asyncStruct->callback(texture);
-        if(image)
-        {
-            image->release();
-        }       
-        delete asyncStruct;
-        delete imageInfo;
+        // texture already retained, no need to re-retain it
+        _textures.insert( std::make_pair(filename, texture) );
+    }
+    else
+    {
+        // canceled
+        CC_SAFE_RELEASE_NULL(texture);
+    }
 
-        --_asyncRefCount;
-        if (0 == _asyncRefCount)
-        {
-            Director::getInstance()->getScheduler()->unschedule(schedule_selector(TextureCache::addImageAsyncCallBack), this);
-        }
+    for (auto& callback : asyncStruct->callbacks)
+    {
+        callback(texture);
     }
+    CC_SAFE_RELEASE(asyncStruct->image);
+    delete asyncStruct;
+
+    --_asyncRefCount;
 }
 
 Texture2D * TextureCache::addImage(const std::string &path)
@@ -492,10 +626,17 @@ void TextureCache::reloadAllTextures()
 
 void TextureCache::waitForQuit()
 {
-    // notify sub thread to quick
-    _needQuit = true;
-    _sleepCondition.notify_one();
-    if (_loadingThread) _loadingThread->join();
+    // notify sub threads to quit
+    {
+        std::lock_guard<std::mutex> lock(_asyncMutex);
+        _needQuit = true;
+    }
+    _sleepCondition.notify_all();
+    for (auto& thread : _loadingThreads)
+    {
+        thread.join();
+    }
+    _loadingThreads.clear();
 }
 
 std::string TextureCache::getCachedTextureInfo() const
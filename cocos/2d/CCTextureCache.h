@@ -36,6 +36,7 @@ THE SOFTWARE.
 #include <string>
 #include <unordered_map>
 #include <functional>
+#include <vector>
 
 #include "CCRef.h"
 #include "CCTexture2D.h"
@@ -119,6 +120,44 @@ public:
     */
     virtual void addImageAsync(const std::string &filepath, const std::function<void(Texture2D*)>& callback);
 
+    /* Same as addImageAsync(filepath, callback), with a priority.
+    * Queued files are decoded by order of priority, the highest first, then by order of request.
+    * Requesting a file that is already being loaded doesn't decode it again: the callback is added
+    * to the pending request, whose priority is raised if needed.
+    */
+    void addImageAsync(const std::string &filepath, const std::function<void(Texture2D*)>& callback, int priority);
+
+    /* Cancels the pending asynchronous loads of a file: their callbacks won't be called.
+    * A file that wasn't decoded yet is dropped from the queue, a decoded one isn't uploaded to the GPU.
+    */
+    void unbindImageAsync(const std::string &filepath);
+
+    /* Cancels all the pending asynchronous loads */
+    void unbindAllImageAsync();
+
+    /** Sets the number of threads that decode the images of addImageAsync().
+    * It must be called before the first asynchronous load. Defaults to the number of cores minus one, between 1 and 4.
+    */
+    void setAsyncLoadingThreadCount(int count);
+    int getAsyncLoadingThreadCount() const { return _loadingThreadCount; }
+
+    /** Sets how long, in seconds, the main thread can spend per frame uploading the decoded images to the GPU.
+    * Images are uploaded in strips of rows of about getAsyncUploadChunkSize() bytes, so that a big image is spread
+    * over several frames. At least one strip is uploaded each frame. Defaults to 1/240 second.
+    */
+    void setAsyncUploadBudget(float seconds) { _asyncUploadBudget = seconds; }
+    float getAsyncUploadBudget() const { return _asyncUploadBudget; }
+
+    /** Sets the size, in bytes, of the strips uploaded by glTexSubImage2D. Defaults to 256KB */
+    void setAsyncUploadChunkSize(ssize_t bytes);
+    ssize_t getAsyncUploadChunkSize() const { return _asyncUploadChunkSize; }
+
+    /** Bytes of the decoded images that still have to be uploaded to the GPU */
+    ssize_t getAsyncPendingUploadBytes();
+
+    /** Seconds spent uploading asynchronously loaded images during the last frame */
+    float getAsyncUploadTime() const { return _asyncUploadTime; }
+
     /** Returns a Texture2D object given an Image.
     * If the image was not previously loaded, it will create a new Texture2D object and it will return it.
     * Otherwise it will return a reference of a previously loaded image.
@@ -180,38 +219,45 @@ public:
 private:
     void addImageAsyncCallBack(float dt);
     void loadImage();
+    void finishAsyncUpload();
 
 public:
     struct AsyncStruct
     {
     public:
-        AsyncStruct(const std::string& fn, std::function<void(Texture2D*)> f) : filename(fn), callback(f) {}
+        AsyncStruct(const std::string& fn, int p, unsigned int seq) : filename(fn), priority(p), sequence(seq), image(nullptr), texture(nullptr), queued(true) {}
 
         std::string filename;
-        std::function<void(Texture2D*)> callback;
+        std::vector<std::function<void(Texture2D*)>> callbacks;   ///< everyone waiting for this file, empty if canceled
+        int priority;
+        unsigned int sequence;      ///< order of the request, among the requests of the same priority
+        Image *image;               ///< decoded image, nullptr until decoded or if the file can't be loaded
+        Texture2D *texture;         ///< texture being uploaded by the main thread
+        bool queued;                ///< not picked up by a loading thread yet
     };
 
 protected:
-    typedef struct _ImageInfo
-    {
-        AsyncStruct *asyncStruct;
-        Image        *image;
-    } ImageInfo;
+    static bool compareAsyncPriority(const AsyncStruct* a, const AsyncStruct* b);
+    void startLoadingThreads();
     
-    std::thread* _loadingThread;
-
-    std::queue<AsyncStruct*>* _asyncStructQueue;
-    std::deque<ImageInfo*>* _imageInfoQueue;
+    std::vector<std::thread> _loadingThreads;
+    int _loadingThreadCount;
 
-    std::mutex _asyncStructQueueMutex;
-    std::mutex _imageInfoMutex;
+    std::vector<AsyncStruct*> _asyncRequestQueue;       ///< heap of the requests waiting to be decoded
+    std::deque<AsyncStruct*> _asyncLoadedQueue;         ///< requests decoded (or canceled) waiting for the main thread
+    std::unordered_map<std::string, AsyncStruct*> _asyncRequests;   ///< requests in flight, by full path
+    std::deque<AsyncStruct*> _asyncUploadQueue;         ///< requests being uploaded, only used by the main thread
 
-    std::mutex _sleepMutex;
+    std::mutex _asyncMutex;
     std::condition_variable _sleepCondition;
 
     bool _needQuit;
 
     int _asyncRefCount;
+    unsigned int _asyncSequence;
+    float _asyncUploadBudget;
+    ssize_t _asyncUploadChunkSize;
+    float _asyncUploadTime;
 
     std::unordered_map<std::string, Texture2D*> _textures;
 };
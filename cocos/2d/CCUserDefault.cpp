@@ -25,8 +25,29 @@ THE SOFTWARE.
 #include "CCUserDefault.h"
 #include "platform/CCCommon.h"
 #include "platform/CCFileUtils.h"
+#include "CCDirector.h"
+#include "CCEventDispatcher.h"
+#include "CCEventListenerCustom.h"
+#include "CCEventType.h"
 #include "tinyxml2.h"
 #include "base64.h"
+#include <unordered_map>
+#include <unordered_set>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <chrono>
+
+#if CC_TARGET_PLATFORM == CC_PLATFORM_WIN32
+#include <Windows.h>
+#include <io.h>
+#elif CC_TARGET_PLATFORM == CC_PLATFORM_WP8 || CC_TARGET_PLATFORM == CC_PLATFORM_WINRT
+#include <Windows.h>
+#include <io.h>
+#include "CCWinRTUtils.h"
+#elif CC_TARGET_PLATFORM != CC_PLATFORM_IOS && CC_TARGET_PLATFORM != CC_PLATFORM_ANDROID
+#include <unistd.h>
+#endif
 
 #if (CC_TARGET_PLATFORM != CC_PLATFORM_IOS && CC_TARGET_PLATFORM != CC_PLATFORM_ANDROID)
 
@@ -35,105 +56,390 @@ THE SOFTWARE.
 
 #define XML_FILE_NAME "UserDefault.xml"
 
+// the writes since the last snapshot, appended to the xml file path
+#define JOURNAL_FILE_SUFFIX ".journal"
+// the snapshot is written here, then renamed over the xml file
+#define SNAPSHOT_TEMP_FILE_SUFFIX ".tmp"
+// size of the journal that triggers a new snapshot
+#define JOURNAL_COMPACTION_SIZE (64 * 1024)
+// the writer thread waits this long for more values before appending them to the journal
+#define WRITE_BEHIND_DELAY_MS 100
+
+#define USERDEFAULT_WRITE_BEHIND (CC_TARGET_PLATFORM != CC_PLATFORM_EMSCRIPTEN)
+
 using namespace std;
 
 NS_CC_BEGIN
 
 /**
- * define the functions here because we don't want to
- * export xmlNodePtr and other types in "CCUserDefault.h"
+ * define the store here because we don't want to
+ * export tinyxml2 and the thread types in "CCUserDefault.h"
+ *
+ * The values are loaded once and read from memory. The writes only update the memory: a thread
+ * appends the changed values to a journal, and when the journal gets too big it writes a new xml file.
+ * The new xml file is written next to the old one and renamed over it, so a crash leaves either the
+ * old file and its journal, or the new file.
  */
+class UserDefaultStore
+{
+public:
+    explicit UserDefaultStore(const std::string& xmlPath);
+    ~UserDefaultStore();
+
+    bool getValueForKey(const char* key, std::string& value);
+    void setValueForKey(const char* key, const char* value);
+
+    // writes the pending values and a new xml file, synchronously
+    void flush();
+
+private:
+    void load();
+    void replayJournal();
+    void writePending(bool forceSnapshot);
+    bool appendToJournal(const std::vector<std::pair<std::string, std::string>>& records);
+    bool writeSnapshot(const std::unordered_map<std::string, std::string>& values);
+    void writerLoop();
+
+    std::string _xmlPath;
+    std::string _journalPath;
+    std::string _tempPath;
+
+    std::unordered_map<std::string, std::string> _values;
+    std::unordered_set<std::string> _dirtyKeys;         // changed since they were written to the journal
+    std::mutex _valuesMutex;
+
+    std::mutex _fileMutex;                              // one writer of the journal and the xml file at a time
+    long _journalSize;
+
+    std::thread _writer;
+    std::once_flag _writerStarted;
+    std::condition_variable _writeCondition;
+    bool _quit;
+};
+
+static UserDefaultStore* s_store = nullptr;
+// the process may be killed in the background: the pending values are written when it goes there
+static EventListenerCustom* s_toBackgroundListener = nullptr;
+
+static void escapeJournalString(const std::string& str, std::string& out)
+{
+    for (char c : str)
+    {
+        switch (c)
+        {
+            case '\\': out += "\\\\"; break;
+            case '\t': out += "\\t"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            default: out += c; break;
+        }
+    }
+}
+
+static std::string unescapeJournalString(const char* begin, const char* end)
+{
+    std::string out;
+    out.reserve(end - begin);
+    for (const char* c = begin; c < end; ++c)
+    {
+        if (*c == '\\' && c + 1 < end)
+        {
+            ++c;
+            switch (*c)
+            {
+                case 't': out += '\t'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                default: out += *c; break;
+            }
+        }
+        else
+        {
+            out += *c;
+        }
+    }
+    return out;
+}
 
-static tinyxml2::XMLElement* getXMLNodeForKey(const char* pKey, tinyxml2::XMLElement** rootNode, tinyxml2::XMLDocument **doc)
+// replaces the file "to" by the file "from", atomically
+static bool replaceFile(const std::string& from, const std::string& to)
 {
-    tinyxml2::XMLElement* curNode = nullptr;
+#if CC_TARGET_PLATFORM == CC_PLATFORM_WIN32
+    return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#elif CC_TARGET_PLATFORM == CC_PLATFORM_WP8 || CC_TARGET_PLATFORM == CC_PLATFORM_WINRT
+    // rename() doesn't replace files here
+    return MoveFileExW(CCUtf8ToUnicode(from.c_str()).c_str(), CCUtf8ToUnicode(to.c_str()).c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return rename(from.c_str(), to.c_str()) == 0;
+#endif
+}
 
-    // check the key value
-    if (! pKey)
+// writes the buffered data of fp to the disk, so that a crash after a rename can't leave an empty or truncated file
+static bool syncFile(FILE* fp)
+{
+    if (fflush(fp) != 0)
     {
-        return nullptr;
+        return false;
     }
+#if CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_WP8 || CC_TARGET_PLATFORM == CC_PLATFORM_WINRT
+    return _commit(_fileno(fp)) == 0;
+#else
+    return fsync(fileno(fp)) == 0;
+#endif
+}
+
+UserDefaultStore::UserDefaultStore(const std::string& xmlPath)
+: _xmlPath(xmlPath)
+, _journalPath(xmlPath + JOURNAL_FILE_SUFFIX)
+, _tempPath(xmlPath + SNAPSHOT_TEMP_FILE_SUFFIX)
+, _journalSize(0)
+, _quit(false)
+{
+    load();
+}
 
-    do 
+UserDefaultStore::~UserDefaultStore()
+{
+    if (_writer.joinable())
     {
- 		tinyxml2::XMLDocument* xmlDoc = new tinyxml2::XMLDocument();
-		*doc = xmlDoc;
-
-        std::string xmlBuffer = FileUtils::getInstance()->getStringFromFile(UserDefault::getInstance()->getXMLFilePath());
-
-		if (xmlBuffer.empty())
-		{
-			CCLOG("can not read xml file");
-			break;
-		}
-		xmlDoc->Parse(xmlBuffer.c_str(), xmlBuffer.size());
-
-		// get root node
-		*rootNode = xmlDoc->RootElement();
-		if (nullptr == *rootNode)
-		{
-			CCLOG("read root node error");
-			break;
-		}
-		// find the node
-		curNode = (*rootNode)->FirstChildElement();
-		while (nullptr != curNode)
-		{
-			const char* nodeName = curNode->Value();
-			if (!strcmp(nodeName, pKey))
-			{
-				break;
-			}
-
-			curNode = curNode->NextSiblingElement();
-		}
-	} while (0);
-
-	return curNode;
-}
-
-static void setValueForKey(const char* pKey, const char* pValue)
-{
- 	tinyxml2::XMLElement* rootNode;
-	tinyxml2::XMLDocument* doc;
-	tinyxml2::XMLElement* node;
-	// check the params
-	if (! pKey || ! pValue)
-	{
-		return;
-	}
-	// find the node
-	node = getXMLNodeForKey(pKey, &rootNode, &doc);
-	// if node exist, change the content
-	if (node)
-	{
-        if (node->FirstChild())
         {
-            node->FirstChild()->SetValue(pValue);
+            std::lock_guard<std::mutex> lock(_valuesMutex);
+            _quit = true;
+        }
+        _writeCondition.notify_one();
+        _writer.join();
+    }
+
+    writePending(true);
+}
+
+void UserDefaultStore::load()
+{
+    tinyxml2::XMLDocument doc;
+    std::string xmlBuffer = FileUtils::getInstance()->getStringFromFile(_xmlPath);
+    if (xmlBuffer.empty())
+    {
+        CCLOG("can not read xml file");
+    }
+    else
+    {
+        doc.Parse(xmlBuffer.c_str(), xmlBuffer.size());
+        tinyxml2::XMLElement* rootNode = doc.RootElement();
+        if (nullptr == rootNode)
+        {
+            CCLOG("read root node error");
         }
         else
         {
-            tinyxml2::XMLText* content = doc->NewText(pValue);
-            node->LinkEndChild(content);
+            for (tinyxml2::XMLElement* node = rootNode->FirstChildElement(); node; node = node->NextSiblingElement())
+            {
+                if (node->FirstChild())
+                {
+                    _values[node->Value()] = node->FirstChild()->Value();
+                }
+            }
         }
-	}
-	else
-	{
-		if (rootNode)
-		{
-			tinyxml2::XMLElement* tmpNode = doc->NewElement(pKey);//new tinyxml2::XMLElement(pKey);
-			rootNode->LinkEndChild(tmpNode);
-			tinyxml2::XMLText* content = doc->NewText(pValue);//new tinyxml2::XMLText(pValue);
-			tmpNode->LinkEndChild(content);
-		}	
-	}
+    }
 
-    // save file and free doc
-	if (doc)
-	{
-		doc->SaveFile(UserDefault::getInstance()->getXMLFilePath().c_str());
-		delete doc;
-	}
+    replayJournal();
+}
+
+void UserDefaultStore::replayJournal()
+{
+    FILE* fp = fopen(_journalPath.c_str(), "rb");
+    if (fp == nullptr)
+    {
+        return;
+    }
+
+    std::string journal;
+    char buffer[4096];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), fp)) > 0)
+    {
+        journal.append(buffer, read);
+    }
+    fclose(fp);
+    _journalSize = (long)journal.size();
+
+    // one "key\tvalue\n" record per write. A record cut by a crash has no end of line and is ignored
+    const char* cur = journal.c_str();
+    const char* end = cur + journal.size();
+    while (cur < end)
+    {
+        const char* lineEnd = (const char*)memchr(cur, '\n', end - cur);
+        if (lineEnd == nullptr)
+        {
+            break;
+        }
+
+        const char* tab = (const char*)memchr(cur, '\t', lineEnd - cur);
+        if (tab)
+        {
+            _values[unescapeJournalString(cur, tab)] = unescapeJournalString(tab + 1, lineEnd);
+        }
+        cur = lineEnd + 1;
+    }
+}
+
+bool UserDefaultStore::getValueForKey(const char* key, std::string& value)
+{
+    std::lock_guard<std::mutex> lock(_valuesMutex);
+    auto it = _values.find(key);
+    // like the xml file, an empty value is no value
+    if (it == _values.end() || it->second.empty())
+    {
+        return false;
+    }
+    value = it->second;
+    return true;
+}
+
+void UserDefaultStore::setValueForKey(const char* key, const char* value)
+{
+    {
+        std::lock_guard<std::mutex> lock(_valuesMutex);
+        auto it = _values.find(key);
+        if (it != _values.end() && it->second == value)
+        {
+            return;
+        }
+        _values[key] = value;
+        _dirtyKeys.insert(key);
+    }
+
+#if USERDEFAULT_WRITE_BEHIND
+    // lazy init, the values may be set from several threads
+    std::call_once(_writerStarted, [this]() {
+        _writer = std::thread(&UserDefaultStore::writerLoop, this);
+    });
+    _writeCondition.notify_one();
+#else
+    writePending(false);
+#endif
+}
+
+void UserDefaultStore::flush()
+{
+    writePending(true);
+}
+
+void UserDefaultStore::writerLoop()
+{
+    std::unique_lock<std::mutex> lock(_valuesMutex);
+    while (true)
+    {
+        _writeCondition.wait(lock, [this]() { return _quit || !_dirtyKeys.empty(); });
+        if (_quit)
+        {
+            break;
+        }
+
+        // wait for the other values set in the same frames, to write them at once
+        _writeCondition.wait_for(lock, std::chrono::milliseconds(WRITE_BEHIND_DELAY_MS), [this]() { return _quit; });
+
+        lock.unlock();
+        writePending(false);
+        lock.lock();
+    }
+}
+
+void UserDefaultStore::writePending(bool forceSnapshot)
+{
+    std::lock_guard<std::mutex> fileLock(_fileMutex);
+
+    std::vector<std::pair<std::string, std::string>> records;
+    std::unordered_map<std::string, std::string> snapshot;
+    bool needSnapshot;
+    {
+        std::lock_guard<std::mutex> lock(_valuesMutex);
+        records.reserve(_dirtyKeys.size());
+        for (auto& key : _dirtyKeys)
+        {
+            records.push_back(std::make_pair(key, _values[key]));
+        }
+        _dirtyKeys.clear();
+
+        // the journal ends with the values of the snapshot, so replaying it over the snapshot is harmless
+        needSnapshot = (forceSnapshot && (_journalSize > 0 || !records.empty())) || _journalSize >= JOURNAL_COMPACTION_SIZE;
+        if (needSnapshot)
+        {
+            snapshot = _values;
+        }
+    }
+
+    if (!records.empty() && !appendToJournal(records))
+    {
+        // the journal can't be written: the snapshot has to
+        needSnapshot = true;
+        std::lock_guard<std::mutex> lock(_valuesMutex);
+        snapshot = _values;
+    }
+
+    if (needSnapshot && writeSnapshot(snapshot))
+    {
+        remove(_journalPath.c_str());
+        _journalSize = 0;
+    }
+}
+
+bool UserDefaultStore::appendToJournal(const std::vector<std::pair<std::string, std::string>>& records)
+{
+    std::string buffer;
+    for (auto& record : records)
+    {
+        escapeJournalString(record.first, buffer);
+        buffer += '\t';
+        escapeJournalString(record.second, buffer);
+        buffer += '\n';
+    }
+
+    FILE* fp = fopen(_journalPath.c_str(), "ab");
+    if (fp == nullptr)
+    {
+        CCLOG("can not open %s", _journalPath.c_str());
+        return false;
+    }
+    bool ok = fwrite(buffer.data(), 1, buffer.size(), fp) == buffer.size();
+    ok = (fclose(fp) == 0) && ok;
+
+    _journalSize += (long)buffer.size();
+    return ok;
+}
+
+bool UserDefaultStore::writeSnapshot(const std::unordered_map<std::string, std::string>& values)
+{
+    tinyxml2::XMLDocument doc;
+    doc.LinkEndChild(doc.NewDeclaration(nullptr));
+    tinyxml2::XMLElement* rootNode = doc.NewElement(USERDEFAULT_ROOT_NAME);
+    doc.LinkEndChild(rootNode);
+
+    for (auto& value : values)
+    {
+        tinyxml2::XMLElement* node = doc.NewElement(value.first.c_str());
+        rootNode->LinkEndChild(node);
+        node->LinkEndChild(doc.NewText(value.second.c_str()));
+    }
+
+    FILE* fp = fopen(_tempPath.c_str(), "wb");
+    if (fp == nullptr)
+    {
+        CCLOG("can not open %s", _tempPath.c_str());
+        return false;
+    }
+    bool ok = tinyxml2::XML_SUCCESS == doc.SaveFile(fp) && syncFile(fp);
+    ok = (fclose(fp) == 0) && ok;
+    if (!ok)
+    {
+        CCLOG("can not write %s", _tempPath.c_str());
+        return false;
+    }
+    if (!replaceFile(_tempPath, _xmlPath))
+    {
+        CCLOG("can not replace %s", _xmlPath.c_str());
+        return false;
+    }
+    return true;
 }
 
 /**
@@ -146,10 +452,24 @@ bool UserDefault::_isFilePathInitialized = false;
 
 UserDefault::~UserDefault()
 {
+    if (s_toBackgroundListener)
+    {
+        Director::getInstance()->getEventDispatcher()->removeEventListener(s_toBackgroundListener);
+        s_toBackgroundListener = nullptr;
+    }
+
+    // writes what the writer thread didn't yet
+    CC_SAFE_DELETE(s_store);
 }
 
 UserDefault::UserDefault()
 {
+    s_store = new UserDefaultStore(_filePath);
+
+    s_toBackgroundListener = EventListenerCustom::create(EVENT_COME_TO_BACKGROUND, [](EventCustom* event){
+        s_store->flush();
+    });
+    Director::getInstance()->getEventDispatcher()->addEventListenerWithFixedPriority(s_toBackgroundListener, 1);
 }
 
 bool UserDefault::getBoolForKey(const char* pKey)
@@ -159,26 +479,14 @@ bool UserDefault::getBoolForKey(const char* pKey)
 
 bool UserDefault::getBoolForKey(const char* pKey, bool defaultValue)
 {
-    const char* value = nullptr;
-	tinyxml2::XMLElement* rootNode;
-	tinyxml2::XMLDocument* doc;
-	tinyxml2::XMLElement* node;
-	node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-	// find the node
-	if (node && node->FirstChild())
-	{
-        value = (const char*)(node->FirstChild()->Value());
-	}
-
+    std::string value;
 	bool ret = defaultValue;
 
-	if (value)
+	if (pKey && s_store->getValueForKey(pKey, value))
 	{
-		ret = (! strcmp(value, "true"));
+		ret = (value == "true");
 	}
 
-    if (doc) delete doc;
-
 	return ret;
 }
 
@@ -189,30 +497,14 @@ int UserDefault::getIntegerForKey(const char* pKey)
 
 int UserDefault::getIntegerForKey(const char* pKey, int defaultValue)
 {
-	const char* value = nullptr;
-	tinyxml2::XMLElement* rootNode;
-	tinyxml2::XMLDocument* doc;
-	tinyxml2::XMLElement* node;
-	node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-	// find the node
-	if (node && node->FirstChild())
-	{
-        value = (const char*)(node->FirstChild()->Value());
-	}
-
+    std::string value;
 	int ret = defaultValue;
 
-	if (value)
+	if (pKey && s_store->getValueForKey(pKey, value))
 	{
-		ret = atoi(value);
+		ret = atoi(value.c_str());
 	}
 
-	if(doc)
-	{
-		delete doc;
-	}
-
-
 	return ret;
 }
 
@@ -235,26 +527,14 @@ double  UserDefault::getDoubleForKey(const char* pKey)
 
 double UserDefault::getDoubleForKey(const char* pKey, double defaultValue)
 {
-	const char* value = nullptr;
-	tinyxml2::XMLElement* rootNode;
-	tinyxml2::XMLDocument* doc;
-	tinyxml2::XMLElement* node;
-	node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-	// find the node
-	if (node && node->FirstChild())
-	{
-        value = (const char*)(node->FirstChild()->Value());
-	}
-
+    std::string value;
 	double ret = defaultValue;
 
-	if (value)
+	if (pKey && s_store->getValueForKey(pKey, value))
 	{
-		ret = atof(value);
+		ret = atof(value.c_str());
 	}
 
-    if (doc) delete doc;
-
 	return ret;
 }
 
@@ -265,27 +545,14 @@ std::string UserDefault::getStringForKey(const char* pKey)
 
 string UserDefault::getStringForKey(const char* pKey, const std::string & defaultValue)
 {
-    const char* value = nullptr;
-	tinyxml2::XMLElement* rootNode;
-	tinyxml2::XMLDocument* doc;
-	tinyxml2::XMLElement* node;
-	node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-	// find the node
-	if (node && node->FirstChild())
-	{
-        value = (const char*)(node->FirstChild()->Value());
-	}
+    std::string value;
 
-	string ret = defaultValue;
-
-	if (value)
+	if (pKey && s_store->getValueForKey(pKey, value))
 	{
-		ret = string(value);
+		return value;
 	}
 
-    if (doc) delete doc;
-
-	return ret;
+	return defaultValue;
 }
 
 Data UserDefault::getDataForKey(const char* pKey)
@@ -295,31 +562,19 @@ Data UserDefault::getDataForKey(const char* pKey)
 
 Data UserDefault::getDataForKey(const char* pKey, const Data& defaultValue)
 {
-    const char* encodedData = nullptr;
-	tinyxml2::XMLElement* rootNode;
-	tinyxml2::XMLDocument* doc;
-	tinyxml2::XMLElement* node;
-	node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-	// find the node
-	if (node && node->FirstChild())
-	{
-        encodedData = (const char*)(node->FirstChild()->Value());
-	}
-    
+    std::string encodedData;
 	Data ret = defaultValue;
     
-	if (encodedData)
+	if (pKey && s_store->getValueForKey(pKey, encodedData))
 	{
         unsigned char * decodedData = nullptr;
-        int decodedDataLen = base64Decode((unsigned char*)encodedData, (unsigned int)strlen(encodedData), &decodedData);
+        int decodedDataLen = base64Decode((unsigned char*)encodedData.c_str(), (unsigned int)encodedData.size(), &decodedData);
         
         if (decodedData) {
             ret.fastSet(decodedData, decodedDataLen);
         }
 	}
     
-    if (doc) delete doc;
-    
 	return ret;    
 }
 
@@ -351,7 +606,7 @@ void UserDefault::setIntegerForKey(const char* pKey, int value)
     memset(tmp, 0, 50);
     sprintf(tmp, "%d", value);
 
-    setValueForKey(pKey, tmp);
+    s_store->setValueForKey(pKey, tmp);
 }
 
 void UserDefault::setFloatForKey(const char* pKey, float value)
@@ -372,7 +627,7 @@ void UserDefault::setDoubleForKey(const char* pKey, double value)
     memset(tmp, 0, 50);
     sprintf(tmp, "%f", value);
 
-    setValueForKey(pKey, tmp);
+    s_store->setValueForKey(pKey, tmp);
 }
 
 void UserDefault::setStringForKey(const char* pKey, const std::string & value)
@@ -383,7 +638,7 @@ void UserDefault::setStringForKey(const char* pKey, const std::string & value)
         return;
     }
 
-    setValueForKey(pKey, value.c_str());
+    s_store->setValueForKey(pKey, value.c_str());
 }
 
 void UserDefault::setDataForKey(const char* pKey, const Data& value) {
@@ -397,25 +652,32 @@ void UserDefault::setDataForKey(const char* pKey, const Data& value) {
     
     base64Encode(value.getBytes(), static_cast<unsigned int>(value.getSize()), &encodedData);
         
-    setValueForKey(pKey, encodedData);
-    
     if (encodedData)
+    {
+        s_store->setValueForKey(pKey, encodedData);
         free(encodedData);
+    }
 }
 
 UserDefault* UserDefault::getInstance()
 {
-    initXMLFilePath();
-
-    // only create xml file one time
-    // the file exists after the program exit
-    if ((! isXMLFileExist()) && (! createXMLFile()))
-    {
-        return nullptr;
-    }
-
     if (! _userDefault)
     {
+        initXMLFilePath();
+
+        // a crash while replacing the xml file can leave the new one alone
+        if (! isXMLFileExist())
+        {
+            replaceFile(_filePath + SNAPSHOT_TEMP_FILE_SUFFIX, _filePath);
+        }
+
+        // only create xml file one time
+        // the file exists after the program exit
+        if ((! isXMLFileExist()) && (! createXMLFile()))
+        {
+            return nullptr;
+        }
+
         _userDefault = new UserDefault();
     }
 
@@ -500,6 +762,7 @@ const string& UserDefault::getXMLFilePath()
 
 void UserDefault::flush()
 {
+    s_store->flush();
 }
 
 NS_CC_END
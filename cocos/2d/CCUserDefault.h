@@ -146,7 +146,9 @@ public:
      */
     void    setDataForKey(const char* pKey, const Data& value);
     /**
-     @brief Save content to xml file
+     @brief Save content to xml file.
+     Values are saved by a background thread shortly after they are set, flush() saves them immediately.
+     They are also flushed when the application goes to the background and when the Director ends.
      * @js NA
      */
     void    flush();
@@ -156,6 +158,11 @@ public:
      * @lua NA
      */
     static UserDefault* getInstance();
+    /** returns the singleton, or nullptr if it doesn't exist. It is never created
+     * @js NA
+     * @lua NA
+     */
+    static UserDefault* getInstanceIfExists() { return _userDefault; }
     /**
      * @js NA
      */
@@ -48,5 +48,33 @@ void GLToCGAffine(const GLfloat *m, AffineTransform *t)
     t->b = m[1]; t->d = m[5]; t->ty = m[13];
 }
 
+bool GLIsAffine2D(const GLfloat *m)
+{
+    // | a c 0  tx |
+    // | b d 0  ty |
+    // | 0 0 sz tz |
+    // | 0 0 0  1  |
+    return m[2] == 0.0f && m[3] == 0.0f && m[6] == 0.0f && m[7] == 0.0f
+        && m[8] == 0.0f && m[9] == 0.0f && m[11] == 0.0f && m[15] == 1.0f;
+}
+
+void GLAffine2DMultiply(GLfloat *out, const GLfloat *lhs, const GLfloat *rhs)
+{
+    // 14 multiplications instead of the 64 of a full 4x4 product
+    const GLfloat a  = lhs[0] * rhs[0]  + lhs[4] * rhs[1];
+    const GLfloat b  = lhs[1] * rhs[0]  + lhs[5] * rhs[1];
+    const GLfloat c  = lhs[0] * rhs[4]  + lhs[4] * rhs[5];
+    const GLfloat d  = lhs[1] * rhs[4]  + lhs[5] * rhs[5];
+    const GLfloat tx = lhs[0] * rhs[12] + lhs[4] * rhs[13] + lhs[12];
+    const GLfloat ty = lhs[1] * rhs[12] + lhs[5] * rhs[13] + lhs[13];
+    const GLfloat sz = lhs[10] * rhs[10];
+    const GLfloat tz = lhs[10] * rhs[14] + lhs[14];
+
+    out[0] = a;    out[4] = c;    out[8] = 0.0f; out[12] = tx;
+    out[1] = b;    out[5] = d;    out[9] = 0.0f; out[13] = ty;
+    out[2] = 0.0f; out[6] = 0.0f; out[10] = sz; out[14] = tz;
+    out[3] = 0.0f; out[7] = 0.0f; out[11] = 0.0f; out[15] = 1.0f;
+}
+
 }//namespace   cocos2d 
 
@@ -37,6 +37,11 @@ struct AffineTransform;
 
 void CGAffineToGL(const AffineTransform &t, GLfloat *m);
 void GLToCGAffine(const GLfloat *m, AffineTransform *t);
+
+/** Returns true if the 4x4 matrix only holds a 2D affine transform, plus an optional z scale and z translation */
+bool GLIsAffine2D(const GLfloat *m);
+/** out = lhs * rhs, for two matrices that pass GLIsAffine2D. out may alias lhs or rhs */
+void GLAffine2DMultiply(GLfloat *out, const GLfloat *lhs, const GLfloat *rhs);
 }//namespace   cocos2d 
 
 #endif // __SUPPORT_TRANSFORM_UTILS_H__
@@ -54,6 +54,9 @@ THE SOFTWARE.
     - ccGLUseProgram() instead of glUseProgram()
     - GL::deleteProgram() instead of glDeleteProgram()
     - GL::blendFunc() instead of glBlendFunc()
+    - GL::bindBuffer(), GL::deleteBuffers() and GL::vertexAttribPointer() instead of glBindBuffer(), glDeleteBuffers() and glVertexAttribPointer()
+    - GL::enable(), GL::disable(), GL::depthFunc(), GL::depthMask(), GL::scissor() and GL::stencilFunc(), GL::stencilOp(), GL::stencilMask()
+      instead of the GL functions with the same names
 
  If this functionality is disabled, then ccGLUseProgram(), GL::deleteProgram(), GL::blendFunc() will call the GL ones, without using the cache.
 
@@ -262,6 +265,38 @@ To enable set it to a value different than 0. Disabled by default.
 #define CC_ENABLE_PROFILERS 0
 #endif
 
+/** @def CC_ENABLE_NULL_GL
+ If enabled, the GL calls can be switched at startup to GLNull, a backend that doesn't need a GPU,
+ so that the performance tests can run on headless machines. See GLView::createHeadless().
+ The GL 1.1 functions are then called through a function pointer. Only supported on Linux.
+
+ To enable set it to 1. Disabled by default. The USE_NULL_GL option of CMake enables it.
+ */
+#ifndef CC_ENABLE_NULL_GL
+#define CC_ENABLE_NULL_GL 0
+#endif
+
+/** @def CC_ENABLE_PROFILER_TIMELINE
+ If enabled, the scheduler, the actions, the event dispatcher and the renderer record their events in the ProfilerTimeline
+ when a capture is running. When no capture runs each event costs a single test, so it can stay enabled in release builds.
+
+ To disable set it to 0. Enabled by default.
+ */
+#ifndef CC_ENABLE_PROFILER_TIMELINE
+#define CC_ENABLE_PROFILER_TIMELINE 1
+#endif
+
+/** @def CC_ENABLE_ACTION_POOL
+ If enabled, the actions are allocated from pools of fixed size slots kept by the Action class. Deleting an action
+ gives its slot back to the pool, the memory is never returned to the system.
+ Disable it when tracking the actions with a memory checker.
+
+ To disable set it to 0. Enabled by default.
+ */
+#ifndef CC_ENABLE_ACTION_POOL
+#define CC_ENABLE_ACTION_POOL 1
+#endif
+
 /** Enable Lua engine debug log */
 #ifndef CC_LUA_ENGINE_DEBUG
 #define CC_LUA_ENGINE_DEBUG 0
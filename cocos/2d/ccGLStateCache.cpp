@@ -43,10 +43,14 @@ namespace
     static bool        s_vertexAttribPosition = false;
     static bool        s_vertexAttribColor = false;
     static bool        s_vertexAttribTexCoords = false;
+
+    static unsigned int s_stateChanges = 0;
+    static unsigned int s_redundantStateChanges = 0;
     
 #if CC_ENABLE_GL_STATE_CACHE
     
 #define kMaxActiveTexture 16
+#define kMaxVertexAttribs 16
     
     static GLuint    s_currentShaderProgram = -1;
     static GLuint    s_currentBoundTexture[kMaxActiveTexture] =  {(GLuint)-1,(GLuint)-1,(GLuint)-1,(GLuint)-1, (GLuint)-1,(GLuint)-1,(GLuint)-1,(GLuint)-1, (GLuint)-1,(GLuint)-1,(GLuint)-1,(GLuint)-1, (GLuint)-1,(GLuint)-1,(GLuint)-1,(GLuint)-1, };
@@ -56,7 +60,62 @@ namespace
     static GLuint    s_VAO = 0;
     static GLenum    s_activeTexture = -1;
 
+    static GLuint    s_arrayBuffer = -1;
+    static GLuint    s_elementArrayBuffer = -1;
+    // The element array binding belongs to the VAO, the one of the default VAO is kept while another one is bound
+    static GLuint    s_defaultVAOElementArrayBuffer = -1;
+
+    struct VertexAttribPointer
+    {
+        bool            valid;
+        GLuint          buffer;
+        GLint           size;
+        GLenum          type;
+        GLboolean       normalized;
+        GLsizei         stride;
+        const GLvoid*   pointer;
+    };
+    static VertexAttribPointer s_vertexAttribPointers[kMaxVertexAttribs];
+
+    // -1: unknown, 0: disabled, 1: enabled
+    static const GLenum s_cachedCapabilities[] = { GL_BLEND, GL_DEPTH_TEST, GL_STENCIL_TEST, GL_SCISSOR_TEST, GL_CULL_FACE };
+#define kCachedCapabilityCount (sizeof(s_cachedCapabilities) / sizeof(s_cachedCapabilities[0]))
+    static int       s_capabilityState[kCachedCapabilityCount] = { -1, -1, -1, -1, -1 };
+
+    static GLenum    s_depthFunc = -1;
+    static int       s_depthMask = -1;
+    static bool      s_scissorValid = false;
+    static GLint     s_scissorBox[4];
+    static bool      s_stencilFuncValid = false;
+    static GLenum    s_stencilFunc;
+    static GLint     s_stencilRef;
+    static GLuint    s_stencilValueMask;
+    static bool      s_stencilOpValid = false;
+    static GLenum    s_stencilOp[3];
+    static bool      s_stencilWriteMaskValid = false;
+    static GLuint    s_stencilWriteMask;
+
+    static int capabilityIndex(GLenum cap)
+    {
+        for (int i = 0; i < (int)kCachedCapabilityCount; ++i)
+        {
+            if (s_cachedCapabilities[i] == cap)
+                return i;
+        }
+        return -1;
+    }
+
 #endif // CC_ENABLE_GL_STATE_CACHE
+
+    // Counts the state change and returns whether it has to be sent to GL
+    static inline bool stateChanged(bool changed)
+    {
+        if (changed)
+            ++s_stateChanges;
+        else
+            ++s_redundantStateChanges;
+        return changed;
+    }
 }
 
 // GL State Cache functions
@@ -83,6 +142,26 @@ void invalidateStateCache( void )
     s_blendingDest = -1;
     s_GLServerState = 0;
     s_VAO = 0;
+    s_activeTexture = -1;
+
+    s_arrayBuffer = -1;
+    s_elementArrayBuffer = -1;
+    s_defaultVAOElementArrayBuffer = -1;
+    for( int i=0; i < kMaxVertexAttribs; i++ )
+    {
+        s_vertexAttribPointers[i].valid = false;
+    }
+
+    for( int i=0; i < (int)kCachedCapabilityCount; i++ )
+    {
+        s_capabilityState[i] = -1;
+    }
+    s_depthFunc = -1;
+    s_depthMask = -1;
+    s_scissorValid = false;
+    s_stencilFuncValid = false;
+    s_stencilOpValid = false;
+    s_stencilWriteMaskValid = false;
     
 #endif // CC_ENABLE_GL_STATE_CACHE
 }
@@ -102,11 +181,12 @@ void deleteProgram( GLuint program )
 void useProgram( GLuint program )
 {
 #if CC_ENABLE_GL_STATE_CACHE
-    if( program != s_currentShaderProgram ) {
+    if( stateChanged(program != s_currentShaderProgram) ) {
         s_currentShaderProgram = program;
         glUseProgram(program);
     }
 #else
+    stateChanged(true);
     glUseProgram(program);
 #endif // CC_ENABLE_GL_STATE_CACHE
 }
@@ -115,11 +195,11 @@ static void SetBlending(GLenum sfactor, GLenum dfactor)
 {
 	if (sfactor == GL_ONE && dfactor == GL_ZERO)
     {
-		glDisable(GL_BLEND);
+		disable(GL_BLEND);
 	}
     else
     {
-		glEnable(GL_BLEND);
+		enable(GL_BLEND);
 		glBlendFunc(sfactor, dfactor);
 	}
 }
@@ -127,13 +207,14 @@ static void SetBlending(GLenum sfactor, GLenum dfactor)
 void blendFunc(GLenum sfactor, GLenum dfactor)
 {
 #if CC_ENABLE_GL_STATE_CACHE
-    if (sfactor != s_blendingSource || dfactor != s_blendingDest)
+    if (stateChanged(sfactor != s_blendingSource || dfactor != s_blendingDest))
     {
         s_blendingSource = sfactor;
         s_blendingDest = dfactor;
         SetBlending(sfactor, dfactor);
     }
 #else
+    stateChanged(true);
     SetBlending( sfactor, dfactor );
 #endif // CC_ENABLE_GL_STATE_CACHE
 }
@@ -157,13 +238,14 @@ void bindTexture2DN(GLuint textureUnit, GLuint textureId)
 {
 #if CC_ENABLE_GL_STATE_CACHE
     CCASSERT(textureUnit < kMaxActiveTexture, "textureUnit is too big");
-    if (s_currentBoundTexture[textureUnit] != textureId)
+    if (stateChanged(s_currentBoundTexture[textureUnit] != textureId))
     {
         s_currentBoundTexture[textureUnit] = textureId;
         activeTexture(GL_TEXTURE0 + textureUnit);
         glBindTexture(GL_TEXTURE_2D, textureId);
     }
 #else
+    stateChanged(true);
     glActiveTexture(GL_TEXTURE0 + textureUnit);
     glBindTexture(GL_TEXTURE_2D, textureId);
 #endif
@@ -190,11 +272,12 @@ void deleteTextureN(GLuint textureUnit, GLuint textureId)
 void activeTexture(GLenum texture)
 {
 #if CC_ENABLE_GL_STATE_CACHE
-    if(s_activeTexture != texture) {
+    if(stateChanged(s_activeTexture != texture)) {
         s_activeTexture = texture;
         glActiveTexture(s_activeTexture);
     }
 #else
+    stateChanged(true);
     glActiveTexture(texture);
 #endif
 }
@@ -205,20 +288,115 @@ void bindVAO(GLuint vaoId)
     {
     
 #if CC_ENABLE_GL_STATE_CACHE
-        if (s_VAO != vaoId)
+        if (stateChanged(s_VAO != vaoId))
         {
+            if (s_VAO == 0)
+                s_defaultVAOElementArrayBuffer = s_elementArrayBuffer;
+            s_elementArrayBuffer = (vaoId == 0) ? s_defaultVAOElementArrayBuffer : -1;
+
             s_VAO = vaoId;
             glBindVertexArray(vaoId);
         }
 #else
+        stateChanged(true);
         glBindVertexArray(vaoId);
 #endif // CC_ENABLE_GL_STATE_CACHE
     
     }
 }
 
+// GL Buffer functions
+
+void bindBuffer(GLenum target, GLuint buffer)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    GLuint* current = nullptr;
+    if (target == GL_ARRAY_BUFFER)
+        current = &s_arrayBuffer;
+    else if (target == GL_ELEMENT_ARRAY_BUFFER)
+        current = &s_elementArrayBuffer;
+
+    if (current == nullptr)
+    {
+        stateChanged(true);
+        glBindBuffer(target, buffer);
+    }
+    else if (stateChanged(*current != buffer))
+    {
+        *current = buffer;
+        glBindBuffer(target, buffer);
+    }
+#else
+    stateChanged(true);
+    glBindBuffer(target, buffer);
+#endif // CC_ENABLE_GL_STATE_CACHE
+}
+
+void deleteBuffers(GLsizei n, const GLuint* buffers)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        // GL unbinds a deleted buffer, and its name can be given to a new one
+        if (s_arrayBuffer == buffers[i])
+            s_arrayBuffer = 0;
+        if (s_elementArrayBuffer == buffers[i])
+            s_elementArrayBuffer = 0;
+        if (s_defaultVAOElementArrayBuffer == buffers[i])
+            s_defaultVAOElementArrayBuffer = -1;
+
+        for (int j = 0; j < kMaxVertexAttribs; ++j)
+        {
+            if (s_vertexAttribPointers[j].buffer == buffers[i])
+                s_vertexAttribPointers[j].valid = false;
+        }
+    }
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    glDeleteBuffers(n, buffers);
+}
+
 // GL Vertex Attrib functions
 
+void vertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const GLvoid* pointer)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    // The pointers of the other VAOs are stored in them, there is no need to set them again
+    if (s_VAO != 0 || index >= kMaxVertexAttribs || s_arrayBuffer == (GLuint)-1)
+    {
+        stateChanged(true);
+        glVertexAttribPointer(index, size, type, normalized, stride, pointer);
+        if (index < kMaxVertexAttribs && s_VAO == 0)
+            s_vertexAttribPointers[index].valid = false;
+        return;
+    }
+
+    auto& current = s_vertexAttribPointers[index];
+    bool changed = !current.valid
+        || current.buffer != s_arrayBuffer
+        || current.size != size
+        || current.type != type
+        || current.normalized != normalized
+        || current.stride != stride
+        || current.pointer != pointer;
+
+    if (stateChanged(changed))
+    {
+        current.valid = true;
+        current.buffer = s_arrayBuffer;
+        current.size = size;
+        current.type = type;
+        current.normalized = normalized;
+        current.stride = stride;
+        current.pointer = pointer;
+        glVertexAttribPointer(index, size, type, normalized, stride, pointer);
+    }
+#else
+    stateChanged(true);
+    glVertexAttribPointer(index, size, type, normalized, stride, pointer);
+#endif // CC_ENABLE_GL_STATE_CACHE
+}
+
 void enableVertexAttribs( unsigned int flags )
 {
     bindVAO(0);
@@ -226,7 +404,7 @@ void enableVertexAttribs( unsigned int flags )
     /* Position */
     bool enablePosition = flags & VERTEX_ATTRIB_FLAG_POSITION;
 
-    if( enablePosition != s_vertexAttribPosition ) {
+    if( stateChanged(enablePosition != s_vertexAttribPosition) ) {
         if( enablePosition )
             glEnableVertexAttribArray( GLProgram::VERTEX_ATTRIB_POSITION );
         else
@@ -238,7 +416,7 @@ void enableVertexAttribs( unsigned int flags )
     /* Color */
     bool enableColor = (flags & VERTEX_ATTRIB_FLAG_COLOR) != 0 ? true : false;
 
-    if( enableColor != s_vertexAttribColor ) {
+    if( stateChanged(enableColor != s_vertexAttribColor) ) {
         if( enableColor )
             glEnableVertexAttribArray( GLProgram::VERTEX_ATTRIB_COLOR );
         else
@@ -250,7 +428,7 @@ void enableVertexAttribs( unsigned int flags )
     /* Tex Coords */
     bool enableTexCoords = (flags & VERTEX_ATTRIB_FLAG_TEX_COORDS) != 0 ? true : false;
 
-    if( enableTexCoords != s_vertexAttribTexCoords ) {
+    if( stateChanged(enableTexCoords != s_vertexAttribTexCoords) ) {
         if( enableTexCoords )
             glEnableVertexAttribArray( GLProgram::VERTEX_ATTRIB_TEX_COORDS );
         else
@@ -260,6 +438,145 @@ void enableVertexAttribs( unsigned int flags )
     }
 }
 
+// GL Server State functions
+
+static void setCapability(GLenum cap, bool enabled)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    int index = capabilityIndex(cap);
+    if (index >= 0 && !stateChanged(s_capabilityState[index] != (int)enabled))
+        return;
+
+    if (index >= 0)
+        s_capabilityState[index] = enabled;
+    else
+        stateChanged(true);
+#else
+    stateChanged(true);
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    if (enabled)
+        glEnable(cap);
+    else
+        glDisable(cap);
+}
+
+void enable(GLenum cap)
+{
+    setCapability(cap, true);
+}
+
+void disable(GLenum cap)
+{
+    setCapability(cap, false);
+}
+
+void depthFunc(GLenum func)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (stateChanged(s_depthFunc != func))
+    {
+        s_depthFunc = func;
+        glDepthFunc(func);
+    }
+#else
+    stateChanged(true);
+    glDepthFunc(func);
+#endif // CC_ENABLE_GL_STATE_CACHE
+}
+
+void depthMask(GLboolean flag)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    int value = flag ? 1 : 0;
+    if (stateChanged(s_depthMask != value))
+    {
+        s_depthMask = value;
+        glDepthMask(flag);
+    }
+#else
+    stateChanged(true);
+    glDepthMask(flag);
+#endif // CC_ENABLE_GL_STATE_CACHE
+}
+
+void scissor(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    bool changed = !s_scissorValid
+        || s_scissorBox[0] != x || s_scissorBox[1] != y
+        || s_scissorBox[2] != width || s_scissorBox[3] != height;
+
+    if (stateChanged(changed))
+    {
+        s_scissorValid = true;
+        s_scissorBox[0] = x;
+        s_scissorBox[1] = y;
+        s_scissorBox[2] = width;
+        s_scissorBox[3] = height;
+        glScissor(x, y, width, height);
+    }
+#else
+    stateChanged(true);
+    glScissor(x, y, width, height);
+#endif // CC_ENABLE_GL_STATE_CACHE
+}
+
+void stencilFunc(GLenum func, GLint ref, GLuint mask)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    bool changed = !s_stencilFuncValid
+        || s_stencilFunc != func || s_stencilRef != ref || s_stencilValueMask != mask;
+
+    if (stateChanged(changed))
+    {
+        s_stencilFuncValid = true;
+        s_stencilFunc = func;
+        s_stencilRef = ref;
+        s_stencilValueMask = mask;
+        glStencilFunc(func, ref, mask);
+    }
+#else
+    stateChanged(true);
+    glStencilFunc(func, ref, mask);
+#endif // CC_ENABLE_GL_STATE_CACHE
+}
+
+void stencilOp(GLenum fail, GLenum zfail, GLenum zpass)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    bool changed = !s_stencilOpValid
+        || s_stencilOp[0] != fail || s_stencilOp[1] != zfail || s_stencilOp[2] != zpass;
+
+    if (stateChanged(changed))
+    {
+        s_stencilOpValid = true;
+        s_stencilOp[0] = fail;
+        s_stencilOp[1] = zfail;
+        s_stencilOp[2] = zpass;
+        glStencilOp(fail, zfail, zpass);
+    }
+#else
+    stateChanged(true);
+    glStencilOp(fail, zfail, zpass);
+#endif // CC_ENABLE_GL_STATE_CACHE
+}
+
+void stencilMask(GLuint mask)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (stateChanged(!s_stencilWriteMaskValid || s_stencilWriteMask != mask))
+    {
+        s_stencilWriteMaskValid = true;
+        s_stencilWriteMask = mask;
+        glStencilMask(mask);
+    }
+#else
+    stateChanged(true);
+    glStencilMask(mask);
+#endif // CC_ENABLE_GL_STATE_CACHE
+}
+
 // GL Uniforms functions
 
 void setProjectionMatrixDirty( void )
@@ -267,6 +584,29 @@ void setProjectionMatrixDirty( void )
     s_currentProjectionMatrix = -1;
 }
 
+// State change counters
+
+void countStateChange(bool redundant)
+{
+    stateChanged(!redundant);
+}
+
+unsigned int getStateChangeCount(void)
+{
+    return s_stateChanges;
+}
+
+unsigned int getRedundantStateChangeCount(void)
+{
+    return s_redundantStateChanges;
+}
+
+void resetStateChangeCounters(void)
+{
+    s_stateChanges = 0;
+    s_redundantStateChanges = 0;
+}
+
 } // Namespace GL
 
 NS_CC_END
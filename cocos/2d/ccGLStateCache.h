@@ -141,6 +141,96 @@ void CC_DLL activeTexture(GLenum texture);
  */
 void CC_DLL bindVAO(GLuint vaoId);
 
+/** If the buffer is not already bound to the target, it binds it.
+ GL_ARRAY_BUFFER and GL_ELEMENT_ARRAY_BUFFER are cached, the element array binding is reset when another VAO is bound.
+ If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glBindBuffer() directly.
+ @since v3.0
+ */
+void CC_DLL bindBuffer(GLenum target, GLuint buffer);
+
+/** It will delete the given buffers. The bindings and the vertex attrib pointers using them are invalidated.
+ If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glDeleteBuffers() directly.
+ @since v3.0
+ */
+void CC_DLL deleteBuffers(GLsizei n, const GLuint* buffers);
+
+/** Sets the vertex attrib pointer in case it is different than the current one.
+ The buffer bound to GL_ARRAY_BUFFER is part of the cached state. Only the pointers of the default VAO are cached.
+ If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glVertexAttribPointer() directly.
+ @since v3.0
+ */
+void CC_DLL vertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const GLvoid* pointer);
+
+/** Enables a capability in case it is not already enabled.
+ GL_BLEND, GL_DEPTH_TEST, GL_STENCIL_TEST, GL_SCISSOR_TEST and GL_CULL_FACE are cached, the other ones are always enabled.
+ If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glEnable() directly.
+ @since v3.0
+ */
+void CC_DLL enable(GLenum cap);
+
+/** Disables a capability in case it is not already disabled.
+ If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glDisable() directly.
+ @since v3.0
+ */
+void CC_DLL disable(GLenum cap);
+
+/** Sets the depth function in case it is different than the current one.
+ If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glDepthFunc() directly.
+ @since v3.0
+ */
+void CC_DLL depthFunc(GLenum func);
+
+/** Enables or disables writing into the depth buffer in case it is not already done.
+ If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glDepthMask() directly.
+ @since v3.0
+ */
+void CC_DLL depthMask(GLboolean flag);
+
+/** Sets the scissor box in case it is different than the current one.
+ If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glScissor() directly.
+ @since v3.0
+ */
+void CC_DLL scissor(GLint x, GLint y, GLsizei width, GLsizei height);
+
+/** Sets the stencil test function in case it is different than the current one.
+ If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glStencilFunc() directly.
+ @since v3.0
+ */
+void CC_DLL stencilFunc(GLenum func, GLint ref, GLuint mask);
+
+/** Sets the stencil test actions in case they are different than the current ones.
+ If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glStencilOp() directly.
+ @since v3.0
+ */
+void CC_DLL stencilOp(GLenum fail, GLenum zfail, GLenum zpass);
+
+/** Sets the stencil write mask in case it is different than the current one.
+ If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glStencilMask() directly.
+ @since v3.0
+ */
+void CC_DLL stencilMask(GLuint mask);
+
+/** Counts a state change made by another cache of the engine, like the uniform values of GLProgram.
+ A redundant change is one that was filtered out instead of being sent to GL.
+ @since v3.0
+ */
+void CC_DLL countStateChange(bool redundant);
+
+/** Number of state changes sent to GL since the last resetStateChangeCounters()
+ @since v3.0
+ */
+unsigned int CC_DLL getStateChangeCount(void);
+
+/** Number of redundant state changes filtered out since the last resetStateChangeCounters()
+ @since v3.0
+ */
+unsigned int CC_DLL getRedundantStateChangeCount(void);
+
+/** Resets the state change counters. The Director does it once per frame when the stats are displayed.
+ @since v3.0
+ */
+void CC_DLL resetStateChangeCounters(void);
+
 // end of shaders group
 /// @}
 
@@ -235,6 +235,27 @@ It should work same as apples CFSwapInt32LittleToHost(..)
 
 #endif
 
+#if CC_ENABLE_PROFILER_TIMELINE
+
+#define CC_PROFILER_TIMELINE_CONCAT_(__a__, __b__) __a__##__b__
+#define CC_PROFILER_TIMELINE_CONCAT(__a__, __b__) CC_PROFILER_TIMELINE_CONCAT_(__a__, __b__)
+
+#define CC_PROFILER_TIMELINE_SCOPE(__name__) ProfilerTimelineScope CC_PROFILER_TIMELINE_CONCAT(__timelineScope, __LINE__)(__name__)
+#define CC_PROFILER_TIMELINE_BEGIN(__name__) do{ if(ProfilerTimeline::isRecording()) ProfilerTimeline::getInstance()->record(ProfilerTimeline::EventType::BEGIN, __name__); } while(0)
+#define CC_PROFILER_TIMELINE_END(__name__) do{ if(ProfilerTimeline::isRecording()) ProfilerTimeline::getInstance()->record(ProfilerTimeline::EventType::END, __name__); } while(0)
+#define CC_PROFILER_TIMELINE_COUNTER(__name__, __value__) do{ if(ProfilerTimeline::isRecording()) ProfilerTimeline::getInstance()->record(ProfilerTimeline::EventType::COUNTER, __name__, __value__); } while(0)
+#define CC_PROFILER_TIMELINE_MARKER(__name__) do{ if(ProfilerTimeline::isRecording()) ProfilerTimeline::getInstance()->record(ProfilerTimeline::EventType::MARKER, __name__); } while(0)
+
+#else
+
+#define CC_PROFILER_TIMELINE_SCOPE(__name__) do {} while(0)
+#define CC_PROFILER_TIMELINE_BEGIN(__name__) do {} while(0)
+#define CC_PROFILER_TIMELINE_END(__name__) do {} while(0)
+#define CC_PROFILER_TIMELINE_COUNTER(__name__, __value__) do {} while(0)
+#define CC_PROFILER_TIMELINE_MARKER(__name__) do {} while(0)
+
+#endif
+
 #if !defined(COCOS2D_DEBUG) || COCOS2D_DEBUG == 0
 #define CHECK_GL_ERROR_DEBUG()
 #else
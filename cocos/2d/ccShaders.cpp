@@ -93,4 +93,7 @@ const GLchar * ccLabelOutline_frag =
 const GLchar * ccLabel_vert =
 #include "ccShader_Label_vert.h"
 
+const GLchar * ccLabel_noMVP_vert =
+#include "ccShader_Label_noMVP_vert.h"
+
 NS_CC_END
@@ -68,6 +68,7 @@ extern CC_DLL const GLchar * ccLabelNormal_frag;
 extern CC_DLL const GLchar * ccLabelOutline_frag;
 
 extern CC_DLL const GLchar * ccLabel_vert;
+extern CC_DLL const GLchar * ccLabel_noMVP_vert;
 
 // end of shaders group
 /// @}
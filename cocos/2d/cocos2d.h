@@ -42,6 +42,7 @@ THE SOFTWARE.
 #include "CCActionInterval.h"
 #include "CCActionCamera.h"
 #include "CCActionManager.h"
+#include "CCActionTemplate.h"
 #include "CCActionEase.h"
 #include "CCActionPageTurn3D.h"
 #include "CCActionGrid.h"
@@ -120,6 +121,7 @@ THE SOFTWARE.
 #include "renderer/CCGroupCommand.h"
 #include "renderer/CCMaterialManager.h"
 #include "renderer/CCQuadCommand.h"
+#include "renderer/CCQuadTransform.h"
 #include "renderer/CCRenderCommand.h"
 #include "renderer/CCRenderCommandPool.h"
 #include "renderer/CCRenderMaterial.h"
@@ -225,6 +227,7 @@ THE SOFTWARE.
 #include "ccUTF8.h"
 #include "CCProfiling.h"
 #include "CCConsole.h"
+#include "CCThreadPool.h"
 #include "CCUserDefault.h"
 #include "CCVertex.h"
 
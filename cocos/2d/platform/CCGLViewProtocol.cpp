@@ -27,6 +27,7 @@ THE SOFTWARE.
 #include "CCTouch.h"
 #include "CCDirector.h"
 #include "CCEventDispatcher.h"
+#include "ccGLStateCache.h"
 
 NS_CC_BEGIN
 
@@ -201,7 +202,7 @@ void GLViewProtocol::setViewPortInPoints(float x , float y , float w , float h)
 
 void GLViewProtocol::setScissorInPoints(float x , float y , float w , float h)
 {
-    glScissor((GLint)(x * _scaleX + _viewPortRect.origin.x),
+    GL::scissor((GLint)(x * _scaleX + _viewPortRect.origin.x),
               (GLint)(y * _scaleY + _viewPortRect.origin.y),
               (GLsizei)(w * _scaleX),
               (GLsizei)(h * _scaleY));
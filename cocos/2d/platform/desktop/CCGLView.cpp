@@ -30,6 +30,7 @@ THE SOFTWARE.
 #include "CCEventKeyboard.h"
 #include "CCEventMouse.h"
 #include "CCIMEDispatcher.h"
+#include "ccGLStateCache.h"
 
 #include <unordered_map>
 
@@ -250,7 +251,7 @@ static keyCodeItem g_keyCodeStructArray[] = {
 //////////////////////////////////////////////////////////////////////////
 
 
-GLView::GLView()
+GLView::GLView(bool headless)
 : _captured(false)
 , _supportTouch(false)
 , _isInRetinaMonitor(false)
@@ -261,6 +262,8 @@ GLView::GLView()
 , _monitor(nullptr)
 , _mouseX(0.0f)
 , _mouseY(0.0f)
+, _headless(headless)
+, _headlessRunning(false)
 {
     _viewName = "cocos2dx";
     g_keyCodeMap.clear();
@@ -269,6 +272,11 @@ GLView::GLView()
         g_keyCodeMap[item.glfwKeyCode] = item.keyCode;
     }
 
+    if (_headless)
+    {
+        return;
+    }
+
     GLFWEventHandler::setGLView(this);
 
     glfwSetErrorCallback(GLFWEventHandler::onGLFWError);
@@ -278,6 +286,11 @@ GLView::GLView()
 GLView::~GLView()
 {
     CCLOGINFO("deallocing GLView: %p", this);
+    if (_headless)
+    {
+        return;
+    }
+
     GLFWEventHandler::setGLView(nullptr);
     glfwTerminate();
 }
@@ -326,6 +339,19 @@ GLView* GLView::createWithFullScreen(const std::string& viewName, const GLFWvidm
     return nullptr;
 }
 
+#if CC_ENABLE_NULL_GL
+GLView* GLView::createHeadless(const std::string& viewName, const Size& frameSize)
+{
+    auto ret = new GLView(true);
+    if(ret && ret->initHeadless(viewName, frameSize)) {
+        ret->autorelease();
+        return ret;
+    }
+
+    CC_SAFE_DELETE(ret);
+    return nullptr;
+}
+#endif
 
 bool GLView::initWithRect(const std::string& viewName, Rect rect, float frameZoomFactor)
 {
@@ -401,9 +427,32 @@ bool GLView::initWithFullscreen(const std::string &viewname, const GLFWvidmode &
     return initWithRect(viewname, Rect(0, 0, videoMode.width, videoMode.height), 1.0f);
 }
 
+bool GLView::initHeadless(const std::string& viewName, const Size& frameSize)
+{
+#if CC_ENABLE_NULL_GL
+    setViewName(viewName);
+
+    // before the first GL call
+    GLNull::install();
+
+    _headlessRunning = true;
+    GLViewProtocol::setFrameSize(frameSize.width, frameSize.height);
+
+    // Enable point size by default.
+    glEnable(GL_VERTEX_PROGRAM_POINT_SIZE);
+
+    return true;
+#else
+    CC_UNUSED_PARAM(viewName);
+    CC_UNUSED_PARAM(frameSize);
+    CCLOG("cocos2d: the headless GLView needs CC_ENABLE_NULL_GL");
+    return false;
+#endif
+}
+
 bool GLView::isOpenGLReady()
 {
-    return nullptr != _mainWindow;
+    return nullptr != _mainWindow || _headlessRunning;
 }
 
 void GLView::end()
@@ -413,6 +462,7 @@ void GLView::end()
         glfwSetWindowShouldClose(_mainWindow,1);
         _mainWindow = nullptr;
     }
+    _headlessRunning = false;
     // Release self. Otherwise, GLView could not be freed.
     release();
 }
@@ -428,12 +478,13 @@ bool GLView::windowShouldClose()
     if(_mainWindow)
         return glfwWindowShouldClose(_mainWindow) ? true : false;
     else
-        return true;
+        return !_headlessRunning;
 }
 
 void GLView::pollEvents()
 {
-    glfwPollEvents();
+    if (!_headless)
+        glfwPollEvents();
 }
 
 
@@ -479,7 +530,7 @@ float GLView::getFrameZoomFactor()
 
 void GLView::updateFrameSize()
 {
-    if (_screenSize.width > 0 && _screenSize.height > 0)
+    if (_mainWindow && _screenSize.width > 0 && _screenSize.height > 0)
     {
         int w = 0, h = 0;
         glfwGetWindowSize(_mainWindow, &w, &h);
@@ -530,7 +581,7 @@ void GLView::setViewPortInPoints(float x , float y , float w , float h)
 
 void GLView::setScissorInPoints(float x , float y , float w , float h)
 {
-    glScissor((GLint)(x * _scaleX * _retinaFactor * _frameZoomFactor + _viewPortRect.origin.x * _retinaFactor * _frameZoomFactor),
+    GL::scissor((GLint)(x * _scaleX * _retinaFactor * _frameZoomFactor + _viewPortRect.origin.x * _retinaFactor * _frameZoomFactor),
                (GLint)(y * _scaleY * _retinaFactor  * _frameZoomFactor + _viewPortRect.origin.y * _retinaFactor * _frameZoomFactor),
                (GLsizei)(w * _scaleX * _retinaFactor * _frameZoomFactor),
                (GLsizei)(h * _scaleY * _retinaFactor * _frameZoomFactor));
@@ -40,6 +40,12 @@ public:
     static GLView* createWithRect(const std::string& viewName, Rect size, float frameZoomFactor = 1.0f);
     static GLView* createWithFullScreen(const std::string& viewName);
     static GLView* createWithFullScreen(const std::string& viewName, const GLFWvidmode &videoMode, GLFWmonitor *monitor);
+#if CC_ENABLE_NULL_GL
+    /** Creates a view without window nor GL context: the GL calls go to GLNull.
+     It runs until Director::end() is called.
+     */
+    static GLView* createHeadless(const std::string& viewName, const Size& frameSize);
+#endif
 
     /*
      *frameZoomFactor for frame. This method is for debugging big resolution (e.g.new ipad) app on desktop.
@@ -78,7 +84,7 @@ public:
     bool isRetinaEnabled() { return _isRetinaEnabled; };
 
 protected:
-    GLView();
+    GLView(bool headless = false);
     virtual ~GLView();
 
     bool initWithRect(const std::string& viewName, Rect rect, float frameZoomFactor);
@@ -86,6 +92,7 @@ protected:
     bool initWithFullscreen(const std::string& viewname, const GLFWvidmode &videoMode, GLFWmonitor *monitor);
 
     bool initGlew();
+    bool initHeadless(const std::string& viewName, const Size& frameSize);
 
     void updateFrameSize();
 
@@ -114,6 +121,10 @@ protected:
     float _mouseX;
     float _mouseY;
 
+    // no window, see createHeadless()
+    bool _headless;
+    bool _headlessRunning;
+
     friend class GLFWEventHandler;
 
 private:
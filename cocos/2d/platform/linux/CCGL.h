@@ -26,10 +26,15 @@ THE SOFTWARE.
 #define __CCGL_H__
 
 #include "CCPlatformConfig.h"
+#include "ccConfig.h"
 #if CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
 
 #include "GL/glew.h"
 
+#if CC_ENABLE_NULL_GL
+#include "CCGLNull.h"
+#endif
+
 #define CC_GL_DEPTH24_STENCIL8		GL_DEPTH24_STENCIL8
 
 #endif // CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
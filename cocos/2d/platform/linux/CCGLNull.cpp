@@ -0,0 +1,1191 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "CCPlatformConfig.h"
+#if CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
+
+#include "CCGL.h"
+#include "CCGLNull.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "ccMacros.h"
+
+NS_CC_BEGIN
+
+// the GL 1.1 functions of libGL until GLNull::install() is called.
+// The functions aren't followed by parenthesis, so the macros of CCGLNull.h don't replace them.
+GLDispatch g_glDispatch = {
+    &glAlphaFunc,
+    &glBindTexture,
+    &glBlendFunc,
+    &glClear,
+    &glClearColor,
+    &glClearDepth,
+    &glClearStencil,
+    &glColorMask,
+    &glDeleteTextures,
+    &glDepthFunc,
+    &glDepthMask,
+    &glDisable,
+    &glDrawArrays,
+    &glDrawElements,
+    &glEnable,
+    &glGenTextures,
+    &glGetBooleanv,
+    &glGetError,
+    &glGetFloatv,
+    &glGetIntegerv,
+    &glGetString,
+    &glHint,
+    &glIsEnabled,
+    &glLineWidth,
+    &glPixelStorei,
+    &glPolygonOffset,
+    &glReadPixels,
+    &glScissor,
+    &glStencilFunc,
+    &glStencilMask,
+    &glStencilOp,
+    &glTexImage2D,
+    &glTexParameteri,
+    &glTexSubImage2D,
+    &glViewport
+};
+
+namespace {
+
+bool s_installed = false;
+GLNull::Stats s_stats = {0, 0, 0, 0, 0, 0};
+FILE* s_trace = nullptr;
+
+// object names are never reused, so that the traces don't depend on the deletions
+GLuint s_nextName = 1;
+
+std::unordered_map<GLuint, std::vector<unsigned char>> s_buffers;
+GLuint s_arrayBuffer = 0;
+GLuint s_elementArrayBuffer = 0;
+GLintptr s_mappedOffset = 0;
+GLsizeiptr s_mappedLength = 0;
+
+const int MAX_TEXTURE_UNITS = 16;
+GLuint s_textures[MAX_TEXTURE_UNITS] = {0};
+GLenum s_activeTexture = GL_TEXTURE0;
+
+GLuint s_program = 0;
+GLuint s_vertexArray = 0;
+GLuint s_framebuffer = 0;
+GLuint s_renderbuffer = 0;
+
+std::unordered_map<GLuint, std::unordered_map<std::string, GLint>> s_uniformLocations;
+std::unordered_map<GLuint, std::unordered_map<std::string, GLint>> s_attribLocations;
+
+std::unordered_set<GLenum> s_enabled;
+GLint s_viewport[4] = {0, 0, 0, 0};
+GLint s_scissorBox[4] = {0, 0, 0, 0};
+GLfloat s_clearColor[4] = {0, 0, 0, 0};
+GLfloat s_clearDepth = 1;
+GLboolean s_depthMask = GL_TRUE;
+GLboolean s_colorMask[4] = {GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE};
+GLint s_unpackAlignment = 4;
+
+//
+// trace
+//
+template <typename T>
+typename std::enable_if<std::is_pointer<T>::value>::type traceArg(T value)
+{
+    fprintf(s_trace, " %d", value ? 1 : 0);
+}
+
+template <typename T>
+typename std::enable_if<std::is_floating_point<T>::value>::type traceArg(T value)
+{
+    fprintf(s_trace, " %g", (double)value);
+}
+
+template <typename T>
+typename std::enable_if<std::is_integral<T>::value>::type traceArg(T value)
+{
+    fprintf(s_trace, " %lld", (long long)value);
+}
+
+void traceArgs()
+{
+}
+
+template <typename T, typename... Args>
+void traceArgs(T first, Args... rest)
+{
+    traceArg(first);
+    traceArgs(rest...);
+}
+
+template <typename... Args>
+void call(const char* name, Args... args)
+{
+    ++s_stats.calls;
+    if (s_trace)
+    {
+        fputs(name, s_trace);
+        traceArgs(args...);
+        fputc('\n', s_trace);
+    }
+}
+
+template <typename... Args>
+void stateCall(const char* name, Args... args)
+{
+    ++s_stats.stateChanges;
+    call(name, args...);
+}
+
+template <typename... Args>
+void uniformCall(const char* name, Args... args)
+{
+    ++s_stats.uniforms;
+    call(name, args...);
+}
+
+//
+// helpers
+//
+size_t bytesPerPixel(GLenum format, GLenum type)
+{
+    if (type == GL_UNSIGNED_SHORT_4_4_4_4 || type == GL_UNSIGNED_SHORT_5_5_5_1 || type == GL_UNSIGNED_SHORT_5_6_5)
+    {
+        return 2;
+    }
+
+    switch (format)
+    {
+        case GL_RGBA:
+        case GL_BGRA:
+            return 4;
+        case GL_RGB:
+            return 3;
+        case GL_LUMINANCE_ALPHA:
+            return 2;
+        default:
+            return 1;
+    }
+}
+
+GLuint* bufferBinding(GLenum target)
+{
+    return target == GL_ELEMENT_ARRAY_BUFFER ? &s_elementArrayBuffer : &s_arrayBuffer;
+}
+
+std::vector<unsigned char>* boundBuffer(GLenum target)
+{
+    GLuint name = *bufferBinding(target);
+    return name ? &s_buffers[name] : nullptr;
+}
+
+// number of values returned by glGet*v() for pname
+int valueCount(GLenum pname)
+{
+    switch (pname)
+    {
+        case GL_VIEWPORT:
+        case GL_SCISSOR_BOX:
+        case GL_COLOR_CLEAR_VALUE:
+        case GL_COLOR_WRITEMASK:
+            return 4;
+        case GL_DEPTH_RANGE:
+            return 2;
+        default:
+            return 1;
+    }
+}
+
+void getValues(GLenum pname, GLfloat* values)
+{
+    int count = valueCount(pname);
+    for (int i = 0; i < count; ++i)
+    {
+        values[i] = 0;
+    }
+
+    switch (pname)
+    {
+        case GL_MAX_TEXTURE_SIZE:           values[0] = 4096; break;
+        case GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS:
+        case GL_MAX_TEXTURE_IMAGE_UNITS:    values[0] = MAX_TEXTURE_UNITS; break;
+        case GL_MAX_VERTEX_ATTRIBS:         values[0] = 16; break;
+        case GL_DEPTH_BITS:                 values[0] = 24; break;
+        case GL_STENCIL_BITS:               values[0] = 8; break;
+        case GL_STENCIL_WRITEMASK:
+        case GL_STENCIL_VALUE_MASK:         values[0] = (GLfloat)0xff; break;
+        case GL_STENCIL_FUNC:
+        case GL_DEPTH_FUNC:                 values[0] = pname == GL_DEPTH_FUNC ? GL_LESS : GL_ALWAYS; break;
+        case GL_STENCIL_FAIL:
+        case GL_STENCIL_PASS_DEPTH_FAIL:
+        case GL_STENCIL_PASS_DEPTH_PASS:    values[0] = GL_KEEP; break;
+        case GL_UNPACK_ALIGNMENT:           values[0] = s_unpackAlignment; break;
+        case GL_ARRAY_BUFFER_BINDING:       values[0] = s_arrayBuffer; break;
+        case GL_ELEMENT_ARRAY_BUFFER_BINDING: values[0] = s_elementArrayBuffer; break;
+        case GL_CURRENT_PROGRAM:            values[0] = s_program; break;
+        case GL_ACTIVE_TEXTURE:             values[0] = s_activeTexture; break;
+        case GL_TEXTURE_BINDING_2D:         values[0] = s_textures[(s_activeTexture - GL_TEXTURE0) % MAX_TEXTURE_UNITS]; break;
+        case GL_FRAMEBUFFER_BINDING:        values[0] = s_framebuffer; break;
+        case GL_RENDERBUFFER_BINDING:       values[0] = s_renderbuffer; break;
+        case GL_DEPTH_CLEAR_VALUE:          values[0] = s_clearDepth; break;
+        case GL_DEPTH_WRITEMASK:            values[0] = s_depthMask; break;
+        case GL_DEPTH_RANGE:                values[1] = 1; break;
+        case GL_VIEWPORT:
+        case GL_SCISSOR_BOX:
+            for (int i = 0; i < 4; ++i)
+            {
+                values[i] = pname == GL_VIEWPORT ? s_viewport[i] : s_scissorBox[i];
+            }
+            break;
+        case GL_COLOR_CLEAR_VALUE:
+            memcpy(values, s_clearColor, sizeof(s_clearColor));
+            break;
+        case GL_COLOR_WRITEMASK:
+            for (int i = 0; i < 4; ++i)
+            {
+                values[i] = s_colorMask[i];
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+GLuint genName()
+{
+    return s_nextName++;
+}
+
+void genNames(GLsizei n, GLuint* names)
+{
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        names[i] = genName();
+    }
+}
+
+GLint location(std::unordered_map<std::string, GLint>& locations, const GLchar* name)
+{
+    auto iter = locations.find(name);
+    if (iter != locations.end())
+    {
+        return iter->second;
+    }
+    GLint location = (GLint)locations.size();
+    locations[name] = location;
+    return location;
+}
+
+//
+// GL 1.1
+//
+void GLAPIENTRY nullAlphaFunc(GLenum func, GLclampf ref)
+{
+    stateCall("glAlphaFunc", func, ref);
+}
+
+void GLAPIENTRY nullBindTexture(GLenum target, GLuint texture)
+{
+    stateCall("glBindTexture", target, texture);
+    s_textures[(s_activeTexture - GL_TEXTURE0) % MAX_TEXTURE_UNITS] = texture;
+}
+
+void GLAPIENTRY nullBlendFunc(GLenum sfactor, GLenum dfactor)
+{
+    stateCall("glBlendFunc", sfactor, dfactor);
+}
+
+void GLAPIENTRY nullClear(GLbitfield mask)
+{
+    call("glClear", mask);
+}
+
+void GLAPIENTRY nullClearColor(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha)
+{
+    stateCall("glClearColor", red, green, blue, alpha);
+    s_clearColor[0] = red;
+    s_clearColor[1] = green;
+    s_clearColor[2] = blue;
+    s_clearColor[3] = alpha;
+}
+
+void GLAPIENTRY nullClearDepth(GLclampd depth)
+{
+    stateCall("glClearDepth", depth);
+    s_clearDepth = depth;
+}
+
+void GLAPIENTRY nullClearStencil(GLint s)
+{
+    stateCall("glClearStencil", s);
+}
+
+void GLAPIENTRY nullColorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha)
+{
+    stateCall("glColorMask", red, green, blue, alpha);
+    s_colorMask[0] = red;
+    s_colorMask[1] = green;
+    s_colorMask[2] = blue;
+    s_colorMask[3] = alpha;
+}
+
+void GLAPIENTRY nullDeleteTextures(GLsizei n, const GLuint *textures)
+{
+    call("glDeleteTextures", n);
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        for (auto& bound : s_textures)
+        {
+            if (bound == textures[i])
+            {
+                bound = 0;
+            }
+        }
+    }
+}
+
+void GLAPIENTRY nullDepthFunc(GLenum func)
+{
+    stateCall("glDepthFunc", func);
+}
+
+void GLAPIENTRY nullDepthMask(GLboolean flag)
+{
+    stateCall("glDepthMask", flag);
+    s_depthMask = flag;
+}
+
+void GLAPIENTRY nullDisable(GLenum cap)
+{
+    stateCall("glDisable", cap);
+    s_enabled.erase(cap);
+}
+
+void GLAPIENTRY nullDrawArrays(GLenum mode, GLint first, GLsizei count)
+{
+    call("glDrawArrays", mode, first, count);
+    ++s_stats.drawCalls;
+    s_stats.vertices += count;
+}
+
+void GLAPIENTRY nullDrawElements(GLenum mode, GLsizei count, GLenum type, const GLvoid *indices)
+{
+    // indices are an offset when an element buffer is bound
+    call("glDrawElements", mode, count, type, s_elementArrayBuffer ? (long long)(intptr_t)indices : (long long)(indices != nullptr));
+    ++s_stats.drawCalls;
+    s_stats.vertices += count;
+}
+
+void GLAPIENTRY nullEnable(GLenum cap)
+{
+    stateCall("glEnable", cap);
+    s_enabled.insert(cap);
+}
+
+void GLAPIENTRY nullGenTextures(GLsizei n, GLuint *textures)
+{
+    call("glGenTextures", n);
+    genNames(n, textures);
+}
+
+void GLAPIENTRY nullGetFloatv(GLenum pname, GLfloat *params)
+{
+    call("glGetFloatv", pname);
+    getValues(pname, params);
+}
+
+void GLAPIENTRY nullGetBooleanv(GLenum pname, GLboolean *params)
+{
+    call("glGetBooleanv", pname);
+    GLfloat values[4];
+    getValues(pname, values);
+    for (int i = 0; i < valueCount(pname); ++i)
+    {
+        params[i] = values[i] != 0 ? GL_TRUE : GL_FALSE;
+    }
+}
+
+GLenum GLAPIENTRY nullGetError(void)
+{
+    call("glGetError");
+    return GL_NO_ERROR;
+}
+
+void GLAPIENTRY nullGetIntegerv(GLenum pname, GLint *params)
+{
+    call("glGetIntegerv", pname);
+    GLfloat values[4];
+    getValues(pname, values);
+    for (int i = 0; i < valueCount(pname); ++i)
+    {
+        params[i] = (GLint)values[i];
+    }
+}
+
+const GLubyte* GLAPIENTRY nullGetString(GLenum name)
+{
+    call("glGetString", name);
+    switch (name)
+    {
+        case GL_VENDOR:
+            return (const GLubyte*)"cocos2d-x";
+        case GL_RENDERER:
+            return (const GLubyte*)"GLNull";
+        case GL_VERSION:
+            return (const GLubyte*)"2.1 GLNull";
+        case GL_SHADING_LANGUAGE_VERSION:
+            return (const GLubyte*)"1.20";
+        case GL_EXTENSIONS:
+            return (const GLubyte*)"GL_ARB_vertex_array_object GL_ARB_map_buffer_range GL_ARB_sync GL_ARB_framebuffer_object";
+        default:
+            return (const GLubyte*)"";
+    }
+}
+
+void GLAPIENTRY nullHint(GLenum target, GLenum mode)
+{
+    call("glHint", target, mode);
+}
+
+GLboolean GLAPIENTRY nullIsEnabled(GLenum cap)
+{
+    call("glIsEnabled", cap);
+    return s_enabled.count(cap) ? GL_TRUE : GL_FALSE;
+}
+
+void GLAPIENTRY nullLineWidth(GLfloat width)
+{
+    stateCall("glLineWidth", width);
+}
+
+void GLAPIENTRY nullPixelStorei(GLenum pname, GLint param)
+{
+    stateCall("glPixelStorei", pname, param);
+    if (pname == GL_UNPACK_ALIGNMENT)
+    {
+        s_unpackAlignment = param;
+    }
+}
+
+void GLAPIENTRY nullPolygonOffset(GLfloat factor, GLfloat units)
+{
+    stateCall("glPolygonOffset", factor, units);
+}
+
+void GLAPIENTRY nullReadPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, GLvoid *pixels)
+{
+    call("glReadPixels", x, y, width, height, format, type);
+    // rows are aligned to 4 bytes by default
+    size_t rowSize = (width * bytesPerPixel(format, type) + 3) & ~3;
+    memset(pixels, 0, rowSize * height);
+}
+
+void GLAPIENTRY nullScissor(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    stateCall("glScissor", x, y, width, height);
+    s_scissorBox[0] = x;
+    s_scissorBox[1] = y;
+    s_scissorBox[2] = width;
+    s_scissorBox[3] = height;
+}
+
+void GLAPIENTRY nullStencilFunc(GLenum func, GLint ref, GLuint mask)
+{
+    stateCall("glStencilFunc", func, ref, mask);
+}
+
+void GLAPIENTRY nullStencilMask(GLuint mask)
+{
+    stateCall("glStencilMask", mask);
+}
+
+void GLAPIENTRY nullStencilOp(GLenum fail, GLenum zfail, GLenum zpass)
+{
+    stateCall("glStencilOp", fail, zfail, zpass);
+}
+
+void GLAPIENTRY nullTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const GLvoid *pixels)
+{
+    call("glTexImage2D", target, level, internalformat, width, height, border, format, type, pixels);
+    if (pixels)
+    {
+        s_stats.bytesUploaded += width * height * bytesPerPixel(format, type);
+    }
+}
+
+void GLAPIENTRY nullTexParameteri(GLenum target, GLenum pname, GLint param)
+{
+    stateCall("glTexParameteri", target, pname, param);
+}
+
+void GLAPIENTRY nullTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const GLvoid *pixels)
+{
+    call("glTexSubImage2D", target, level, xoffset, yoffset, width, height, format, type, pixels);
+    s_stats.bytesUploaded += width * height * bytesPerPixel(format, type);
+}
+
+void GLAPIENTRY nullViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    stateCall("glViewport", x, y, width, height);
+    s_viewport[0] = x;
+    s_viewport[1] = y;
+    s_viewport[2] = width;
+    s_viewport[3] = height;
+}
+
+//
+// functions loaded by GLEW
+//
+void GLAPIENTRY nullActiveTexture(GLenum texture)
+{
+    stateCall("glActiveTexture", texture);
+    s_activeTexture = texture;
+}
+
+void GLAPIENTRY nullAttachShader(GLuint program, GLuint shader)
+{
+    call("glAttachShader", program, shader);
+}
+
+void GLAPIENTRY nullBindAttribLocation(GLuint program, GLuint index, const GLchar* name)
+{
+    call("glBindAttribLocation", program, index);
+    s_attribLocations[program][name] = index;
+}
+
+void GLAPIENTRY nullBindBuffer(GLenum target, GLuint buffer)
+{
+    stateCall("glBindBuffer", target, buffer);
+    *bufferBinding(target) = buffer;
+}
+
+void GLAPIENTRY nullBindFramebuffer(GLenum target, GLuint framebuffer)
+{
+    stateCall("glBindFramebuffer", target, framebuffer);
+    s_framebuffer = framebuffer;
+}
+
+void GLAPIENTRY nullBindRenderbuffer(GLenum target, GLuint renderbuffer)
+{
+    stateCall("glBindRenderbuffer", target, renderbuffer);
+    s_renderbuffer = renderbuffer;
+}
+
+void GLAPIENTRY nullBindVertexArray(GLuint array)
+{
+    stateCall("glBindVertexArray", array);
+    s_vertexArray = array;
+}
+
+void GLAPIENTRY nullBlendEquation(GLenum mode)
+{
+    stateCall("glBlendEquation", mode);
+}
+
+void GLAPIENTRY nullBlendFuncSeparate(GLenum sfactorRGB, GLenum dfactorRGB, GLenum sfactorAlpha, GLenum dfactorAlpha)
+{
+    stateCall("glBlendFuncSeparate", sfactorRGB, dfactorRGB, sfactorAlpha, dfactorAlpha);
+}
+
+void GLAPIENTRY nullBufferData(GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage)
+{
+    call("glBufferData", target, size, data, usage);
+    auto buffer = boundBuffer(target);
+    if (buffer)
+    {
+        buffer->resize(size);
+        if (data)
+        {
+            memcpy(buffer->data(), data, size);
+        }
+    }
+    if (data)
+    {
+        s_stats.bytesUploaded += size;
+    }
+}
+
+void GLAPIENTRY nullBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data)
+{
+    call("glBufferSubData", target, offset, size, data);
+    auto buffer = boundBuffer(target);
+    if (buffer && offset + size <= (GLsizeiptr)buffer->size())
+    {
+        memcpy(buffer->data() + offset, data, size);
+    }
+    s_stats.bytesUploaded += size;
+}
+
+GLenum GLAPIENTRY nullCheckFramebufferStatus(GLenum target)
+{
+    call("glCheckFramebufferStatus", target);
+    return GL_FRAMEBUFFER_COMPLETE;
+}
+
+GLenum GLAPIENTRY nullClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout)
+{
+    call("glClientWaitSync", sync, flags);
+    return GL_ALREADY_SIGNALED;
+}
+
+void GLAPIENTRY nullCompileShader(GLuint shader)
+{
+    call("glCompileShader", shader);
+}
+
+void GLAPIENTRY nullCompressedTexImage2D(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const GLvoid *data)
+{
+    call("glCompressedTexImage2D", target, level, internalformat, width, height, border, imageSize, data);
+    s_stats.bytesUploaded += imageSize;
+}
+
+GLuint GLAPIENTRY nullCreateProgram(void)
+{
+    call("glCreateProgram");
+    return genName();
+}
+
+GLuint GLAPIENTRY nullCreateShader(GLenum type)
+{
+    call("glCreateShader", type);
+    return genName();
+}
+
+void GLAPIENTRY nullDeleteBuffers(GLsizei n, const GLuint* buffers)
+{
+    call("glDeleteBuffers", n);
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        s_buffers.erase(buffers[i]);
+        if (s_arrayBuffer == buffers[i])
+        {
+            s_arrayBuffer = 0;
+        }
+        if (s_elementArrayBuffer == buffers[i])
+        {
+            s_elementArrayBuffer = 0;
+        }
+    }
+}
+
+void GLAPIENTRY nullDeleteFramebuffers(GLsizei n, const GLuint* framebuffers)
+{
+    call("glDeleteFramebuffers", n);
+}
+
+void GLAPIENTRY nullDeleteProgram(GLuint program)
+{
+    call("glDeleteProgram", program);
+    s_uniformLocations.erase(program);
+    s_attribLocations.erase(program);
+}
+
+void GLAPIENTRY nullDeleteRenderbuffers(GLsizei n, const GLuint* renderbuffers)
+{
+    call("glDeleteRenderbuffers", n);
+}
+
+void GLAPIENTRY nullDeleteShader(GLuint shader)
+{
+    call("glDeleteShader", shader);
+}
+
+void GLAPIENTRY nullDeleteSync(GLsync sync)
+{
+    call("glDeleteSync", sync);
+}
+
+void GLAPIENTRY nullDeleteVertexArrays(GLsizei n, const GLuint* arrays)
+{
+    call("glDeleteVertexArrays", n);
+}
+
+void GLAPIENTRY nullDetachShader(GLuint program, GLuint shader)
+{
+    call("glDetachShader", program, shader);
+}
+
+void GLAPIENTRY nullDisableVertexAttribArray(GLuint index)
+{
+    stateCall("glDisableVertexAttribArray", index);
+}
+
+void GLAPIENTRY nullEnableVertexAttribArray(GLuint index)
+{
+    stateCall("glEnableVertexAttribArray", index);
+}
+
+GLsync GLAPIENTRY nullFenceSync(GLenum condition, GLbitfield flags)
+{
+    call("glFenceSync", condition, flags);
+    // never dereferenced, only compared to null
+    return (GLsync)(intptr_t)genName();
+}
+
+void GLAPIENTRY nullFramebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer)
+{
+    call("glFramebufferRenderbuffer", target, attachment, renderbuffertarget, renderbuffer);
+}
+
+void GLAPIENTRY nullFramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level)
+{
+    call("glFramebufferTexture2D", target, attachment, textarget, texture, level);
+}
+
+void GLAPIENTRY nullGenBuffers(GLsizei n, GLuint* buffers)
+{
+    call("glGenBuffers", n);
+    genNames(n, buffers);
+}
+
+void GLAPIENTRY nullGenFramebuffers(GLsizei n, GLuint* framebuffers)
+{
+    call("glGenFramebuffers", n);
+    genNames(n, framebuffers);
+}
+
+void GLAPIENTRY nullGenRenderbuffers(GLsizei n, GLuint* renderbuffers)
+{
+    call("glGenRenderbuffers", n);
+    genNames(n, renderbuffers);
+}
+
+void GLAPIENTRY nullGenVertexArrays(GLsizei n, GLuint* arrays)
+{
+    call("glGenVertexArrays", n);
+    genNames(n, arrays);
+}
+
+void GLAPIENTRY nullGenerateMipmap(GLenum target)
+{
+    call("glGenerateMipmap", target);
+}
+
+GLint GLAPIENTRY nullGetAttribLocation(GLuint program, const GLchar* name)
+{
+    call("glGetAttribLocation", program);
+    auto& locations = s_attribLocations[program];
+    auto iter = locations.find(name);
+    return iter != locations.end() ? iter->second : -1;
+}
+
+void GLAPIENTRY nullGetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+{
+    call("glGetProgramInfoLog", program);
+    if (length)
+    {
+        *length = 0;
+    }
+    if (bufSize > 0)
+    {
+        infoLog[0] = '\0';
+    }
+}
+
+void GLAPIENTRY nullGetProgramiv(GLuint program, GLenum pname, GLint* param)
+{
+    call("glGetProgramiv", program, pname);
+    *param = (pname == GL_LINK_STATUS || pname == GL_VALIDATE_STATUS) ? GL_TRUE : 0;
+}
+
+void GLAPIENTRY nullGetRenderbufferParameteriv(GLenum target, GLenum pname, GLint* params)
+{
+    call("glGetRenderbufferParameteriv", target, pname);
+    *params = 0;
+}
+
+void GLAPIENTRY nullGetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+{
+    call("glGetShaderInfoLog", shader);
+    if (length)
+    {
+        *length = 0;
+    }
+    if (bufSize > 0)
+    {
+        infoLog[0] = '\0';
+    }
+}
+
+void GLAPIENTRY nullGetShaderSource(GLuint obj, GLsizei maxLength, GLsizei* length, GLchar* source)
+{
+    call("glGetShaderSource", obj);
+    if (length)
+    {
+        *length = 0;
+    }
+    if (maxLength > 0)
+    {
+        source[0] = '\0';
+    }
+}
+
+void GLAPIENTRY nullGetShaderiv(GLuint shader, GLenum pname, GLint* param)
+{
+    call("glGetShaderiv", shader, pname);
+    *param = pname == GL_COMPILE_STATUS ? GL_TRUE : 0;
+}
+
+GLint GLAPIENTRY nullGetUniformLocation(GLuint program, const GLchar* name)
+{
+    call("glGetUniformLocation", program);
+    return location(s_uniformLocations[program], name);
+}
+
+void GLAPIENTRY nullLinkProgram(GLuint program)
+{
+    call("glLinkProgram", program);
+}
+
+GLvoid* GLAPIENTRY nullMapBuffer(GLenum target, GLenum access)
+{
+    call("glMapBuffer", target, access);
+    auto buffer = boundBuffer(target);
+    if (!buffer || buffer->empty())
+    {
+        return nullptr;
+    }
+    s_mappedOffset = 0;
+    s_mappedLength = buffer->size();
+    return buffer->data();
+}
+
+GLvoid* GLAPIENTRY nullMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)
+{
+    call("glMapBufferRange", target, offset, length, access);
+    auto buffer = boundBuffer(target);
+    if (!buffer || offset + length > (GLsizeiptr)buffer->size())
+    {
+        return nullptr;
+    }
+    s_mappedOffset = offset;
+    s_mappedLength = length;
+    return buffer->data() + offset;
+}
+
+void GLAPIENTRY nullReleaseShaderCompiler(void)
+{
+    call("glReleaseShaderCompiler");
+}
+
+void GLAPIENTRY nullRenderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height)
+{
+    call("glRenderbufferStorage", target, internalformat, width, height);
+}
+
+void GLAPIENTRY nullShaderSource(GLuint shader, GLsizei count, const GLchar* const* strings, const GLint* lengths)
+{
+    call("glShaderSource", shader, count);
+}
+
+void GLAPIENTRY nullUniform1f(GLint location, GLfloat v0)
+{
+    uniformCall("glUniform1f", location, v0);
+}
+
+void GLAPIENTRY nullUniform1fv(GLint location, GLsizei count, const GLfloat* value)
+{
+    uniformCall("glUniform1fv", location, count, value);
+}
+
+void GLAPIENTRY nullUniform1i(GLint location, GLint v0)
+{
+    uniformCall("glUniform1i", location, v0);
+}
+
+void GLAPIENTRY nullUniform1iv(GLint location, GLsizei count, const GLint* value)
+{
+    uniformCall("glUniform1iv", location, count, value);
+}
+
+void GLAPIENTRY nullUniform2f(GLint location, GLfloat v0, GLfloat v1)
+{
+    uniformCall("glUniform2f", location, v0, v1);
+}
+
+void GLAPIENTRY nullUniform2fv(GLint location, GLsizei count, const GLfloat* value)
+{
+    uniformCall("glUniform2fv", location, count, value);
+}
+
+void GLAPIENTRY nullUniform2i(GLint location, GLint v0, GLint v1)
+{
+    uniformCall("glUniform2i", location, v0, v1);
+}
+
+void GLAPIENTRY nullUniform2iv(GLint location, GLsizei count, const GLint* value)
+{
+    uniformCall("glUniform2iv", location, count, value);
+}
+
+void GLAPIENTRY nullUniform3f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2)
+{
+    uniformCall("glUniform3f", location, v0, v1, v2);
+}
+
+void GLAPIENTRY nullUniform3fv(GLint location, GLsizei count, const GLfloat* value)
+{
+    uniformCall("glUniform3fv", location, count, value);
+}
+
+void GLAPIENTRY nullUniform3i(GLint location, GLint v0, GLint v1, GLint v2)
+{
+    uniformCall("glUniform3i", location, v0, v1, v2);
+}
+
+void GLAPIENTRY nullUniform3iv(GLint location, GLsizei count, const GLint* value)
+{
+    uniformCall("glUniform3iv", location, count, value);
+}
+
+void GLAPIENTRY nullUniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3)
+{
+    uniformCall("glUniform4f", location, v0, v1, v2, v3);
+}
+
+void GLAPIENTRY nullUniform4fv(GLint location, GLsizei count, const GLfloat* value)
+{
+    uniformCall("glUniform4fv", location, count, value);
+}
+
+void GLAPIENTRY nullUniform4i(GLint location, GLint v0, GLint v1, GLint v2, GLint v3)
+{
+    uniformCall("glUniform4i", location, v0, v1, v2, v3);
+}
+
+void GLAPIENTRY nullUniform4iv(GLint location, GLsizei count, const GLint* value)
+{
+    uniformCall("glUniform4iv", location, count, value);
+}
+
+void GLAPIENTRY nullUniformMatrix2fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+{
+    uniformCall("glUniformMatrix2fv", location, count, transpose, value);
+}
+
+void GLAPIENTRY nullUniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+{
+    uniformCall("glUniformMatrix3fv", location, count, transpose, value);
+}
+
+void GLAPIENTRY nullUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+{
+    uniformCall("glUniformMatrix4fv", location, count, transpose, value);
+}
+
+GLboolean GLAPIENTRY nullUnmapBuffer(GLenum target)
+{
+    call("glUnmapBuffer", target);
+    // the data written into the mapped range is what would be sent to the GPU
+    s_stats.bytesUploaded += s_mappedLength;
+    s_mappedOffset = 0;
+    s_mappedLength = 0;
+    return GL_TRUE;
+}
+
+void GLAPIENTRY nullUseProgram(GLuint program)
+{
+    stateCall("glUseProgram", program);
+    s_program = program;
+}
+
+void GLAPIENTRY nullVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const GLvoid* pointer)
+{
+    // pointer is an offset when an array buffer is bound
+    stateCall("glVertexAttribPointer", index, size, type, normalized, stride, s_arrayBuffer ? (long long)(intptr_t)pointer : (long long)(pointer != nullptr));
+}
+
+} // namespace
+
+// the signatures of the GLEW typedefs differ a little between GLEW versions (const qualifiers)
+#define CC_GL_NULL_INSTALL(name) __glew##name = (decltype(__glew##name))null##name
+
+void GLNull::install()
+{
+    if (s_installed)
+    {
+        return;
+    }
+    s_installed = true;
+
+    g_glDispatch.alphaFunc = nullAlphaFunc;
+    g_glDispatch.bindTexture = nullBindTexture;
+    g_glDispatch.blendFunc = nullBlendFunc;
+    g_glDispatch.clear = nullClear;
+    g_glDispatch.clearColor = nullClearColor;
+    g_glDispatch.clearDepth = nullClearDepth;
+    g_glDispatch.clearStencil = nullClearStencil;
+    g_glDispatch.colorMask = nullColorMask;
+    g_glDispatch.deleteTextures = nullDeleteTextures;
+    g_glDispatch.depthFunc = nullDepthFunc;
+    g_glDispatch.depthMask = nullDepthMask;
+    g_glDispatch.disable = nullDisable;
+    g_glDispatch.drawArrays = nullDrawArrays;
+    g_glDispatch.drawElements = nullDrawElements;
+    g_glDispatch.enable = nullEnable;
+    g_glDispatch.genTextures = nullGenTextures;
+    g_glDispatch.getBooleanv = nullGetBooleanv;
+    g_glDispatch.getError = nullGetError;
+    g_glDispatch.getFloatv = nullGetFloatv;
+    g_glDispatch.getIntegerv = nullGetIntegerv;
+    g_glDispatch.getString = nullGetString;
+    g_glDispatch.hint = nullHint;
+    g_glDispatch.isEnabled = nullIsEnabled;
+    g_glDispatch.lineWidth = nullLineWidth;
+    g_glDispatch.pixelStorei = nullPixelStorei;
+    g_glDispatch.polygonOffset = nullPolygonOffset;
+    g_glDispatch.readPixels = nullReadPixels;
+    g_glDispatch.scissor = nullScissor;
+    g_glDispatch.stencilFunc = nullStencilFunc;
+    g_glDispatch.stencilMask = nullStencilMask;
+    g_glDispatch.stencilOp = nullStencilOp;
+    g_glDispatch.texImage2D = nullTexImage2D;
+    g_glDispatch.texParameteri = nullTexParameteri;
+    g_glDispatch.texSubImage2D = nullTexSubImage2D;
+    g_glDispatch.viewport = nullViewport;
+
+    CC_GL_NULL_INSTALL(ActiveTexture);
+    CC_GL_NULL_INSTALL(AttachShader);
+    CC_GL_NULL_INSTALL(BindAttribLocation);
+    CC_GL_NULL_INSTALL(BindBuffer);
+    CC_GL_NULL_INSTALL(BindFramebuffer);
+    CC_GL_NULL_INSTALL(BindRenderbuffer);
+    CC_GL_NULL_INSTALL(BindVertexArray);
+    CC_GL_NULL_INSTALL(BlendEquation);
+    CC_GL_NULL_INSTALL(BlendFuncSeparate);
+    CC_GL_NULL_INSTALL(BufferData);
+    CC_GL_NULL_INSTALL(BufferSubData);
+    CC_GL_NULL_INSTALL(CheckFramebufferStatus);
+    CC_GL_NULL_INSTALL(ClientWaitSync);
+    CC_GL_NULL_INSTALL(CompileShader);
+    CC_GL_NULL_INSTALL(CompressedTexImage2D);
+    CC_GL_NULL_INSTALL(CreateProgram);
+    CC_GL_NULL_INSTALL(CreateShader);
+    CC_GL_NULL_INSTALL(DeleteBuffers);
+    CC_GL_NULL_INSTALL(DeleteFramebuffers);
+    CC_GL_NULL_INSTALL(DeleteProgram);
+    CC_GL_NULL_INSTALL(DeleteRenderbuffers);
+    CC_GL_NULL_INSTALL(DeleteShader);
+    CC_GL_NULL_INSTALL(DeleteSync);
+    CC_GL_NULL_INSTALL(DeleteVertexArrays);
+    CC_GL_NULL_INSTALL(DetachShader);
+    CC_GL_NULL_INSTALL(DisableVertexAttribArray);
+    CC_GL_NULL_INSTALL(EnableVertexAttribArray);
+    CC_GL_NULL_INSTALL(FenceSync);
+    CC_GL_NULL_INSTALL(FramebufferRenderbuffer);
+    CC_GL_NULL_INSTALL(FramebufferTexture2D);
+    CC_GL_NULL_INSTALL(GenBuffers);
+    CC_GL_NULL_INSTALL(GenFramebuffers);
+    CC_GL_NULL_INSTALL(GenRenderbuffers);
+    CC_GL_NULL_INSTALL(GenVertexArrays);
+    CC_GL_NULL_INSTALL(GenerateMipmap);
+    CC_GL_NULL_INSTALL(GetAttribLocation);
+    CC_GL_NULL_INSTALL(GetProgramInfoLog);
+    CC_GL_NULL_INSTALL(GetProgramiv);
+    CC_GL_NULL_INSTALL(GetRenderbufferParameteriv);
+    CC_GL_NULL_INSTALL(GetShaderInfoLog);
+    CC_GL_NULL_INSTALL(GetShaderSource);
+    CC_GL_NULL_INSTALL(GetShaderiv);
+    CC_GL_NULL_INSTALL(GetUniformLocation);
+    CC_GL_NULL_INSTALL(LinkProgram);
+    CC_GL_NULL_INSTALL(MapBuffer);
+    CC_GL_NULL_INSTALL(MapBufferRange);
+    CC_GL_NULL_INSTALL(ReleaseShaderCompiler);
+    CC_GL_NULL_INSTALL(RenderbufferStorage);
+    CC_GL_NULL_INSTALL(ShaderSource);
+    CC_GL_NULL_INSTALL(Uniform1f);
+    CC_GL_NULL_INSTALL(Uniform1fv);
+    CC_GL_NULL_INSTALL(Uniform1i);
+    CC_GL_NULL_INSTALL(Uniform1iv);
+    CC_GL_NULL_INSTALL(Uniform2f);
+    CC_GL_NULL_INSTALL(Uniform2fv);
+    CC_GL_NULL_INSTALL(Uniform2i);
+    CC_GL_NULL_INSTALL(Uniform2iv);
+    CC_GL_NULL_INSTALL(Uniform3f);
+    CC_GL_NULL_INSTALL(Uniform3fv);
+    CC_GL_NULL_INSTALL(Uniform3i);
+    CC_GL_NULL_INSTALL(Uniform3iv);
+    CC_GL_NULL_INSTALL(Uniform4f);
+    CC_GL_NULL_INSTALL(Uniform4fv);
+    CC_GL_NULL_INSTALL(Uniform4i);
+    CC_GL_NULL_INSTALL(Uniform4iv);
+    CC_GL_NULL_INSTALL(UniformMatrix2fv);
+    CC_GL_NULL_INSTALL(UniformMatrix3fv);
+    CC_GL_NULL_INSTALL(UniformMatrix4fv);
+    CC_GL_NULL_INSTALL(UnmapBuffer);
+    CC_GL_NULL_INSTALL(UseProgram);
+    CC_GL_NULL_INSTALL(VertexAttribPointer);
+}
+
+#undef CC_GL_NULL_INSTALL
+
+bool GLNull::isInstalled()
+{
+    return s_installed;
+}
+
+bool GLNull::setTraceFile(const std::string& path)
+{
+    if (s_trace)
+    {
+        fclose(s_trace);
+        s_trace = nullptr;
+    }
+
+    if (path.empty())
+    {
+        return true;
+    }
+
+    s_trace = fopen(path.c_str(), "w");
+    if (!s_trace)
+    {
+        CCLOG("GLNull: can't open the trace file %s", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+const GLNull::Stats& GLNull::getStats()
+{
+    return s_stats;
+}
+
+void GLNull::resetStats()
+{
+    memset(&s_stats, 0, sizeof(s_stats));
+}
+
+NS_CC_END
+
+#endif // CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
@@ -0,0 +1,163 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_GL_NULL_H__
+#define __CC_GL_NULL_H__
+
+#include "CCPlatformConfig.h"
+#if CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
+
+#include "CCPlatformMacros.h"
+#include "GL/glew.h"
+#include <string>
+
+NS_CC_BEGIN
+
+/** GPU-free backend for the GL calls of the engine, selected at startup.
+
+ Builds with CC_ENABLE_NULL_GL call the GL 1.1 functions through `g_glDispatch`, GLEW already
+ loads the other ones. `GLNull::install()` replaces all of them with functions that don't need a
+ GL context: they keep the state the engine reads back (object names, bindings, viewport, enabled
+ capabilities, buffer contents), count the work that would be sent to the GPU and can record every
+ call into a trace file.
+ The whole `Director::drawScene()` pipeline runs unchanged, see `GLView::createHeadless()`.
+ */
+class CC_DLL GLNull
+{
+public:
+    struct Stats
+    {
+        /** every GL call */
+        unsigned int calls;
+        /** glDrawArrays() and glDrawElements() */
+        unsigned int drawCalls;
+        /** vertices (or indices) sent by the draw calls */
+        unsigned int vertices;
+        /** bindings, blending, depth, stencil, enabled capabilities, programs and vertex attributes */
+        unsigned int stateChanges;
+        /** glUniform*() calls */
+        unsigned int uniforms;
+        /** buffer and texture data sent to the GPU, mapped ranges included */
+        size_t bytesUploaded;
+    };
+
+    /** Replaces the GL functions with the null backend. Must be called before the first GL call and can't be undone */
+    static void install();
+    /** Whether or not the null backend replaces the GL functions */
+    static bool isInstalled();
+
+    /** Records the GL calls into a text file, one call and its arguments per line.
+     Pointers are recorded as 0 or 1 so that two runs of the same frames give the same trace.
+     An empty path stops recording.
+     */
+    static bool setTraceFile(const std::string& path);
+
+    /** Counters since the last resetStats() */
+    static const Stats& getStats();
+    static void resetStats();
+};
+
+/** GL 1.1 functions, which GLEW doesn't load. The macros below route the calls of the engine through them */
+struct CC_DLL GLDispatch
+{
+    void (GLAPIENTRY *alphaFunc)(GLenum func, GLclampf ref);
+    void (GLAPIENTRY *bindTexture)(GLenum target, GLuint texture);
+    void (GLAPIENTRY *blendFunc)(GLenum sfactor, GLenum dfactor);
+    void (GLAPIENTRY *clear)(GLbitfield mask);
+    void (GLAPIENTRY *clearColor)(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha);
+    void (GLAPIENTRY *clearDepth)(GLclampd depth);
+    void (GLAPIENTRY *clearStencil)(GLint s);
+    void (GLAPIENTRY *colorMask)(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha);
+    void (GLAPIENTRY *deleteTextures)(GLsizei n, const GLuint *textures);
+    void (GLAPIENTRY *depthFunc)(GLenum func);
+    void (GLAPIENTRY *depthMask)(GLboolean flag);
+    void (GLAPIENTRY *disable)(GLenum cap);
+    void (GLAPIENTRY *drawArrays)(GLenum mode, GLint first, GLsizei count);
+    void (GLAPIENTRY *drawElements)(GLenum mode, GLsizei count, GLenum type, const GLvoid *indices);
+    void (GLAPIENTRY *enable)(GLenum cap);
+    void (GLAPIENTRY *genTextures)(GLsizei n, GLuint *textures);
+    void (GLAPIENTRY *getBooleanv)(GLenum pname, GLboolean *params);
+    GLenum (GLAPIENTRY *getError)(void);
+    void (GLAPIENTRY *getFloatv)(GLenum pname, GLfloat *params);
+    void (GLAPIENTRY *getIntegerv)(GLenum pname, GLint *params);
+    const GLubyte* (GLAPIENTRY *getString)(GLenum name);
+    void (GLAPIENTRY *hint)(GLenum target, GLenum mode);
+    GLboolean (GLAPIENTRY *isEnabled)(GLenum cap);
+    void (GLAPIENTRY *lineWidth)(GLfloat width);
+    void (GLAPIENTRY *pixelStorei)(GLenum pname, GLint param);
+    void (GLAPIENTRY *polygonOffset)(GLfloat factor, GLfloat units);
+    void (GLAPIENTRY *readPixels)(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, GLvoid *pixels);
+    void (GLAPIENTRY *scissor)(GLint x, GLint y, GLsizei width, GLsizei height);
+    void (GLAPIENTRY *stencilFunc)(GLenum func, GLint ref, GLuint mask);
+    void (GLAPIENTRY *stencilMask)(GLuint mask);
+    void (GLAPIENTRY *stencilOp)(GLenum fail, GLenum zfail, GLenum zpass);
+    void (GLAPIENTRY *texImage2D)(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const GLvoid *pixels);
+    void (GLAPIENTRY *texParameteri)(GLenum target, GLenum pname, GLint param);
+    void (GLAPIENTRY *texSubImage2D)(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const GLvoid *pixels);
+    void (GLAPIENTRY *viewport)(GLint x, GLint y, GLsizei width, GLsizei height);
+};
+
+extern CC_DLL GLDispatch g_glDispatch;
+
+NS_CC_END
+
+#define glAlphaFunc(...) cocos2d::g_glDispatch.alphaFunc(__VA_ARGS__)
+#define glBindTexture(...) cocos2d::g_glDispatch.bindTexture(__VA_ARGS__)
+#define glBlendFunc(...) cocos2d::g_glDispatch.blendFunc(__VA_ARGS__)
+#define glClear(...) cocos2d::g_glDispatch.clear(__VA_ARGS__)
+#define glClearColor(...) cocos2d::g_glDispatch.clearColor(__VA_ARGS__)
+#define glClearDepth(...) cocos2d::g_glDispatch.clearDepth(__VA_ARGS__)
+#define glClearStencil(...) cocos2d::g_glDispatch.clearStencil(__VA_ARGS__)
+#define glColorMask(...) cocos2d::g_glDispatch.colorMask(__VA_ARGS__)
+#define glDeleteTextures(...) cocos2d::g_glDispatch.deleteTextures(__VA_ARGS__)
+#define glDepthFunc(...) cocos2d::g_glDispatch.depthFunc(__VA_ARGS__)
+#define glDepthMask(...) cocos2d::g_glDispatch.depthMask(__VA_ARGS__)
+#define glDisable(...) cocos2d::g_glDispatch.disable(__VA_ARGS__)
+#define glDrawArrays(...) cocos2d::g_glDispatch.drawArrays(__VA_ARGS__)
+#define glDrawElements(...) cocos2d::g_glDispatch.drawElements(__VA_ARGS__)
+#define glEnable(...) cocos2d::g_glDispatch.enable(__VA_ARGS__)
+#define glGenTextures(...) cocos2d::g_glDispatch.genTextures(__VA_ARGS__)
+#define glGetBooleanv(...) cocos2d::g_glDispatch.getBooleanv(__VA_ARGS__)
+#define glGetError() cocos2d::g_glDispatch.getError()
+#define glGetFloatv(...) cocos2d::g_glDispatch.getFloatv(__VA_ARGS__)
+#define glGetIntegerv(...) cocos2d::g_glDispatch.getIntegerv(__VA_ARGS__)
+#define glGetString(...) cocos2d::g_glDispatch.getString(__VA_ARGS__)
+#define glHint(...) cocos2d::g_glDispatch.hint(__VA_ARGS__)
+#define glIsEnabled(...) cocos2d::g_glDispatch.isEnabled(__VA_ARGS__)
+#define glLineWidth(...) cocos2d::g_glDispatch.lineWidth(__VA_ARGS__)
+#define glPixelStorei(...) cocos2d::g_glDispatch.pixelStorei(__VA_ARGS__)
+#define glPolygonOffset(...) cocos2d::g_glDispatch.polygonOffset(__VA_ARGS__)
+#define glReadPixels(...) cocos2d::g_glDispatch.readPixels(__VA_ARGS__)
+#define glScissor(...) cocos2d::g_glDispatch.scissor(__VA_ARGS__)
+#define glStencilFunc(...) cocos2d::g_glDispatch.stencilFunc(__VA_ARGS__)
+#define glStencilMask(...) cocos2d::g_glDispatch.stencilMask(__VA_ARGS__)
+#define glStencilOp(...) cocos2d::g_glDispatch.stencilOp(__VA_ARGS__)
+#define glTexImage2D(...) cocos2d::g_glDispatch.texImage2D(__VA_ARGS__)
+#define glTexParameteri(...) cocos2d::g_glDispatch.texParameteri(__VA_ARGS__)
+#define glTexSubImage2D(...) cocos2d::g_glDispatch.texSubImage2D(__VA_ARGS__)
+#define glViewport(...) cocos2d::g_glDispatch.viewport(__VA_ARGS__)
+
+#endif // CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
+
+#endif // __CC_GL_NULL_H__
@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include "CCApplication.h"
 #include "CCWinRTUtils.h"
 #include "CCNotificationCenter.h"
+#include "ccGLStateCache.h"
 
 using namespace Platform;
 using namespace Windows::Foundation;
@@ -498,17 +499,17 @@ void GLView::setScissorInPoints(float x , float y , float w , float h)
 	{
 		case DisplayOrientations::Landscape:
 		case DisplayOrientations::LandscapeFlipped:
-            glScissor((GLint)(y * _scaleX + _viewPortRect.origin.y),
-                       (GLint)((_viewPortRect.size.width - ((x + w) * _scaleX)) + _viewPortRect.origin.x),
-                       (GLsizei)(h * _scaleY),
-                       (GLsizei)(w * _scaleX));
+            GL::scissor((GLint)(y * _scaleX + _viewPortRect.origin.y),
+                        (GLint)((_viewPortRect.size.width - ((x + w) * _scaleX)) + _viewPortRect.origin.x),
+                        (GLsizei)(h * _scaleY),
+                        (GLsizei)(w * _scaleX));
 			break;
 
         default:
-            glScissor((GLint)(x * _scaleX + _viewPortRect.origin.x),
-                       (GLint)(y * _scaleY + _viewPortRect.origin.y),
-                       (GLsizei)(w * _scaleX),
-                       (GLsizei)(h * _scaleY));
+            GL::scissor((GLint)(x * _scaleX + _viewPortRect.origin.x),
+                        (GLint)(y * _scaleY + _viewPortRect.origin.y),
+                        (GLsizei)(w * _scaleX),
+                        (GLsizei)(h * _scaleY));
 	}
 }
 
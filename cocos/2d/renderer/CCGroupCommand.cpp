@@ -54,6 +54,8 @@ int GroupCommandManager::getGroupID()
         if(!it->second)
         {
             _groupMapping[it->first] = true;
+            // The previous owner might have changed how the queue is sorted
+            Director::getInstance()->getRenderer()->setRenderQueueSortMode(it->first, RenderQueue::SortMode::GLOBAL_ORDER);
             return it->first;
         }
     }
@@ -42,12 +42,21 @@ QuadCommand::QuadCommand()
 ,_blendType(BlendFunc::DISABLE)
 ,_quads(nullptr)
 ,_quadsCount(0)
+,_uniformCount(0)
 {
     _type = RenderCommand::Type::QUAD_COMMAND;
 }
 
 void QuadCommand::init(float globalOrder, GLuint textureID, GLProgram* shader, BlendFunc blendType, V3F_C4B_T2F_Quad* quad, ssize_t quadCount, const kmMat4 &mv)
 {
+    init(globalOrder, textureID, shader, blendType, quad, quadCount, mv, nullptr, nullptr, 0);
+}
+
+void QuadCommand::init(float globalOrder, GLuint textureID, GLProgram* shader, BlendFunc blendType, V3F_C4B_T2F_Quad* quad, ssize_t quadCount, const kmMat4 &mv,
+                       const GLint* uniformLocations, const Color4F* uniformValues, int uniformCount)
+{
+    CCASSERT(uniformCount >= 0 && uniformCount <= MAX_MATERIAL_UNIFORMS, "Too many uniforms in the material");
+
     _globalOrder = globalOrder;
 
     _quadsCount = quadCount;
@@ -55,11 +64,24 @@ void QuadCommand::init(float globalOrder, GLuint textureID, GLProgram* shader, B
 
     _mv = mv;
 
-    if( _textureID != textureID || _blendType.src != blendType.src || _blendType.dst != blendType.dst || _shader != shader) {
+    bool uniformsChanged = (_uniformCount != uniformCount);
+    for (int i = 0; i < uniformCount && !uniformsChanged; ++i)
+    {
+        uniformsChanged = _uniformLocations[i] != uniformLocations[i] || _uniformValues[i] != uniformValues[i];
+    }
+
+    if( _textureID != textureID || _blendType.src != blendType.src || _blendType.dst != blendType.dst || _shader != shader || uniformsChanged) {
         
         _textureID = textureID;
         _blendType = blendType;
         _shader = shader;
+
+        _uniformCount = uniformCount;
+        for (int i = 0; i < uniformCount; ++i)
+        {
+            _uniformLocations[i] = uniformLocations[i];
+            _uniformValues[i] = uniformValues[i];
+        }
         
         generateMaterialID();
     }
@@ -101,6 +123,19 @@ void QuadCommand::generateMaterialID()
     convertIntToByteArray(_textureID, intArray+2);
     
     _materialID = XXH32((const void*)intArray, sizeof(intArray), 0);
+
+    // the uniform values are chained to the hash, the sort key doesn't need them
+    if (_uniformCount > 0)
+    {
+        _materialID = XXH32((const void*)_uniformLocations, sizeof(GLint) * _uniformCount, _materialID);
+        _materialID = XXH32((const void*)_uniformValues, sizeof(Color4F) * _uniformCount, _materialID);
+    }
+
+    // sort key: translucency, program, texture and blend, from the most to the least significant bits
+    _materialKey = ((isTranslucent() ? 1u : 0u) << 31)
+                 | ((_shader->getProgram() & 0x7FF) << 20)
+                 | ((_textureID & 0xFFFF) << 4)
+                 | (blendID & 0xF);
 }
 
 void QuadCommand::useMaterial() const
@@ -108,6 +143,11 @@ void QuadCommand::useMaterial() const
     _shader->use();
     _shader->setUniformsForBuiltins(_mv);
 
+    for (int i = 0; i < _uniformCount; ++i)
+    {
+        _shader->setUniformLocationWith4f(_uniformLocations[i], _uniformValues[i].r, _uniformValues[i].g, _uniformValues[i].b, _uniformValues[i].a);
+    }
+
     //Set texture
     GL::bindTexture2D(_textureID);
 
@@ -38,6 +38,8 @@ NS_CC_BEGIN
 class QuadCommand : public RenderCommand
 {
 public:
+    /** Maximum number of uniforms that can be part of the material */
+    static const int MAX_MATERIAL_UNIFORMS = 2;
 
     QuadCommand();
     ~QuadCommand();
@@ -47,6 +49,11 @@ public:
     void init(float globalOrder, GLuint texutreID, GLProgram* shader, BlendFunc blendType, V3F_C4B_T2F_Quad* quads, ssize_t quadCount,
               const kmMat4& mv);
 
+    /** Same as init(), with vec4 uniforms that are set when the material is used, like the text color of a Label.
+     * The uniform values are part of the material: only the commands using the same values are batched together */
+    void init(float globalOrder, GLuint texutreID, GLProgram* shader, BlendFunc blendType, V3F_C4B_T2F_Quad* quads, ssize_t quadCount,
+              const kmMat4& mv, const GLint* uniformLocations, const Color4F* uniformValues, int uniformCount);
+
     void useMaterial() const;
 
     //TODO use material to decide if it is translucent
@@ -82,6 +89,10 @@ protected:
     ssize_t _quadsCount;
 
     kmMat4 _mv;
+
+    GLint _uniformLocations[MAX_MATERIAL_UNIFORMS];
+    Color4F _uniformValues[MAX_MATERIAL_UNIFORMS];
+    int _uniformCount;
 };
 NS_CC_END
 
@@ -0,0 +1,195 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "renderer/CCQuadTransform.h"
+
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CC_QUAD_TRANSFORM_SSE2 1
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define CC_QUAD_TRANSFORM_NEON 1
+#endif
+
+NS_CC_BEGIN
+
+// number of vertices in a V3F_C4B_T2F_Quad
+static const int QUAD_VERTICES = 4;
+
+TransformKind getTransformKind(const kmMat4& modelView)
+{
+    const float* m = modelView.mat;
+
+    // column major: the translation lives in m[12], m[13] and m[14]
+    if (m[0] != 1 || m[1] != 0 || m[2] != 0 || m[3] != 0 ||
+        m[4] != 0 || m[5] != 1 || m[6] != 0 || m[7] != 0 ||
+        m[8] != 0 || m[9] != 0 || m[10] != 1 || m[11] != 0 ||
+        m[15] != 1)
+    {
+        return TransformKind::GENERIC;
+    }
+
+    if (m[12] == 0 && m[13] == 0 && m[14] == 0)
+    {
+        return TransformKind::IDENTITY;
+    }
+
+    return TransformKind::TRANSLATION;
+}
+
+static void translateQuads(const V3F_C4B_T2F_Quad* in, V3F_C4B_T2F_Quad* out, ssize_t quantity, const kmMat4& modelView)
+{
+    const float tx = modelView.mat[12];
+    const float ty = modelView.mat[13];
+    const float tz = modelView.mat[14];
+
+    const V3F_C4B_T2F* src = &in[0].tl;
+    V3F_C4B_T2F* dst = &out[0].tl;
+    const ssize_t count = quantity * QUAD_VERTICES;
+
+    for (ssize_t i = 0; i < count; ++i)
+    {
+        dst[i].vertices.x = src[i].vertices.x + tx;
+        dst[i].vertices.y = src[i].vertices.y + ty;
+        dst[i].vertices.z = src[i].vertices.z + tz;
+        dst[i].colors = src[i].colors;
+        dst[i].texCoords = src[i].texCoords;
+    }
+}
+
+void transformQuadsScalar(const V3F_C4B_T2F_Quad* in, V3F_C4B_T2F_Quad* out, ssize_t quantity, const kmMat4& modelView)
+{
+    const float* m = modelView.mat;
+
+    const V3F_C4B_T2F* src = &in[0].tl;
+    V3F_C4B_T2F* dst = &out[0].tl;
+    const ssize_t count = quantity * QUAD_VERTICES;
+
+    for (ssize_t i = 0; i < count; ++i)
+    {
+        const Vertex3F& v = src[i].vertices;
+        dst[i].vertices.x = m[0] * v.x + m[4] * v.y + m[8] * v.z + m[12];
+        dst[i].vertices.y = m[1] * v.x + m[5] * v.y + m[9] * v.z + m[13];
+        dst[i].vertices.z = m[2] * v.x + m[6] * v.y + m[10] * v.z + m[14];
+        dst[i].colors = src[i].colors;
+        dst[i].texCoords = src[i].texCoords;
+    }
+}
+
+#if CC_QUAD_TRANSFORM_SSE2
+
+static void transformQuadsSIMD(const V3F_C4B_T2F_Quad* in, V3F_C4B_T2F_Quad* out, ssize_t quantity, const kmMat4& modelView)
+{
+    // kmMat4 is not guaranteed to be 16 bytes aligned
+    const __m128 c0 = _mm_loadu_ps(&modelView.mat[0]);
+    const __m128 c1 = _mm_loadu_ps(&modelView.mat[4]);
+    const __m128 c2 = _mm_loadu_ps(&modelView.mat[8]);
+    const __m128 c3 = _mm_loadu_ps(&modelView.mat[12]);
+
+    const V3F_C4B_T2F* src = &in[0].tl;
+    V3F_C4B_T2F* dst = &out[0].tl;
+    const ssize_t count = quantity * QUAD_VERTICES;
+
+    for (ssize_t i = 0; i < count; ++i)
+    {
+        const Vertex3F& v = src[i].vertices;
+        __m128 r = _mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(v.x)), c3);
+        r = _mm_add_ps(_mm_mul_ps(c1, _mm_set1_ps(v.y)), r);
+        r = _mm_add_ps(_mm_mul_ps(c2, _mm_set1_ps(v.z)), r);
+
+        // the vertex is only 12 bytes: store x,y and then z
+        _mm_storel_pi((__m64*)&dst[i].vertices.x, r);
+        _mm_store_ss(&dst[i].vertices.z, _mm_movehl_ps(r, r));
+
+        // colors and tex coords are copied as a 12 bytes block
+        memcpy(&dst[i].colors, &src[i].colors, sizeof(V3F_C4B_T2F) - sizeof(Vertex3F));
+    }
+}
+
+#elif CC_QUAD_TRANSFORM_NEON
+
+static void transformQuadsSIMD(const V3F_C4B_T2F_Quad* in, V3F_C4B_T2F_Quad* out, ssize_t quantity, const kmMat4& modelView)
+{
+    const float32x4_t c0 = vld1q_f32(&modelView.mat[0]);
+    const float32x4_t c1 = vld1q_f32(&modelView.mat[4]);
+    const float32x4_t c2 = vld1q_f32(&modelView.mat[8]);
+    const float32x4_t c3 = vld1q_f32(&modelView.mat[12]);
+
+    const V3F_C4B_T2F* src = &in[0].tl;
+    V3F_C4B_T2F* dst = &out[0].tl;
+    const ssize_t count = quantity * QUAD_VERTICES;
+
+    for (ssize_t i = 0; i < count; ++i)
+    {
+        const Vertex3F& v = src[i].vertices;
+        float32x4_t r = vmlaq_n_f32(c3, c0, v.x);
+        r = vmlaq_n_f32(r, c1, v.y);
+        r = vmlaq_n_f32(r, c2, v.z);
+
+        // the vertex is only 12 bytes: store x,y and then z
+        vst1_f32(&dst[i].vertices.x, vget_low_f32(r));
+        vst1q_lane_f32(&dst[i].vertices.z, r, 2);
+
+        // colors and tex coords are copied as a 12 bytes block
+        memcpy(&dst[i].colors, &src[i].colors, sizeof(V3F_C4B_T2F) - sizeof(Vertex3F));
+    }
+}
+
+#endif
+
+void transformQuads(const V3F_C4B_T2F_Quad* in, V3F_C4B_T2F_Quad* out, ssize_t quantity, const kmMat4& modelView)
+{
+    switch (getTransformKind(modelView))
+    {
+        case TransformKind::IDENTITY:
+            memcpy(out, in, sizeof(V3F_C4B_T2F_Quad) * quantity);
+            break;
+        case TransformKind::TRANSLATION:
+            translateQuads(in, out, quantity, modelView);
+            break;
+        default:
+#if CC_QUAD_TRANSFORM_SSE2 || CC_QUAD_TRANSFORM_NEON
+            transformQuadsSIMD(in, out, quantity, modelView);
+#else
+            transformQuadsScalar(in, out, quantity, modelView);
+#endif
+            break;
+    }
+}
+
+const char* getQuadTransformBackendName()
+{
+#if CC_QUAD_TRANSFORM_SSE2
+    return "SSE2";
+#elif CC_QUAD_TRANSFORM_NEON
+    return "NEON";
+#else
+    return "scalar";
+#endif
+}
+
+NS_CC_END
@@ -0,0 +1,61 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __CC_QUADTRANSFORM_H_
+#define __CC_QUADTRANSFORM_H_
+
+#include "CCPlatformMacros.h"
+#include "ccTypes.h"
+#include "kazmath/kazmath.h"
+
+NS_CC_BEGIN
+
+/** Kind of transformation a model view matrix performs. Used to skip work when transforming vertices. */
+enum class TransformKind
+{
+    IDENTITY,
+    TRANSLATION,
+    GENERIC,
+};
+
+/** returns the kind of transformation that `modelView` performs */
+TransformKind CC_DLL getTransformKind(const kmMat4& modelView);
+
+/** Transforms `quantity` quads from `in` into `out`, copying colors and texture coordinates.
+ It uses SSE2 or NEON when they are available at compile time, and it skips the matrix
+ multiplication when `modelView` is the identity or a translation.
+ `out` is only written to, so it can point to mapped GPU memory.
+ */
+void CC_DLL transformQuads(const V3F_C4B_T2F_Quad* in, V3F_C4B_T2F_Quad* out, ssize_t quantity, const kmMat4& modelView);
+
+/** Same as `transformQuads` but always uses the scalar, full matrix path. Useful as a reference. */
+void CC_DLL transformQuadsScalar(const V3F_C4B_T2F_Quad* in, V3F_C4B_T2F_Quad* out, ssize_t quantity, const kmMat4& modelView);
+
+/** returns the name of the vector instruction set used by `transformQuads` */
+const char* CC_DLL getQuadTransformBackendName();
+
+NS_CC_END
+
+#endif //__CC_QUADTRANSFORM_H_
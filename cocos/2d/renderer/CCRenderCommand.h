@@ -56,6 +56,21 @@ public:
     /** Returns the Command type */
     inline Type getType() const { return _type; }
 
+    /** Returns the material part of the sort key. Commands with the same material key can be batched together */
+    inline uint32_t getMaterialKey() const { return _materialKey; }
+
+    /** Returns a 64-bit key that sorts by global order first and by material key next.
+     Only used by render queues that sort by material.
+     */
+    inline uint64_t getSortKey() const
+    {
+        // map the float bits into an unsigned integer that keeps the order of the floats
+        union { float f; uint32_t u; } order;
+        order.f = _globalOrder;
+        uint32_t depth = (order.u & 0x80000000) ? ~order.u : (order.u | 0x80000000);
+        return ((uint64_t)depth << 32) | _materialKey;
+    }
+
 protected:
     RenderCommand();
     virtual ~RenderCommand();
@@ -67,6 +82,9 @@ protected:
 
     // commands are sort by depth
     float _globalOrder;
+
+    // translucency, shader, texture and blend bits. 0 for commands that can't be batched
+    uint32_t _materialKey;
 };
 
 NS_CC_END
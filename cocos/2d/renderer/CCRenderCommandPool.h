@@ -26,73 +26,197 @@
 #ifndef __CC_RENDERCOMMANDPOOL_H__
 #define __CC_RENDERCOMMANDPOOL_H__
 
-#include <set>
-#include <list>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <stdint.h>
+#include <type_traits>
 #include "CCPlatformMacros.h"
+#include "ccMacros.h"
 NS_CC_BEGIN
 
-template <class T>
+/** Recycles render commands without allocating memory once it has grown to the peak usage.
+
+ Commands live in blocks that are never freed before the pool itself, each block twice as big as
+ the previous one. The free commands are chained through their slot (an intrusive free list), so
+ generateCommand() and pushBackCommand() only move a list head.
+
+ With THREAD_SAFE set, the free list is a lock-free stack: commands can be generated and pushed back
+ from any thread. The head holds a generation tag next to the slot index so that a slot popped and
+ pushed back by another thread in the meantime can't corrupt it (ABA problem). Only the allocation
+ of a new block takes a lock.
+ */
+template <class T, bool THREAD_SAFE = false>
 class RenderCommandPool
 {
 public:
     RenderCommandPool()
+    : _head(NIL)
+    , _blockCount(0)
+    , _capacity(0)
+    , _blockAllocations(0)
     {
+        for (int i = 0; i < MAX_BLOCKS; ++i)
+        {
+            _blocks[i] = nullptr;
+        }
     }
+
     ~RenderCommandPool()
     {
-//        if( 0 != _usedPool.size())
-//        {
-//            CCLOG("All RenderCommand should not be used when Pool is released!");
-//        }
-        _freePool.clear();
-        for (typename std::list<T*>::iterator iter = _allocatedPoolBlocks.begin(); iter != _allocatedPoolBlocks.end(); ++iter)
+        for (int i = 0; i < _blockCount; ++i)
         {
-            delete[] *iter;
-            *iter = nullptr;
+            Slot* block = _blocks[i].load();
+            uint32_t size = FIRST_BLOCK_SIZE << i;
+            for (uint32_t j = 0; j < size; ++j)
+            {
+                block[j].getCommand()->~T();
+            }
+            delete[] block;
         }
-        _allocatedPoolBlocks.clear();
     }
 
     T* generateCommand()
     {
-        T* result = nullptr;
-        if(_freePool.empty())
+        Slot* slot = pop();
+        while (slot == nullptr)
         {
-            AllocateCommands();
+            allocateBlock();
+            slot = pop();
         }
-        result = _freePool.front();
-        _freePool.pop_front();
-        //_usedPool.insert(result);
-        return result;
+        return slot->getCommand();
     }
-    
+
     void pushBackCommand(T* ptr)
     {
-//        if(_usedPool.find(ptr) == _usedPool.end())
-//        {
-//            CCLOG("push Back Wrong command!");
-//            return;
-//        }
-        
-        _freePool.push_back(ptr);
-        //_usedPool.erase(ptr);
-        
+        // the command lives in the storage of a standard-layout Slot
+        static_assert(std::is_standard_layout<Slot>::value, "offsetof() needs a standard-layout Slot");
+        Slot* slot = reinterpret_cast<Slot*>(reinterpret_cast<char*>(ptr) - offsetof(Slot, storage));
+        push(slot, slot);
     }
+
+    /** number of commands allocated, in use or free */
+    inline uint32_t getCapacity() const { return _capacity; }
+
+    /** number of blocks allocated since the pool was created. It stops growing once the pool reached the peak usage */
+    inline uint32_t getBlockAllocations() const { return _blockAllocations; }
+
 private:
-    void AllocateCommands()
+    // T is not standard-layout (commands have virtual functions), so it is constructed in raw storage:
+    // Slot stays standard-layout and offsetof() gives the way back from a command to its slot
+    struct Slot
+    {
+        typename std::aligned_storage<sizeof(T), std::alignment_of<T>::value>::type storage;
+        uint32_t index;
+        std::atomic<uint32_t> next;
+
+        inline T* getCommand() { return reinterpret_cast<T*>(&storage); }
+    };
+
+    static const uint32_t NIL = 0xFFFFFFFF;
+    static const uint32_t FIRST_BLOCK_SIZE = 32;
+    // block b holds FIRST_BLOCK_SIZE << b slots, 27 blocks address every 32 bits index
+    static const int MAX_BLOCKS = 27;
+
+    static uint64_t makeHead(uint64_t previousHead, uint32_t index)
+    {
+        return (((previousHead >> 32) + 1) << 32) | index;
+    }
+
+    Slot* getSlot(uint32_t index) const
+    {
+        // block b starts at index FIRST_BLOCK_SIZE * (2^b - 1)
+        uint32_t v = index / FIRST_BLOCK_SIZE + 1;
+        int block = 0;
+        while (v >>= 1)
+        {
+            ++block;
+        }
+        uint32_t offset = index - FIRST_BLOCK_SIZE * ((1u << block) - 1);
+        return _blocks[block].load(std::memory_order_acquire) + offset;
+    }
+
+    Slot* pop()
+    {
+        uint64_t head = _head.load(std::memory_order_acquire);
+        while (true)
+        {
+            uint32_t index = (uint32_t)head;
+            if (index == NIL)
+            {
+                return nullptr;
+            }
+
+            Slot* slot = getSlot(index);
+            uint32_t next = slot->next.load(std::memory_order_relaxed);
+            if (!THREAD_SAFE)
+            {
+                _head.store(makeHead(head, next), std::memory_order_relaxed);
+                return slot;
+            }
+            // if another thread popped the slot in the meantime, the tag changed and this fails
+            if (_head.compare_exchange_weak(head, makeHead(head, next), std::memory_order_acquire, std::memory_order_acquire))
+            {
+                return slot;
+            }
+        }
+    }
+
+    // pushes the chain of slots first -> ... -> last
+    void push(Slot* first, Slot* last)
     {
-        static const int COMMANDS_ALLOCATE_BLOCK_SIZE = 32;
-        T* commands = new T[COMMANDS_ALLOCATE_BLOCK_SIZE];
-        _allocatedPoolBlocks.push_back(commands);
-        for(int index = 0; index < COMMANDS_ALLOCATE_BLOCK_SIZE; ++index)
+        uint64_t head = _head.load(std::memory_order_relaxed);
+        if (!THREAD_SAFE)
         {
-            _freePool.push_back(commands+index);
+            last->next.store((uint32_t)head, std::memory_order_relaxed);
+            _head.store(makeHead(head, first->index), std::memory_order_relaxed);
+            return;
         }
+        do
+        {
+            last->next.store((uint32_t)head, std::memory_order_relaxed);
+        } while (!_head.compare_exchange_weak(head, makeHead(head, first->index), std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    void allocateBlock()
+    {
+        std::unique_lock<std::mutex> lock(_allocationMutex, std::defer_lock);
+        if (THREAD_SAFE)
+        {
+            lock.lock();
+            // another thread may have refilled the free list while we were waiting
+            if ((uint32_t)_head.load(std::memory_order_acquire) != NIL)
+            {
+                return;
+            }
+        }
+
+        CCASSERT(_blockCount < MAX_BLOCKS, "RenderCommandPool is full");
+
+        uint32_t size = FIRST_BLOCK_SIZE << _blockCount;
+        uint32_t firstIndex = _capacity;
+        Slot* block = new Slot[size];
+        for (uint32_t i = 0; i < size; ++i)
+        {
+            new (&block[i].storage) T();
+            block[i].index = firstIndex + i;
+            block[i].next.store(firstIndex + i + 1, std::memory_order_relaxed);
+        }
+        _blocks[_blockCount].store(block, std::memory_order_release);
+        ++_blockCount;
+        _capacity += size;
+        ++_blockAllocations;
+
+        push(block, block + size - 1);
     }
 
-    std::list<T*> _allocatedPoolBlocks;
-    std::list<T*> _freePool;
-    //std::set<T*> _usedPool;
+    std::atomic<uint64_t> _head;
+    std::atomic<Slot*> _blocks[MAX_BLOCKS];
+    int _blockCount;
+    uint32_t _capacity;
+    uint32_t _blockAllocations;
+    std::mutex _allocationMutex;
 };
 
 NS_CC_END
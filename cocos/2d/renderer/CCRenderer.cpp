@@ -30,6 +30,7 @@
 #include "renderer/CCBatchCommand.h"
 #include "renderer/CCCustomCommand.h"
 #include "renderer/CCGroupCommand.h"
+#include "renderer/CCQuadTransform.h"
 #include "CCShaderCache.h"
 #include "ccGLStateCache.h"
 #include "CCConfiguration.h"
@@ -37,9 +38,19 @@
 #include "CCEventDispatcher.h"
 #include "CCEventListenerCustom.h"
 #include "CCEventType.h"
+#include "CCNode.h"
+#include "CCThreadPool.h"
+#include "CCProfiling.h"
 
 #include "kazmath/kazmath.h"
 
+// Unsynchronized ranged mapping is only safe when the ring segments can be fenced
+#if defined(GL_MAP_UNSYNCHRONIZED_BIT) && defined(GL_SYNC_GPU_COMMANDS_COMPLETE)
+#define CC_RENDERER_USE_FENCED_RING 1
+#else
+#define CC_RENDERER_USE_FENCED_RING 0
+#endif
+
 NS_CC_BEGIN
 
 // helper
@@ -48,8 +59,33 @@ static bool compareRenderCommand(RenderCommand* a, RenderCommand* b)
     return a->getGlobalOrder() < b->getGlobalOrder();
 }
 
+static void setQuadVertexAttribPointers()
+{
+    // vertices
+    GL::vertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof(V3F_C4B_T2F, vertices));
+
+    // colors
+    GL::vertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof(V3F_C4B_T2F, colors));
+
+    // tex coords
+    GL::vertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORDS, 2, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof(V3F_C4B_T2F, texCoords));
+}
+
+#if CC_RENDERER_USE_FENCED_RING
+static bool useFencedRing()
+{
+    auto conf = Configuration::getInstance();
+    return conf->supportsMapBufferRange() && conf->supportsFenceSync();
+}
+#endif
+
 // queue
 
+RenderQueue::RenderQueue()
+: _sortMode(SortMode::GLOBAL_ORDER)
+{
+}
+
 void RenderQueue::push_back(RenderCommand* command)
 {
     float z = command->getGlobalOrder();
@@ -68,11 +104,81 @@ ssize_t RenderQueue::size() const
 
 void RenderQueue::sort()
 {
+    if (_sortMode == SortMode::MATERIAL)
+    {
+        // _queue0 has the same global order: it is grouped by material only
+        sortByKey(_queueNegZ);
+        sortByKey(_queue0);
+        sortByKey(_queuePosZ);
+        return;
+    }
+
     // Don't sort _queue0, it already comes sorted
     std::sort(std::begin(_queueNegZ), std::end(_queueNegZ), compareRenderCommand);
     std::sort(std::begin(_queuePosZ), std::end(_queuePosZ), compareRenderCommand);
 }
 
+void RenderQueue::sortByKey(std::vector<RenderCommand*>& commands)
+{
+    // LSD radix sort, 8 bits per pass. It is stable, so commands with the same key keep their order.
+    static const int RADIX_BITS = 8;
+    static const int RADIX_SIZE = 1 << RADIX_BITS;
+    static const int PASSES = 64 / RADIX_BITS;
+
+    const size_t count = commands.size();
+    if (count < 2)
+        return;
+
+    _sortKeys.resize(count);
+    _sortScratch.resize(count);
+
+    uint64_t allOr = 0;
+    uint64_t allAnd = ~(uint64_t)0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint64_t key = commands[i]->getSortKey();
+        _sortKeys[i] = std::make_pair(key, commands[i]);
+        allOr |= key;
+        allAnd &= key;
+    }
+
+    // bits that are equal in every key don't need to be sorted
+    const uint64_t varyingBits = allOr ^ allAnd;
+
+    size_t histogram[RADIX_SIZE];
+    for (int pass = 0; pass < PASSES; ++pass)
+    {
+        const int shift = pass * RADIX_BITS;
+        if (((varyingBits >> shift) & (RADIX_SIZE - 1)) == 0)
+            continue;
+
+        memset(histogram, 0, sizeof(histogram));
+        for (size_t i = 0; i < count; ++i)
+        {
+            ++histogram[(_sortKeys[i].first >> shift) & (RADIX_SIZE - 1)];
+        }
+
+        size_t offset = 0;
+        for (int digit = 0; digit < RADIX_SIZE; ++digit)
+        {
+            size_t n = histogram[digit];
+            histogram[digit] = offset;
+            offset += n;
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            _sortScratch[histogram[(_sortKeys[i].first >> shift) & (RADIX_SIZE - 1)]++] = _sortKeys[i];
+        }
+        _sortKeys.swap(_sortScratch);
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        commands[i] = _sortKeys[i].second;
+    }
+}
+
 RenderCommand* RenderQueue::operator[](ssize_t index) const
 {
     if(index < static_cast<ssize_t>(_queueNegZ.size()))
@@ -109,9 +215,21 @@ static const int DEFAULT_RENDER_QUEUE = 0;
 //
 Renderer::Renderer()
 :_lastMaterialID(0)
+,_quads(nullptr)
+,_indices(nullptr)
 ,_numQuads(0)
+,_currentSegment(0)
+,_streamingEnabled(false)
+,_streamingBuffersCreated(false)
+,_batchQuads(nullptr)
+,_batchFirstQuad(0)
+,_batchCapacity(VBO_SIZE)
 ,_glViewAssigned(false)
+,_drawnBatches(0)
+,_drawnVertices(0)
+,_copiedBytes(0)
 ,_isRendering(false)
+,_isCommandRecorder(false)
 #if CC_ENABLE_CACHE_TEXTURE_DATA
 ,_cacheTextureListener(nullptr)
 #endif
@@ -123,20 +241,35 @@ Renderer::Renderer()
     RenderQueue defaultRenderQueue;
     _renderGroups.push_back(defaultRenderQueue);
     _batchedQuadCommands.reserve(BATCH_QUADCOMMAND_RESEVER_SIZE);
+    memset(_streamingSegments, 0, sizeof(_streamingSegments));
 }
 
 Renderer::~Renderer()
 {
     _renderGroups.clear();
     _groupCommandManager->release();
+
+    for (auto recorder : _commandRecorders)
+    {
+        delete recorder;
+    }
+    _commandRecorders.clear();
+
+    if (_isCommandRecorder)
+        return;
+
+    CC_SAFE_DELETE_ARRAY(_quads);
+    CC_SAFE_DELETE_ARRAY(_indices);
     
-    glDeleteBuffers(2, _buffersVBO);
+    GL::deleteBuffers(2, _buffersVBO);
     
     if (Configuration::getInstance()->supportsShareableVAO())
     {
         glDeleteVertexArrays(1, &_quadVAO);
         GL::bindVAO(0);
     }
+
+    releaseStreamingBuffers();
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     Director::getInstance()->getEventDispatcher()->removeEventListener(_cacheTextureListener);
 #endif
@@ -144,6 +277,15 @@ Renderer::~Renderer()
 
 void Renderer::initGLView()
 {
+    CCASSERT(!_isCommandRecorder, "Command recorders can't render");
+
+    if (!_quads)
+    {
+        _quads = new V3F_C4B_T2F_Quad[VBO_SIZE];
+        _indices = new GLushort[6 * VBO_SIZE];
+        _batchQuads = _quads;
+    }
+
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     _cacheTextureListener = EventListenerCustom::create(EVENT_COME_TO_FOREGROUND, [this](EventCustom* event){
         /** listen the event that coming to foreground on Android */
@@ -175,6 +317,9 @@ void Renderer::setupIndices()
 
 void Renderer::setupBuffer()
 {
+    // The GL context might have been recreated: the streaming buffers are lazily recreated as well
+    _streamingBuffersCreated = false;
+
     if(Configuration::getInstance()->supportsShareableVAO())
     {
         setupVBOAndVAO();
@@ -192,28 +337,28 @@ void Renderer::setupVBOAndVAO()
 
     glGenBuffers(2, &_buffersVBO[0]);
 
-    glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+    GL::bindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
     glBufferData(GL_ARRAY_BUFFER, sizeof(_quads[0]) * VBO_SIZE, _quads, GL_DYNAMIC_DRAW);
 
     // vertices
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_POSITION);
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof( V3F_C4B_T2F, vertices));
+    GL::vertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof( V3F_C4B_T2F, vertices));
 
     // colors
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_COLOR);
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof( V3F_C4B_T2F, colors));
+    GL::vertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof( V3F_C4B_T2F, colors));
 
     // tex coords
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_TEX_COORDS);
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORDS, 2, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof( V3F_C4B_T2F, texCoords));
+    GL::vertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORDS, 2, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof( V3F_C4B_T2F, texCoords));
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * VBO_SIZE * 6, _indices, GL_STATIC_DRAW);
 
     // Must unbind the VAO before changing the element buffer.
     GL::bindVAO(0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ARRAY_BUFFER, 0);
 
     CHECK_GL_ERROR_DEBUG();
 }
@@ -230,17 +375,178 @@ void Renderer::mapBuffers()
     // Avoid changing the element buffer for whatever VAO might be bound.
     GL::bindVAO(0);
 
-    glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+    GL::bindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
     glBufferData(GL_ARRAY_BUFFER, sizeof(_quads[0]) * VBO_SIZE, _quads, GL_DYNAMIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ARRAY_BUFFER, 0);
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * VBO_SIZE * 6, _indices, GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
     CHECK_GL_ERROR_DEBUG();
 }
 
+void Renderer::setupStreamingBuffers()
+{
+    bool useVAO = Configuration::getInstance()->supportsShareableVAO();
+
+    for (int i = 0; i < STREAMING_RING_SIZE; ++i)
+    {
+        auto& segment = _streamingSegments[i];
+        segment.vao = 0;
+        segment.fence = nullptr;
+        segment.usedQuads = 0;
+
+        glGenBuffers(1, &segment.vbo);
+
+        if (useVAO)
+        {
+            glGenVertexArrays(1, &segment.vao);
+            GL::bindVAO(segment.vao);
+        }
+
+        GL::bindBuffer(GL_ARRAY_BUFFER, segment.vbo);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(_quads[0]) * VBO_SIZE, nullptr, GL_STREAM_DRAW);
+
+        if (useVAO)
+        {
+            glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_POSITION);
+            glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_COLOR);
+            glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_TEX_COORDS);
+            setQuadVertexAttribPointers();
+
+            // all the segments share the same indices
+            GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+
+            // Must unbind the VAO before changing the element buffer.
+            GL::bindVAO(0);
+        }
+    }
+
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ARRAY_BUFFER, 0);
+
+    _currentSegment = 0;
+    _streamingBuffersCreated = true;
+
+    CHECK_GL_ERROR_DEBUG();
+}
+
+void Renderer::releaseStreamingBuffers()
+{
+    if (!_streamingBuffersCreated)
+        return;
+
+    for (auto& segment : _streamingSegments)
+    {
+#if CC_RENDERER_USE_FENCED_RING
+        if (segment.fence)
+        {
+            glDeleteSync((GLsync)segment.fence);
+        }
+#endif
+        GL::deleteBuffers(1, &segment.vbo);
+        if (segment.vao)
+        {
+            glDeleteVertexArrays(1, &segment.vao);
+        }
+    }
+    memset(_streamingSegments, 0, sizeof(_streamingSegments));
+    GL::bindVAO(0);
+
+    _streamingBuffersCreated = false;
+}
+
+void Renderer::setVertexStreamingEnabled(bool enabled)
+{
+    CCASSERT(!_isRendering, "Cannot change the vertex streaming mode while rendering");
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT) || (CC_TARGET_PLATFORM == CC_PLATFORM_WP8)
+    // AngleProject does not implement glMapBuffer
+    enabled = false;
+#endif
+
+    _streamingEnabled = enabled;
+}
+
+void Renderer::mapStreamingBuffer(ssize_t quadCount)
+{
+    auto segment = &_streamingSegments[_currentSegment];
+
+#if CC_RENDERER_USE_FENCED_RING
+    if (useFencedRing())
+    {
+        // Keep appending to the current segment while it has room. The already written
+        // ranges might still be in use by the GPU, but they are never touched again.
+        if (segment->usedQuads + quadCount > VBO_SIZE)
+        {
+            segment->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+            _currentSegment = (_currentSegment + 1) % STREAMING_RING_SIZE;
+            segment = &_streamingSegments[_currentSegment];
+
+            // Only wait if the GPU is still reading from the segment a whole ring ago
+            if (segment->fence)
+            {
+                GLsync fence = (GLsync)segment->fence;
+                GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+                while (result == GL_TIMEOUT_EXPIRED)
+                {
+                    result = glClientWaitSync(fence, 0, 1000000000);
+                }
+                glDeleteSync(fence);
+                segment->fence = nullptr;
+            }
+            segment->usedQuads = 0;
+        }
+
+        GL::bindBuffer(GL_ARRAY_BUFFER, segment->vbo);
+        _batchQuads = (V3F_C4B_T2F_Quad*)glMapBufferRange(GL_ARRAY_BUFFER,
+                                                          sizeof(_quads[0]) * segment->usedQuads,
+                                                          sizeof(_quads[0]) * (VBO_SIZE - segment->usedQuads),
+                                                          GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        _batchFirstQuad = segment->usedQuads;
+        _batchCapacity = VBO_SIZE - segment->usedQuads;
+    }
+    else
+#endif
+    {
+        // Without fences every batch takes the next segment of the ring and orphans it,
+        // so mapping it never waits for the GPU to finish reading the previous contents.
+        _currentSegment = (_currentSegment + 1) % STREAMING_RING_SIZE;
+        segment = &_streamingSegments[_currentSegment];
+
+        GL::bindBuffer(GL_ARRAY_BUFFER, segment->vbo);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(_quads[0]) * VBO_SIZE, nullptr, GL_STREAM_DRAW);
+        _batchQuads = (V3F_C4B_T2F_Quad*)glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
+        _batchFirstQuad = 0;
+        _batchCapacity = VBO_SIZE;
+    }
+
+    GL::bindBuffer(GL_ARRAY_BUFFER, 0);
+
+    if (_batchQuads == nullptr)
+    {
+        CCLOG("cocos2d: Renderer: failed to map the streaming vertex buffer. Falling back to staged uploads.");
+        _streamingEnabled = false;
+        _batchQuads = _quads;
+        _batchFirstQuad = 0;
+        _batchCapacity = VBO_SIZE;
+    }
+}
+
+void Renderer::unmapStreamingBuffer()
+{
+    auto& segment = _streamingSegments[_currentSegment];
+
+    GL::bindBuffer(GL_ARRAY_BUFFER, segment.vbo);
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+    GL::bindBuffer(GL_ARRAY_BUFFER, 0);
+
+    segment.usedQuads = _batchFirstQuad + _numQuads;
+    _batchQuads = _quads;
+}
+
 void Renderer::addCommand(RenderCommand* command)
 {
     int renderQueue =_commandGroupStack.top();
@@ -258,6 +564,7 @@ void Renderer::addCommand(RenderCommand* command, int renderQueue)
 void Renderer::pushGroup(int renderQueueID)
 {
     CCASSERT(!_isRendering, "Cannot change render queue while rendering");
+    CCASSERT(!_isCommandRecorder, "Group commands can't be used in nodes visited in parallel");
     _commandGroupStack.push(renderQueueID);
 }
 
@@ -274,6 +581,63 @@ int Renderer::createRenderQueue()
     return (int)_renderGroups.size() - 1;
 }
 
+void Renderer::visitInParallel(Node* const* nodes, ssize_t count, const kmMat4& parentTransform, bool parentTransformUpdated)
+{
+    CCASSERT(!_isRendering, "Cannot visit nodes while rendering");
+
+    auto pool = ThreadPool::getInstance();
+
+    // Nested parallel visits, or no workers to share the work with: visit in place
+    if (_isCommandRecorder || count < 2 || pool->getThreadCount() == 0)
+    {
+        for (ssize_t i = 0; i < count; ++i)
+        {
+            nodes[i]->visit(this, parentTransform, parentTransformUpdated);
+        }
+        return;
+    }
+
+    // Contiguous ranges of nodes go to the same recorder, so merging the
+    // recorders in order gives the same command order as a sequential visit
+    int chunks = std::min((int)count, pool->getThreadCount() + 1);
+    while ((int)_commandRecorders.size() < chunks)
+    {
+        auto recorder = new Renderer();
+        recorder->_isCommandRecorder = true;
+        _commandRecorders.push_back(recorder);
+    }
+
+    pool->parallelFor(chunks, [&](int chunk) {
+        CC_PROFILER_TIMELINE_SCOPE("Renderer::visitInParallel");
+        auto recorder = _commandRecorders[chunk];
+        ssize_t begin = count * chunk / chunks;
+        ssize_t end = count * (chunk + 1) / chunks;
+        for (ssize_t i = begin; i < end; ++i)
+        {
+            nodes[i]->visit(recorder, parentTransform, parentTransformUpdated);
+        }
+    });
+
+    for (int chunk = 0; chunk < chunks; ++chunk)
+    {
+        auto recorder = _commandRecorders[chunk];
+        const RenderQueue& queue = recorder->_renderGroups[DEFAULT_RENDER_QUEUE];
+        ssize_t size = queue.size();
+        for (ssize_t i = 0; i < size; ++i)
+        {
+            addCommand(queue[i]);
+        }
+        recorder->clean();
+    }
+}
+
+void Renderer::setRenderQueueSortMode(int renderQueueID, RenderQueue::SortMode mode)
+{
+    CCASSERT(!_isRendering, "Cannot change the sort mode while rendering");
+    CCASSERT(renderQueueID >= 0 && renderQueueID < (int)_renderGroups.size(), "Invalid render queue");
+    _renderGroups[renderQueueID].setSortMode(mode);
+}
+
 void Renderer::visitRenderQueue(const RenderQueue& queue)
 {
     ssize_t size = queue.size();
@@ -286,18 +650,24 @@ void Renderer::visitRenderQueue(const RenderQueue& queue)
         {
             auto cmd = static_cast<QuadCommand*>(command);
             //Batch quads
-            if(_numQuads + cmd->getQuadCount() > VBO_SIZE)
+            if(_numQuads + cmd->getQuadCount() > _batchCapacity)
             {
                 CCASSERT(cmd->getQuadCount()>= 0 && cmd->getQuadCount() < VBO_SIZE, "VBO is not big enough for quad data, please break the quad data down or use customized render command");
                 
                 //Draw batched quads if VBO is full
                 drawBatchedQuads();
             }
+
+            //Write the quads straight into GPU memory when streaming
+            if(_streamingEnabled && _batchQuads == _quads && cmd->getQuadCount() > 0)
+            {
+                mapStreamingBuffer(cmd->getQuadCount());
+            }
             
             _batchedQuadCommands.push_back(cmd);
             
-            memcpy(_quads + _numQuads, cmd->getQuads(), sizeof(V3F_C4B_T2F_Quad) * cmd->getQuadCount());
-            convertToWorldCoordinates(_quads + _numQuads, cmd->getQuadCount(), cmd->getModelView());
+            convertToWorldCoordinates(cmd->getQuads(), _batchQuads + _numQuads, cmd->getQuadCount(), cmd->getModelView());
+            _copiedBytes += sizeof(V3F_C4B_T2F_Quad) * cmd->getQuadCount();
             
             _numQuads += cmd->getQuadCount();
 
@@ -312,12 +682,14 @@ void Renderer::visitRenderQueue(const RenderQueue& queue)
         {
             flush();
             auto cmd = static_cast<CustomCommand*>(command);
+            CC_PROFILER_TIMELINE_MARKER("CustomCommand");
             cmd->execute();
         }
         else if(RenderCommand::Type::BATCH_COMMAND == commandType)
         {
             flush();
             auto cmd = static_cast<BatchCommand*>(command);
+            CC_PROFILER_TIMELINE_MARKER("BatchCommand");
             cmd->execute();
         }
         else
@@ -334,22 +706,31 @@ void Renderer::render()
 
     //TODO setup camera or MVP
     _isRendering = true;
+    CC_PROFILER_TIMELINE_BEGIN("Renderer::render");
     
     if (_glViewAssigned)
     {
         // cleanup
-        _drawnBatches = _drawnVertices = 0;
+        _drawnBatches = _drawnVertices = _copiedBytes = 0;
+
+        if (_streamingEnabled && !_streamingBuffersCreated)
+        {
+            setupStreamingBuffers();
+        }
 
         //Process render commands
         //1. Sort render commands based on ID
+        CC_PROFILER_TIMELINE_BEGIN("Renderer::sort");
         for (auto &renderqueue : _renderGroups)
         {
             renderqueue.sort();
         }
+        CC_PROFILER_TIMELINE_END("Renderer::sort");
         visitRenderQueue(_renderGroups[0]);
         flush();
     }
     clean();
+    CC_PROFILER_TIMELINE_END("Renderer::render");
     _isRendering = false;
 }
 
@@ -369,31 +750,16 @@ void Renderer::clean()
     // Clear batch quad commands
     _batchedQuadCommands.clear();
     _numQuads = 0;
+    _batchFirstQuad = 0;
+    _batchCapacity = VBO_SIZE;
 
     _lastMaterialID = 0;
 }
 
-void Renderer::convertToWorldCoordinates(V3F_C4B_T2F_Quad* quads, ssize_t quantity, const kmMat4& modelView)
+void Renderer::convertToWorldCoordinates(const V3F_C4B_T2F_Quad* in, V3F_C4B_T2F_Quad* out, ssize_t quantity, const kmMat4& modelView)
 {
-//    kmMat4 matrixP, mvp;
-//    kmGLGetMatrix(KM_GL_PROJECTION, &matrixP);
-//    kmMat4Multiply(&mvp, &matrixP, &modelView);
-
-    for(ssize_t i=0; i<quantity; ++i) {
-        V3F_C4B_T2F_Quad *q = &quads[i];
-
-        kmVec3 *vec1 = (kmVec3*)&q->bl.vertices;
-        kmVec3Transform(vec1, vec1, &modelView);
-
-        kmVec3 *vec2 = (kmVec3*)&q->br.vertices;
-        kmVec3Transform(vec2, vec2, &modelView);
-
-        kmVec3 *vec3 = (kmVec3*)&q->tr.vertices;
-        kmVec3Transform(vec3, vec3, &modelView);
-
-        kmVec3 *vec4 = (kmVec3*)&q->tl.vertices;
-        kmVec3Transform(vec4, vec4, &modelView);
-    }
+    // `out` might be write-only mapped memory: transformQuads never reads from it
+    transformQuads(in, out, quantity, modelView);
 }
 
 void Renderer::drawBatchedQuads()
@@ -409,10 +775,31 @@ void Renderer::drawBatchedQuads()
         return;
     }
 
-    if (Configuration::getInstance()->supportsShareableVAO())
+    bool streamed = (_batchQuads != _quads);
+
+    if (streamed)
+    {
+        //Quads were already written into the mapped segment
+        unmapStreamingBuffer();
+        startQuad = _batchFirstQuad;
+
+        auto& segment = _streamingSegments[_currentSegment];
+        if (Configuration::getInstance()->supportsShareableVAO())
+        {
+            GL::bindVAO(segment.vao);
+        }
+        else
+        {
+            GL::bindBuffer(GL_ARRAY_BUFFER, segment.vbo);
+            GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
+            setQuadVertexAttribPointers();
+            GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+        }
+    }
+    else if (Configuration::getInstance()->supportsShareableVAO())
     {
         //Set VBO data
-        glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+        GL::bindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
 
         // option 1: subdata
 //        glBufferSubData(GL_ARRAY_BUFFER, sizeof(_quads[0])*start, sizeof(_quads[0]) * n , &_quads[start] );
@@ -425,8 +812,9 @@ void Renderer::drawBatchedQuads()
         void *buf = glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
         memcpy(buf, _quads, sizeof(_quads[0])* (_numQuads));
         glUnmapBuffer(GL_ARRAY_BUFFER);
+        _copiedBytes += sizeof(_quads[0]) * _numQuads;
 
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        GL::bindBuffer(GL_ARRAY_BUFFER, 0);
 
         //Bind VAO
         GL::bindVAO(_quadVAO);
@@ -434,22 +822,23 @@ void Renderer::drawBatchedQuads()
     else
     {
 #define kQuadSize sizeof(_quads[0].bl)
-        glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+        GL::bindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
 
         glBufferData(GL_ARRAY_BUFFER, sizeof(_quads[0]) * _numQuads , _quads, GL_DYNAMIC_DRAW);
+        _copiedBytes += sizeof(_quads[0]) * _numQuads;
 
         GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
 
         // vertices
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) offsetof(V3F_C4B_T2F, vertices));
+        GL::vertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) offsetof(V3F_C4B_T2F, vertices));
 
         // colors
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, kQuadSize, (GLvoid*) offsetof(V3F_C4B_T2F, colors));
+        GL::vertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, kQuadSize, (GLvoid*) offsetof(V3F_C4B_T2F, colors));
 
         // tex coords
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORDS, 2, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) offsetof(V3F_C4B_T2F, texCoords));
+        GL::vertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORDS, 2, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) offsetof(V3F_C4B_T2F, texCoords));
 
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+        GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
     }
 
     //Start drawing verties in batch
@@ -461,6 +850,7 @@ void Renderer::drawBatchedQuads()
             //Draw quads
             if(quadsToDraw > 0)
             {
+                CC_PROFILER_TIMELINE_MARKER("glDrawElements");
                 glDrawElements(GL_TRIANGLES, (GLsizei) quadsToDraw*6, GL_UNSIGNED_SHORT, (GLvoid*) (startQuad*6*sizeof(_indices[0])) );
                 _drawnBatches++;
                 _drawnVertices += quadsToDraw*6;
@@ -480,6 +870,7 @@ void Renderer::drawBatchedQuads()
     //Draw any remaining quad
     if(quadsToDraw > 0)
     {
+        CC_PROFILER_TIMELINE_MARKER("glDrawElements");
         glDrawElements(GL_TRIANGLES, (GLsizei) quadsToDraw*6, GL_UNSIGNED_SHORT, (GLvoid*) (startQuad*6*sizeof(_indices[0])) );
         _drawnBatches++;
         _drawnVertices += quadsToDraw*6;
@@ -492,16 +883,19 @@ void Renderer::drawBatchedQuads()
     }
     else
     {
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        GL::bindBuffer(GL_ARRAY_BUFFER, 0);
+        GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     }
 
     _batchedQuadCommands.clear();
     _numQuads = 0;
+    _batchFirstQuad = 0;
+    _batchCapacity = VBO_SIZE;
 }
 
 void Renderer::flush()
 {
+    CC_PROFILER_TIMELINE_SCOPE("Renderer::flush");
     drawBatchedQuads();
     _lastMaterialID = 0;
 }
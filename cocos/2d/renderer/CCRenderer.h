@@ -37,25 +37,52 @@ NS_CC_BEGIN
 
 class EventListenerCustom;
 class QuadCommand;
+class Node;
 
 /** Class that knows how to sort `RenderCommand` objects.
  Since the commands that have `z == 0` are "pushed back" in
  the correct order, the only `RenderCommand` objects that need to be sorted,
  are the ones that have `z < 0` and `z > 0`.
+
+ Queues can opt-in to sort by material as well: commands with the same global order
+ are then grouped by translucency, shader, texture and blend using a radix sort on
+ `RenderCommand::getSortKey()`. It changes the draw order of commands with the same
+ global order, so only use it when they don't overlap.
 */
 class RenderQueue {
 
 public:
+    enum class SortMode
+    {
+        /** stable sort by global order only */
+        GLOBAL_ORDER,
+        /** radix sort by global order and material */
+        MATERIAL,
+    };
+
+    RenderQueue();
+
     void push_back(RenderCommand* command);
     ssize_t size() const;
     void sort();
     RenderCommand* operator[](ssize_t index) const;
     void clear();
 
+    inline void setSortMode(SortMode mode) { _sortMode = mode; }
+    inline SortMode getSortMode() const { return _sortMode; }
+
 protected:
+    void sortByKey(std::vector<RenderCommand*>& commands);
+
     std::vector<RenderCommand*> _queueNegZ;
     std::vector<RenderCommand*> _queue0;
     std::vector<RenderCommand*> _queuePosZ;
+
+    SortMode _sortMode;
+
+    // radix sort buffers, kept around to avoid allocations
+    std::vector<std::pair<uint64_t, RenderCommand*>> _sortKeys;
+    std::vector<std::pair<uint64_t, RenderCommand*>> _sortScratch;
 };
 
 struct RenderStackElement
@@ -75,6 +102,7 @@ class Renderer
 public:
     static const int VBO_SIZE = 65536 / 6;
     static const int BATCH_QUADCOMMAND_RESEVER_SIZE = 64;
+    static const int STREAMING_RING_SIZE = 3;
 
     Renderer();
     ~Renderer();
@@ -97,6 +125,11 @@ public:
     /** Creates a render queue and returns its Id */
     int createRenderQueue();
 
+    /** Sets how the commands of a render queue are sorted. `RenderQueue::SortMode::GLOBAL_ORDER` by default.
+     Queues used by `GroupCommand`s go back to the default when their ID is reused, so set it after `GroupCommand::init()`.
+     */
+    void setRenderQueueSortMode(int renderQueueID, RenderQueue::SortMode mode);
+
     /** Renders into the GLView all the queued `RenderCommand` objects */
     void render();
 
@@ -112,8 +145,31 @@ public:
     /* RenderCommands (except) QuadCommand should update this value */
     void addDrawnVertices(ssize_t number) { _drawnVertices += number; };
 
+    /* returns the number of vertex bytes written by the CPU in the last frame */
+    ssize_t getCopiedBytes() const { return _copiedBytes; }
+
+    /** Enables or disables the streaming vertex buffer mode.
+     When enabled, quads are transformed straight into a ring of mapped vertex buffers
+     instead of being staged in the renderer and uploaded on every flush.
+     */
+    void setVertexStreamingEnabled(bool enabled);
+    /** Whether or not the streaming vertex buffer mode is enabled */
+    bool isVertexStreamingEnabled() const { return _streamingEnabled; }
+
     inline GroupCommandManager* getGroupCommandManager() const { return _groupCommandManager; };
 
+    /** Visits `count` nodes on worker threads and adds their commands in the same order a sequential visit would.
+     The nodes are split in contiguous chunks, one per thread. The nodes of a chunk are visited one after
+     the other on the same thread and record into the command list of the chunk. The lists are merged in
+     chunk order once all of them are visited.
+     Nodes of different chunks run at the same time, so the subtrees must be independent: they can't use
+     `GroupCommand`s, the kmGL matrix stack, nor create, retain or release objects while they are visited.
+     */
+    void visitInParallel(Node* const* nodes, ssize_t count, const kmMat4& parentTransform, bool parentTransformUpdated);
+
+    /** Whether or not this renderer only records commands for a parallel visit. Recorders can't render. */
+    inline bool isCommandRecorder() const { return _isCommandRecorder; }
+
     /** returns whether or not a rectangle is visible or not */
     bool checkVisibility(const kmMat4& transform, const Size& size);
 
@@ -133,7 +189,14 @@ protected:
     
     void visitRenderQueue(const RenderQueue& queue);
 
-    void convertToWorldCoordinates(V3F_C4B_T2F_Quad* quads, ssize_t quantity, const kmMat4& modelView);
+    void convertToWorldCoordinates(const V3F_C4B_T2F_Quad* in, V3F_C4B_T2F_Quad* out, ssize_t quantity, const kmMat4& modelView);
+
+    //Streaming vertex buffers
+    void setupStreamingBuffers();
+    void releaseStreamingBuffers();
+    //Maps a segment of the ring with room for at least `quadCount` quads
+    void mapStreamingBuffer(ssize_t quadCount);
+    void unmapStreamingBuffer();
 
     std::stack<int> _commandGroupStack;
     
@@ -143,20 +206,47 @@ protected:
 
     std::vector<QuadCommand*> _batchedQuadCommands;
 
-    V3F_C4B_T2F_Quad _quads[VBO_SIZE];
-    GLushort _indices[6 * VBO_SIZE];
+    // VBO_SIZE quads and 6 * VBO_SIZE indices, allocated by initGLView(). Command recorders don't need them
+    V3F_C4B_T2F_Quad* _quads;
+    GLushort* _indices;
     GLuint _quadVAO;
     GLuint _buffersVBO[2]; //0: vertex  1: indices
 
     int _numQuads;
+
+    struct StreamingSegment
+    {
+        GLuint vao;
+        GLuint vbo;
+        // GLsync, only used when fence sync objects are supported
+        void* fence;
+        // number of quads already consumed in this segment
+        int usedQuads;
+    };
+
+    StreamingSegment _streamingSegments[STREAMING_RING_SIZE];
+    int _currentSegment;
+    bool _streamingEnabled;
+    bool _streamingBuffersCreated;
+    // destination of the quads of the current batch: either `_quads` or mapped GPU memory
+    V3F_C4B_T2F_Quad* _batchQuads;
+    // first quad of the current batch inside the bound vertex buffer
+    int _batchFirstQuad;
+    // max number of quads the current batch can hold
+    int _batchCapacity;
     
     bool _glViewAssigned;
 
     // stats
     ssize_t _drawnBatches;
     ssize_t _drawnVertices;
+    ssize_t _copiedBytes;
     //the flag for checking whether renderer is rendering
     bool _isRendering;
+
+    //parallel visit: recorders used by the worker threads, one per visited node
+    bool _isCommandRecorder;
+    std::vector<Renderer*> _commandRecorders;
     
     GroupCommandManager* _groupCommandManager;
     
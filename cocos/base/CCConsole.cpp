@@ -57,6 +57,7 @@
 #include "CCDirector.h"
 #include "CCScheduler.h"
 #include "CCScene.h"
+#include "CCProfiling.h"
 #include "CCPlatformConfig.h"
 #include "platform/CCFileUtils.h"
 #include "CCConfiguration.h"
@@ -86,6 +87,8 @@ static std::string &trim(std::string &s) {
     return ltrim(rtrim(s));
 }
 
+static char invalid_filename_char[] = {':', '/', '\\', '?', '%', '*', '<', '>', '"', '|', '\r', '\n', '\t'};
+
 static std::vector<std::string> &split(const std::string &s, char delim, std::vector<std::string> &elems) {
     std::stringstream ss(s);
     std::string item;
@@ -288,6 +291,7 @@ Console::Console()
             }
         } },
         { "help", "Print this message", std::bind(&Console::commandHelp, this, std::placeholders::_1, std::placeholders::_2) },
+        { "profile", "Record a timeline of the frames, in the Chrome trace format. Args: [start | stop [filename]]", std::bind(&Console::commandProfile, this, std::placeholders::_1, std::placeholders::_2) },
         { "projection", "Change or print the current projection. Args: [2d | 3d]", std::bind(&Console::commandProjection, this, std::placeholders::_1, std::placeholders::_2) },
         { "resolution", "Change or print the window resolution. Args: [width height resolution_policy | ]", std::bind(&Console::commandResolution, this, std::placeholders::_1, std::placeholders::_2) },
         { "scenegraph", "Print the scene graph", std::bind(&Console::commandSceneGraph, this, std::placeholders::_1, std::placeholders::_2) },
@@ -587,6 +591,56 @@ void Console::commandTextures(int fd, const std::string& args)
     }
 }
 
+void Console::commandProfile(int fd, const std::string& args)
+{
+    Scheduler *sched = Director::getInstance()->getScheduler();
+
+    if( args.compare("start") == 0 )
+    {
+        // between two frames, so that the capture starts with a whole frame
+        sched->performFunctionInCocosThread( [](){
+            ProfilerTimeline::getInstance()->start();
+        }
+                                            );
+    }
+    else if( args.compare("stop") == 0 || args.compare(0, 5, "stop ") == 0 )
+    {
+        std::string filename = args.substr(4);
+        trim(filename);
+        if( filename.empty() )
+        {
+            filename = "profile.json";
+        }
+        for(char x : invalid_filename_char)
+        {
+            if( filename.find(x) != std::string::npos )
+            {
+                mydprintf(fd, "profile: invalid file name!\n");
+                return;
+            }
+        }
+
+        std::string filepath = _writablePath + filename;
+        sched->performFunctionInCocosThread( [=](){
+            auto timeline = ProfilerTimeline::getInstance();
+            timeline->stop();
+            if( timeline->writeToFile(filepath) )
+            {
+                mydprintf(fd, "Profile written to %s\n", filepath.c_str());
+            }
+            else
+            {
+                mydprintf(fd, "Can't write the profile to %s\n", filepath.c_str());
+            }
+            sendPrompt(fd);
+        }
+                                            );
+    }
+    else
+    {
+        mydprintf(fd, "Unsupported argument: '%s'. Supported arguments: 'start' or 'stop [filename]'\n", args.c_str());
+    }
+}
 
 void Console::commandDirector(int fd, const std::string& args)
 {
@@ -774,8 +828,6 @@ void Console::commandTouch(int fd, const std::string& args)
     }
 }
 
-static char invalid_filename_char[] = {':', '/', '\\', '?', '%', '*', '<', '>', '"', '|', '\r', '\n', '\t'};
-
 void Console::commandUpload(int fd)
 {
     ssize_t n, rc;
@@ -0,0 +1,181 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "CCThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+NS_CC_BEGIN
+
+static ThreadPool* s_sharedThreadPool = nullptr;
+
+ThreadPool* ThreadPool::getInstance()
+{
+    if (!s_sharedThreadPool)
+    {
+        int cores = (int)std::thread::hardware_concurrency();
+        s_sharedThreadPool = new ThreadPool(cores > 2 ? cores - 1 : 1);
+    }
+    return s_sharedThreadPool;
+}
+
+void ThreadPool::destroyInstance()
+{
+    CC_SAFE_DELETE(s_sharedThreadPool);
+}
+
+ThreadPool::ThreadPool(int threadCount)
+: _stop(false)
+{
+    for (int i = 0; i < threadCount; ++i)
+    {
+        _threads.push_back(std::thread(&ThreadPool::workerLoop, this));
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _condition.notify_all();
+
+    for (auto& thread : _threads)
+    {
+        thread.join();
+    }
+}
+
+void ThreadPool::enqueue(const std::function<void()>& task)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _tasks.push_back(task);
+    }
+    _condition.notify_one();
+}
+
+void ThreadPool::workerLoop()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _condition.wait(lock, [this]() { return _stop || !_tasks.empty(); });
+
+            // drain the queue before stopping
+            if (_tasks.empty())
+                return;
+
+            task = std::move(_tasks.front());
+            _tasks.pop_front();
+        }
+        task();
+    }
+}
+
+namespace {
+
+struct ParallelForState
+{
+    std::atomic<int> next;
+    int count;
+    const std::function<void(int)>* task;
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    // helpers running the loop
+    int active;
+    // set by the caller once all the indices are taken: late helpers must not touch `task`
+    bool closed;
+
+    void run()
+    {
+        int index;
+        while ((index = next++) < count)
+        {
+            (*task)(index);
+        }
+    }
+};
+
+}
+
+void ThreadPool::parallelFor(int count, const std::function<void(int)>& task)
+{
+    if (count <= 0)
+        return;
+
+    int helpers = std::min(count - 1, getThreadCount());
+    if (helpers <= 0)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            task(i);
+        }
+        return;
+    }
+
+    // helpers might start after this call returns, so the state is shared
+    auto state = std::make_shared<ParallelForState>();
+    state->next = 0;
+    state->count = count;
+    state->task = &task;
+    state->active = 0;
+    state->closed = false;
+
+    for (int i = 0; i < helpers; ++i)
+    {
+        enqueue([state]() {
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (state->closed)
+                    return;
+                ++state->active;
+            }
+
+            state->run();
+
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                --state->active;
+            }
+            state->condition.notify_all();
+        });
+    }
+
+    state->run();
+
+    // wait for the helpers that took an index, the others won't run anything
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->closed = true;
+    state->condition.wait(lock, [&state]() { return state->active == 0; });
+}
+
+NS_CC_END
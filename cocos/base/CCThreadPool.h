@@ -0,0 +1,82 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __CCTHREADPOOL_H__
+#define __CCTHREADPOOL_H__
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <vector>
+#include <deque>
+
+#include "CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+/** A fixed set of worker threads that run queued tasks.
+ Tasks must not touch the scene graph, the GL context or autoreleased objects
+ unless the caller guarantees nothing else does at the same time.
+ */
+class CC_DLL ThreadPool
+{
+public:
+    /** returns the shared pool. It has one thread less than the number of cores, and at least one */
+    static ThreadPool* getInstance();
+
+    /** destroys the shared pool, waiting for the queued tasks to finish */
+    static void destroyInstance();
+
+    explicit ThreadPool(int threadCount);
+    ~ThreadPool();
+
+    /** queues a task that runs on one of the worker threads */
+    void enqueue(const std::function<void()>& task);
+
+    /** Runs `task(index)` for every index in [0, count) and returns when all of them have finished.
+     The calling thread runs tasks as well, so it never waits for workers busy with other tasks.
+     */
+    void parallelFor(int count, const std::function<void(int)>& task);
+
+    /** returns the number of worker threads */
+    inline int getThreadCount() const { return (int)_threads.size(); }
+
+protected:
+    void workerLoop();
+
+    std::vector<std::thread> _threads;
+    std::deque<std::function<void()>> _tasks;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    bool _stop;
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(ThreadPool);
+};
+
+NS_CC_END
+
+#endif /* __CCTHREADPOOL_H__ */
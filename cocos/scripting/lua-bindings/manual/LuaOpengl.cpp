@@ -297,7 +297,7 @@ static int tolua_Cocos2d_glBindBuffer00(lua_State* tolua_S)
     {
         unsigned int target   = (unsigned int)tolua_tonumber(tolua_S,1,0);
         unsigned int buffer   = (unsigned int)tolua_tonumber(tolua_S,2,0);
-        glBindBuffer((GLenum)target,(GLuint)buffer);
+        GL::bindBuffer((GLenum)target,(GLuint)buffer);
     }
     return 0;
 #ifndef TOLUA_RELEASE
@@ -1104,7 +1104,7 @@ static int tolua_Cocos2d_glDeleteBuffers00(lua_State* tolua_S)
 #endif
     {
         unsigned int buffers   = (unsigned int)tolua_tonumber(tolua_S,1,0);
-        glDeleteBuffers(1,&buffers );
+        GL::deleteBuffers(1,&buffers );
     }
     return 0;
 #ifndef TOLUA_RELEASE
@@ -1260,7 +1260,7 @@ static int tolua_Cocos2d_glDepthFunc00(lua_State* tolua_S)
 #endif
     {
         unsigned int func   = (unsigned int)tolua_tonumber(tolua_S,1,0);
-        glDepthFunc((GLenum)func);
+        GL::depthFunc((GLenum)func);
     }
     return 0;
 #ifndef TOLUA_RELEASE
@@ -1286,7 +1286,7 @@ static int tolua_Cocos2d_glDepthMask00(lua_State* tolua_S)
 #endif
     {
         unsigned char flag   = (unsigned char)tolua_tonumber(tolua_S,1,0);
-        glDepthMask((GLboolean)flag  );
+        GL::depthMask((GLboolean)flag  );
     }
     return 0;
 #ifndef TOLUA_RELEASE
@@ -1368,7 +1368,7 @@ static int tolua_Cocos2d_glDisable00(lua_State* tolua_S)
 #endif
     {
         unsigned int cap   = (unsigned int)tolua_tonumber(tolua_S,1,0);
-        glDisable((GLenum)cap );
+        GL::disable((GLenum)cap );
     }
     return 0;
 #ifndef TOLUA_RELEASE
@@ -1526,7 +1526,7 @@ static int tolua_Cocos2d_glEnable00(lua_State* tolua_S)
 #endif
     {
         unsigned int cap   = (unsigned int)tolua_tonumber(tolua_S,1,0);
-        glEnable((GLenum)cap);
+        GL::enable((GLenum)cap);
     }
     return 0;
 #ifndef TOLUA_RELEASE
@@ -2838,7 +2838,7 @@ static int tolua_Cocos2d_glScissor00(lua_State* tolua_S)
         int arg1 = (int)tolua_tonumber(tolua_S, 2, 0);
         int arg2 = (int)tolua_tonumber(tolua_S, 3, 0);
         int arg3 = (int)tolua_tonumber(tolua_S, 4, 0);
-        glScissor((GLint)arg0 , (GLint)arg1 , (GLsizei)arg2 , (GLsizei)arg3  );
+        GL::scissor((GLint)arg0 , (GLint)arg1 , (GLsizei)arg2 , (GLsizei)arg3  );
     }
     return 0;
 #ifndef TOLUA_RELEASE
@@ -2896,7 +2896,7 @@ static int tolua_Cocos2d_glStencilFunc00(lua_State* tolua_S)
         unsigned int arg0 = (unsigned int)tolua_tonumber(tolua_S, 1, 0);
         int arg1 = (int)tolua_tonumber(tolua_S, 2, 0);
         unsigned int arg2 = (unsigned int)tolua_tonumber(tolua_S, 3, 0);        
-        glStencilFunc((GLenum)arg0 , (GLint)arg1 , (GLuint)arg2  );
+        GL::stencilFunc((GLenum)arg0 , (GLint)arg1 , (GLuint)arg2  );
     }
     return 0;
 #ifndef TOLUA_RELEASE
@@ -2954,7 +2954,7 @@ static int tolua_Cocos2d_glStencilMask00(lua_State* tolua_S)
 #endif
     {
         unsigned int arg0 = (unsigned int)tolua_tonumber(tolua_S, 1, 0);
-        glStencilMask((GLuint)arg0);
+        GL::stencilMask((GLuint)arg0);
     }
     return 0;
 #ifndef TOLUA_RELEASE
@@ -3012,7 +3012,7 @@ static int tolua_Cocos2d_glStencilOp00(lua_State* tolua_S)
         unsigned int arg0 = (unsigned int)tolua_tonumber(tolua_S, 1, 0);
         unsigned int arg1 = (unsigned int)tolua_tonumber(tolua_S, 2, 0);
         unsigned int arg2 = (unsigned int)tolua_tonumber(tolua_S, 3, 0);
-        glStencilOp((GLenum)arg0 , (GLenum)arg1 , (GLenum)arg2  );
+        GL::stencilOp((GLenum)arg0 , (GLenum)arg1 , (GLenum)arg2  );
     }
     return 0;
 #ifndef TOLUA_RELEASE
@@ -4318,7 +4318,7 @@ static int tolua_Cocos2d_glVertexAttribPointer00(lua_State* tolua_S)
         bool arg3 = tolua_toboolean(tolua_S, 4, 0);
         int arg4 = (int)tolua_tonumber(tolua_S, 5, 0);
         //int arg5 = (int)tolua_tonumber(tolua_S, 7, 0);
-        glVertexAttribPointer((GLuint)arg0 , (GLint)arg1 , (GLenum)arg2 , (GLboolean)arg3 , (GLsizei)arg4 , (GLvoid*)NULL);
+        GL::vertexAttribPointer((GLuint)arg0 , (GLint)arg1 , (GLenum)arg2 , (GLboolean)arg3 , (GLsizei)arg4 , (GLvoid*)NULL);
     }
     return 0;
 #ifndef TOLUA_RELEASE
@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "kazmath/GL/matrix.h"
 #include "CCGLProgram.h"
 #include "CCShaderCache.h"
+#include "ccGLStateCache.h"
 #include "CCDirector.h"
 #include "CCDrawingPrimitives.h"
 #include "renderer/CCRenderer.h"
@@ -835,13 +836,13 @@ void Layout::onBeforeVisitStencil()
     glGetIntegerv(GL_STENCIL_PASS_DEPTH_FAIL, (GLint *)&_currentStencilPassDepthFail);
     glGetIntegerv(GL_STENCIL_PASS_DEPTH_PASS, (GLint *)&_currentStencilPassDepthPass);
     
-    glEnable(GL_STENCIL_TEST);
+    GL::enable(GL_STENCIL_TEST);
     CHECK_GL_ERROR_DEBUG();
-    glStencilMask(mask_layer);
+    GL::stencilMask(mask_layer);
     glGetBooleanv(GL_DEPTH_WRITEMASK, &_currentDepthWriteMask);
-    glDepthMask(GL_FALSE);
-    glStencilFunc(GL_NEVER, mask_layer, mask_layer);
-    glStencilOp(GL_ZERO, GL_KEEP, GL_KEEP);
+    GL::depthMask(GL_FALSE);
+    GL::stencilFunc(GL_NEVER, mask_layer, mask_layer);
+    GL::stencilOp(GL_ZERO, GL_KEEP, GL_KEEP);
     kmGLMatrixMode(KM_GL_MODELVIEW);
     kmGLPushMatrix();
     kmGLLoadIdentity();
@@ -856,26 +857,26 @@ void Layout::onBeforeVisitStencil()
     kmGLPopMatrix();
     kmGLMatrixMode(KM_GL_MODELVIEW);
     kmGLPopMatrix();
-    glStencilFunc(GL_NEVER, mask_layer, mask_layer);
-    glStencilOp(GL_REPLACE, GL_KEEP, GL_KEEP);
+    GL::stencilFunc(GL_NEVER, mask_layer, mask_layer);
+    GL::stencilOp(GL_REPLACE, GL_KEEP, GL_KEEP);
 }
 
 void Layout::onAfterDrawStencil()
 {
-    glDepthMask(_currentDepthWriteMask);
-    glStencilFunc(GL_EQUAL, _mask_layer_le, _mask_layer_le);
-    glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+    GL::depthMask(_currentDepthWriteMask);
+    GL::stencilFunc(GL_EQUAL, _mask_layer_le, _mask_layer_le);
+    GL::stencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
 }
 
 
 void Layout::onAfterVisitStencil()
 {
-    glStencilFunc(_currentStencilFunc, _currentStencilRef, _currentStencilValueMask);
-    glStencilOp(_currentStencilFail, _currentStencilPassDepthFail, _currentStencilPassDepthPass);
-    glStencilMask(_currentStencilWriteMask);
+    GL::stencilFunc(_currentStencilFunc, _currentStencilRef, _currentStencilValueMask);
+    GL::stencilOp(_currentStencilFail, _currentStencilPassDepthFail, _currentStencilPassDepthPass);
+    GL::stencilMask(_currentStencilWriteMask);
     if (!_currentStencilEnabled)
     {
-        glDisable(GL_STENCIL_TEST);
+        GL::disable(GL_STENCIL_TEST);
     }
     s_layer--;
 }
@@ -883,14 +884,14 @@ void Layout::onAfterVisitStencil()
 void Layout::onBeforeVisitScissor()
 {
     Rect clippingRect = getClippingRect();
-    glEnable(GL_SCISSOR_TEST);
+    GL::enable(GL_SCISSOR_TEST);
     auto glview = Director::getInstance()->getOpenGLView();
     glview->setScissorInPoints(clippingRect.origin.x, clippingRect.origin.y, clippingRect.size.width, clippingRect.size.height);
 }
 
 void Layout::onAfterVisitScissor()
 {
-    glDisable(GL_SCISSOR_TEST);
+    GL::disable(GL_SCISSOR_TEST);
 }
     
 void Layout::scissorClippingVisit(Renderer *renderer, const kmMat4& parentTransform, bool parentTransformUpdated)
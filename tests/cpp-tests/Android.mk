@@ -153,6 +153,9 @@ Classes/PerformanceTest/PerformanceContainerTest.cpp \
 Classes/PerformanceTest/PerformanceEventDispatcherTest.cpp \
 Classes/PerformanceTest/PerformanceScenarioTest.cpp \
 Classes/PerformanceTest/PerformanceCallbackTest.cpp \
+Classes/PerformanceTest/PerformanceSchedulerTest.cpp \
+Classes/PerformanceTest/PerformanceActionTest.cpp \
+Classes/PerformanceTest/PerformanceRunner.cpp \
 Classes/PhysicsTest/PhysicsTest.cpp \
 Classes/ReleasePoolTest/ReleasePoolTest.cpp \
 Classes/RenderTextureTest/RenderTextureTest.cpp \
@@ -659,13 +659,13 @@ void RawStencilBufferTest::draw(Renderer *renderer, const kmMat4 &transform, boo
 
 void RawStencilBufferTest::onEnableStencil()
 {
-    glEnable(GL_STENCIL_TEST);
+    GL::enable(GL_STENCIL_TEST);
     CHECK_GL_ERROR_DEBUG();
 }
 
 void RawStencilBufferTest::onDisableStencil()
 {
-    glDisable(GL_STENCIL_TEST);
+    GL::disable(GL_STENCIL_TEST);
     CHECK_GL_ERROR_DEBUG();
 }
 
@@ -687,19 +687,19 @@ void RawStencilBufferTest::onBeforeDrawSprite(int planeIndex, const Point& pt)
 void RawStencilBufferTest::setupStencilForClippingOnPlane(GLint plane)
 {
     GLint planeMask = 0x1 << plane;
-    glStencilMask(planeMask);
+    GL::stencilMask(planeMask);
     glClearStencil(0x0);
     glClear(GL_STENCIL_BUFFER_BIT);
     glFlush();
-    glStencilFunc(GL_NEVER, planeMask, planeMask);
-    glStencilOp(GL_REPLACE, GL_KEEP, GL_KEEP);
+    GL::stencilFunc(GL_NEVER, planeMask, planeMask);
+    GL::stencilOp(GL_REPLACE, GL_KEEP, GL_KEEP);
 }
 
 void RawStencilBufferTest::setupStencilForDrawingOnPlane(GLint plane)
 {
     GLint planeMask = 0x1 << plane;
-    glStencilFunc(GL_EQUAL, planeMask, planeMask);
-    glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+    GL::stencilFunc(GL_EQUAL, planeMask, planeMask);
+    GL::stencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
 }
 
 //@implementation RawStencilBufferTest2
@@ -712,12 +712,12 @@ std::string RawStencilBufferTest2::subtitle() const
 void RawStencilBufferTest2::setupStencilForClippingOnPlane(GLint plane)
 {
     RawStencilBufferTest::setupStencilForClippingOnPlane(plane);
-    glDepthMask(GL_FALSE);
+    GL::depthMask(GL_FALSE);
 }
 
 void RawStencilBufferTest2::setupStencilForDrawingOnPlane(GLint plane)
 {
-    glDepthMask(GL_TRUE);
+    GL::depthMask(GL_TRUE);
     RawStencilBufferTest::setupStencilForDrawingOnPlane(plane);
 }
 
@@ -731,13 +731,13 @@ std::string RawStencilBufferTest3::subtitle() const
 void RawStencilBufferTest3::setupStencilForClippingOnPlane(GLint plane)
 {
     RawStencilBufferTest::setupStencilForClippingOnPlane(plane);
-    glDisable(GL_DEPTH_TEST);
-    glDepthMask(GL_FALSE);
+    GL::disable(GL_DEPTH_TEST);
+    GL::depthMask(GL_FALSE);
 }
 
 void RawStencilBufferTest3::setupStencilForDrawingOnPlane(GLint plane)
 {
-    glDepthMask(GL_TRUE);
+    GL::depthMask(GL_TRUE);
     //glEnable(GL_DEPTH_TEST);
     RawStencilBufferTest::setupStencilForDrawingOnPlane(plane);
 }
@@ -761,7 +761,7 @@ std::string RawStencilBufferTest4::subtitle() const
 void RawStencilBufferTest4::setupStencilForClippingOnPlane(GLint plane)
 {
     RawStencilBufferTest::setupStencilForClippingOnPlane(plane);
-    glDepthMask(GL_FALSE);
+    GL::depthMask(GL_FALSE);
 
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
     glEnable(GL_ALPHA_TEST);
@@ -779,7 +779,7 @@ void RawStencilBufferTest4::setupStencilForDrawingOnPlane(GLint plane)
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
     glDisable(GL_ALPHA_TEST);
 #endif
-    glDepthMask(GL_TRUE);
+    GL::depthMask(GL_TRUE);
     RawStencilBufferTest::setupStencilForDrawingOnPlane(plane);
 }
 
@@ -793,8 +793,8 @@ std::string RawStencilBufferTest5::subtitle() const
 void RawStencilBufferTest5::setupStencilForClippingOnPlane(GLint plane)
 {
     RawStencilBufferTest::setupStencilForClippingOnPlane(plane);
-    glDisable(GL_DEPTH_TEST);
-    glDepthMask(GL_FALSE);
+    GL::disable(GL_DEPTH_TEST);
+    GL::depthMask(GL_FALSE);
 
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
     glEnable(GL_ALPHA_TEST);
@@ -812,7 +812,7 @@ void RawStencilBufferTest5::setupStencilForDrawingOnPlane(GLint plane)
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
     glDisable(GL_ALPHA_TEST);
 #endif
-    glDepthMask(GL_TRUE);
+    GL::depthMask(GL_TRUE);
     //glEnable(GL_DEPTH_TEST);
     RawStencilBufferTest::setupStencilForDrawingOnPlane(plane);
 }
@@ -831,7 +831,7 @@ void RawStencilBufferTest6::setup()
     auto winPoint = Point(Director::getInstance()->getWinSize());
     //by default, glReadPixels will pack data with 4 bytes allignment
     unsigned char bits[4] = {0,0,0,0};
-    glStencilMask(~0);
+    GL::stencilMask(~0);
     glClearStencil(0);
     glClear(GL_STENCIL_BUFFER_BIT);
     glFlush();
@@ -839,7 +839,7 @@ void RawStencilBufferTest6::setup()
     auto clearToZeroLabel = Label::createWithTTF(String::createWithFormat("00=%02x", bits[0])->getCString(), "fonts/arial.ttf", 20);
     clearToZeroLabel->setPosition( Point((winPoint.x / 3) * 1, winPoint.y - 10) );
     this->addChild(clearToZeroLabel);
-    glStencilMask(0x0F);
+    GL::stencilMask(0x0F);
     glClearStencil(0xAA);
     glClear(GL_STENCIL_BUFFER_BIT);
     glFlush();
@@ -848,20 +848,20 @@ void RawStencilBufferTest6::setup()
     clearToMaskLabel->setPosition( Point((winPoint.x / 3) * 2, winPoint.y - 10) );
     this->addChild(clearToMaskLabel);
 #endif
-    glStencilMask(~0);
+    GL::stencilMask(~0);
 }
 
 void RawStencilBufferTest6::setupStencilForClippingOnPlane(GLint plane)
 {
     GLint planeMask = 0x1 << plane;
-    glStencilMask(planeMask);
-    glStencilFunc(GL_NEVER, 0, planeMask);
-    glStencilOp(GL_REPLACE, GL_KEEP, GL_KEEP);
+    GL::stencilMask(planeMask);
+    GL::stencilFunc(GL_NEVER, 0, planeMask);
+    GL::stencilOp(GL_REPLACE, GL_KEEP, GL_KEEP);
     DrawPrimitives::drawSolidRect(Point::ZERO, Point(Director::getInstance()->getWinSize()), Color4F(1, 1, 1, 1));
-    glStencilFunc(GL_NEVER, planeMask, planeMask);
-    glStencilOp(GL_REPLACE, GL_KEEP, GL_KEEP);
-    glDisable(GL_DEPTH_TEST);
-    glDepthMask(GL_FALSE);
+    GL::stencilFunc(GL_NEVER, planeMask, planeMask);
+    GL::stencilOp(GL_REPLACE, GL_KEEP, GL_KEEP);
+    GL::disable(GL_DEPTH_TEST);
+    GL::depthMask(GL_FALSE);
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
     glEnable(GL_ALPHA_TEST);
     glAlphaFunc(GL_GREATER, _alphaThreshold);
@@ -879,7 +879,7 @@ void RawStencilBufferTest6::setupStencilForDrawingOnPlane(GLint plane)
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
     glDisable(GL_ALPHA_TEST);
 #endif
-    glDepthMask(GL_TRUE);
+    GL::depthMask(GL_TRUE);
     //glEnable(GL_DEPTH_TEST);
     RawStencilBufferTest::setupStencilForDrawingOnPlane(plane);
     glFlush();
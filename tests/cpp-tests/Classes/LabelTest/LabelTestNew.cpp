@@ -78,7 +78,8 @@ static std::function<Layer*()> createFunctions[] =
     CL(LabelTTFOldNew),
     CL(LabelFontNameTest),
     CL(LabelAlignmentTest),
-    CL(LabelIssue4428Test)
+    CL(LabelIssue4428Test),
+    CL(LabelTransformTest)
 };
 
 #define MAX_LAYER    (sizeof(createFunctions) / sizeof(createFunctions[0]))
@@ -1759,3 +1760,51 @@ std::string LabelIssue4428Test::subtitle() const
 {
     return "Reorder issue #4428.The label should be flipped vertically.";
 }
+
+LabelTransformTest::LabelTransformTest()
+{
+    auto size = Director::getInstance()->getWinSize();
+
+    // The labels and their reference sprites share a translated and scaled parent,
+    // so a label drawn with the wrong transform moves away from its sprite.
+    auto container = Node::create();
+    container->setPosition(Point(size.width * 0.2f, size.height * 0.15f));
+    container->setScale(1.5f);
+    addChild(container);
+
+    TTFConfig ttfConfig("fonts/arial.ttf", 16);
+    TTFConfig distanceFieldConfig("fonts/arial.ttf", 16, GlyphCollection::DYNAMIC, nullptr, true);
+
+    Label* labels[5];
+    labels[0] = Label::createWithTTF(ttfConfig, "TTF");
+    labels[1] = Label::createWithTTF(ttfConfig, "TTF outline");
+    labels[1]->enableOutline(Color4B::BLUE, 1);
+    labels[2] = Label::createWithTTF(distanceFieldConfig, "TTF distance field");
+    labels[3] = Label::createWithTTF(ttfConfig, "TTF shadow");
+    labels[3]->enableShadow(Color4B::RED);
+    labels[4] = Label::createWithBMFont("fonts/bitmapFontTest3.fnt", "FNT");
+
+    for (int i = 0; i < 5; ++i)
+    {
+        auto position = Point(0, 30.0f * i);
+
+        auto sprite = Sprite::create("Images/r1.png");
+        sprite->setAnchorPoint(Point::ANCHOR_MIDDLE_RIGHT);
+        sprite->setPosition(position);
+        container->addChild(sprite);
+
+        labels[i]->setAnchorPoint(Point::ANCHOR_MIDDLE_LEFT);
+        labels[i]->setPosition(position);
+        container->addChild(labels[i]);
+    }
+}
+
+std::string LabelTransformTest::title() const
+{
+    return "New Label + transform";
+}
+
+std::string LabelTransformTest::subtitle() const
+{
+    return "Each label should start right after its sprite";
+}
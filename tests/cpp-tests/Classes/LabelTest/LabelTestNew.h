@@ -496,6 +496,17 @@ public:
     virtual std::string subtitle() const override;
 };
 
+class LabelTransformTest : public AtlasDemoNew
+{
+public:
+    CREATE_FUNC(LabelTransformTest);
+
+    LabelTransformTest();
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
 // we don't support linebreak mode
 
 #endif
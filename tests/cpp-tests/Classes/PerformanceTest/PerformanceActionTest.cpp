@@ -0,0 +1,290 @@
+//
+//  PerformanceActionTest.cpp
+//
+
+#include "PerformanceActionTest.h"
+
+#include <chrono>
+
+static std::function<PerformanceActionScene*()> createFunctions[] =
+{
+    CL(ActionTweenPerfTest),
+    CL(ActionSteppedTweenPerfTest),
+    CL(ActionClonePerfTest),
+    CL(ActionTemplatePerfTest),
+};
+
+#define MAX_LAYER    (sizeof(createFunctions) / sizeof(createFunctions[0]))
+
+
+static int g_curCase = 0;
+
+////////////////////////////////////////////////////////
+//
+// ActionBasicLayer
+//
+////////////////////////////////////////////////////////
+
+ActionBasicLayer::ActionBasicLayer(bool bControlMenuVisible, int nMaxCases, int nCurCase)
+: PerformBasicLayer(bControlMenuVisible, nMaxCases, nCurCase)
+{
+}
+
+void ActionBasicLayer::showCurrentTest()
+{
+    auto scene = createFunctions[_curCase]();
+    
+    g_curCase = _curCase;
+    
+    if (scene)
+    {
+        Director::getInstance()->replaceScene(scene);
+    }
+}
+
+////////////////////////////////////////////////////////
+//
+// PerformanceActionScene
+//
+////////////////////////////////////////////////////////
+
+PerformanceActionScene::PerformanceActionScene()
+: _testActionManager(nullptr)
+, _timeLabel(nullptr)
+, _totalTime(0)
+, _createTime(0)
+, _frames(0)
+{
+}
+
+PerformanceActionScene::~PerformanceActionScene()
+{
+    CC_SAFE_RELEASE(_testActionManager);
+}
+
+void PerformanceActionScene::onEnter()
+{
+    Scene::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+    
+    auto menuLayer = new ActionBasicLayer(true, MAX_LAYER, g_curCase);
+    addChild(menuLayer);
+    menuLayer->release();
+    
+    // Title
+    auto label = Label::createWithTTF(title().c_str(), "fonts/arial.ttf", 32);
+    addChild(label, 1);
+    label->setPosition(Point(s.width/2, s.height-50));
+    
+    // Subtitle
+    std::string strSubTitle = subtitle();
+    if(strSubTitle.length())
+    {
+        auto l = Label::createWithTTF(strSubTitle.c_str(), "fonts/Thonburi.ttf", 16);
+        addChild(l, 1);
+        l->setPosition(Point(s.width/2, s.height-80));
+    }
+
+    _timeLabel = Label::createWithTTF("", "fonts/arial.ttf", 24);
+    addChild(_timeLabel, 1);
+    _timeLabel->setPosition(Point(s.width/2, s.height/2));
+
+    _testActionManager = new ActionManager();
+    for (int i = 0; i < NODE_COUNT; ++i)
+    {
+        auto sprite = Sprite::create("Images/grossini_dance_01.png");
+        sprite->setActionManager(_testActionManager);
+        sprite->setPosition(Point(CCRANDOM_0_1() * s.width, CCRANDOM_0_1() * s.height));
+        addChild(sprite);
+        _nodes.pushBack(sprite);
+    }
+
+    _totalTime = 0;
+    _createTime = 0;
+    _frames = 0;
+    
+    getScheduler()->schedule(schedule_selector(PerformanceActionScene::onUpdate), this, 0.0f, false);
+    getScheduler()->schedule(schedule_selector(PerformanceActionScene::dumpActionTime), this, 2, false);
+}
+
+void PerformanceActionScene::onExit()
+{
+    _testActionManager->removeAllActions();
+    
+    Scene::onExit();
+}
+
+std::string PerformanceActionScene::title() const
+{
+    return "No title";
+}
+
+std::string PerformanceActionScene::subtitle() const
+{
+    return "Time of the new actions and of ActionManager::update, see console";
+}
+
+void PerformanceActionScene::onUpdate(float dt)
+{
+    auto begin = std::chrono::high_resolution_clock::now();
+    for (const auto &node : _nodes)
+    {
+        if (_testActionManager->getNumberOfRunningActionsInTarget(node) == 0)
+        {
+            node->runAction(createAction(node));
+        }
+    }
+    auto created = std::chrono::high_resolution_clock::now();
+    _testActionManager->update(dt);
+    auto end = std::chrono::high_resolution_clock::now();
+    
+    _createTime += std::chrono::duration_cast<std::chrono::duration<double, std::micro>>(created - begin).count();
+    _totalTime += std::chrono::duration_cast<std::chrono::duration<double, std::micro>>(end - created).count();
+    ++_frames;
+}
+
+void PerformanceActionScene::dumpActionTime(float dt)
+{
+    if (_frames == 0)
+        return;
+    
+    auto microseconds = _totalTime / _frames;
+    auto createMicroseconds = _createTime / _frames;
+    log("%s: %.1f us per frame for %d nodes, %.1f us to create the actions", title().c_str(), microseconds, NODE_COUNT, createMicroseconds);
+    _timeLabel->setString(StringUtils::format("%.1f us per frame\ncreate: %.1f us", microseconds, createMicroseconds));
+    
+    _totalTime = 0;
+    _createTime = 0;
+    _frames = 0;
+}
+
+ActionInterval* PerformanceActionScene::createTween(Node* node)
+{
+    auto s = Director::getInstance()->getWinSize();
+    float duration = 0.5f + CCRANDOM_0_1() * 2.0f;
+    
+    switch (rand() % 4)
+    {
+        case 0:
+            return EaseInOut::create(MoveTo::create(duration, Point(CCRANDOM_0_1() * s.width, CCRANDOM_0_1() * s.height)), 2.0f);
+        case 1:
+            return EaseSineOut::create(ScaleTo::create(duration, 0.5f + CCRANDOM_0_1()));
+        case 2:
+            return RotateBy::create(duration, 360.0f * CCRANDOM_0_1());
+        default:
+            return FadeTo::create(duration, (GLubyte)(rand() % 256));
+    }
+}
+
+////////////////////////////////////////////////////////
+//
+// ActionTweenPerfTest
+//
+////////////////////////////////////////////////////////
+
+std::string ActionTweenPerfTest::title() const
+{
+    return "Batched tweens";
+}
+
+Action* ActionTweenPerfTest::createAction(Node* node)
+{
+    return createTween(node);
+}
+
+////////////////////////////////////////////////////////
+//
+// ActionSteppedTweenPerfTest
+//
+////////////////////////////////////////////////////////
+
+std::string ActionSteppedTweenPerfTest::title() const
+{
+    return "Tweens in Speed actions";
+}
+
+Action* ActionSteppedTweenPerfTest::createAction(Node* node)
+{
+    return Speed::create(createTween(node), 1.0f);
+}
+
+////////////////////////////////////////////////////////
+//
+// ActionClonePerfTest
+//
+////////////////////////////////////////////////////////
+
+ActionClonePerfTest::ActionClonePerfTest()
+{
+    _prototype = Sequence::create(
+        Spawn::create(EaseOut::create(ScaleTo::create(0.1f, 1.3f), 2.0f), TintTo::create(0.05f, 255, 0, 0), nullptr),
+        Spawn::create(EaseBounceOut::create(ScaleTo::create(0.3f, 1.0f)), TintTo::create(0.2f, 255, 255, 255), nullptr),
+        MoveBy::create(0.1f, Point(8, 0)),
+        MoveBy::create(0.1f, Point(-8, 0)),
+        nullptr);
+    _prototype->retain();
+}
+
+ActionClonePerfTest::~ActionClonePerfTest()
+{
+    _prototype->release();
+}
+
+std::string ActionClonePerfTest::title() const
+{
+    return "Hit effects cloned";
+}
+
+Action* ActionClonePerfTest::createAction(Node* node)
+{
+    return _prototype->clone();
+}
+
+////////////////////////////////////////////////////////
+//
+// ActionTemplatePerfTest
+//
+////////////////////////////////////////////////////////
+
+ActionTemplatePerfTest::ActionTemplatePerfTest()
+{
+    Vector<ActionTemplate*> flash;
+    flash.pushBack(ActionTemplate::ease(ActionTemplate::scaleTo(0.1f, 1.3f), ActionTemplate::Easing::OUT, 2.0f));
+    flash.pushBack(ActionTemplate::tintTo(0.05f, Color3B::RED));
+
+    Vector<ActionTemplate*> settle;
+    settle.pushBack(ActionTemplate::ease(ActionTemplate::scaleTo(0.3f, 1.0f), ActionTemplate::Easing::BOUNCE_OUT));
+    settle.pushBack(ActionTemplate::tintTo(0.2f, Color3B::WHITE));
+
+    Vector<ActionTemplate*> steps;
+    steps.pushBack(ActionTemplate::spawn(flash));
+    steps.pushBack(ActionTemplate::spawn(settle));
+    steps.pushBack(ActionTemplate::moveBy(0.1f, Point(8, 0)));
+    steps.pushBack(ActionTemplate::moveBy(0.1f, Point(-8, 0)));
+
+    _template = ActionTemplate::sequence(steps);
+    _template->retain();
+}
+
+ActionTemplatePerfTest::~ActionTemplatePerfTest()
+{
+    _template->release();
+}
+
+std::string ActionTemplatePerfTest::title() const
+{
+    return "Hit effects from a template";
+}
+
+Action* ActionTemplatePerfTest::createAction(Node* node)
+{
+    return _template->instantiate();
+}
+
+void runActionPerformanceTest()
+{
+    auto scene = createFunctions[g_curCase]();
+    
+    Director::getInstance()->replaceScene(scene);
+}
@@ -0,0 +1,102 @@
+//
+//  PerformanceActionTest.h
+
+#ifndef __PERFORMANCE_ACTION_TEST_H__
+#define __PERFORMANCE_ACTION_TEST_H__
+
+#include "PerformanceTest.h"
+
+class ActionBasicLayer : public PerformBasicLayer
+{
+public:
+    ActionBasicLayer(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0);
+    
+    virtual void showCurrentTest();
+};
+
+// The actions are run by an action manager of the test, which is updated once per frame
+class PerformanceActionScene : public Scene
+{
+public:
+    PerformanceActionScene();
+    virtual ~PerformanceActionScene();
+
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string title() const;
+    virtual std::string subtitle() const;
+
+    // creates the action run by a node when its previous one is done
+    virtual Action* createAction(Node* node) = 0;
+    void onUpdate(float dt);
+
+    void dumpActionTime(float dt);
+    
+    static const int NODE_COUNT = 2000;
+
+protected:
+    ActionInterval* createTween(Node* node);
+
+    ActionManager* _testActionManager;
+    Vector<Node*> _nodes;
+    Label* _timeLabel;
+    double _totalTime;
+    double _createTime;
+    int _frames;
+};
+
+// eased tweens, updated by the tween pools of the action manager
+class ActionTweenPerfTest : public PerformanceActionScene
+{
+public:
+    CREATE_FUNC(ActionTweenPerfTest);
+    
+    virtual std::string title() const override;
+    virtual Action* createAction(Node* node) override;
+};
+
+// the same tweens inside a Speed action, stepped one by one
+class ActionSteppedTweenPerfTest : public PerformanceActionScene
+{
+public:
+    CREATE_FUNC(ActionSteppedTweenPerfTest);
+    
+    virtual std::string title() const override;
+    virtual Action* createAction(Node* node) override;
+};
+
+// short hit effects, cloned from a prototype sequence
+class ActionClonePerfTest : public PerformanceActionScene
+{
+public:
+    CREATE_FUNC(ActionClonePerfTest);
+
+    ActionClonePerfTest();
+    virtual ~ActionClonePerfTest();
+
+    virtual std::string title() const override;
+    virtual Action* createAction(Node* node) override;
+
+protected:
+    Action* _prototype;
+};
+
+// the same hit effects, instantiated from an ActionTemplate
+class ActionTemplatePerfTest : public PerformanceActionScene
+{
+public:
+    CREATE_FUNC(ActionTemplatePerfTest);
+
+    ActionTemplatePerfTest();
+    virtual ~ActionTemplatePerfTest();
+
+    virtual std::string title() const override;
+    virtual Action* createAction(Node* node) override;
+
+protected:
+    ActionTemplate* _template;
+};
+
+void runActionPerformanceTest();
+
+#endif /* __PERFORMANCE_ACTION_TEST_H__ */
@@ -311,6 +311,52 @@ const char*  PerformanceEventDispatcherScene::testName()
 
 void TouchEventDispatchingPerfTest::generateTestFunctions()
 {
+    // Lays out the touchable nodes in a grid of cells, like an inventory, and sends 4 touches somewhere in the window
+    auto dispatchToGrid = [this](EventListenerTouchOneByOne* listener){
+        auto dispatcher = Director::getInstance()->getEventDispatcher();
+        Size size = Director::getInstance()->getWinSize();
+        if (_quantityOfNodes != _lastRenderedCount)
+        {
+            int columns = std::max(1, (int)sqrtf(_quantityOfNodes * size.width / size.height));
+            int rows = (_quantityOfNodes + columns - 1) / columns;
+            Size cellSize(size.width / columns, size.height / rows);
+
+            for (int i = 0; i < this->_quantityOfNodes; ++i)
+            {
+                auto node = Node::create();
+                node->setTag(1000 + i);
+                node->setContentSize(cellSize);
+                node->setPosition(Point((i % columns) * cellSize.width, (i / columns) * cellSize.height));
+                this->addChild(node);
+                this->_nodes.push_back(node);
+                dispatcher->addEventListenerWithSceneGraphPriority(listener->clone(), node);
+            }
+
+            _lastRenderedCount = _quantityOfNodes;
+        }
+
+        EventTouch touchEvent;
+        touchEvent.setEventCode(EventTouch::EventCode::BEGAN);
+        std::vector<Touch*> touches;
+
+        for (int i = 0; i < 4; ++i)
+        {
+            Touch* touch = new Touch();
+            touch->autorelease();
+            touch->setTouchInfo(i, rand() % (int)size.width, rand() % (int)size.height);
+            touches.push_back(touch);
+        }
+        touchEvent.setTouches(touches);
+
+        CC_PROFILER_START(this->profilerName());
+        dispatcher->dispatchEvent(&touchEvent);
+        CC_PROFILER_STOP(this->profilerName());
+
+        // releases the claimed touches
+        touchEvent.setEventCode(EventTouch::EventCode::CANCELLED);
+        dispatcher->dispatchEvent(&touchEvent);
+    };
+
     TestFunction testFunctions[] = {
         { "OneByOne-scenegraph",    [=](){
             auto dispatcher = Director::getInstance()->getEventDispatcher();
@@ -356,6 +402,34 @@ void TouchEventDispatchingPerfTest::generateTestFunctions()
             CC_PROFILER_STOP(this->profilerName());
         } } ,
         
+        { "OneByOne-grid-bounds",    [=](){
+            auto listener = EventListenerTouchOneByOne::create();
+            listener->onTouchBegan = [](Touch* touch, Event* event){
+                auto target = event->getCurrentTarget();
+                Point locationInNode = target->convertToNodeSpace(touch->getLocation());
+                Size s = target->getContentSize();
+                return Rect(0, 0, s.width, s.height).containsPoint(locationInNode);
+            };
+            listener->onTouchMoved = [](Touch* touch, Event* event){};
+            listener->onTouchEnded = [](Touch* touch, Event* event){};
+            listener->onTouchCancelled = [](Touch* touch, Event* event){};
+
+            dispatchToGrid(listener);
+        } } ,
+
+        { "OneByOne-grid-hittest",    [=](){
+            auto listener = EventListenerTouchOneByOne::create();
+            listener->setHitTestEnabled(true);
+            listener->onTouchBegan = [](Touch* touch, Event* event){
+                return true;
+            };
+            listener->onTouchMoved = [](Touch* touch, Event* event){};
+            listener->onTouchEnded = [](Touch* touch, Event* event){};
+            listener->onTouchCancelled = [](Touch* touch, Event* event){};
+
+            dispatchToGrid(listener);
+        } } ,
+
         { "OneByOne-fixed",    [=](){
             auto dispatcher = Director::getInstance()->getEventDispatcher();
             if (_quantityOfNodes != _lastRenderedCount)
@@ -741,6 +815,29 @@ void CustomEventDispatchingPerfTest::generateTestFunctions()
             dispatcher->dispatchEvent(&event);
             CC_PROFILER_STOP(this->profilerName());
         } } ,
+        { "custom-scenegraph-key",    [=](){
+            auto dispatcher = Director::getInstance()->getEventDispatcher();
+            static const EventListener::ListenerKey eventKey = EventListener::internListenerID("custom_event_test_key");
+            if (_quantityOfNodes != _lastRenderedCount)
+            {
+                auto listener = EventListenerCustom::create("custom_event_test_key", [](EventCustom* event){});
+                
+                for (int i = 0; i < this->_quantityOfNodes; ++i)
+                {
+                    auto node = Node::create();
+                    node->setTag(1000 + i);
+                    this->addChild(node);
+                    this->_nodes.push_back(node);
+                    dispatcher->addEventListenerWithSceneGraphPriority(listener->clone(), node);
+                }
+                
+                _lastRenderedCount = _quantityOfNodes;
+            }
+            
+            CC_PROFILER_START(this->profilerName());
+            dispatcher->dispatchCustomEvent(eventKey);
+            CC_PROFILER_STOP(this->profilerName());
+        } } ,
         { "custom-fixed",    [=](){
             auto dispatcher = Director::getInstance()->getEventDispatcher();
             if (_quantityOfNodes != _lastRenderedCount)
@@ -4,7 +4,7 @@ enum {
     kMaxNodes = 200,
     kNodesIncrease = 10,
 
-    TEST_COUNT = 5,
+    TEST_COUNT = 7,
 };
 
 enum {
@@ -19,7 +19,9 @@ enum {
     kCaseLabelBMFontUpdate,
     kCaseLabelUpdate,
     kCaseLabelBMFontBigLabels,
-    kCaseLabelBigLabels
+    kCaseLabelBigLabels,
+    kCaseLabelScoreUpdate,
+    kCaseLabelBMFontScoreUpdate
 };
 
 #define LongSentencesExample "Lorem ipsum dolor sit amet, consectetur adipisicing elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua.\
@@ -158,6 +160,10 @@ std::string LabelMainScene::title() const
         return "Testing LabelBMFont Big Labels";
     case kCaseLabelBigLabels:
         return "Testing Label Big Labels";
+    case kCaseLabelScoreUpdate:
+        return "Testing Label Score Update";
+    case kCaseLabelBMFontScoreUpdate:
+        return "Testing LabelBMFont Score Update";
     default:
         break;
     }
@@ -247,6 +253,29 @@ void LabelMainScene::onIncrease(Ref* sender)
             }
             break;
         }        
+    case kCaseLabelScoreUpdate:
+        {
+            TTFConfig ttfConfig("fonts/arial.ttf", 30, GlyphCollection::DYNAMIC);
+            for( int i=0;i< kNodesIncrease;i++)
+            {
+                auto label = Label::createWithTTF(ttfConfig, "Score: 0", TextHAlignment::LEFT);
+                label->setPosition(Point((size.width/2 + rand() % 50), ((int)size.height/2 + rand() % 50)));
+                _labelContainer->addChild(label, 1, _quantityNodes);
+
+                _quantityNodes++;
+            }
+            break;
+        }
+    case kCaseLabelBMFontScoreUpdate:
+        for( int i=0;i< kNodesIncrease;i++)
+        {
+            auto label = Label::createWithBMFont("fonts/bitmapFontTest3.fnt", "Score: 0");
+            label->setPosition(Point((size.width/2 + rand() % 50), ((int)size.height/2 + rand() % 50)));
+            _labelContainer->addChild(label, 1, _quantityNodes);
+
+            _quantityNodes++;
+        }
+        break;
     default:
         break;
     }
@@ -310,12 +339,20 @@ void LabelMainScene::updateAutoTest(float dt)
 
 void LabelMainScene::updateText(float dt)
 {
-    if(_s_labelCurCase > kCaseLabelUpdate)
+    if(_s_labelCurCase > kCaseLabelUpdate && _s_labelCurCase < kCaseLabelScoreUpdate)
         return;
 
     _accumulativeTime += dt;
-    char text[20];
-    sprintf(text,"%.2f",_accumulativeTime);
+    char text[40];
+    if (_s_labelCurCase >= kCaseLabelScoreUpdate)
+    {
+        // only the last digits change from one frame to the next one
+        sprintf(text,"Score: %d",(int)(_accumulativeTime * 1000));
+    }
+    else
+    {
+        sprintf(text,"%.2f",_accumulativeTime);
+    }
 
     auto& children = _labelContainer->getChildren();
     
@@ -334,6 +371,8 @@ void LabelMainScene::updateText(float dt)
         }
         break;
     case kCaseLabelUpdate:
+    case kCaseLabelScoreUpdate:
+    case kCaseLabelBMFontScoreUpdate:
         for(const auto &child : children) {
             Label* label = (Label*)child;
             label->setString(text);
@@ -48,7 +48,7 @@ public:
 
 private:
     static const  int MAX_AUTO_TEST_TIMES  = 35;
-    static const  int MAX_SUB_TEST_NUMS    = 5;
+    static const  int MAX_SUB_TEST_NUMS    = 7;
     
 
     void  dumpProfilerFPS();
@@ -46,6 +46,7 @@ static std::function<NodeChildrenMainScene*()> createFunctions[] =
     CL(SortAllChildrenSpriteSheet),
 
     CL(VisitSceneGraph),
+    CL(VisitDeepSceneGraph),
 };
 
 #define MAX_LAYER    (sizeof(createFunctions) / sizeof(createFunctions[0]))
@@ -968,6 +969,70 @@ const char*  VisitSceneGraph::testName()
     return "visit()";
 }
 
+////////////////////////////////////////////////////////
+//
+// VisitDeepSceneGraph
+//
+////////////////////////////////////////////////////////
+void VisitDeepSceneGraph::initWithQuantityOfNodes(unsigned int nodes)
+{
+    _root = Node::create();
+    addChild(_root);
+
+    NodeChildrenMainScene::initWithQuantityOfNodes(nodes);
+    scheduleUpdate();
+}
+
+void VisitDeepSceneGraph::updateQuantityOfNodes()
+{
+    // rebuild the hierarchy: chains of CHAIN_DEPTH nested nodes
+    _root->removeAllChildren();
+
+    Node* parent = nullptr;
+    for(int i = 0; i < quantityOfNodes; i++)
+    {
+        auto node = Node::create();
+        node->setPosition(Point(1, 1));
+        node->setScale(0.99f);
+        node->setRotation(1);
+
+        if (i % CHAIN_DEPTH == 0)
+            _root->addChild(node);
+        else
+            parent->addChild(node);
+        parent = node;
+    }
+
+    currentQuantityOfNodes = quantityOfNodes;
+}
+
+void VisitDeepSceneGraph::update(float dt)
+{
+    // moving the root dirties every transform below it
+    _root->setRotation(_root->getRotation() + 1);
+
+    CC_PROFILER_START( this->profilerName() );
+    this->visit();
+    CC_PROFILER_STOP( this->profilerName() );
+
+    Director::getInstance()->getRenderer()->clean();
+}
+
+std::string VisitDeepSceneGraph::title() const
+{
+    return "Visiting a dirty deep scene graph";
+}
+
+std::string VisitDeepSceneGraph::subtitle() const
+{
+    return "re-multiplies every transform. See console";
+}
+
+const char*  VisitDeepSceneGraph::testName()
+{
+    return "visit() dirty";
+}
+
 ///----------------------------------------
 void runNodeChildrenTest()
 {
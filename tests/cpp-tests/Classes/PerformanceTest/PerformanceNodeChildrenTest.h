@@ -227,6 +227,27 @@ public:
     virtual const char* testName() override;
 };
 
+class VisitDeepSceneGraph : public NodeChildrenMainScene
+{
+public:
+    static const int CHAIN_DEPTH = 10;
+
+    CREATE_FUNC(VisitDeepSceneGraph);
+
+    VisitDeepSceneGraph() : _root(nullptr) {}
+
+    void initWithQuantityOfNodes(unsigned int nodes) override;
+
+    virtual void update(float dt) override;
+    void updateQuantityOfNodes() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual const char* testName() override;
+
+protected:
+    Node* _root;
+};
+
 void runNodeChildrenTest();
 
 #endif // __PERFORMANCE_NODE_CHILDREN_TEST_H__
@@ -17,6 +17,7 @@ enum {
 };
 
 static int s_nParCurIdx = 0;
+static bool s_parallelUpdate = false;
 
 ////////////////////////////////////////////////////////
 //
@@ -103,6 +104,18 @@ void ParticleMainScene::initWithSubTest(int asubtest, int particles)
     menu->setPosition(Point(s.width/2, s.height/2+15));
     addChild(menu, 1);
 
+    // updates the particles on the worker threads of the ThreadPool
+    MenuItemFont::setFontSize(24);
+    auto parallel = MenuItemToggle::createWithCallback([&](Ref *sender) {
+        s_parallelUpdate = static_cast<MenuItemToggle*>(sender)->getSelectedIndex() == 1;
+        auto emitter = static_cast<ParticleSystem*>(getChildByTag(kTagParticleSystem));
+        emitter->setParallelUpdateEnabled(s_parallelUpdate);
+    }, MenuItemFont::create("Threads: off"), MenuItemFont::create("Threads: on"), NULL);
+    parallel->setSelectedIndex(s_parallelUpdate ? 1 : 0);
+    auto parallelMenu = Menu::create(parallel, NULL);
+    parallelMenu->setPosition(Point(s.width/2, s.height/2-40));
+    addChild(parallelMenu, 1);
+
     auto infoLabel = Label::createWithTTF("0 nodes", "fonts/Marker Felt.ttf", 30);
     infoLabel->setColor(Color3B(0,200,20));
     infoLabel->setPosition(Point(s.width/2, s.height - 90));
@@ -238,6 +251,7 @@ void ParticleMainScene::createParticleSystem()
         CCLOG("Shall not happen!");
         break;
     }
+    particleSystem->setParallelUpdateEnabled(s_parallelUpdate);
     addChild(particleSystem, 0, kTagParticleSystem);
 
     doTest();
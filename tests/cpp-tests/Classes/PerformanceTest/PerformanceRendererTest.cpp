@@ -9,9 +9,25 @@
 #include "PerformanceRendererTest.h"
 #include "PerformanceTextureTest.h"
 #include "../testResource.h"
+#include "renderer/CCQuadTransform.h"
 
-RenderTestLayer::RenderTestLayer()
-: PerformBasicLayer(true, 1, 1)
+#include <chrono>
+
+static std::function<RenderTestLayer*(int)> createFunctions[] =
+{
+    [](int curCase) { return new RenderTMXTestLayer(curCase); },
+    [](int curCase) { return new RenderStreamingTestLayer(curCase); },
+    [](int curCase) { return new RenderTransformBenchmarkLayer(curCase); },
+    [](int curCase) { return new RenderMaterialSortTestLayer(curCase); },
+    [](int curCase) { return new RenderParallelVisitTestLayer(curCase); },
+    [](int curCase) { return new RenderSpatialCullingTestLayer(curCase); },
+    [](int curCase) { return new RenderCommandPoolTestLayer(curCase); },
+};
+
+#define MAX_LAYER    (sizeof(createFunctions) / sizeof(createFunctions[0]))
+
+RenderTestLayer::RenderTestLayer(int nCurCase)
+: PerformBasicLayer(true, MAX_LAYER, nCurCase)
 {
 }
 
@@ -19,10 +35,10 @@ RenderTestLayer::~RenderTestLayer()
 {
 }
 
-Scene* RenderTestLayer::scene()
+Scene* RenderTestLayer::scene(int nCurCase)
 {
     auto scene = Scene::create();
-    RenderTestLayer *layer = new RenderTestLayer();
+    RenderTestLayer *layer = createFunctions[nCurCase](nCurCase);
     scene->addChild(layer);
     layer->release();
     
@@ -32,6 +48,46 @@ Scene* RenderTestLayer::scene()
 void RenderTestLayer::onEnter()
 {
     PerformBasicLayer::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+
+    auto label = Label::createWithTTF(title().c_str(), "fonts/arial.ttf", 32);
+    addChild(label, 1);
+    label->setPosition(Point(s.width/2, s.height-50));
+
+    std::string strSubTitle = subtitle();
+    if(strSubTitle.length())
+    {
+        auto l = Label::createWithTTF(strSubTitle.c_str(), "fonts/Thonburi.ttf", 16);
+        addChild(l, 1);
+        l->setPosition(Point(s.width/2, s.height-80));
+    }
+}
+
+void RenderTestLayer::showCurrentTest()
+{
+    Director::getInstance()->replaceScene(RenderTestLayer::scene(_curCase));
+}
+
+std::string RenderTestLayer::title() const
+{
+    return "No title";
+}
+
+std::string RenderTestLayer::subtitle() const
+{
+    return "";
+}
+
+////////////////////////////////////////////////////////
+//
+// RenderTMXTestLayer
+//
+////////////////////////////////////////////////////////
+
+void RenderTMXTestLayer::onEnter()
+{
+    RenderTestLayer::onEnter();
     auto map = TMXTiledMap::create("TileMaps/map/sl.tmx");
     
     Size CC_UNUSED s = map->getContentSize();
@@ -43,13 +99,481 @@ void RenderTestLayer::onEnter()
     //map->setPosition( Point(-20,-200) );
 }
 
-void RenderTestLayer::showCurrentTest()
+std::string RenderTMXTestLayer::title() const
 {
-    
+    return "TMX map";
+}
+
+////////////////////////////////////////////////////////
+//
+// RenderStreamingTestLayer
+//
+////////////////////////////////////////////////////////
+
+void RenderStreamingTestLayer::onEnter()
+{
+    RenderTestLayer::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+
+    for (int i = 0; i < SPRITE_COUNT; ++i)
+    {
+        auto sprite = Sprite::create(s_pathGrossini);
+        sprite->setPosition(Point(CCRANDOM_0_1() * s.width, CCRANDOM_0_1() * s.height));
+        sprite->setScale(0.2f);
+        sprite->setRotation(CCRANDOM_0_1() * 360);
+        addChild(sprite, -1);
+    }
+
+    _infoLabel = Label::createWithTTF("", "fonts/arial.ttf", 20);
+    _infoLabel->setPosition(Point(s.width/2, s.height/2));
+    addChild(_infoLabel, 1);
+
+    MenuItemFont::setFontSize(24);
+    auto toggle = MenuItemFont::create("Toggle streaming", CC_CALLBACK_1(RenderStreamingTestLayer::onToggleStreaming, this));
+    auto menu = Menu::create(toggle, NULL);
+    menu->setPosition(Point(s.width/2, s.height/2 - 40));
+    addChild(menu, 1);
+
+    _streamingWasEnabled = Director::getInstance()->getRenderer()->isVertexStreamingEnabled();
+    scheduleUpdate();
+}
+
+void RenderStreamingTestLayer::onExit()
+{
+    Director::getInstance()->getRenderer()->setVertexStreamingEnabled(_streamingWasEnabled);
+    RenderTestLayer::onExit();
+}
+
+void RenderStreamingTestLayer::update(float dt)
+{
+    auto renderer = Director::getInstance()->getRenderer();
+
+    // stats are from the previous frame
+    char buffer[128];
+    snprintf(buffer, sizeof(buffer), "streaming: %s - bytes copied per frame: %ld",
+             renderer->isVertexStreamingEnabled() ? "on" : "off",
+             (long)renderer->getCopiedBytes());
+    _infoLabel->setString(buffer);
+}
+
+void RenderStreamingTestLayer::onToggleStreaming(Ref* sender)
+{
+    auto renderer = Director::getInstance()->getRenderer();
+    renderer->setVertexStreamingEnabled(!renderer->isVertexStreamingEnabled());
+}
+
+std::string RenderStreamingTestLayer::title() const
+{
+    return "Vertex streaming";
+}
+
+std::string RenderStreamingTestLayer::subtitle() const
+{
+    return "Quads are written straight into mapped buffers when on";
+}
+
+////////////////////////////////////////////////////////
+//
+// RenderTransformBenchmarkLayer
+//
+////////////////////////////////////////////////////////
+
+void RenderTransformBenchmarkLayer::onEnter()
+{
+    RenderTestLayer::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+
+    _resultLabel = Label::createWithTTF("Running...", "fonts/arial.ttf", 16);
+    _resultLabel->setPosition(Point(s.width/2, s.height/2));
+    addChild(_resultLabel, 1);
+
+    // run it once the scene is on screen, it takes a while
+    scheduleOnce(schedule_selector(RenderTransformBenchmarkLayer::runBenchmark), 0.5f);
+}
+
+void RenderTransformBenchmarkLayer::runBenchmark(float dt)
+{
+    static const int QUAD_COUNTS[] = { 10000, 50000, 100000 };
+    static const int LOOP_COUNT = 20;
+
+    kmMat4 generic, translation, identity;
+    kmMat4RotationZ(&generic, kmDegreesToRadians(30));
+    generic.mat[12] = 100;
+    generic.mat[13] = 50;
+    kmMat4Translation(&translation, 100, 50, 0);
+    kmMat4Identity(&identity);
+
+    std::string result = StringUtils::format("backend: %s\n", getQuadTransformBackendName());
+
+    for (int quadCount : QUAD_COUNTS)
+    {
+        std::vector<V3F_C4B_T2F_Quad> in(quadCount);
+        std::vector<V3F_C4B_T2F_Quad> out(quadCount);
+        for (auto& quad : in)
+        {
+            quad.tl.vertices = Vertex3F(CCRANDOM_0_1() * 100, CCRANDOM_0_1() * 100, 0);
+            quad.bl.vertices = Vertex3F(CCRANDOM_0_1() * 100, CCRANDOM_0_1() * 100, 0);
+            quad.tr.vertices = Vertex3F(CCRANDOM_0_1() * 100, CCRANDOM_0_1() * 100, 0);
+            quad.br.vertices = Vertex3F(CCRANDOM_0_1() * 100, CCRANDOM_0_1() * 100, 0);
+        }
+
+        auto measure = [&](const std::function<void()>& kernel) {
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < LOOP_COUNT; ++i)
+            {
+                kernel();
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / (double)LOOP_COUNT;
+        };
+
+        double scalar = measure([&]() { transformQuadsScalar(in.data(), out.data(), quadCount, generic); });
+        double simd = measure([&]() { transformQuads(in.data(), out.data(), quadCount, generic); });
+        double translated = measure([&]() { transformQuads(in.data(), out.data(), quadCount, translation); });
+        double copied = measure([&]() { transformQuads(in.data(), out.data(), quadCount, identity); });
+
+        auto line = StringUtils::format("%d quads: scalar %.0fus, simd %.0fus, translation %.0fus, identity %.0fus\n",
+                                        quadCount, scalar, simd, translated, copied);
+        log("%s", line.c_str());
+        result += line;
+    }
+
+    _resultLabel->setString(result);
+}
+
+std::string RenderTransformBenchmarkLayer::title() const
+{
+    return "Quad transform benchmark";
+}
+
+std::string RenderTransformBenchmarkLayer::subtitle() const
+{
+    return "Compares the scalar and batched quad transform kernels";
+}
+
+////////////////////////////////////////////////////////
+//
+// RenderMaterialSortTestLayer
+//
+////////////////////////////////////////////////////////
+
+void RenderMaterialSortTestLayer::onEnter()
+{
+    RenderTestLayer::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+
+    // interleave textures with the same global order: every sprite breaks the batch unless sorted by material
+    const char* images[] = { s_pathGrossini, s_pathSister1, s_pathSister2 };
+    for (int i = 0; i < SPRITE_COUNT; ++i)
+    {
+        auto sprite = Sprite::create(images[i % 3]);
+        sprite->setPosition(Point(CCRANDOM_0_1() * s.width, CCRANDOM_0_1() * s.height));
+        sprite->setScale(0.3f);
+        addChild(sprite, -1);
+    }
+
+    _infoLabel = Label::createWithTTF("", "fonts/arial.ttf", 20);
+    _infoLabel->setPosition(Point(s.width/2, s.height/2));
+    addChild(_infoLabel, 1);
+
+    MenuItemFont::setFontSize(24);
+    auto toggle = MenuItemFont::create("Toggle sort mode", CC_CALLBACK_1(RenderMaterialSortTestLayer::onToggleSortMode, this));
+    auto menu = Menu::create(toggle, NULL);
+    menu->setPosition(Point(s.width/2, s.height/2 - 40));
+    addChild(menu, 1);
+
+    scheduleUpdate();
+}
+
+void RenderMaterialSortTestLayer::onExit()
+{
+    Director::getInstance()->getRenderer()->setRenderQueueSortMode(0, RenderQueue::SortMode::GLOBAL_ORDER);
+    RenderTestLayer::onExit();
+}
+
+void RenderMaterialSortTestLayer::update(float dt)
+{
+    auto renderer = Director::getInstance()->getRenderer();
+
+    char buffer[128];
+    snprintf(buffer, sizeof(buffer), "sort by material: %s - draw calls: %ld",
+             _sortByMaterial ? "on" : "off",
+             (long)renderer->getDrawnBatches());
+    _infoLabel->setString(buffer);
+}
+
+void RenderMaterialSortTestLayer::onToggleSortMode(Ref* sender)
+{
+    _sortByMaterial = !_sortByMaterial;
+    Director::getInstance()->getRenderer()->setRenderQueueSortMode(0, _sortByMaterial ? RenderQueue::SortMode::MATERIAL : RenderQueue::SortMode::GLOBAL_ORDER);
+}
+
+std::string RenderMaterialSortTestLayer::title() const
+{
+    return "Sort by material";
+}
+
+std::string RenderMaterialSortTestLayer::subtitle() const
+{
+    return "Sprites with the same Z batch by texture when on";
+}
+
+////////////////////////////////////////////////////////
+//
+// RenderVisitTimeTestLayer
+//
+////////////////////////////////////////////////////////
+
+void RenderVisitTimeTestLayer::onEnter()
+{
+    RenderTestLayer::onEnter();
+
+    _afterUpdateListener = _eventDispatcher->addCustomEventListener(Director::EVENT_AFTER_UPDATE, [this](EventCustom*) {
+        _visitStart = std::chrono::high_resolution_clock::now();
+    });
+    _afterVisitListener = _eventDispatcher->addCustomEventListener(Director::EVENT_AFTER_VISIT, [this](EventCustom*) {
+        auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - _visitStart).count();
+        // smooth the reading, a single frame is too noisy to compare
+        _visitTime = _visitTime * 0.9 + elapsed * 0.1;
+    });
+}
+
+void RenderVisitTimeTestLayer::onExit()
+{
+    _eventDispatcher->removeEventListener(_afterUpdateListener);
+    _eventDispatcher->removeEventListener(_afterVisitListener);
+    RenderTestLayer::onExit();
+}
+
+////////////////////////////////////////////////////////
+//
+// RenderParallelVisitTestLayer
+//
+////////////////////////////////////////////////////////
+
+void RenderParallelVisitTestLayer::onEnter()
+{
+    RenderVisitTimeTestLayer::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+
+    // plain sprites only: subtrees visited in parallel must not use the kmGL stack or group commands
+    _container = Node::create();
+    addChild(_container, -1);
+    for (int g = 0; g < GROUP_COUNT; ++g)
+    {
+        auto group = Node::create();
+        group->setPosition(Point(s.width * (g + 0.5f) / GROUP_COUNT, 0));
+        _container->addChild(group);
+        for (int i = 0; i < SPRITES_PER_GROUP; ++i)
+        {
+            auto sprite = Sprite::create(s_pathGrossini);
+            sprite->setPosition(Point((CCRANDOM_0_1() - 0.5f) * s.width / GROUP_COUNT, CCRANDOM_0_1() * s.height));
+            sprite->setScale(0.2f);
+            sprite->setRotation(CCRANDOM_0_1() * 360);
+            group->addChild(sprite);
+        }
+    }
+
+    _infoLabel = Label::createWithTTF("", "fonts/arial.ttf", 20);
+    _infoLabel->setPosition(Point(s.width/2, s.height/2));
+    addChild(_infoLabel, 1);
+
+    MenuItemFont::setFontSize(24);
+    auto toggle = MenuItemFont::create("Toggle parallel visit", CC_CALLBACK_1(RenderParallelVisitTestLayer::onToggleParallel, this));
+    auto menu = Menu::create(toggle, NULL);
+    menu->setPosition(Point(s.width/2, s.height/2 - 40));
+    addChild(menu, 1);
+
+    scheduleUpdate();
+}
+
+void RenderParallelVisitTestLayer::update(float dt)
+{
+    for (const auto& group : _container->getChildren())
+    {
+        group->setRotation(group->getRotation() + dt * 10);
+    }
+
+    char buffer[128];
+    snprintf(buffer, sizeof(buffer), "parallel visit: %s (%d threads) - visit: %.2f ms",
+             _container->isParallelVisitEnabled() ? "on" : "off",
+             ThreadPool::getInstance()->getThreadCount(),
+             _visitTime);
+    _infoLabel->setString(buffer);
+}
+
+void RenderParallelVisitTestLayer::onToggleParallel(Ref* sender)
+{
+    _container->setParallelVisitEnabled(!_container->isParallelVisitEnabled());
+}
+
+std::string RenderParallelVisitTestLayer::title() const
+{
+    return "Parallel visit";
+}
+
+std::string RenderParallelVisitTestLayer::subtitle() const
+{
+    return "Visits sprite groups on the thread pool when on";
+}
+
+////////////////////////////////////////////////////////
+//
+// RenderSpatialCullingTestLayer
+//
+////////////////////////////////////////////////////////
+
+void RenderSpatialCullingTestLayer::onEnter()
+{
+    RenderVisitTimeTestLayer::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+
+    // a world much wider than the screen, scrolled horizontally
+    _world = Node::create();
+    addChild(_world, -1);
+    for (int i = 0; i < SPRITE_COUNT; ++i)
+    {
+        auto sprite = Sprite::create(s_pathGrossini);
+        sprite->setPosition(Point(CCRANDOM_0_1() * s.width * WORLD_SCREENS, CCRANDOM_0_1() * s.height));
+        sprite->setScale(0.2f);
+        _world->addChild(sprite);
+    }
+
+    _infoLabel = Label::createWithTTF("", "fonts/arial.ttf", 20);
+    _infoLabel->setPosition(Point(s.width/2, s.height/2));
+    addChild(_infoLabel, 1);
+
+    MenuItemFont::setFontSize(24);
+    auto toggle = MenuItemFont::create("Toggle spatial culling", CC_CALLBACK_1(RenderSpatialCullingTestLayer::onToggleCulling, this));
+    auto menu = Menu::create(toggle, NULL);
+    menu->setPosition(Point(s.width/2, s.height/2 - 40));
+    addChild(menu, 1);
+
+    scheduleUpdate();
+}
+
+void RenderSpatialCullingTestLayer::update(float dt)
+{
+    auto s = Director::getInstance()->getWinSize();
+    float worldWidth = s.width * (WORLD_SCREENS - 1);
+    _scroll = fmodf(_scroll + dt * 200, worldWidth);
+    _world->setPositionX(-_scroll);
+
+    char buffer[128];
+    snprintf(buffer, sizeof(buffer), "spatial culling: %s - visit: %.2f ms - draw calls: %ld",
+             _world->isSpatialCullingEnabled() ? "on" : "off",
+             _visitTime,
+             (long)Director::getInstance()->getRenderer()->getDrawnBatches());
+    _infoLabel->setString(buffer);
+}
+
+void RenderSpatialCullingTestLayer::onToggleCulling(Ref* sender)
+{
+    _world->setSpatialCullingEnabled(!_world->isSpatialCullingEnabled());
+}
+
+std::string RenderSpatialCullingTestLayer::title() const
+{
+    return "Spatial culling";
+}
+
+std::string RenderSpatialCullingTestLayer::subtitle() const
+{
+    return "Only the visible sprites of the scrolling world are visited when on";
+}
+
+////////////////////////////////////////////////////////
+//
+// RenderCommandPoolTestLayer
+//
+////////////////////////////////////////////////////////
+
+void RenderCommandPoolTestLayer::onEnter()
+{
+    RenderTestLayer::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+
+    _infoLabel = Label::createWithTTF("", "fonts/arial.ttf", 16);
+    _infoLabel->setPosition(Point(s.width/2, s.height/2));
+    addChild(_infoLabel, 1);
+
+    _commands.reserve(COMMANDS_PER_FRAME);
+    scheduleUpdate();
+}
+
+void RenderCommandPoolTestLayer::update(float dt)
+{
+    typedef std::chrono::high_resolution_clock Clock;
+
+    // new/delete per command, as a reference
+    auto start = Clock::now();
+    for (int i = 0; i < COMMANDS_PER_FRAME; ++i)
+        _commands.push_back(new QuadCommand());
+    for (auto command : _commands)
+        delete command;
+    _commands.clear();
+    double heapTime = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    // single threaded pool
+    uint32_t blocks = _pool.getBlockAllocations();
+    start = Clock::now();
+    for (int i = 0; i < COMMANDS_PER_FRAME; ++i)
+        _commands.push_back(_pool.generateCommand());
+    for (auto command : _commands)
+        _pool.pushBackCommand(command);
+    _commands.clear();
+    double poolTime = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    uint32_t poolAllocations = _pool.getBlockAllocations() - blocks;
+
+    // thread safe pool, used from every worker at once
+    auto threadPool = ThreadPool::getInstance();
+    int tasks = threadPool->getThreadCount() + 1;
+    blocks = _threadSafePool.getBlockAllocations();
+    start = Clock::now();
+    threadPool->parallelFor(tasks, [this, tasks](int) {
+        QuadCommand* commands[256];
+        for (int done = 0; done < COMMANDS_PER_FRAME / tasks; done += 256)
+        {
+            for (auto& command : commands)
+                command = _threadSafePool.generateCommand();
+            for (auto command : commands)
+                _threadSafePool.pushBackCommand(command);
+        }
+    });
+    double threadSafeTime = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    uint32_t threadSafeAllocations = _threadSafePool.getBlockAllocations() - blocks;
+
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer),
+             "%d commands per frame\n"
+             "new/delete: %.2f ms, %d allocations\n"
+             "pool: %.2f ms, %u allocations (capacity %u)\n"
+             "thread safe pool, %d threads: %.2f ms, %u allocations (capacity %u)",
+             COMMANDS_PER_FRAME,
+             heapTime, COMMANDS_PER_FRAME,
+             poolTime, poolAllocations, _pool.getCapacity(),
+             tasks, threadSafeTime, threadSafeAllocations, _threadSafePool.getCapacity());
+    _infoLabel->setString(buffer);
+}
+
+std::string RenderCommandPoolTestLayer::title() const
+{
+    return "Render command pool";
+}
+
+std::string RenderCommandPoolTestLayer::subtitle() const
+{
+    return "Allocations per frame drop to 0 once the pools have grown";
 }
 
 void runRendererTest()
 {
     auto scene = RenderTestLayer::scene();
     Director::getInstance()->replaceScene(scene);
-}
\ No newline at end of file
+}
@@ -10,18 +10,164 @@
 #define __PERFORMANCE_RENDERER_TEST_H__
 
 #include "PerformanceTest.h"
+#include "renderer/CCRenderCommandPool.h"
+
+#include <chrono>
 
 class RenderTestLayer : public PerformBasicLayer
 {
     
 public:
-    RenderTestLayer();
+    RenderTestLayer(int nCurCase = 0);
     virtual ~RenderTestLayer();
     
     virtual void onEnter() override;
     virtual void showCurrentTest() override;
+
+    virtual std::string title() const;
+    virtual std::string subtitle() const;
+public:
+    static Scene* scene(int nCurCase = 0);
+};
+
+class RenderTMXTestLayer : public RenderTestLayer
+{
+public:
+    RenderTMXTestLayer(int nCurCase) : RenderTestLayer(nCurCase) {}
+
+    virtual void onEnter() override;
+    virtual std::string title() const override;
+};
+
+class RenderStreamingTestLayer : public RenderTestLayer
+{
+public:
+    static const int SPRITE_COUNT = 5000;
+
+    RenderStreamingTestLayer(int nCurCase) : RenderTestLayer(nCurCase), _streamingWasEnabled(false), _infoLabel(nullptr) {}
+
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual void update(float dt) override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    void onToggleStreaming(Ref* sender);
+
+protected:
+    bool _streamingWasEnabled;
+    Label* _infoLabel;
+};
+
+class RenderTransformBenchmarkLayer : public RenderTestLayer
+{
 public:
-    static Scene* scene();
+    RenderTransformBenchmarkLayer(int nCurCase) : RenderTestLayer(nCurCase), _resultLabel(nullptr) {}
+
+    virtual void onEnter() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    void runBenchmark(float dt);
+
+protected:
+    Label* _resultLabel;
+};
+
+class RenderMaterialSortTestLayer : public RenderTestLayer
+{
+public:
+    static const int SPRITE_COUNT = 2000;
+
+    RenderMaterialSortTestLayer(int nCurCase) : RenderTestLayer(nCurCase), _sortByMaterial(false), _infoLabel(nullptr) {}
+
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual void update(float dt) override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    void onToggleSortMode(Ref* sender);
+
+protected:
+    bool _sortByMaterial;
+    Label* _infoLabel;
+};
+
+// Measures the time spent in the visit of the scene, between Director::EVENT_AFTER_UPDATE and EVENT_AFTER_VISIT
+class RenderVisitTimeTestLayer : public RenderTestLayer
+{
+public:
+    RenderVisitTimeTestLayer(int nCurCase) : RenderTestLayer(nCurCase), _afterUpdateListener(nullptr), _afterVisitListener(nullptr), _visitTime(0) {}
+
+    virtual void onEnter() override;
+    virtual void onExit() override;
+
+protected:
+    EventListenerCustom* _afterUpdateListener;
+    EventListenerCustom* _afterVisitListener;
+    std::chrono::high_resolution_clock::time_point _visitStart;
+    double _visitTime;
+};
+
+class RenderParallelVisitTestLayer : public RenderVisitTimeTestLayer
+{
+public:
+    static const int GROUP_COUNT = 8;
+    static const int SPRITES_PER_GROUP = 1000;
+
+    RenderParallelVisitTestLayer(int nCurCase) : RenderVisitTimeTestLayer(nCurCase), _container(nullptr), _infoLabel(nullptr) {}
+
+    virtual void onEnter() override;
+    virtual void update(float dt) override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    void onToggleParallel(Ref* sender);
+
+protected:
+    Node* _container;
+    Label* _infoLabel;
+};
+
+class RenderSpatialCullingTestLayer : public RenderVisitTimeTestLayer
+{
+public:
+    static const int SPRITE_COUNT = 50000;
+    static const int WORLD_SCREENS = 16;
+
+    RenderSpatialCullingTestLayer(int nCurCase) : RenderVisitTimeTestLayer(nCurCase), _world(nullptr), _infoLabel(nullptr), _scroll(0) {}
+
+    virtual void onEnter() override;
+    virtual void update(float dt) override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    void onToggleCulling(Ref* sender);
+
+protected:
+    Node* _world;
+    Label* _infoLabel;
+    float _scroll;
+};
+
+class RenderCommandPoolTestLayer : public RenderTestLayer
+{
+public:
+    static const int COMMANDS_PER_FRAME = 20000;
+
+    RenderCommandPoolTestLayer(int nCurCase) : RenderTestLayer(nCurCase), _infoLabel(nullptr) {}
+
+    virtual void onEnter() override;
+    virtual void update(float dt) override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+protected:
+    RenderCommandPool<QuadCommand> _pool;
+    RenderCommandPool<QuadCommand, true> _threadSafePool;
+    std::vector<QuadCommand*> _commands;
+    Label* _infoLabel;
 };
 
 void runRendererTest();
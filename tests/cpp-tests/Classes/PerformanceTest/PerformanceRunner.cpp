@@ -0,0 +1,193 @@
+//
+//  PerformanceRunner.cpp
+
+#include "PerformanceRunner.h"
+#include "PerformanceTest.h"
+#include "renderer/CCRenderer.h"
+#if CC_ENABLE_NULL_GL
+#include "CCGLNull.h"
+#endif
+#include <algorithm>
+
+static PerformanceRunner* s_runner = nullptr;
+
+static PerformBasicLayer* findPerformLayer(Node* node)
+{
+    if (node == nullptr)
+        return nullptr;
+
+    auto layer = dynamic_cast<PerformBasicLayer*>(node);
+    if (layer)
+        return layer;
+
+    for (const auto& child : node->getChildren())
+    {
+        layer = findPerformLayer(child);
+        if (layer)
+            return layer;
+    }
+    return nullptr;
+}
+
+void PerformanceRunner::start(int frames, int warmupFrames, const std::string& outputPath)
+{
+    CCASSERT(s_runner == nullptr, "The performance runner is already running");
+    CCASSERT(frames > 0, "Invalid frame count");
+
+    s_runner = new PerformanceRunner(frames, std::max(warmupFrames, 0));
+    if (!outputPath.empty())
+    {
+        s_runner->_output = fopen(outputPath.c_str(), "w");
+        if (s_runner->_output == nullptr)
+        {
+            log("PerformanceRunner: can't open %s, writing the results to stdout", outputPath.c_str());
+            s_runner->_output = stdout;
+        }
+    }
+}
+
+PerformanceRunner::PerformanceRunner(int frames, int warmupFrames)
+: _frames(frames)
+, _warmupFrames(warmupFrames)
+, _output(stdout)
+, _listener(nullptr)
+, _test(-1)
+, _case(0)
+, _frame(0)
+{
+    resetCounters();
+
+    // The renderer counters of a frame are still valid after the draw, before the buffers are swapped
+    _listener = Director::getInstance()->getEventDispatcher()->addCustomEventListener(Director::EVENT_AFTER_DRAW, CC_CALLBACK_1(PerformanceRunner::onAfterDraw, this));
+}
+
+PerformanceRunner::~PerformanceRunner()
+{
+    if (_output && _output != stdout)
+        fclose(_output);
+}
+
+void PerformanceRunner::resetCounters()
+{
+    _frame = 0;
+    _frameTimes.clear();
+    _frameTimes.reserve(_frames);
+    _drawCalls = _vertices = 0;
+    _glCalls = _glStateChanges = _glUniforms = _glBytes = 0;
+}
+
+void PerformanceRunner::startTest(int index)
+{
+    _test = index;
+    _case = 0;
+    resetCounters();
+
+    // Same random sequence on every run
+    srand(1);
+    runPerformanceTest(index);
+}
+
+void PerformanceRunner::onAfterDraw(EventCustom* event)
+{
+    auto now = std::chrono::steady_clock::now();
+    auto director = Director::getInstance();
+
+    if (_test < 0)
+    {
+        // The first frame: the application has finished launching, turn off what would skew the timings
+        director->setDisplayStats(false);
+        director->setAnimationInterval(0);
+        _lastFrame = now;
+        startTest(0);
+        return;
+    }
+
+    float ms = std::chrono::duration<float, std::milli>(now - _lastFrame).count();
+    _lastFrame = now;
+
+    // The warmup frames absorb the scene creation and the texture loads of a case
+    if (_frame >= _warmupFrames)
+    {
+        _frameTimes.push_back(ms);
+        auto renderer = director->getRenderer();
+        _drawCalls += renderer->getDrawnBatches();
+        _vertices += renderer->getDrawnVertices();
+#if CC_ENABLE_NULL_GL
+        if (GLNull::isInstalled())
+        {
+            const auto& stats = GLNull::getStats();
+            _glCalls += stats.calls;
+            _glStateChanges += stats.stateChanges;
+            _glUniforms += stats.uniforms;
+            _glBytes += stats.bytesUploaded;
+        }
+#endif
+    }
+#if CC_ENABLE_NULL_GL
+    if (GLNull::isInstalled())
+        GLNull::resetStats();
+#endif
+
+    if (++_frame < _warmupFrames + _frames)
+        return;
+
+    writeResult();
+
+    if (nextCase())
+        return;
+
+    if (_test + 1 < getPerformanceTestCount())
+        startTest(_test + 1);
+    else
+        finish();
+}
+
+bool PerformanceRunner::nextCase()
+{
+    auto layer = findPerformLayer(Director::getInstance()->getRunningScene());
+    if (layer == nullptr || layer->getCurrentCase() + 1 >= layer->getMaxCases())
+        return false;
+
+    layer->nextCallback(nullptr);
+    // Tests in auto mode refuse to move to another case
+    if (layer->getCurrentCase() == _case)
+        return false;
+
+    _case = layer->getCurrentCase();
+    resetCounters();
+    srand(1);
+    return true;
+}
+
+void PerformanceRunner::writeResult()
+{
+    std::vector<float> sorted(_frameTimes);
+    std::sort(sorted.begin(), sorted.end());
+
+    size_t count = sorted.size();
+    double total = 0;
+    for (auto ms : sorted)
+        total += ms;
+
+    fprintf(_output,
+            "{\"test\":\"%s\",\"case\":%d,\"frames\":%d,"
+            "\"avg_ms\":%.4f,\"min_ms\":%.4f,\"p50_ms\":%.4f,\"p95_ms\":%.4f,\"max_ms\":%.4f,"
+            "\"draw_calls\":%.1f,\"vertices\":%.1f,"
+            "\"gl_calls\":%.1f,\"gl_state_changes\":%.1f,\"gl_uniforms\":%.1f,\"gl_upload_bytes\":%.1f}\n",
+            getPerformanceTestName(_test), _case, (int)count,
+            total / count, sorted.front(), sorted[count / 2], sorted[count * 95 / 100], sorted.back(),
+            _drawCalls / count, _vertices / count,
+            _glCalls / count, _glStateChanges / count, _glUniforms / count, _glBytes / count);
+    fflush(_output);
+}
+
+void PerformanceRunner::finish()
+{
+    Director::getInstance()->getEventDispatcher()->removeEventListener(_listener);
+    _listener = nullptr;
+
+    s_runner = nullptr;
+    release();
+
+    Director::getInstance()->end();
+}
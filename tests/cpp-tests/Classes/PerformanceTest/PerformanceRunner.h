@@ -0,0 +1,53 @@
+//
+//  PerformanceRunner.h
+
+#ifndef __PERFORMANCE_RUNNER_H__
+#define __PERFORMANCE_RUNNER_H__
+
+#include "cocos2d.h"
+#include <chrono>
+
+USING_NS_CC;
+
+/** Runs every case of every performance test for a fixed number of frames, without user input.
+ One JSON object per case is written to the output file (stdout when the path is empty), e.g.
+ {"test":"Particle Test","case":0,"frames":300,"avg_ms":1.21,"min_ms":0.98,"p50_ms":1.19,"p95_ms":1.44,"max_ms":2.03,
+  "draw_calls":3.0,"vertices":1204.0,"gl_calls":211.0,"gl_state_changes":40.0,"gl_uniforms":12.0,"gl_upload_bytes":98304.0}
+ The counters are averages per frame, the gl_* ones are only written by the headless backend.
+ The director is ended once the last case has run.
+ */
+class PerformanceRunner : public Ref
+{
+public:
+    static void start(int frames, int warmupFrames, const std::string& outputPath);
+
+private:
+    PerformanceRunner(int frames, int warmupFrames);
+    virtual ~PerformanceRunner();
+
+    void onAfterDraw(EventCustom* event);
+    void startTest(int index);
+    bool nextCase();
+    void resetCounters();
+    void writeResult();
+    void finish();
+
+    int _frames;
+    int _warmupFrames;
+    FILE* _output;
+    EventListenerCustom* _listener;
+
+    int _test;
+    int _case;
+    int _frame;
+    std::chrono::steady_clock::time_point _lastFrame;
+    std::vector<float> _frameTimes;
+    double _drawCalls;
+    double _vertices;
+    double _glCalls;
+    double _glStateChanges;
+    double _glUniforms;
+    double _glBytes;
+};
+
+#endif
@@ -0,0 +1,272 @@
+//
+//  PerformanceSchedulerTest.cpp
+//
+
+#include "PerformanceSchedulerTest.h"
+
+#include <chrono>
+
+static std::function<PerformanceSchedulerScene*()> createFunctions[] =
+{
+    CL(SchedulerUpdatePerfTest),
+    CL(SchedulerUpdateChurnPerfTest),
+    CL(SchedulerSelectorPerfTest),
+    CL(SchedulerCallbackPerfTest),
+    CL(SchedulerIntervalPerfTest),
+};
+
+#define MAX_LAYER    (sizeof(createFunctions) / sizeof(createFunctions[0]))
+
+
+static int g_curCase = 0;
+
+////////////////////////////////////////////////////////
+//
+// SchedulerBasicLayer
+//
+////////////////////////////////////////////////////////
+
+SchedulerBasicLayer::SchedulerBasicLayer(bool bControlMenuVisible, int nMaxCases, int nCurCase)
+: PerformBasicLayer(bControlMenuVisible, nMaxCases, nCurCase)
+{
+}
+
+void SchedulerBasicLayer::showCurrentTest()
+{
+    auto scene = createFunctions[_curCase]();
+    
+    g_curCase = _curCase;
+    
+    if (scene)
+    {
+        Director::getInstance()->replaceScene(scene);
+    }
+}
+
+////////////////////////////////////////////////////////
+//
+// PerformanceSchedulerScene
+//
+////////////////////////////////////////////////////////
+
+PerformanceSchedulerScene::PerformanceSchedulerScene()
+: _testScheduler(nullptr)
+, _timeLabel(nullptr)
+, _totalTime(0)
+, _frames(0)
+{
+}
+
+PerformanceSchedulerScene::~PerformanceSchedulerScene()
+{
+    CC_SAFE_RELEASE(_testScheduler);
+}
+
+void PerformanceSchedulerScene::onEnter()
+{
+    Scene::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+    
+    auto menuLayer = new SchedulerBasicLayer(true, MAX_LAYER, g_curCase);
+    addChild(menuLayer);
+    menuLayer->release();
+    
+    // Title
+    auto label = Label::createWithTTF(title().c_str(), "fonts/arial.ttf", 32);
+    addChild(label, 1);
+    label->setPosition(Point(s.width/2, s.height-50));
+    
+    // Subtitle
+    std::string strSubTitle = subtitle();
+    if(strSubTitle.length())
+    {
+        auto l = Label::createWithTTF(strSubTitle.c_str(), "fonts/Thonburi.ttf", 16);
+        addChild(l, 1);
+        l->setPosition(Point(s.width/2, s.height-80));
+    }
+
+    _timeLabel = Label::createWithTTF("", "fonts/arial.ttf", 24);
+    addChild(_timeLabel, 1);
+    _timeLabel->setPosition(Point(s.width/2, s.height/2));
+
+    _testScheduler = new Scheduler();
+    for (int i = 0; i < TARGET_COUNT; ++i)
+    {
+        auto target = new Target();
+        _targets.pushBack(target);
+        target->release();
+    }
+    scheduleTargets();
+
+    _totalTime = 0;
+    _frames = 0;
+    
+    getScheduler()->schedule(schedule_selector(PerformanceSchedulerScene::onUpdate), this, 0.0f, false);
+    getScheduler()->schedule(schedule_selector(PerformanceSchedulerScene::dumpCallbackTime), this, 2, false);
+}
+
+void PerformanceSchedulerScene::onExit()
+{
+    _testScheduler->unscheduleAll();
+    
+    Scene::onExit();
+}
+
+std::string PerformanceSchedulerScene::title() const
+{
+    return "No title";
+}
+
+std::string PerformanceSchedulerScene::subtitle() const
+{
+    return "Time per callback, see console";
+}
+
+void PerformanceSchedulerScene::onUpdate(float dt)
+{
+    auto begin = std::chrono::high_resolution_clock::now();
+    _testScheduler->update(dt);
+    auto end = std::chrono::high_resolution_clock::now();
+    
+    _totalTime += std::chrono::duration_cast<std::chrono::duration<double, std::nano>>(end - begin).count();
+    ++_frames;
+}
+
+void PerformanceSchedulerScene::dumpCallbackTime(float dt)
+{
+    if (_frames == 0)
+        return;
+    
+    auto nanoseconds = _totalTime / _frames / TARGET_COUNT;
+    log("%s: %.1f ns per callback", title().c_str(), nanoseconds);
+    _timeLabel->setString(StringUtils::format("%.1f ns per callback", nanoseconds));
+    
+    _totalTime = 0;
+    _frames = 0;
+}
+
+////////////////////////////////////////////////////////
+//
+// SchedulerUpdatePerfTest
+//
+////////////////////////////////////////////////////////
+
+std::string SchedulerUpdatePerfTest::title() const
+{
+    return "Update selectors";
+}
+
+void SchedulerUpdatePerfTest::scheduleTargets()
+{
+    for (const auto &target : _targets)
+    {
+        _testScheduler->scheduleUpdate(target, 0, false);
+    }
+}
+
+////////////////////////////////////////////////////////
+//
+// SchedulerUpdateChurnPerfTest
+//
+////////////////////////////////////////////////////////
+
+std::string SchedulerUpdateChurnPerfTest::title() const
+{
+    return "Update selectors, 10% rescheduled";
+}
+
+void SchedulerUpdateChurnPerfTest::scheduleTargets()
+{
+    _nextTarget = 0;
+    _handles.clear();
+    for (const auto &target : _targets)
+    {
+        _handles.push_back(_testScheduler->scheduleUpdate(target, 0, false));
+    }
+}
+
+void SchedulerUpdateChurnPerfTest::onUpdate(float dt)
+{
+    auto begin = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < TARGET_COUNT / 10; ++i)
+    {
+        _testScheduler->unscheduleUpdate(_handles[_nextTarget]);
+        _handles[_nextTarget] = _testScheduler->scheduleUpdate(_targets.at(_nextTarget), 0, false);
+        _nextTarget = (_nextTarget + 1) % TARGET_COUNT;
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    _totalTime += std::chrono::duration_cast<std::chrono::duration<double, std::nano>>(end - begin).count();
+    
+    PerformanceSchedulerScene::onUpdate(dt);
+}
+
+////////////////////////////////////////////////////////
+//
+// SchedulerSelectorPerfTest
+//
+////////////////////////////////////////////////////////
+
+std::string SchedulerSelectorPerfTest::title() const
+{
+    return "Custom selectors, interval 0";
+}
+
+void SchedulerSelectorPerfTest::scheduleTargets()
+{
+    for (const auto &target : _targets)
+    {
+        _testScheduler->schedule(schedule_selector(Target::tick), target, 0.0f, false);
+    }
+}
+
+////////////////////////////////////////////////////////
+//
+// SchedulerCallbackPerfTest
+//
+////////////////////////////////////////////////////////
+
+std::string SchedulerCallbackPerfTest::title() const
+{
+    return "Lambdas, interval 0";
+}
+
+void SchedulerCallbackPerfTest::scheduleTargets()
+{
+    for (const auto &target : _targets)
+    {
+        _testScheduler->schedule([target](float dt){
+            target->tick(dt);
+        }, target, 0.0f, false, "tick");
+    }
+}
+
+////////////////////////////////////////////////////////
+//
+// SchedulerIntervalPerfTest
+//
+////////////////////////////////////////////////////////
+
+std::string SchedulerIntervalPerfTest::title() const
+{
+    return "Custom selectors, interval 2 to 10s";
+}
+
+void SchedulerIntervalPerfTest::scheduleTargets()
+{
+    int index = 0;
+    for (const auto &target : _targets)
+    {
+        // spread the deadlines, most of the frames trigger a few timers
+        float interval = 2.0f + (index % 100) * 0.08f;
+        _testScheduler->schedule(schedule_selector(Target::tick), target, interval, false);
+        ++index;
+    }
+}
+
+void runSchedulerPerformanceTest()
+{
+    auto scene = createFunctions[g_curCase]();
+    
+    Director::getInstance()->replaceScene(scene);
+}
@@ -0,0 +1,112 @@
+//
+//  PerformanceSchedulerTest.h
+
+#ifndef __PERFORMANCE_SCHEDULER_TEST_H__
+#define __PERFORMANCE_SCHEDULER_TEST_H__
+
+#include "PerformanceTest.h"
+
+class SchedulerBasicLayer : public PerformBasicLayer
+{
+public:
+    SchedulerBasicLayer(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0);
+    
+    virtual void showCurrentTest();
+};
+
+// The callbacks are scheduled on a scheduler of the test, which is updated once per frame
+class PerformanceSchedulerScene : public Scene
+{
+public:
+    PerformanceSchedulerScene();
+    virtual ~PerformanceSchedulerScene();
+
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string title() const;
+    virtual std::string subtitle() const;
+
+    // schedules the callbacks of the targets
+    virtual void scheduleTargets() = 0;
+    virtual void onUpdate(float dt);
+
+    void dumpCallbackTime(float dt);
+    
+    static const int TARGET_COUNT = 10000;
+
+protected:
+    class Target : public Ref
+    {
+    public:
+        Target() : _ticks(0) {}
+        void update(float dt) { ++_ticks; }
+        void tick(float dt) { ++_ticks; }
+        
+        int _ticks;
+    };
+
+    Scheduler* _testScheduler;
+    Vector<Target*> _targets;
+    Label* _timeLabel;
+    double _totalTime;
+    int _frames;
+};
+
+// update selectors scheduled with scheduleUpdate()
+class SchedulerUpdatePerfTest : public PerformanceSchedulerScene
+{
+public:
+    CREATE_FUNC(SchedulerUpdatePerfTest);
+    
+    virtual std::string title() const override;
+    virtual void scheduleTargets() override;
+};
+
+// update selectors, a tenth of them unscheduled and scheduled again every frame
+class SchedulerUpdateChurnPerfTest : public PerformanceSchedulerScene
+{
+public:
+    CREATE_FUNC(SchedulerUpdateChurnPerfTest);
+    
+    virtual std::string title() const override;
+    virtual void scheduleTargets() override;
+    virtual void onUpdate(float dt) override;
+    
+private:
+    std::vector<Scheduler::UpdateHandle> _handles;
+    int _nextTarget;
+};
+
+// custom selectors called every frame
+class SchedulerSelectorPerfTest : public PerformanceSchedulerScene
+{
+public:
+    CREATE_FUNC(SchedulerSelectorPerfTest);
+    
+    virtual std::string title() const override;
+    virtual void scheduleTargets() override;
+};
+
+// lambdas called every frame
+class SchedulerCallbackPerfTest : public PerformanceSchedulerScene
+{
+public:
+    CREATE_FUNC(SchedulerCallbackPerfTest);
+    
+    virtual std::string title() const override;
+    virtual void scheduleTargets() override;
+};
+
+// custom selectors called every few seconds
+class SchedulerIntervalPerfTest : public PerformanceSchedulerScene
+{
+public:
+    CREATE_FUNC(SchedulerIntervalPerfTest);
+    
+    virtual std::string title() const override;
+    virtual void scheduleTargets() override;
+};
+
+void runSchedulerPerformanceTest();
+
+#endif /* __PERFORMANCE_SCHEDULER_TEST_H__ */
@@ -12,6 +12,8 @@
 #include "PerformanceEventDispatcherTest.h"
 #include "PerformanceScenarioTest.h"
 #include "PerformanceCallbackTest.h"
+#include "PerformanceSchedulerTest.h"
+#include "PerformanceActionTest.h"
 
 enum
 {
@@ -36,10 +38,27 @@ struct {
     { "EventDispatcher Perf Test", [](Ref* sender ) { runEventDispatcherPerformanceTest(); } },
     { "Scenario Perf Test", [](Ref* sender ) { runScenarioTest(); } },
     { "Callback Perf Test", [](Ref* sender ) { runCallbackPerformanceTest(); } },
+    { "Scheduler Perf Test", [](Ref* sender ) { runSchedulerPerformanceTest(); } },
+    { "Action Perf Test", [](Ref* sender ) { runActionPerformanceTest(); } },
 };
 
 static const int g_testMax = sizeof(g_testsName)/sizeof(g_testsName[0]);
 
+int getPerformanceTestCount()
+{
+    return g_testMax;
+}
+
+const char* getPerformanceTestName(int index)
+{
+    return g_testsName[index].name;
+}
+
+void runPerformanceTest(int index)
+{
+    g_testsName[index].callback(nullptr);
+}
+
 Point PerformanceMainLayer::_CurrentPos = Point::ZERO;
 
 ////////////////////////////////////////////////////////
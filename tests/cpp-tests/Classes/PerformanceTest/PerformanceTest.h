@@ -33,6 +33,9 @@ public:
 
     virtual void toMainLayer(Ref* sender);
 
+    int getCurrentCase() const { return _curCase; }
+    int getMaxCases() const { return _maxCases; }
+
 protected:
     bool _controlMenuVisible;
     int  _maxCases;
@@ -45,4 +48,9 @@ public:
     virtual void runThisTest();
 };
 
+// Used by the command line runner to walk the test list without the menu
+int getPerformanceTestCount();
+const char* getPerformanceTestName(int index);
+void runPerformanceTest(int index);
+
 #endif
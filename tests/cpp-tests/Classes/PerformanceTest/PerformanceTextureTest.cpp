@@ -2,7 +2,7 @@
 
 enum
 {
-    TEST_COUNT = 1,
+    TEST_COUNT = 2,
 };
 
 static int s_nTexCurCase = 0;
@@ -32,6 +32,9 @@ void TextureMenuLayer::showCurrentTest()
     case 0:
         scene = TextureTest::scene();
         break;
+    case 1:
+        scene = TextureAsyncTest::scene();
+        break;
     }
     s_nTexCurCase = _curCase;
 
@@ -348,7 +351,125 @@ std::string TextureTest::subtitle() const
 Scene* TextureTest::scene()
 {
     auto scene = Scene::create();
-    TextureTest *layer = new TextureTest(false, TEST_COUNT, s_nTexCurCase);
+    TextureTest *layer = new TextureTest(true, TEST_COUNT, s_nTexCurCase);
+    scene->addChild(layer);
+    layer->release();
+
+    return scene;
+}
+
+////////////////////////////////////////////////////////
+//
+// TextureAsyncTest
+//
+////////////////////////////////////////////////////////
+static const char* s_asyncImages[] = {
+    "Images/PlanetCute-1024x1024.png",
+    "Images/landscape-1024x1024.png",
+    "Images/texture1024x1024.png",
+    "Images/test_1021x1024.png",
+    "Images/texture512x512.png",
+    "Images/white-512x512.png",
+    "Images/background1.jpg",
+    "Images/background2.jpg",
+    "Images/background3.jpg",
+    "Images/background1.png",
+    "Images/background2.png",
+    "Images/background3.png",
+    "Images/test_image.webp",
+    // requested twice: decoded once
+    "Images/landscape-1024x1024.png",
+};
+
+void TextureAsyncTest::performTests()
+{
+    auto s = Director::getInstance()->getWinSize();
+
+    _infoLabel = Label::createWithTTF("", "fonts/arial.ttf", 20);
+    _infoLabel->setPosition(Point(s.width/2, s.height/2));
+    addChild(_infoLabel, 1);
+
+    schedule(schedule_selector(TextureAsyncTest::trackUploadTime));
+    loadImages(1);
+}
+
+void TextureAsyncTest::loadImages(int threadCount)
+{
+    // a private cache, so that nothing is loaded already
+    CC_SAFE_RELEASE(_cache);
+    _cache = new TextureCache();
+    _cache->setAsyncLoadingThreadCount(threadCount);
+    _threadCount = threadCount;
+    _maxUploadTime = 0;
+
+    _pendingLoads = sizeof(s_asyncImages) / sizeof(s_asyncImages[0]);
+    gettimeofday(&_startTime, NULL);
+    for (int i = 0; i < _pendingLoads; ++i)
+    {
+        // the big images first
+        _cache->addImageAsync(s_asyncImages[i], CC_CALLBACK_1(TextureAsyncTest::imageLoaded, this), i < 4 ? 1 : 0);
+    }
+}
+
+void TextureAsyncTest::imageLoaded(Texture2D* texture)
+{
+    if (--_pendingLoads > 0)
+        return;
+
+    float elapsed = calculateDeltaTime(&_startTime);
+    char buffer[128];
+    snprintf(buffer, sizeof(buffer), "%d loading threads: %.0f ms, longest upload frame: %.1f ms\n",
+             _threadCount, elapsed * 1000, std::max(_maxUploadTime, _cache->getAsyncUploadTime()) * 1000);
+    log("%s", buffer);
+    _results += buffer;
+    _infoLabel->setString(_results);
+
+    if (_threadCount == 1)
+    {
+        // don't destroy the cache from its own callback
+        scheduleOnce(schedule_selector(TextureAsyncTest::loadWithMoreThreads), 0);
+    }
+}
+
+void TextureAsyncTest::loadWithMoreThreads(float dt)
+{
+    loadImages(std::max(2, (int)std::thread::hardware_concurrency() - 1));
+}
+
+void TextureAsyncTest::trackUploadTime(float dt)
+{
+    // sampled every frame, the cache only reports its last frame
+    if (_cache)
+    {
+        _maxUploadTime = std::max(_maxUploadTime, _cache->getAsyncUploadTime());
+    }
+}
+
+void TextureAsyncTest::onExit()
+{
+    if (_cache)
+    {
+        _cache->unbindAllImageAsync();
+        Director::getInstance()->getScheduler()->unscheduleAllForTarget(_cache);
+        CC_SAFE_RELEASE_NULL(_cache);
+    }
+    TextureMenuLayer::onExit();
+}
+
+std::string TextureAsyncTest::title() const
+{
+    return "Texture Async Loading Test";
+}
+
+std::string TextureAsyncTest::subtitle() const
+{
+    return "Loads images with 1, then several decoding threads";
+}
+
+Scene* TextureAsyncTest::scene()
+{
+    auto scene = Scene::create();
+    TextureAsyncTest *layer = new TextureAsyncTest(true, TEST_COUNT, s_nTexCurCase);
     scene->addChild(layer);
     layer->release();
 
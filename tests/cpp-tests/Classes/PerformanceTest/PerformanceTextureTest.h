@@ -35,6 +35,42 @@ public:
     static Scene* scene();
 };
 
+class TextureAsyncTest : public TextureMenuLayer
+{
+public:
+    TextureAsyncTest(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0)
+        :TextureMenuLayer(bControlMenuVisible, nMaxCases, nCurCase)
+        , _cache(nullptr)
+        , _threadCount(0)
+        , _pendingLoads(0)
+        , _maxUploadTime(0)
+        , _infoLabel(nullptr)
+    {
+    }
+
+    virtual void performTests();
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    /** loads every test image with a fresh cache and `threadCount` loading threads */
+    void loadImages(int threadCount);
+    void imageLoaded(Texture2D* texture);
+    void loadWithMoreThreads(float dt);
+    void trackUploadTime(float dt);
+
+    static Scene* scene();
+
+protected:
+    TextureCache* _cache;
+    int _threadCount;
+    int _pendingLoads;
+    float _maxUploadTime;       ///< longest time spent uploading textures in a frame
+    struct timeval _startTime;
+    Label* _infoLabel;
+    std::string _results;
+};
+
 void runTextureTest();
 
 #endif
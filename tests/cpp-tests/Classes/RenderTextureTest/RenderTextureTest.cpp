@@ -548,25 +548,25 @@ void RenderTextureTestDepthStencil::draw(Renderer *renderer, const kmMat4 &trans
 
 void RenderTextureTestDepthStencil::onBeforeClear()
 {
-    glStencilMask(0xFF);
+    GL::stencilMask(0xFF);
 }
 
 void RenderTextureTestDepthStencil::onBeforeStencil()
 {
     //! mark sprite quad into stencil buffer
-    glEnable(GL_STENCIL_TEST);
-    glStencilFunc(GL_NEVER, 1, 0xFF);
-    glStencilOp(GL_REPLACE, GL_REPLACE, GL_REPLACE);
+    GL::enable(GL_STENCIL_TEST);
+    GL::stencilFunc(GL_NEVER, 1, 0xFF);
+    GL::stencilOp(GL_REPLACE, GL_REPLACE, GL_REPLACE);
 }
 
 void RenderTextureTestDepthStencil::onBeforDraw()
 {
-    glStencilFunc(GL_NOTEQUAL, 1, 0xFF);
+    GL::stencilFunc(GL_NOTEQUAL, 1, 0xFF);
 }
 
 void RenderTextureTestDepthStencil::onAfterDraw()
 {
-    glDisable(GL_STENCIL_TEST);
+    GL::disable(GL_STENCIL_TEST);
 }
 
 std::string RenderTextureTestDepthStencil::title() const
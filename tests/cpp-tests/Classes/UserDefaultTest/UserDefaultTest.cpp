@@ -1,6 +1,7 @@
 #include "UserDefaultTest.h"
 #include "stdio.h"
 #include "stdlib.h"
+#include <chrono>
 
 // enable log
 #define COCOS2D_DEBUG 1
@@ -88,6 +89,18 @@ void UserDefaultTest::doTest()
     {
         CCLOG("bool is false");
     }
+
+    CCLOG("********************** save in a loop ***********************");
+
+    // values are read from memory and saved by a background thread: this shouldn't stall the frame
+    auto start = std::chrono::steady_clock::now();
+    for (int n = 0; n < 1000; ++n)
+    {
+        UserDefault::getInstance()->setIntegerForKey("integer", n);
+        i = UserDefault::getInstance()->getIntegerForKey("integer");
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    CCLOG("1000 sets and gets in %.2f ms, integer is %d", elapsed.count() / 1000.0f, i);
 }
 
 
@@ -1,5 +1,9 @@
 #include "../Classes/AppDelegate.h"
+#include "../Classes/PerformanceTest/PerformanceRunner.h"
 #include "cocos2d.h"
+#if CC_ENABLE_NULL_GL
+#include "CCGLNull.h"
+#endif
 
 #include <stdlib.h>
 #include <stdio.h>
@@ -8,9 +12,66 @@
 
 USING_NS_CC;
 
+static void printUsage(const char* name)
+{
+    printf("usage: %s [--headless] [--frames N] [--warmup N] [--output FILE] [--gl-trace FILE]\n", name);
+    printf("  --headless      run without a window or GPU (needs a build with USE_NULL_GL)\n");
+    printf("  --frames N      run every performance test case for N frames and exit\n");
+    printf("  --warmup N      frames skipped at the start of each case, 10 by default\n");
+    printf("  --output FILE   write the results as JSON lines into FILE instead of stdout\n");
+    printf("  --gl-trace FILE record the GL calls of the headless backend into FILE\n");
+}
+
 int main(int argc, char **argv)
 {
+    bool headless = false;
+    int frames = 0;
+    int warmupFrames = 10;
+    std::string output;
+    std::string glTrace;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--headless")
+            headless = true;
+        else if (arg == "--frames" && hasValue)
+            frames = atoi(argv[++i]);
+        else if (arg == "--warmup" && hasValue)
+            warmupFrames = atoi(argv[++i]);
+        else if (arg == "--output" && hasValue)
+            output = argv[++i];
+        else if (arg == "--gl-trace" && hasValue)
+            glTrace = argv[++i];
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
     // create the application instance
     AppDelegate app;
+
+    if (headless)
+    {
+#if CC_ENABLE_NULL_GL
+        auto director = Director::getInstance();
+        director->setOpenGLView(GLView::createHeadless("Cpp Tests", Size(960, 640)));
+        // The same frames on every run, whatever the speed of the machine
+        director->setFixedDeltaTime(1.0f / 60);
+        if (!glTrace.empty())
+            GLNull::setTraceFile(glTrace);
+#else
+        printf("--headless needs a build with USE_NULL_GL\n");
+        return 1;
+#endif
+    }
+
+    if (frames > 0)
+        PerformanceRunner::start(frames, warmupFrames, output);
+
     return Application::getInstance()->run();
 }